@@ -34,12 +34,14 @@ $(CSOUND_SRC_ROOT)/Engine/envvar.c \
 $(CSOUND_SRC_ROOT)/Engine/extract.c \
 $(CSOUND_SRC_ROOT)/Engine/fgens.c \
 $(CSOUND_SRC_ROOT)/Engine/insert.c \
+$(CSOUND_SRC_ROOT)/Engine/interleave.c \
 $(CSOUND_SRC_ROOT)/Engine/linevent.c \
 $(CSOUND_SRC_ROOT)/Engine/memalloc.c \
 $(CSOUND_SRC_ROOT)/Engine/memfiles.c \
 $(CSOUND_SRC_ROOT)/Engine/musmon.c \
 $(CSOUND_SRC_ROOT)/Engine/namedins.c \
 $(CSOUND_SRC_ROOT)/Engine/rdscor.c \
+$(CSOUND_SRC_ROOT)/Engine/scbin.c \
 $(CSOUND_SRC_ROOT)/Engine/scsort.c \
 $(CSOUND_SRC_ROOT)/Engine/scxtract.c \
 $(CSOUND_SRC_ROOT)/Engine/sort.c \
@@ -61,6 +63,7 @@ $(CSOUND_SRC_ROOT)/InOut/window.c \
 $(CSOUND_SRC_ROOT)/InOut/winEPS.c \
 $(CSOUND_SRC_ROOT)/InOut/circularbuffer.c \
 $(CSOUND_SRC_ROOT)/OOps/aops.c \
+$(CSOUND_SRC_ROOT)/OOps/aops_simd.c \
 $(CSOUND_SRC_ROOT)/OOps/bus.c \
 $(CSOUND_SRC_ROOT)/OOps/cmath.c \
 $(CSOUND_SRC_ROOT)/OOps/diskin2.c \
@@ -68,6 +71,7 @@ $(CSOUND_SRC_ROOT)/OOps/disprep.c \
 $(CSOUND_SRC_ROOT)/OOps/dumpf.c \
 $(CSOUND_SRC_ROOT)/OOps/fftlib.c \
 $(CSOUND_SRC_ROOT)/OOps/pffft.c \
+$(CSOUND_SRC_ROOT)/OOps/partconv.c \
 $(CSOUND_SRC_ROOT)/OOps/goto_ops.c \
 $(CSOUND_SRC_ROOT)/OOps/midiinterop.c \
 $(CSOUND_SRC_ROOT)/OOps/midiops.c \
@@ -159,6 +163,7 @@ $(CSOUND_SRC_ROOT)/Top/main.c \
 $(CSOUND_SRC_ROOT)/Top/new_opts.c \
 $(CSOUND_SRC_ROOT)/Top/one_file.c \
 $(CSOUND_SRC_ROOT)/Top/opcode.c \
+$(CSOUND_SRC_ROOT)/Top/profile.c \
 $(CSOUND_SRC_ROOT)/Top/threads.c \
 $(CSOUND_SRC_ROOT)/Top/utility.c \
 $(CSOUND_SRC_ROOT)/Top/server.c \
@@ -235,8 +240,10 @@ $(CSOUND_SRC_ROOT)/Engine/csound_orc_expressions.c \
 $(CSOUND_SRC_ROOT)/Engine/csound_orc_optimize.c \
 $(CSOUND_SRC_ROOT)/Engine/csound_orc_compile.c \
 $(CSOUND_SRC_ROOT)/Engine/new_orc_parser.c \
+$(CSOUND_SRC_ROOT)/Engine/orc_cache.c \
 $(CSOUND_SRC_ROOT)/Engine/symbtab.c \
 $(CSOUND_SRC_ROOT)/Engine/cs_new_dispatch.c \
+$(CSOUND_SRC_ROOT)/Engine/cs_ws_dispatch.c \
 $(CSOUND_SRC_ROOT)/Engine/cs_par_base.c \
 $(CSOUND_SRC_ROOT)/Engine/cs_par_orc_semantic_analysis.c \
 $(CSOUND_SRC_ROOT)/Opcodes/mp3in.c \
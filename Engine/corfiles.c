@@ -54,7 +54,8 @@ void corfile_putc(CSOUND *csound, int c, CORFIL *f)
 {
     f->body[f->p++] = c;
     if (UNLIKELY(f->p >= f->len)) {
-      char *new = (char*) csound->ReAlloc(csound, f->body, f->len+=100);
+      char *new = (char*) csound->ReAlloc(csound, f->body,
+                                          f->len += (f->len >> 1) + 100);
       if (UNLIKELY(new==NULL)) {
         fprintf(stderr, Str("Out of Memory\n"));
         exit(7);
@@ -74,7 +75,8 @@ void corfile_puts(CSOUND *csound, const char *s, CORFIL *f)
     for (c = s; *c != '\0'; c++) {
       f->body[f->p++] = *c;
       if (UNLIKELY(f->p >= f->len)) {
-        char *new = (char*) csound->ReAlloc(csound, f->body, f->len+=100);
+        char *new = (char*) csound->ReAlloc(csound, f->body,
+                                            f->len += (f->len >> 1) + 100);
         if (UNLIKELY(new==NULL)) {
           fprintf(stderr, Str("Out of Memory\n"));
           exit(7);
@@ -87,7 +89,8 @@ void corfile_puts(CSOUND *csound, const char *s, CORFIL *f)
       while (--n >= 0) {
         f->body[f->p++] = '\0';
         if (UNLIKELY(f->p >= f->len)) {
-          char *new = (char*) csound->ReAlloc(csound, f->body, f->len+=100);
+          char *new = (char*) csound->ReAlloc(csound, f->body,
+                                              f->len += (f->len >> 1) + 100);
           if (UNLIKELY(new==NULL)) {
             fprintf(stderr, Str("Out of Memory\n"));
             exit(7);
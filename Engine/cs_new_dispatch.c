@@ -76,11 +76,29 @@
 #define INIT_SIZE (100)
 //static int task_max_size;
 
+void dag_reinit(CSOUND *csound);
+
+/* Work-stealing engine, see cs_ws_dispatch.c */
+void ws_build(CSOUND *csound);
+void ws_reinit(CSOUND *csound);
+taskID ws_get_task(CSOUND *csound, int index, taskID next_task);
+taskID ws_end_task(CSOUND *csound, int index, taskID task);
+
+/* Does task j depend on the earlier task k?  Both dispatchers answer this
+   from the group matrix built by dag_build, no per-task vectors needed */
+static inline int dag_depends(CSOUND *csound, int j, int k)
+{
+    dagTopology *topo = csound->dag_topo;
+    return topo->group_dep[topo->task_group[k]*topo->num_groups +
+                           topo->task_group[j]];
+}
+
 static void dag_print_state(CSOUND *csound)
 {
     int i;
     watchList *w;
-    printf("*** %d tasks\n", csound->dag_num_active);
+    printf("*** %d tasks in %d groups\n",
+           csound->dag_num_active, csound->dag_topo->num_groups);
     for (i=0; i<csound->dag_num_active; i++) {
       printf("%d(%d): ", i, csound->dag_task_map[i]->insno);
       switch (csound->dag_task_status[i].s) {
@@ -104,10 +122,9 @@ static void dag_print_state(CSOUND *csound)
         break;
       case WAITING:
         {
-          char *tt = csound->dag_task_dep[i];
           int j;
           printf("status=WAITING for tasks [");
-          for (j=0; j<i; j++) if (tt[j]) printf("%d ", j);
+          for (j=0; j<i; j++) if (dag_depends(csound, i, j)) printf("%d ", j);
           printf("]\n");
         }
         break;
@@ -122,17 +139,20 @@ static void create_dag(CSOUND *csound)
 {
     /* Allocate the main task status and watchlists */
     int max = csound->dag_task_max_size;
+    dagTopology *topo = csound->dag_topo;
     csound->dag_task_status = csound->Calloc(csound, sizeof(stateWithPadding)*max);
     csound->dag_task_watch  = csound->Calloc(csound, sizeof(watchList*)*max);
     csound->dag_task_map    = csound->Calloc(csound, sizeof(INSDS*)*max);
-    csound->dag_task_dep    = (char **)csound->Calloc(csound, sizeof(char*)*max);
     csound->dag_wlmm = (watchList *)csound->Calloc(csound, sizeof(watchList)*max);
+    topo->task_group = (int *)csound->Calloc(csound, sizeof(int)*max);
+    topo->first_dep  = (taskID *)csound->Calloc(csound, sizeof(taskID)*max);
 }
 
 static void recreate_dag(CSOUND *csound)
 {
     /* Allocate the main task status and watchlists */
     int max = csound->dag_task_max_size;
+    dagTopology *topo = csound->dag_topo;
     csound->dag_task_status =
       csound->ReAlloc(csound, (stateWithPadding *)csound->dag_task_status,
                sizeof(stateWithPadding)*max);
@@ -141,10 +161,12 @@ static void recreate_dag(CSOUND *csound)
                sizeof(watchList*)*max);
     csound->dag_task_map    =
       csound->ReAlloc(csound, (INSDS *)csound->dag_task_map, sizeof(INSDS*)*max);
-    csound->dag_task_dep    =
-      (char **)csound->ReAlloc(csound, csound->dag_task_dep, sizeof(char*)*max);
     csound->dag_wlmm        =
       (watchList *)csound->ReAlloc(csound, csound->dag_wlmm, sizeof(watchList)*max);
+    topo->task_group =
+      (int *)csound->ReAlloc(csound, topo->task_group, sizeof(int)*max);
+    topo->first_dep  =
+      (taskID *)csound->ReAlloc(csound, topo->first_dep, sizeof(taskID)*max);
 }
 
 static INSTR_SEMANTICS *dag_get_info(CSOUND* csound, int insno)
@@ -183,13 +205,147 @@ static int dag_intersect(CSOUND *csound, struct set_t *current,
     return res;
 }
 
+/* Entries of the instrument pair cache */
+#define DEP_UNKNOWN (0)
+#define DEP_NONE    (1)
+#define DEP_YES     (2)
+
+/* Forget the instrument pair cache; a new orchestra has been merged */
+static void dag_instr_cache_clear(CSOUND *csound, dagTopology *topo)
+{
+    int i;
+    if (topo->instr_dep != NULL) {
+      for (i=0; i<topo->instr_size; i++)
+        if (topo->instr_dep[i] != NULL) csound->Free(csound, topo->instr_dep[i]);
+      csound->Free(csound, topo->instr_dep);
+    }
+    topo->instr_dep = NULL;
+    topo->instr_size = 0;
+    topo->orc_version = csound->dag_orc_version;
+    topo->num_groups = 0;         /* regroup with the new semantics */
+}
+
+/* Do instances of instruments a and b need to run in chain order?  The
+   relation is symmetric, so each pair is worked out from the semantic
+   read/write sets at most once per compiled orchestra */
+static int dag_instr_conflict(CSOUND *csound, int a, int b)
+{
+    dagTopology *topo = csound->dag_topo;
+    char *row;
+    if (a > b) { int t = a; a = b; b = t; }
+    if (b >= topo->instr_size) {
+      int size = csound->engineState.maxinsno+1;
+      if (size <= b) size = b+1;
+      topo->instr_dep = (char **)
+        csound->ReAlloc(csound, topo->instr_dep, sizeof(char*)*size);
+      memset(topo->instr_dep+topo->instr_size, '\0',
+             sizeof(char*)*(size-topo->instr_size));
+      /* rows are indexed by the larger number, so old rows stay valid */
+      topo->instr_size = size;
+    }
+    row = topo->instr_dep[b];
+    if (row == NULL)
+      row = topo->instr_dep[b] = (char *)csound->Calloc(csound, b+1);
+    if (row[a] == DEP_UNKNOWN) {
+      INSTR_SEMANTICS *current_instr = dag_get_info(csound, a);
+      INSTR_SEMANTICS *later_instr = dag_get_info(csound, b);
+      int cnt = 0;
+      row[a] =
+        (dag_intersect(csound, current_instr->write,
+                       later_instr->read, cnt++)       ||
+         dag_intersect(csound, current_instr->read_write,
+                       later_instr->read, cnt++)       ||
+         dag_intersect(csound, current_instr->read,
+                       later_instr->write, cnt++)      ||
+         dag_intersect(csound, current_instr->write,
+                       later_instr->write, cnt++)      ||
+         dag_intersect(csound, current_instr->read_write,
+                       later_instr->write, cnt++)      ||
+         dag_intersect(csound, current_instr->read,
+                       later_instr->read_write, cnt++) ||
+         dag_intersect(csound, current_instr->write,
+                       later_instr->read_write, cnt++)) ? DEP_YES : DEP_NONE;
+    }
+    return row[a] == DEP_YES;
+}
+
+/* Split the active chain into runs of one instrument and fill the
+   group x group dependency matrix from the instrument pair cache.
+   Notes starting and ending mostly change how many instances a group
+   has, not which instruments follow each other, so the matrix and the
+   group each group waits for are only worked out again when that
+   sequence changes: O(active) otherwise, O(active + groups^2) cached
+   lookups when it does. */
+static void dag_group(CSOUND *csound, INSDS *chain)
+{
+    dagTopology *topo = csound->dag_topo;
+    INSDS **task_map = csound->dag_task_map;
+    int i = 0, g = -1, h, m, prev = -1;
+    int same = 1;
+
+    while (chain != NULL) {
+      if (chain->insno != prev) {
+        prev = chain->insno;
+        if (++g >= topo->max_groups) {
+          topo->max_groups = g+INIT_SIZE;
+          topo->group_start = (int *)
+            csound->ReAlloc(csound, topo->group_start,
+                            sizeof(int)*(topo->max_groups+1));
+          topo->group_ins = (int *)
+            csound->ReAlloc(csound, topo->group_ins,
+                            sizeof(int)*topo->max_groups);
+          topo->group_wait = (int *)
+            csound->ReAlloc(csound, topo->group_wait,
+                            sizeof(int)*topo->max_groups);
+        }
+        if (g >= topo->num_groups || topo->group_ins[g] != prev) same = 0;
+        topo->group_start[g] = i;
+        topo->group_ins[g] = prev;
+      }
+      topo->task_group[i] = g;
+      task_map[i] = chain;
+      i++; chain = chain->nxtact;
+    }
+    m = g+1;
+    if (m != topo->num_groups) same = 0;
+    topo->num_groups = m;
+    topo->group_start[m] = i;
+    if (!same) {
+      if (m*m > topo->group_dep_size) {
+        topo->group_dep_size = m*m;
+        topo->group_dep = (char *)
+          csound->ReAlloc(csound, topo->group_dep, topo->group_dep_size);
+      }
+      for (g=0; g<m; g++) {
+        for (h=g; h<m; h++)
+          topo->group_dep[g*m+h] =
+            dag_instr_conflict(csound, topo->group_ins[g], topo->group_ins[h]);
+        /* earliest group anything in g waits for */
+        topo->group_wait[g] = INVALID;
+        for (h=0; h<g; h++)
+          if (topo->group_dep[h*m+g]) { topo->group_wait[g] = h; break; }
+      }
+    }
+    for (g=0; g<m; g++) {
+      taskID first = (topo->group_wait[g] != INVALID) ?
+        topo->group_start[topo->group_wait[g]] : INVALID;
+      for (i=topo->group_start[g]; i<topo->group_start[g+1]; i++)
+        topo->first_dep[i] =
+          (first != INVALID) ? first :
+          (topo->group_dep[g*m+g] && i > topo->group_start[g]) ?
+          topo->group_start[g] : INVALID;
+    }
+}
+
 void dag_build(CSOUND *csound, INSDS *chain)
 {
     INSDS *save = chain;
-    INSDS **task_map;
-    int i;
 
     //printf("DAG BUILD***************************************\n");
+    if (csound->dag_topo == NULL)
+      csound->dag_topo = csound->Calloc(csound, sizeof(dagTopology));
+    if (csound->dag_topo->orc_version != csound->dag_orc_version)
+      dag_instr_cache_clear(csound, csound->dag_topo);
     csound->dag_num_active = 0;
     while (chain != NULL) {
       csound->dag_num_active++;
@@ -198,77 +354,20 @@ void dag_build(CSOUND *csound, INSDS *chain)
     if (csound->dag_num_active>csound->dag_task_max_size) {
       //printf("**************need to extend task vector\n");
       csound->dag_task_max_size = csound->dag_num_active+INIT_SIZE;
-      recreate_dag(csound);
+      if (csound->dag_task_status != NULL) recreate_dag(csound);
     }
     if (csound->dag_task_status == NULL)
       create_dag(csound); /* Should move elsewhere */
-    else {
-      memset((void*)csound->dag_task_watch, '\0',
-             sizeof(watchList*)*csound->dag_task_max_size);
-      for (i=0; i<csound->dag_task_max_size; i++) {
-        if (csound->dag_task_dep[i]) {
-          csound->dag_task_dep[i]= NULL;
-        }
-        csound->dag_wlmm[i].id = INVALID;
-      }
-    }
-    task_map = csound->dag_task_map;
-    for (i=0; i<csound->dag_num_active; i++) {
-      csound->dag_task_status[i].s = AVAILABLE;
-      csound->dag_wlmm[i].id=i;
-    }
     csound->dag_changed = 0;
     if (UNLIKELY(csound->oparms->odebug))
       printf("dag_num_active = %d\n", csound->dag_num_active);
-    i = 0; chain = save;
-    while (chain != NULL) {     /* for each instance check against later */
-      int j = i+1;              /* count of instance */
-      if (UNLIKELY(csound->oparms->odebug))
-        printf("\nWho depends on %d (instr %d)?\n", i, chain->insno);
-      INSDS *next = chain->nxtact;
-      INSTR_SEMANTICS *current_instr = dag_get_info(csound, chain->insno);
-      //csp_set_print(csound, current_instr->read);
-      //csp_set_print(csound, current_instr->write);
-      while (next) {
-        INSTR_SEMANTICS *later_instr = dag_get_info(csound, next->insno);
-        int cnt = 0;
-        if (UNLIKELY(csound->oparms->odebug)) printf("%d ", j);
-        //csp_set_print(csound, later_instr->read);
-        //csp_set_print(csound, later_instr->write);
-        //csp_set_print(csound, later_instr->read_write);
-        if (dag_intersect(csound, current_instr->write,
-                          later_instr->read, cnt++)       ||
-            dag_intersect(csound, current_instr->read_write,
-                          later_instr->read, cnt++)       ||
-            dag_intersect(csound, current_instr->read,
-                          later_instr->write, cnt++)      ||
-            dag_intersect(csound, current_instr->write,
-                          later_instr->write, cnt++)      ||
-            dag_intersect(csound, current_instr->read_write,
-                          later_instr->write, cnt++)      ||
-            dag_intersect(csound, current_instr->read,
-                          later_instr->read_write, cnt++) ||
-            dag_intersect(csound, current_instr->write,
-                          later_instr->read_write, cnt++)) {
-          char *tt = csound->dag_task_dep[j];
-          if (tt==NULL) {
-            /* get dep vector if missing and set watch first time */
-            tt = csound->dag_task_dep[j] =
-              (char*)csound->Calloc(csound, sizeof(char)*(j+1));
-            csound->dag_task_status[j].s = WAITING;
-            csound->dag_wlmm[j].next = csound->dag_task_watch[i];
-            csound->dag_wlmm[j].id = j;
-            csound->dag_task_watch[i] = &(csound->dag_wlmm[j]);
-            //printf("set watch %d to %d\n", j, i);
-          }
-          tt[i] = 1;
-          //printf("-yes ");
-        }
-        j++; next = next->nxtact;
-      }
-      task_map[i] = chain;
-      i++; chain = chain->nxtact;
+    dag_group(csound, save);
+    if (csound->oparms->parScheduler == PAR_SCHED_STEAL) {
+      ws_build(csound);
+      ws_reinit(csound);
+      return;
     }
+    dag_reinit(csound);
     if (UNLIKELY(csound->oparms->odebug)) dag_print_state(csound);
 }
 
@@ -279,25 +378,27 @@ void dag_reinit(CSOUND *csound)
     volatile stateWithPadding *task_status = csound->dag_task_status;
     watchList * volatile *task_watch = csound->dag_task_watch;
     watchList *wlmm = csound->dag_wlmm;
+    taskID *first_dep = csound->dag_topo->first_dep;
     if (UNLIKELY(csound->oparms->odebug))
       printf("DAG REINIT************************\n");
+    if (csound->dag_ws != NULL) {
+      ws_reinit(csound);
+      return;
+    }
     for (i=csound->dag_num_active; i<max; i++)
       task_status[i].s = DONE;
-    task_status[0].s = AVAILABLE;
-    task_watch[0] = NULL;
-    for (i=1; i<csound->dag_num_active; i++) {
-      int j;
+    for (i=0; i<csound->dag_num_active; i++) {
       task_status[i].s = AVAILABLE;
       task_watch[i] = NULL;
-      if (csound->dag_task_dep[i]==NULL) continue;
-      for (j=0; j<i; j++)
-        if (csound->dag_task_dep[i][j]) {
-          task_status[i].s = WAITING;
-          wlmm[i].id = i;
-          wlmm[i].next = task_watch[j];
-          task_watch[j] = &wlmm[i];
-          break;
-        }
+    }
+    /* each waiting task starts by watching its earliest prerequisite */
+    for (i=1; i<csound->dag_num_active; i++) {
+      int j = first_dep[i];
+      if (j == INVALID) continue;
+      task_status[i].s = WAITING;
+      wlmm[i].id = i;
+      wlmm[i].next = task_watch[j];
+      task_watch[j] = &wlmm[i];
     }
     //dag_print_state(csound);
 }
@@ -333,6 +434,9 @@ taskID dag_get_task(CSOUND *csound, int index, int numThreads, taskID next_task)
     volatile stateWithPadding *task_status = csound->dag_task_status;
     enum state current_task_status;
 
+    if (csound->dag_ws != NULL)   /* never returns WAIT; parks instead */
+      return ws_get_task(csound, index, next_task);
+
     if (next_task != INVALID) {
       // Have forwarded one task from the previous one
       // assert(ATOMIC_READ(task_status[next_task].s) == WAITING);
@@ -406,7 +510,7 @@ inline static int moveWatch(CSOUND *csound, watchList * volatile *w,
     return 1;
 }
 
-taskID dag_end_task(CSOUND *csound, taskID i)
+taskID dag_end_task(CSOUND *csound, int index, taskID i)
 {
     watchList *to_notify, *next;
     int canQueue;
@@ -415,6 +519,8 @@ taskID dag_end_task(CSOUND *csound, taskID i)
     enum state current_task_status;
     int wait_on_current_tasks;
     taskID next_task = INVALID;
+    if (csound->dag_ws != NULL)
+      return ws_end_task(csound, index, i);
     ATOMIC_WRITE(csound->dag_task_status[i].s, DONE); /* as DONE is zero */
     // A write barrier /might/ be useful here to avoid the case
     // of the list being DoNotRead but the status being something
@@ -436,7 +542,7 @@ taskID dag_end_task(CSOUND *csound, taskID i)
       wait_on_current_tasks = 0;
 
       for (k=0; k<j; k++) {     /* seek next watch */
-        if (csound->dag_task_dep[j][k]==0) continue;
+        if (!dag_depends(csound, j, k)) continue;
         current_task_status = ATOMIC_READ(csound->dag_task_status[k].s);
         //printf("investigating task %d (%d)\n", k, current_task_status);
 
@@ -466,7 +572,7 @@ taskID dag_end_task(CSOUND *csound, taskID i)
       // Try the same thing again but this time waiting on active or available task
       if (wait_on_current_tasks == 1) {
         for (k=0; k<j; k++) {     /* seek next watch */
-          if (csound->dag_task_dep[j][k]==0) continue;
+          if (!dag_depends(csound, j, k)) continue;
           current_task_status = ATOMIC_READ(csound->dag_task_status[k].s);
           //printf("investigating task %d (%d)\n", k, current_task_status);
 
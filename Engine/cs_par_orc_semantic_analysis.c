@@ -240,7 +240,7 @@ void csp_orc_sa_global_read_add_list(CSOUND *csound, struct set_t *set)
 
 void csp_orc_sa_interlocksf(CSOUND *csound, int code)
 {
-    if (code&0xfff8) {
+    if (code&0xfff8&~PU) {
       /* zak etc */
       struct set_t *rr = NULL;
       struct set_t *ww = NULL;
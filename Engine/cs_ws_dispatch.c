@@ -0,0 +1,315 @@
+/*
+    cs_ws_dispatch.c:
+
+    Copyright (C) 2018 The Csound Developers
+
+    This file is part of Csound.
+
+    The Csound Library is free software; you can redistribute it
+    and/or modify it under the terms of the GNU Lesser General Public
+    License as published by the Free Software Foundation; either
+    version 2.1 of the License, or (at your option) any later version.
+
+    Csound is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public
+    License along with Csound; if not, write to the Free Software
+    Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA
+    02110-1301 USA
+
+
+** Work-stealing alternative to the watch-list dispatcher in cs_new_dispatch.c
+**
+** dag_build() splits the active chain into groups (runs of one instrument)
+** and works out which groups must be ordered.  Each group has a gate
+** counting the instances of earlier conflicting groups still to finish;
+** when it opens, all instances of the group become ready, or only the first
+** if the instrument conflicts with itself, in which case each instance
+** releases the next one.  Finishing a task therefore costs one decrement per
+** conflicting later group, not a scan over other tasks.
+**
+** Each performance thread owns a deque of ready tasks: the owner pushes and
+** pops at the bottom, idle threads steal from the top (Chase-Lev).  A
+** finished task keeps the first task it releases to run next, pushing the
+** rest on its own deque.  Threads that find no work park on a condition
+** variable instead of spinning, and are woken when work is pushed or when
+** the last task of the cycle is done.
+**
+** Every task is pushed exactly once per k-cycle, so a deque sized to the
+** task count never wraps and top/bottom are simply reset each cycle.
+*/
+
+#include "csoundCore.h"
+#include "cs_par_base.h"
+
+#define INVALID (-1)
+
+/* number of failed steal rounds before a thread parks */
+#define WS_SPIN_ROUNDS (32)
+
+/* decrement returning the new value on every platform */
+static inline int ws_decr(volatile int *p)
+{
+#if defined(MSVC)
+    return (int) InterlockedDecrement((volatile long *) p);
+#elif defined(HAVE_ATOMIC_BUILTIN)
+    return __atomic_sub_fetch(p, 1, __ATOMIC_SEQ_CST);
+#else
+    return --(*p);
+#endif
+}
+
+typedef struct {
+  volatile long top;          /* thieves take from here */
+  uint8_t pad1[CONCURRENTPADDING - sizeof(long)];
+  volatile long bottom;       /* owner pushes/pops here */
+  uint8_t pad2[CONCURRENTPADDING - sizeof(long)];
+  taskID  *tasks;
+} ws_deque;
+
+struct dag_ws_t {
+  int           nthreads;
+  int           size;         /* tasks allocated for */
+  int           gsize;        /* groups allocated for */
+  int           nedges;       /* successor edges allocated for */
+  ws_deque      *deques;
+  int           *npred;       /* tasks in earlier conflicting groups */
+  volatile int  *gate;        /* of those, still to finish this cycle */
+  int           *succ_start;  /* CSR lists of later conflicting groups */
+  int           *succ;
+  volatile int  remaining;    /* tasks of this cycle not yet finished */
+  uint8_t       pad1[CONCURRENTPADDING - sizeof(int)];
+  volatile int  queued;       /* tasks sitting in the deques */
+  uint8_t       pad2[CONCURRENTPADDING - sizeof(int)];
+  volatile int  sleepers;     /* threads parked on cond */
+  void          *mutex;
+  void          *cond;
+};
+
+static int ws_destroy(CSOUND *csound, void *userData)
+{
+    struct dag_ws_t *ws = (struct dag_ws_t *) userData;
+    if (ws->mutex != NULL) csoundDestroyMutex(ws->mutex);
+    if (ws->cond != NULL) free(ws->cond);
+    csound->dag_ws = NULL;      /* memory itself goes with memRESET */
+    return 0;
+}
+
+static struct dag_ws_t *ws_create(CSOUND *csound)
+{
+    struct dag_ws_t *ws = csound->Calloc(csound, sizeof(struct dag_ws_t));
+    int i;
+    ws->nthreads = csound->oparms->numThreads;
+    ws->deques = csound->Calloc(csound, sizeof(ws_deque)*ws->nthreads);
+    for (i=0; i<ws->nthreads; i++) ws->deques[i].tasks = NULL;
+    ws->mutex = csoundCreateMutex(0);
+    ws->cond = csoundCreateCondVar();
+    if (UNLIKELY(ws->mutex == NULL || ws->cond == NULL))
+      csound->Die(csound, Str("Failed to allocate work-stealing scheduler"));
+    csound->RegisterResetCallback(csound, (void*) ws, ws_destroy);
+    return ws;
+}
+
+static void ws_resize(CSOUND *csound, struct dag_ws_t *ws, int size)
+{
+    int i;
+    ws->size = size;
+    for (i=0; i<ws->nthreads; i++)
+      ws->deques[i].tasks =
+        csound->ReAlloc(csound, ws->deques[i].tasks, sizeof(taskID)*size);
+}
+
+static void ws_resize_groups(CSOUND *csound, struct dag_ws_t *ws, int size)
+{
+    ws->gsize = size;
+    ws->npred = csound->ReAlloc(csound, ws->npred, sizeof(int)*size);
+    ws->gate = csound->ReAlloc(csound, (int*) ws->gate, sizeof(int)*size);
+    ws->succ_start = csound->ReAlloc(csound, ws->succ_start,
+                                     sizeof(int)*(size+1));
+}
+
+/* Gate sizes and successor lists from the group matrix; O(groups^2) */
+void ws_build(CSOUND *csound)
+{
+    struct dag_ws_t *ws = csound->dag_ws;
+    dagTopology *topo = csound->dag_topo;
+    int m = topo->num_groups;
+    int g, h, edges = 0;
+
+    if (ws == NULL) ws = csound->dag_ws = ws_create(csound);
+    if (csound->dag_num_active > ws->size)
+      ws_resize(csound, ws, csound->dag_task_max_size);
+    if (m > ws->gsize) ws_resize_groups(csound, ws, topo->max_groups);
+
+    ws->succ_start[0] = 0;
+    for (h=0; h<m; h++) {
+      ws->npred[h] = 0;
+      for (g=0; g<h; g++)
+        if (topo->group_dep[g*m+h]) {
+          ws->npred[h] += topo->group_start[g+1] - topo->group_start[g];
+          edges++;
+        }
+    }
+    if (edges > ws->nedges) {
+      ws->nedges = edges + edges/2;
+      ws->succ = csound->ReAlloc(csound, ws->succ, sizeof(int)*ws->nedges);
+    }
+    for (g=0, edges=0; g<m; g++) {
+      for (h=g+1; h<m; h++)
+        if (topo->group_dep[g*m+h]) ws->succ[edges++] = h;
+      ws->succ_start[g+1] = edges;
+    }
+}
+
+/* Reset per-cycle state and deal the ready tasks round the threads */
+void ws_reinit(CSOUND *csound)
+{
+    struct dag_ws_t *ws = csound->dag_ws;
+    dagTopology *topo = csound->dag_topo;
+    int m = topo->num_groups;
+    int g, i, t = 0, ready = 0;
+
+    for (i=0; i<ws->nthreads; i++)
+      ws->deques[i].top = ws->deques[i].bottom = 0;
+    for (g=0; g<m; g++) {
+      int end;
+      ws->gate[g] = ws->npred[g];
+      if (ws->npred[g] != 0) continue;
+      i = topo->group_start[g];
+      end = topo->group_dep[g*m+g] ? i+1 : topo->group_start[g+1];
+      for ( ; i<end; i++) {
+        ws_deque *d = &ws->deques[t];
+        d->tasks[d->bottom++] = i;
+        if (++t == ws->nthreads) t = 0;
+        ready++;
+      }
+    }
+    ws->queued = ready;
+    ws->remaining = csound->dag_num_active;
+    ws->sleepers = 0;
+    /* the barrier that follows publishes all of the above */
+}
+
+static inline void ws_push(ws_deque *d, taskID task)
+{
+    long b = d->bottom;
+    d->tasks[b] = task;
+    ATOMIC_SET(d->bottom, b+1);
+}
+
+static inline taskID ws_pop(ws_deque *d)
+{
+    long b = d->bottom - 1, t;
+    taskID task;
+    ATOMIC_SET(d->bottom, b);
+    t = ATOMIC_GET(d->top);
+    if (t > b) {                /* empty */
+      ATOMIC_SET(d->bottom, b+1);
+      return INVALID;
+    }
+    task = d->tasks[b];
+    if (t == b) {               /* last one: race the thieves for it */
+      long nt = t+1;
+      if (ATOMIC_CMP_XCH(&d->top, nt, t)) task = INVALID;
+      ATOMIC_SET(d->bottom, b+1);
+    }
+    return task;
+}
+
+static inline taskID ws_steal(ws_deque *d)
+{
+    long t = ATOMIC_GET(d->top);
+    long b = ATOMIC_GET(d->bottom);
+    if (t < b) {
+      taskID task = d->tasks[t];
+      long nt = t+1;
+      if (!ATOMIC_CMP_XCH(&d->top, nt, t)) return task;
+    }
+    return INVALID;
+}
+
+static inline void ws_wake(struct dag_ws_t *ws, int all)
+{
+    if (ATOMIC_GET(ws->sleepers) > 0) {
+      csoundLockMutex(ws->mutex);
+      if (all) {
+        int i, n = ws->sleepers;
+        for (i=0; i<n; i++) csoundCondSignal(ws->cond);
+      }
+      else csoundCondSignal(ws->cond);
+      csoundUnlockMutex(ws->mutex);
+    }
+}
+
+taskID ws_get_task(CSOUND *csound, int index, taskID next_task)
+{
+    struct dag_ws_t *ws = csound->dag_ws;
+    int nthreads = ws->nthreads;
+    int spins = 0;
+    taskID task;
+
+    if (next_task != INVALID) return next_task;
+    while (1) {
+      int i, victim;
+      if ((task = ws_pop(&ws->deques[index])) != INVALID) {
+        ATOMIC_DECR(ws->queued);
+        return task;
+      }
+      for (i=1, victim=index+1; i<nthreads; i++, victim++) {
+        if (victim == nthreads) victim = 0;
+        if ((task = ws_steal(&ws->deques[victim])) != INVALID) {
+          ATOMIC_DECR(ws->queued);
+          return task;
+        }
+      }
+      if (ATOMIC_GET(ws->remaining) == 0) return INVALID;
+      if (ATOMIC_GET(ws->queued) > 0 || ++spins < WS_SPIN_ROUNDS) continue;
+      /* nothing to take: park until something is pushed or all is done */
+      csoundLockMutex(ws->mutex);
+      ATOMIC_INCR(ws->sleepers);
+      while (ATOMIC_GET(ws->queued) == 0 && ATOMIC_GET(ws->remaining) > 0)
+        csoundCondWait(ws->cond, ws->mutex);
+      ATOMIC_DECR(ws->sleepers);
+      csoundUnlockMutex(ws->mutex);
+      spins = 0;
+    }
+}
+
+/* Hand a newly ready task to this thread, or queue it for others */
+static inline void ws_ready(struct dag_ws_t *ws, int index,
+                            taskID *next_task, taskID task)
+{
+    if (*next_task == INVALID) *next_task = task;   /* run it ourselves */
+    else {
+      ws_push(&ws->deques[index], task);
+      ATOMIC_INCR(ws->queued);
+      ws_wake(ws, 0);
+    }
+}
+
+taskID ws_end_task(CSOUND *csound, int index, taskID task)
+{
+    struct dag_ws_t *ws = csound->dag_ws;
+    dagTopology *topo = csound->dag_topo;
+    int m = topo->num_groups;
+    int g = topo->task_group[task];
+    taskID next_task = INVALID;
+    int k, end = ws->succ_start[g+1];
+
+    /* self-conflicting instrument: instances run in chain order */
+    if (topo->group_dep[g*m+g] && task+1 < topo->group_start[g+1])
+      ws_ready(ws, index, &next_task, task+1);
+    for (k=ws->succ_start[g]; k<end; k++) {
+      int h = ws->succ[k];
+      if (ws_decr(&ws->gate[h]) == 0) {
+        int i = topo->group_start[h];
+        int last = topo->group_dep[h*m+h] ? i+1 : topo->group_start[h+1];
+        for ( ; i<last; i++) ws_ready(ws, index, &next_task, i);
+      }
+    }
+    if (ws_decr(&ws->remaining) == 0) ws_wake(ws, 1);
+    return next_task;
+}
@@ -94,44 +94,104 @@ PUBLIC void cs_cons_free_complete(CSOUND* csound, CONS_CELL* head) {
 /* FUNCTION FOR HASH SET */
 
 PUBLIC CS_HASH_TABLE* cs_hash_table_create(CSOUND* csound) {
-    return (CS_HASH_TABLE*) csound->Calloc(csound, sizeof(CS_HASH_TABLE));
+    CS_HASH_TABLE* hashTable =
+      (CS_HASH_TABLE*) csound->Calloc(csound, sizeof(CS_HASH_TABLE));
+    hashTable->table_size = CS_HASH_INIT_SIZE;
+    hashTable->buckets = (CS_HASH_TABLE_ITEM**)
+      csound->Calloc(csound, sizeof(CS_HASH_TABLE_ITEM*) * CS_HASH_INIT_SIZE);
+    return hashTable;
 }
 
-static unsigned int cs_name_hash(char *s)
+/* 64x64->128 bit multiply, folded to 64 bits */
+static inline uint64_t cs_hash_mix(uint64_t a, uint64_t b)
 {
-    unsigned int h = 0;
-    while (*s != '\0') {
-      h = (h<<4) ^ *s++;
+#if defined(__SIZEOF_INT128__)
+    __uint128_t r = (__uint128_t) a * b;
+    return (uint64_t) r ^ (uint64_t) (r >> 64);
+#else
+    uint64_t ha = a >> 32, la = (uint32_t) a, hb = b >> 32, lb = (uint32_t) b;
+    uint64_t rh = ha * hb, rm0 = ha * lb, rm1 = hb * la, rl = la * lb;
+    uint64_t t = rl + (rm0 << 32), lo, c = t < rl;
+    lo = t + (rm1 << 32);
+    c += lo < t;
+    return lo ^ (rh + (rm0 >> 32) + (rm1 >> 32) + c);
+#endif
+}
+
+/* String hash in the style of wyhash: eight bytes at a time, each
+   word multiplied into the state, so that names differing only in
+   their last characters (gkchan001, gkchan002...) spread over all
+   the buckets.  Only the low bits are used to index the table. */
+static uint32_t cs_name_hash(const char *s)
+{
+    const uint64_t p0 = 0xa0761d6478bd642fULL, p1 = 0xe7037ed1a0b428dbULL,
+                   p2 = 0x8ebc6af09c88c6e3ULL;
+    size_t len = strlen(s), n = len;
+    uint64_t h = p0, w;
+
+    for ( ; n >= 8; n -= 8, s += 8) {
+      memcpy(&w, s, 8);
+      h = cs_hash_mix(w ^ p1, h ^ p2);
     }
-    return (h%HASH_SIZE);
+    for (w = 0; n > 0; n--)
+      w = (w << 8) | (unsigned char) s[n-1];
+    h = cs_hash_mix(w ^ p1, h ^ p2);
+    h = cs_hash_mix(h ^ (uint64_t) len, p0);
+    return (uint32_t) (h ^ (h >> 32));
+}
+
+static CS_HASH_TABLE_ITEM* cs_hash_table_find(CS_HASH_TABLE* hashTable,
+                                              char* key) {
+    uint32_t hash = cs_name_hash(key);
+    CS_HASH_TABLE_ITEM* item =
+      hashTable->buckets[hash & (hashTable->table_size - 1)];
+
+    while (item != NULL) {
+      if (item->hash == hash && strcmp(key, item->key) == 0) {
+        return item;
+      }
+      item = item->next;
+    }
+    return NULL;
+}
+
+/* double the bucket array, relinking items by their cached hashes */
+static void cs_hash_table_grow(CSOUND* csound, CS_HASH_TABLE* hashTable) {
+    uint32_t i, size = hashTable->table_size, newSize = size * 2;
+    CS_HASH_TABLE_ITEM** buckets = (CS_HASH_TABLE_ITEM**)
+      csound->Calloc(csound, sizeof(CS_HASH_TABLE_ITEM*) * newSize);
+
+    for (i = 0; i < size; i++) {
+      CS_HASH_TABLE_ITEM* item = hashTable->buckets[i];
+
+      while (item != NULL) {
+        CS_HASH_TABLE_ITEM* next = item->next;
+        uint32_t index = item->hash & (newSize - 1);
+        item->next = buckets[index];
+        buckets[index] = item;
+        item = next;
+      }
+    }
+    csound->Free(csound, hashTable->buckets);
+    hashTable->buckets = buckets;
+    hashTable->table_size = newSize;
 }
 
 PUBLIC void* cs_hash_table_get(CSOUND* csound,
                                CS_HASH_TABLE* hashTable, char* key) {
     IGN(csound);
-    unsigned int index;
     CS_HASH_TABLE_ITEM* item;
 
     if (key == NULL) {
       return NULL;
     }
 
-    index = cs_name_hash(key);
-    item = hashTable->buckets[index];
-
-    while (item != NULL) {
-      if (strcmp(key, item->key) == 0) {
-        return item->value;
-      }
-      item = item->next;
-    }
-
-    return NULL;
+    item = cs_hash_table_find(hashTable, key);
+    return (item != NULL) ? item->value : NULL;
 }
 
 PUBLIC char* cs_hash_table_get_key(CSOUND* csound,
                                    CS_HASH_TABLE* hashTable, char* key) {
-    unsigned int index;
     CS_HASH_TABLE_ITEM* item;
     IGN(csound);
 
@@ -139,17 +199,8 @@ PUBLIC char* cs_hash_table_get_key(CSOUND* csound,
       return NULL;
     }
 
-    index = cs_name_hash(key);
-    item = hashTable->buckets[index];
-
-    while (item != NULL) {
-      if (strcmp(key, item->key) == 0) {
-        return item->key;
-      }
-      item = item->next;
-    }
-
-    return NULL;
+    item = cs_hash_table_find(hashTable, key);
+    return (item != NULL) ? item->key : NULL;
 }
 
 char* cs_hash_table_put_no_key_copy(CSOUND* csound,
@@ -159,36 +210,30 @@ char* cs_hash_table_put_no_key_copy(CSOUND* csound,
       return NULL;
     }
 
-    unsigned int index = cs_name_hash(key);
-
-    CS_HASH_TABLE_ITEM* item = hashTable->buckets[index];
+    uint32_t hash = cs_name_hash(key);
+    CS_HASH_TABLE_ITEM** link =
+      &hashTable->buckets[hash & (hashTable->table_size - 1)];
+    CS_HASH_TABLE_ITEM* item;
 
-    if (item == NULL) {
-      CS_HASH_TABLE_ITEM* newItem = csound->Malloc(csound,
-                                                   sizeof(CS_HASH_TABLE_ITEM));
-      newItem->key = key;
-      newItem->value = value;
-      newItem->next = NULL;
-      hashTable->buckets[index] = newItem;
-      return newItem->key;
-    } else {
-      while (item != NULL) {
-        if (strcmp(key, item->key) == 0) {
-          item->value = value;
-          return item->key;
-        } else if (item->next == NULL) {
-          CS_HASH_TABLE_ITEM* newItem = csound->Malloc(csound,
-                                                       sizeof(CS_HASH_TABLE_ITEM));
-          newItem->key = key;
-          newItem->value = value;
-          newItem->next = NULL;
-          item->next = newItem;
-          return newItem->key;
-        }
-        item = item->next;
+    /* new items go at the end of the chain, as before */
+    for (item = *link; item != NULL; item = *link) {
+      if (item->hash == hash && strcmp(key, item->key) == 0) {
+        item->value = value;
+        return item->key;
       }
+      link = &item->next;
     }
-    return NULL;
+
+    item = csound->Malloc(csound, sizeof(CS_HASH_TABLE_ITEM));
+    item->key = key;
+    item->value = value;
+    item->next = NULL;
+    item->hash = hash;
+    *link = item;
+    if (++hashTable->count > hashTable->table_size) {
+      cs_hash_table_grow(csound, hashTable);
+    }
+    return key;
 }
 
 PUBLIC void cs_hash_table_put(CSOUND* csound,
@@ -206,25 +251,27 @@ PUBLIC char* cs_hash_table_put_key(CSOUND* csound,
 PUBLIC void cs_hash_table_remove(CSOUND* csound,
                                  CS_HASH_TABLE* hashTable, char* key) {
     CS_HASH_TABLE_ITEM *previous, *item;
-    unsigned int index;
+    uint32_t hash, index;
 
     if (key == NULL) {
       return;
     }
 
-    index = cs_name_hash(key);
+    hash = cs_name_hash(key);
+    index = hash & (hashTable->table_size - 1);
 
     previous = NULL;
     item = hashTable->buckets[index];
 
     while (item != NULL) {
-      if (strcmp(key, item->key) == 0) {
+      if (item->hash == hash && strcmp(key, item->key) == 0) {
         if (previous == NULL) {
           hashTable->buckets[index] = item->next;
         } else {
           previous->next = item->next;
         }
         csound->Free(csound, item);
+        hashTable->count--;
         return;
       }
       previous = item;
@@ -235,9 +282,9 @@ PUBLIC void cs_hash_table_remove(CSOUND* csound,
 PUBLIC CONS_CELL* cs_hash_table_keys(CSOUND* csound, CS_HASH_TABLE* hashTable) {
     CONS_CELL* head = NULL;
 
-    int i = 0;
+    uint32_t i = 0;
 
-    for (i = 0; i < HASH_SIZE; i++) {
+    for (i = 0; i < hashTable->table_size; i++) {
       CS_HASH_TABLE_ITEM* item = hashTable->buckets[i];
 
       while (item != NULL) {
@@ -251,9 +298,9 @@ PUBLIC CONS_CELL* cs_hash_table_keys(CSOUND* csound, CS_HASH_TABLE* hashTable) {
 PUBLIC CONS_CELL* cs_hash_table_values(CSOUND* csound, CS_HASH_TABLE* hashTable) {
     CONS_CELL* head = NULL;
 
-    int i = 0;
+    uint32_t i = 0;
 
-    for (i = 0; i < HASH_SIZE; i++) {
+    for (i = 0; i < hashTable->table_size; i++) {
       CS_HASH_TABLE_ITEM* item = hashTable->buckets[i];
 
       while (item != NULL) {
@@ -267,9 +314,9 @@ PUBLIC CONS_CELL* cs_hash_table_values(CSOUND* csound, CS_HASH_TABLE* hashTable)
 PUBLIC void cs_hash_table_merge(CSOUND* csound,
                                 CS_HASH_TABLE* target, CS_HASH_TABLE* source) {
     // TODO - check if this is the best strategy for merging
-    int i = 0;
+    uint32_t i = 0;
 
-    for (i = 0; i < HASH_SIZE; i++) {
+    for (i = 0; i < source->table_size; i++) {
       CS_HASH_TABLE_ITEM* item = source->buckets[i];
 
       while (item != NULL) {
@@ -286,13 +333,14 @@ PUBLIC void cs_hash_table_merge(CSOUND* csound,
       }
       source->buckets[i] = NULL;
     }
+    source->count = 0;
 
 }
 
 PUBLIC void cs_hash_table_free(CSOUND* csound, CS_HASH_TABLE* hashTable) {
-    int i;
+    uint32_t i;
 
-    for (i = 0; i < HASH_SIZE; i++) {
+    for (i = 0; i < hashTable->table_size; i++) {
       CS_HASH_TABLE_ITEM* item = hashTable->buckets[i];
 
       while(item != NULL) {
@@ -302,14 +350,15 @@ PUBLIC void cs_hash_table_free(CSOUND* csound, CS_HASH_TABLE* hashTable) {
         item = next;
       }
     }
+    csound->Free(csound, hashTable->buckets);
     csound->Free(csound, hashTable);
 }
 
 PUBLIC void cs_hash_table_mfree_complete(CSOUND* csound, CS_HASH_TABLE* hashTable) {
 
-    int i;
+    uint32_t i;
 
-    for (i = 0; i < HASH_SIZE; i++) {
+    for (i = 0; i < hashTable->table_size; i++) {
       CS_HASH_TABLE_ITEM* item = hashTable->buckets[i];
 
       while(item != NULL) {
@@ -320,14 +369,15 @@ PUBLIC void cs_hash_table_mfree_complete(CSOUND* csound, CS_HASH_TABLE* hashTabl
         item = next;
       }
     }
+    csound->Free(csound, hashTable->buckets);
     csound->Free(csound, hashTable);
 }
 
 PUBLIC void cs_hash_table_free_complete(CSOUND* csound, CS_HASH_TABLE* hashTable) {
 
-    int i;
+    uint32_t i;
 
-    for (i = 0; i < HASH_SIZE; i++) {
+    for (i = 0; i < hashTable->table_size; i++) {
       CS_HASH_TABLE_ITEM* item = hashTable->buckets[i];
 
       while(item != NULL) {
@@ -342,11 +392,11 @@ PUBLIC void cs_hash_table_free_complete(CSOUND* csound, CS_HASH_TABLE* hashTable
         item = next;
       }
     }
+    csound->Free(csound, hashTable->buckets);
     csound->Free(csound, hashTable);
 }
 
 
-
 #ifdef __cplusplus
   extern "C" {
 #endif
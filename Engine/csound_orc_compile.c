@@ -945,6 +945,8 @@ void free_instrtxt(CSOUND *csound, INSTRTXT *instrtxt) {
     csound->Free(csound, active);
     active = nxt;
   }
+  if (ip->init_image != NULL) csound->Free(csound, ip->init_image);
+  if (ip->init_reloc != NULL) csound->Free(csound, ip->init_reloc);
   OPTXT *t = ip->nxtop;
   while (t) {
     OPTXT *s = t->nxtop;
@@ -1499,6 +1501,9 @@ int engineState_merge(CSOUND *csound, ENGINE_STATE *engineState) {
   (&(current_state->instxtanchor))->nxtinstxt = csound->instr0;
   /* now free old instr 0 */
   free_instrtxt(csound, old_instr0);
+  /* instruments may have been redefined: drop cached DAG dependencies */
+  csound->dag_orc_version++;
+  csound->dag_changed = 1;
   return 0;
 }
 
@@ -24,6 +24,10 @@
 
 #include "csoundCore.h"
 #include "csound_orc.h"
+#include "aops.h"
+#include "find_opcode.h"
+#include "interlocks.h"
+#include <ctype.h>
 extern void print_tree(CSOUND *csound, char*, TREE *l);
 extern void delete_tree(CSOUND *csound, TREE *l);
 
@@ -418,6 +422,567 @@ TREE* constant_fold(CSOUND *csound, TREE* root)
 }
 
 
+/* Expression fusion.  Once expressions have been expanded each operator
+   is its own opcode writing a synthetic #a variable that the next one
+   reads.  A run of such a-rate arithmetic and function opcodes, where
+   each #a is written and read exactly once, becomes one ##fuse opcode
+   holding the expression in postfix (see aops.h). */
+
+static const struct {
+    const char  *opname;
+    char        code;
+} fuse_ops[] = {
+    { "##add.aa", '+' }, { "##add.ak", '+' }, { "##add.ka", '+' },
+    { "##sub.aa", '-' }, { "##sub.ak", '-' }, { "##sub.ka", '-' },
+    { "##mul.aa", '*' }, { "##mul.ak", '*' }, { "##mul.ka", '*' },
+    { "##div.aa", '/' }, { "##div.ak", '/' }, { "##div.ka", '/' },
+    { "##mod.aa", '%' }, { "##mod.ak", '%' }, { "##mod.ka", '%' },
+    { "int.a", 'I' },    { "frac.a", 'F' },   { "abs.a", 'A' },
+    { "exp.a", 'E' },    { "log.a", 'L' },    { "sqrt.a", 'Q' },
+    { "sin.a", 'S' },    { "cos.a", 'C' },    { "tan.a", 'T' },
+    { "sininv.a", 'J' }, { "cosinv.a", 'K' }, { "taninv.a", 'M' },
+    { "sinh.a", 'H' },   { "cosh.a", 'O' },   { "tanh.a", 'N' },
+    { "log10.a", 'G' },  { "log2.a", 'B' },
+    { NULL, 0 }
+};
+
+typedef struct {
+    TREE    *t;
+    TREE    *arg[2];
+    char    code;
+    int     nin;
+    int     src[2];         /* node whose result is fused in, or -1 */
+    int     first, nops, nargs, depth;
+    int     root;           /* not fused into a later node */
+} FUSE_NODE;
+
+static inline int is_synth_asig(const char *s)
+{
+    return s[0] == '#' && s[1] == 'a';
+}
+
+static inline int is_plain_arg(TREE *t)
+{
+    return t != NULL && t->value != NULL && t->left == NULL &&
+           t->right == NULL;
+}
+
+static char fuse_code(TREE *t, TREE **arg, int *nin)
+{
+    OENTRY *ep = (OENTRY *) t->markup;
+    int i;
+    if (t->type != T_OPCODE || ep == NULL || !is_plain_arg(t->left) ||
+        t->left->next != NULL)
+      return 0;
+    for (i = 0; fuse_ops[i].opname != NULL; i++)
+      if (strcmp(ep->opname, fuse_ops[i].opname) == 0) break;
+    if (fuse_ops[i].opname == NULL) return 0;
+    *nin = (int) strlen(ep->intypes);
+    arg[0] = t->right;
+    arg[1] = arg[0] != NULL ? arg[0]->next : NULL;
+    if (!is_plain_arg(arg[0]) || (*nin == 2 && !is_plain_arg(arg[1])) ||
+        (*nin == 2 ? arg[1]->next : arg[0]->next) != NULL)
+      return 0;
+    return fuse_ops[i].code;
+}
+
+/* occurrences of each #aN anywhere in the statement list, by N */
+static void count_synth_asigs(int *uses, int size, TREE *t)
+{
+    for (; t != NULL; t = t->next) {
+      if (t->value != NULL && t->value->lexeme != NULL &&
+          is_synth_asig(t->value->lexeme)) {
+        int n = atoi(t->value->lexeme + 2);
+        if (n >= 0 && n < size) uses[n]++;
+      }
+      count_synth_asigs(uses, size, t->left);
+      count_synth_asigs(uses, size, t->right);
+    }
+}
+
+static void remove_local_var(CSOUND *csound, CS_VAR_POOL *pool, char *name)
+{
+    CS_VARIABLE *var = cs_hash_table_get(csound, pool->table, name), **pp;
+    if (var == NULL) return;
+    for (pp = &pool->head; *pp != NULL; pp = &(*pp)->next)
+      if (*pp == var) {
+        *pp = var->next;
+        if (pool->tail == var) {        /* find the new tail */
+          CS_VARIABLE *v = pool->head;
+          while (v != NULL && v->next != NULL) v = v->next;
+          pool->tail = v;
+        }
+        cs_hash_table_remove(csound, pool->table, name);
+        pool->varCount--;
+        pool->poolSize -= var->memBlockSize;
+        break;
+      }
+}
+
+static void fuse_emit(FUSE_NODE *nd, int i, char **prog, TREE **tail)
+{
+    int k;
+    for (k = 0; k < nd[i].nin; k++) {
+      if (nd[i].src[k] >= 0) {
+        fuse_emit(nd, nd[i].src[k], prog, tail);
+        continue;
+      }
+      *(*prog)++ = ((OENTRY *) nd[i].t->markup)->intypes[k] == 'a' ? 'a' : 'k';
+      (*tail)->next = nd[i].arg[k];
+      *tail = nd[i].arg[k];
+      (*tail)->next = NULL;
+    }
+    *(*prog)++ = nd[i].code;
+}
+
+static TREE *fuse_expressions(CSOUND *csound, TREE *body, CS_VAR_POOL *pool)
+{
+    FUSE_NODE *nd;
+    OENTRY    *fuse;
+    TREE      *t;
+    int       *uses, nuses = pool->synthArgCount;
+    int       i, j, k, n = 0;
+
+    for (t = body; t != NULL; t = t->next) n++;
+    if (n < 2 || (fuse = find_opcode(csound, "##fuse")) == NULL) return body;
+    nd = (FUSE_NODE *) csound->Calloc(csound, n * sizeof(FUSE_NODE));
+    uses = (int *) csound->Calloc(csound, (nuses + 1) * sizeof(int));
+    count_synth_asigs(uses, nuses, body);
+
+    for (i = 0, t = body; t != NULL; i++, t = t->next) {
+      FUSE_NODE *p = &nd[i];
+      int src[2] = { -1, -1 };
+      p->t = t;
+      if ((p->code = fuse_code(t, p->arg, &p->nin)) == 0) continue;
+      p->src[0] = p->src[1] = -1;
+      p->first = i; p->nops = 1; p->nargs = p->nin; p->depth = p->nin;
+      p->root = 1;
+      /* the producer of a single-use #a is in the run of candidates
+         just before this node */
+      for (k = 0; k < p->nin; k++) {
+        char *name = p->arg[k]->value->lexeme;
+        if (!is_synth_asig(name) || atoi(name + 2) >= nuses ||
+            uses[atoi(name + 2)] != 2)
+          continue;
+        for (j = i - 1; j >= 0 && nd[j].code != 0; j--)
+          if (nd[j].root && strcmp(nd[j].t->left->value->lexeme, name) == 0) {
+            src[k] = j;
+            break;
+          }
+      }
+      if (src[0] < 0 && src[1] < 0) continue;
+      {
+        int first = i, nops = 1, nargs = 0, d[2] = { 1, 1 }, depth;
+        for (k = 0; k < p->nin; k++) {
+          if (src[k] < 0) { nargs++; continue; }
+          if (nd[src[k]].first < first) first = nd[src[k]].first;
+          nops += nd[src[k]].nops;
+          nargs += nd[src[k]].nargs;
+          d[k] = nd[src[k]].depth;
+        }
+        depth = p->nin == 2 ? (d[0] > d[1] + 1 ? d[0] : d[1] + 1) : d[0];
+        /* everything from first to i must belong to the expression */
+        if (nops != i - first + 1 || nargs > FUSE_MAXARGS ||
+            nops > FUSE_MAXOPS || depth > FUSE_DEPTH)
+          continue;
+        for (k = 0; k < p->nin; k++)
+          if ((p->src[k] = src[k]) >= 0) nd[src[k]].root = 0;
+        p->first = first; p->nops = nops; p->nargs = nargs;
+        p->depth = depth;
+      }
+    }
+
+    for (i = 0; i < n; i++) {
+      FUSE_NODE *p = &nd[i];
+      TREE      head, *tail = &head, *progArg;
+      char      *prog, *s;
+      if (p->code == 0 || !p->root || p->nops < 2) continue;
+      s = prog = (char *) csound->Malloc(csound, p->nargs + p->nops + 3);
+      *s++ = '"';
+      fuse_emit(nd, i, &s, &tail);
+      *s++ = '"';
+      *s = '\0';
+      progArg = make_leaf(csound, p->t->line, p->t->locn, STRING_TOKEN,
+                          make_token(csound, prog));
+      progArg->next = head.next;
+      csound->Free(csound, prog);
+      /* the #a arguments fused away are not in the new list */
+      for (j = p->first; j <= i; j++)
+        for (k = 0; k < nd[j].nin; k++)
+          if (nd[j].src[k] >= 0) {
+            nd[j].arg[k]->next = NULL;
+            delete_tree(csound, nd[j].arg[k]);
+          }
+      for (j = p->first; j < i; j++) {
+        remove_local_var(csound, pool, nd[j].t->left->value->lexeme);
+        nd[j].t->right = nd[j].t->next = NULL;
+        delete_tree(csound, nd[j].t);
+      }
+      if (p->first == 0) body = p->t;
+      else nd[p->first - 1].t->next = p->t;
+      csound->Free(csound, p->t->value->lexeme);
+      csound->Free(csound, p->t->value);
+      p->t->value = make_token(csound, "##fuse");
+      p->t->value->type = T_OPCODE;
+      p->t->markup = fuse;
+      p->t->right = progArg;
+    }
+    csound->Free(csound, uses);
+    csound->Free(csound, nd);
+    return body;
+}
+
+/* Common subexpressions, dead code and i-time hoisting.  These work on
+   the flat statement list of an instrument or UDO once expressions have
+   been expanded, and only move or remove opcodes flagged PU in their
+   OENTRY (interlocks.h): such an opcode writes nothing but its outputs,
+   and they depend on its inputs alone. */
+
+#define CSE_MAXARGS 4
+
+typedef struct {
+    int     defs, reads;        /* WI opcodes count as defining inputs */
+    int     initreads;          /* reads by opcodes with an init pass */
+    int     lastdef, firstread, lastread;
+    int     ver;                /* bumped at every definition */
+    int     hoisted;            /* only written at init time */
+} OPT_VAR;
+
+typedef struct {
+    int     stmt, block, epoch, global;
+    OPT_VAR *out, *arg[CSE_MAXARGS];
+    int     outver, ver[CSE_MAXARGS];
+} OPT_EXPR;
+
+static inline int is_var_name(const char *s)
+{
+    return s[0] != '"' && s[0] != '-' && s[0] != '.' && !isdigit(s[0]);
+}
+
+static inline int is_global_name(const char *s)
+{
+    return s[0] == 'g';
+}
+
+static inline int is_pfield_name(const char *s)
+{
+    return s[0] == 'p' && isdigit(s[1]);
+}
+
+static inline int is_irate_name(const char *s)
+{
+    if (s[0] == '#') s++;
+    return s[0] == 'i' || is_pfield_name(s);
+}
+
+static inline OENTRY *stmt_oentry(TREE *t)
+{
+    return (t->type == T_OPCODE || t->type == T_OPCODE0 || t->type == '=') ?
+      (OENTRY *) t->markup : NULL;
+}
+
+static OPT_VAR *opt_var(CSOUND *csound, CS_HASH_TABLE *vars, char *name)
+{
+    OPT_VAR *v = cs_hash_table_get(csound, vars, name);
+    if (v == NULL) {
+      v = (OPT_VAR *) csound->Calloc(csound, sizeof(OPT_VAR));
+      v->lastdef = v->firstread = v->lastread = -1;
+      cs_hash_table_put(csound, vars, name, v);
+    }
+    return v;
+}
+
+/* a PU opcode with one local output and plain arguments */
+static int is_pure_stmt(TREE *t)
+{
+    OENTRY *ep = stmt_oentry(t);
+    TREE   *a;
+    char   *out;
+    if (ep == NULL || !(ep->flags & PU) || !is_plain_arg(t->left) ||
+        t->left->next != NULL || t->right == NULL)
+      return 0;
+    out = t->left->value->lexeme;
+    if (!is_var_name(out) || is_global_name(out) || is_pfield_name(out))
+      return 0;
+    for (a = t->right; a != NULL; a = a->next)
+      if (!is_plain_arg(a)) return 0;
+    return 1;
+}
+
+static void count_reads(CSOUND *csound, CS_HASH_TABLE *vars, TREE *t,
+                        int i, OENTRY *ep)
+{
+    for (; t != NULL; t = t->next) {
+      if (t->value != NULL && t->value->lexeme != NULL &&
+          is_var_name(t->value->lexeme)) {
+        OPT_VAR *v = opt_var(csound, vars, t->value->lexeme);
+        v->reads++;
+        if (v->firstread < 0) v->firstread = i;
+        v->lastread = i;
+        if (ep == NULL || ep->thread != 2) v->initreads++;
+        if (ep != NULL && (ep->flags & WI)) {
+          v->defs++;
+          v->lastdef = i;
+        }
+      }
+      count_reads(csound, vars, t->left, i, ep);
+      count_reads(csound, vars, t->right, i, ep);
+    }
+}
+
+static void rename_reads(CSOUND *csound, TREE *t, char *from, char *to)
+{
+    for (; t != NULL; t = t->next) {
+      if (t->value != NULL && t->value->lexeme != NULL &&
+          strcmp(t->value->lexeme, from) == 0) {
+        csound->Free(csound, t->value->lexeme);
+        t->value->lexeme = cs_strdup(csound, to);
+      }
+      rename_reads(csound, t->left, from, to);
+      rename_reads(csound, t->right, from, to);
+    }
+}
+
+static void delete_stmt(CSOUND *csound, CS_HASH_TABLE *vars,
+                        CS_VAR_POOL *pool, TREE **st, int i)
+{
+    TREE    *a;
+    OPT_VAR *out = opt_var(csound, vars, st[i]->left->value->lexeme);
+    for (a = st[i]->right; a != NULL; a = a->next)
+      if (is_var_name(a->value->lexeme))
+        opt_var(csound, vars, a->value->lexeme)->reads--;
+    if (--out->defs == 0 && out->reads == 0 &&
+        st[i]->left->value->lexeme[0] == '#')
+      remove_local_var(csound, pool, st[i]->left->value->lexeme);
+    st[i]->next = NULL;
+    delete_tree(csound, st[i]);
+    st[i] = NULL;
+}
+
+/* The same PU opcode on the same arguments, with none of them written
+   in between, is replaced by the first result.  Only a compiler
+   temporary that is used within its own block can be dropped this way,
+   and the first result must be a variable that is never written again. */
+static int cse_body(CSOUND *csound, CS_HASH_TABLE *vars, CS_VAR_POOL *pool,
+                    TREE **st, int *blk, int n)
+{
+    CS_HASH_TABLE *avail = cs_hash_table_create(csound);
+    int     i, k, epoch = 0, cnt = 0;
+
+    for (i = 0; i < n; i++) {
+      TREE    *t = st[i], *a;
+      OENTRY  *ep = stmt_oentry(t);
+      int     pure = is_pure_stmt(t);
+      if (pure) {
+        OPT_VAR  *out = opt_var(csound, vars, t->left->value->lexeme);
+        OPT_EXPR *e;
+        size_t   len = strlen(ep->opname) + 1;
+        char     *key, *p;
+        for (a = t->right; a != NULL; a = a->next)
+          len += strlen(a->value->lexeme) + 1;
+        p = key = (char *) csound->Malloc(csound, len);
+        p += sprintf(p, "%s", ep->opname);
+        for (a = t->right; a != NULL; a = a->next)
+          p += sprintf(p, "\001%s", a->value->lexeme);
+        e = (OPT_EXPR *) cs_hash_table_get(csound, avail, key);
+        if (e != NULL && e->block == blk[i] && e->out->ver == e->outver &&
+            (!e->global || e->epoch == epoch)) {
+          for (k = 0; k < CSE_MAXARGS; k++)
+            if (e->arg[k] != NULL && e->arg[k]->ver != e->ver[k]) break;
+          if (k == CSE_MAXARGS && t->left->value->lexeme[0] == '#' &&
+              out->defs == 1 && (out->lastread < 0 ||
+                                 blk[out->lastread] == blk[i])) {
+            char *to = st[e->stmt]->left->value->lexeme;
+            int  j;
+            for (j = i + 1; j <= out->lastread; j++)
+              if (st[j] != NULL) {
+                rename_reads(csound, st[j]->left, t->left->value->lexeme, to);
+                rename_reads(csound, st[j]->right, t->left->value->lexeme, to);
+              }
+            e->out->reads += out->reads;
+            e->out->initreads += out->initreads;
+            if (e->out->firstread < 0) e->out->firstread = out->firstread;
+            if (out->lastread > e->out->lastread)
+              e->out->lastread = out->lastread;
+            out->reads = 0;
+            delete_stmt(csound, vars, pool, st, i);
+            csound->Free(csound, key);
+            cnt++;
+            continue;
+          }
+        }
+        if (out->defs == 1) {
+          int nargs = 0;
+          if (e == NULL) {
+            e = (OPT_EXPR *) csound->Malloc(csound, sizeof(OPT_EXPR));
+            cs_hash_table_put(csound, avail, key, e);
+          }
+          memset(e, 0, sizeof(OPT_EXPR));
+          e->stmt = i; e->block = blk[i]; e->epoch = epoch;
+          e->out = out;
+          e->outver = out->ver + 1;     /* as written by this opcode */
+          for (a = t->right; a != NULL; a = a->next) {
+            char *name = a->value->lexeme;
+            if (!is_var_name(name)) continue;
+            if (nargs == CSE_MAXARGS) {
+              e->block = -1;            /* never matches */
+              break;
+            }
+            e->arg[nargs] = opt_var(csound, vars, name);
+            e->ver[nargs] = e->arg[nargs]->ver;
+            e->global |= is_global_name(name);
+            nargs++;
+          }
+        }
+        csound->Free(csound, key);
+      }
+      /* what this statement writes */
+      for (a = t->left; a != NULL; a = a->next)
+        if (a->value != NULL && is_var_name(a->value->lexeme))
+          opt_var(csound, vars, a->value->lexeme)->ver++;
+      if (ep != NULL && (ep->flags & WI))
+        for (a = t->right; a != NULL; a = a->next)
+          if (a->value != NULL && is_var_name(a->value->lexeme))
+            opt_var(csound, vars, a->value->lexeme)->ver++;
+      if (!pure) epoch++;
+    }
+    cs_hash_table_mfree_complete(csound, avail);
+    return cnt;
+}
+
+/* PU opcodes whose result is never read */
+static int dce_body(CSOUND *csound, CS_HASH_TABLE *vars, CS_VAR_POOL *pool,
+                    TREE **st, int n)
+{
+    int i, cnt = 0, changed;
+    do {                        /* backwards, so chains go in one sweep */
+      changed = 0;
+      for (i = n - 1; i >= 0; i--)
+        if (st[i] != NULL && is_pure_stmt(st[i]) &&
+            opt_var(csound, vars, st[i]->left->value->lexeme)->reads == 0) {
+          delete_stmt(csound, vars, pool, st, i);
+          changed = 1;
+          cnt++;
+        }
+    } while (changed);
+    return cnt;
+}
+
+static OENTRY *init_variant(CSOUND *csound, OENTRY *ep)
+{
+    char      *name = get_opcode_short_name(csound, ep->opname);
+    CONS_CELL *c = cs_hash_table_get(csound, csound->opcodes, name);
+    OENTRY    *e = NULL;
+    for (; c != NULL; c = c->next) {
+      e = (OENTRY *) c->value;
+      if (e->thread == 1 && (e->flags & PU) &&
+          (e->outypes[0] == 'i' || e->outypes[0] == 'I') &&
+          (strlen(e->intypes) == strlen(ep->intypes) ||
+           strcmp(e->intypes, "m") == 0))
+        break;
+      e = NULL;
+    }
+    if (name != ep->opname) csound->Free(csound, name);
+    return e;
+}
+
+/* A k-rate PU opcode whose inputs are all fixed at init time computes
+   the same value on every k-cycle; its i-time variant does it once.
+   This is only done before the first label or jump, where every
+   statement runs exactly once per pass, and only for a k variable
+   that is set nowhere else and read afterwards by k-rate code alone. */
+static int hoist_body(CSOUND *csound, CS_HASH_TABLE *vars, TREE **st, int n)
+{
+    int i, cnt = 0;
+    for (i = 0; i < n; i++) {
+      TREE    *t = st[i], *a;
+      OENTRY  *ep, *iep;
+      OPT_VAR *out;
+      char    *name;
+      if (t == NULL) continue;
+      if ((ep = stmt_oentry(t)) == NULL || strchr(ep->intypes, 'l') != NULL)
+        break;
+      if (!is_pure_stmt(t) || ep->thread != 2) continue;
+      name = t->left->value->lexeme;
+      out = opt_var(csound, vars, name);
+      if (!(name[0] == 'k' || (name[0] == '#' && name[1] == 'k')) ||
+          out->defs != 1 || out->initreads != 0 ||
+          (out->firstread >= 0 && out->firstread <= i))
+        continue;
+      for (a = t->right; a != NULL; a = a->next) {
+        OPT_VAR *v;
+        if (!is_var_name(a->value->lexeme)) continue;
+        if (is_global_name(a->value->lexeme)) break;
+        v = opt_var(csound, vars, a->value->lexeme);
+        if (!v->hoisted && !(is_irate_name(a->value->lexeme) &&
+                             v->lastdef < i))
+          break;
+      }
+      if (a != NULL || (iep = init_variant(csound, ep)) == NULL) continue;
+      t->markup = iep;
+      out->hoisted = 1;
+      cnt++;
+    }
+    return cnt;
+}
+
+static TREE *optimize_body(CSOUND *csound, TREE *body, CS_VAR_POOL *pool)
+{
+    CS_HASH_TABLE *vars;
+    TREE    *t, **st, head, *tail;
+    int     *blk, i, n = 0, block = 0, ncse, ndead, nhoist;
+
+    for (t = body; t != NULL; t = t->next) {
+      /* anything still nested is left alone */
+      if (t->type != T_OPCODE && t->type != T_OPCODE0 && t->type != '=' &&
+          t->type != LABEL_TOKEN && t->type != GOTO_TOKEN &&
+          t->type != IGOTO_TOKEN && t->type != KGOTO_TOKEN)
+        return body;
+      n++;
+    }
+    if (n < 2) return body;
+    st = (TREE **) csound->Malloc(csound, n * sizeof(TREE *));
+    blk = (int *) csound->Malloc(csound, n * sizeof(int));
+    vars = cs_hash_table_create(csound);
+    for (i = 0, t = body; t != NULL; i++, t = t->next) {
+      OENTRY *ep = stmt_oentry(t);
+      TREE   *a;
+      st[i] = t;
+      if (t->type == LABEL_TOKEN) block++;
+      blk[i] = block;
+      for (a = t->left; a != NULL; a = a->next) {
+        if (a->value != NULL && is_var_name(a->value->lexeme)) {
+          OPT_VAR *v = opt_var(csound, vars, a->value->lexeme);
+          v->defs++;
+          v->lastdef = i;
+        }
+        count_reads(csound, vars, a->left, i, ep);
+        count_reads(csound, vars, a->right, i, ep);
+      }
+      count_reads(csound, vars, t->right, i, ep);
+    }
+
+    ncse = cse_body(csound, vars, pool, st, blk, n);
+    ndead = dce_body(csound, vars, pool, st, n);
+    nhoist = hoist_body(csound, vars, st, n);
+    if (UNLIKELY(csound->oparms->odebug) && (ncse || ndead || nhoist))
+      csound->Message(csound, Str("line %d: %d common subexpressions, "
+                                  "%d unused results removed, "
+                                  "%d opcodes moved to i-time\n"),
+                      body->line, ncse, ndead, nhoist);
+
+    for (i = 0, tail = &head; i < n; i++)
+      if (st[i] != NULL) {
+        tail->next = st[i];
+        tail = st[i];
+      }
+    tail->next = NULL;
+    cs_hash_table_mfree_complete(csound, vars);
+    csound->Free(csound, blk);
+    csound->Free(csound, st);
+    return head.next;
+}
+
 /* Optimizes tree (expressions, etc.) */
 TREE * csound_orc_optimize(CSOUND *csound, TREE *root)
 {
@@ -433,8 +998,17 @@ TREE * csound_orc_optimize(CSOUND *csound, TREE *root)
       root = root->next;
     }
     //#ifdef JPFF
-    return remove_excess_assigns(csound,original);
+    original = remove_excess_assigns(csound,original);
     //#else
     //return original;
     //#endif
+    for (root = original; root != NULL; root = root->next)
+      if ((root->type == INSTR_TOKEN || root->type == UDO_TOKEN) &&
+          root->markup != NULL) {
+        root->right = optimize_body(csound, root->right,
+                                    (CS_VAR_POOL *) root->markup);
+        root->right = fuse_expressions(csound, root->right,
+                                       (CS_VAR_POOL *) root->markup);
+      }
+    return original;
 }
@@ -34,6 +34,8 @@
 #include "csound_standard_types.h"
 #include "csound_orc_expressions.h"
 #include "csound_orc_semantics.h"
+#include "csmodule.h"
+#include "find_opcode.h"
 
 extern char *csound_orcget_text ( void *scanner );
 static int is_label(char* ident, CONS_CELL* labelList);
@@ -619,6 +621,8 @@ OENTRY* find_opcode(CSOUND *csound, char *opname)
     shortName = get_opcode_short_name(csound, opname);
 
     head = cs_hash_table_get(csound, csound->opcodes, shortName);
+    if (head == NULL && csoundLoadModuleForOpcode(csound, shortName))
+      head = cs_hash_table_get(csound, csound->opcodes, shortName);
 
     retVal = (head != NULL) ? head->value : NULL;
     if (shortName != opname) csound->Free(csound, shortName);
@@ -649,6 +653,8 @@ OENTRIES* find_opcode2(CSOUND* csound, char* opname)
 
     shortName = get_opcode_short_name(csound, opname);
     head = cs_hash_table_get(csound, csound->opcodes, shortName);
+    if (head == NULL && csoundLoadModuleForOpcode(csound, shortName))
+      head = cs_hash_table_get(csound, csound->opcodes, shortName);
     retVal = get_entries(csound, cs_cons_length(head));
     while (head != NULL) {
       retVal->entries[i++] = head->value;
@@ -1007,6 +1013,44 @@ OENTRY* resolve_opcode_exact(CSOUND* csound, OENTRIES* entries,
     return retVal;
 }
 
+/* Overload resolution cache.  csound->opcode_resolved maps
+   "name\037outtypes\037intypes" to the OENTRY resolve_opcode() chose,
+   so a call signature met before costs one hash lookup instead of a scan
+   of the overloads.  It lasts across compiles and is dropped whenever an
+   opcode is added (opcode_list_new_oentry()). */
+
+static char *resolved_key(char *buf, size_t size, char *opname,
+                          char *outArgTypes, char *inArgTypes)
+{
+    /* \001 stands for a missing list, so NULL and "" stay apart */
+    int n = snprintf(buf, size, "%s\037%s\037%s", opname,
+                     outArgTypes != NULL ? outArgTypes : "\001",
+                     inArgTypes != NULL ? inArgTypes : "\001");
+    return (n > 0 && (size_t) n < size) ? buf : NULL;
+}
+
+static OENTRY *resolved_get(CSOUND *csound, char *key)
+{
+    if (key == NULL || csound->opcode_resolved == NULL) return NULL;
+    return (OENTRY*) cs_hash_table_get(csound, csound->opcode_resolved, key);
+}
+
+static void resolved_put(CSOUND *csound, char *key, OENTRY *oentry)
+{
+    if (key == NULL || oentry == NULL) return;
+    if (csound->opcode_resolved == NULL)
+      csound->opcode_resolved = cs_hash_table_create(csound);
+    cs_hash_table_put(csound, csound->opcode_resolved, key, oentry);
+}
+
+void csoundClearOpcodeResolution(CSOUND *csound)
+{
+    if (csound->opcode_resolved != NULL) {
+      cs_hash_table_free(csound, csound->opcode_resolved);
+      csound->opcode_resolved = NULL;
+    }
+}
+
 /* used when creating T_FUNCTION's */
 char* resolve_opcode_get_outarg(CSOUND* csound, OENTRIES* entries,
                               char* inArgTypes) {
@@ -1138,12 +1182,23 @@ OENTRY* find_opcode_new(CSOUND* csound, char* opname,
 //    csound->Message(csound, "Searching for opcode: %s | %s | %s\n",
 //                    outArgsFound, opname, inArgsFound);
 
+    char buf[256];
+    char* key = resolved_key(buf, sizeof(buf), opname,
+                             outArgsFound, inArgsFound);
+    OENTRY* retVal = resolved_get(csound, key);
+
+    if (retVal != NULL) {
+      return retVal;
+    }
+
     OENTRIES* opcodes = find_opcode2(csound, opname);
 
     if (opcodes->count == 0) {
+      csound->Free(csound, opcodes);
       return NULL;
     }
-    OENTRY* retVal = resolve_opcode(csound, opcodes, outArgsFound, inArgsFound);
+    retVal = resolve_opcode(csound, opcodes, outArgsFound, inArgsFound);
+    resolved_put(csound, key, retVal);
 
     csound->Free(csound, opcodes);
 
@@ -1452,24 +1507,29 @@ int verify_opcode(CSOUND* csound, TREE* root, TYPE_TABLE* typeTable) {
       }
     }
 
-    OENTRIES* entries = find_opcode2(csound, opcodeName);
-    if (UNLIKELY(entries == NULL || entries->count == 0)) {
-      synterr(csound, Str("Unable to find opcode with name: %s\n"),
-              root->value->lexeme);
-      if (entries != NULL) {
-        csound->Free(csound, entries);
+    /* if there is type annotation, try to resolve it */
+    char* outArgString = (root->value->optype == NULL) ?
+                           leftArgString : root->value->optype;
+    char keyBuf[256];
+    char* key = resolved_key(keyBuf, sizeof(keyBuf), opcodeName,
+                             outArgString, rightArgString);
+    OENTRIES* entries = NULL;
+    OENTRY* oentry = resolved_get(csound, key);
+
+    if (oentry == NULL) {
+      entries = find_opcode2(csound, opcodeName);
+      if (UNLIKELY(entries == NULL || entries->count == 0)) {
+        synterr(csound, Str("Unable to find opcode with name: %s\n"),
+                root->value->lexeme);
+        if (entries != NULL) {
+          csound->Free(csound, entries);
+        }
+        return 0;
       }
-      return 0;
+      oentry = resolve_opcode(csound, entries, outArgString, rightArgString);
+      resolved_put(csound, key, oentry);
     }
 
-    OENTRY* oentry;
-    if (root->value->optype == NULL)
-      oentry = resolve_opcode(csound, entries,
-                              leftArgString, rightArgString);
-    /* if there is type annotation, try to resolve it */
-    else oentry = resolve_opcode(csound, entries,
-                                 root->value->optype, rightArgString);
-
 
     if (UNLIKELY(oentry == NULL)) {
       synterr(csound, Str("Unable to find opcode entry for \'%s\' "
@@ -1496,6 +1556,7 @@ int verify_opcode(CSOUND* csound, TREE* root, TYPE_TABLE* typeTable) {
           (strcmp(oentry->opname, "=.a")==0) &&
           left->value->lexeme[0]=='a') { /* Deal with sample accurate assigns */
         int i = 0;
+        if (entries == NULL) entries = find_opcode2(csound, opcodeName);
         while (strcmp(entries->entries[i]->opname, "=.l")) {
           //printf("not %d %s\n",i, entries->entries[i]->opname);
           i++;
@@ -123,12 +123,12 @@ OENTRY opcodlst_1[] = {
   {  "=.T",   S(STRGET_OP),0,   1,  "S",    "i",
      (SUBR) strcpy_opcode_p, (SUBR) NULL, (SUBR) NULL, NULL                 },
   { "=.r",    S(ASSIGN),0,  1,      "r",    "i",    rassign, NULL, NULL, NULL },
-  { "=.i",    S(ASSIGNM),0, 1,      "IIIIIIIIIIIIIIIIIIIIIIII", "m",
+  { "=.i",    S(ASSIGNM),PU, 1,      "IIIIIIIIIIIIIIIIIIIIIIII", "m",
     minit, NULL, NULL, NULL  },
-  { "=.k",    S(ASSIGNM),0, 2,      "zzzzzzzzzzzzzzzzzzzzzzzz", "z",
+  { "=.k",    S(ASSIGNM),PU, 2,      "zzzzzzzzzzzzzzzzzzzzzzzz", "z",
     NULL, minit, NULL, NULL },
-  { "=.a",    S(ASSIGN),0,  2,      "a",    "a",    NULL, gaassign, NULL },
-  { "=.l",    S(ASSIGN),0,  2,      "a",    "a",    NULL,   laassign, NULL },
+  { "=.a",    S(ASSIGN),PU,  2,      "a",    "a",    NULL, gaassign, NULL },
+  { "=.l",    S(ASSIGN),PU,  2,      "a",    "a",    NULL,   laassign, NULL },
   { "=.up",   S(UPSAMP),0,  2,      "a",    "k",  NULL, (SUBR)upsamp, NULL },
   { "=.down",   S(DOWNSAMP),0,  3,  "k",    "ao",   (SUBR)downset,(SUBR)downsamp },
   //  { "=.t",    S(ASSIGNT),0, 2,      "t",    "kk",   NULL,   tassign, NULL   },
@@ -137,54 +137,55 @@ OENTRY opcodlst_1[] = {
   { "init.i", S(ASSIGNM),0, 1,      "IIIIIIIIIIIIIIIIIIIIIIII", "m", minit  },
   { "init.k", S(ASSIGNM),0, 1,      "zzzzzzzzzzzzzzzzzzzzzzzz", "m", minit  },
   { "init.a", S(ASSIGNM),0, 1,      "mmmmmmmmmmmmmmmmmmmmmmmm", "m", mainit },
-  { ">",      S(RELAT),0,   0,      "b",    "ii",   gt,     gt              },
-  { ">.0",      S(RELAT),0,   0,      "B",    "kk",   gt,     gt              },
-  { ">=",     S(RELAT),0,   0,      "b",    "ii",   ge,     ge              },
-  { ">=.0",     S(RELAT),0,   0,      "B",    "kk",   ge,     ge              },
-  { "<",      S(RELAT),0,   0,      "b",    "ii",   lt,     lt              },
-  { "<.0",      S(RELAT),0,   0,      "B",    "kk",   lt,     lt              },
-  { "<=",     S(RELAT),0,   0,      "b",    "ii",   le,     le              },
-  { "<=.0",     S(RELAT),0,   0,      "B",    "kk",   le,     le              },
-  { "==",     S(RELAT),0,   0,      "b",    "ii",   eq,     eq              },
-  { "==.0",     S(RELAT),0,   0,      "B",    "kk",   eq,     eq              },
-  { "!=",     S(RELAT),0,   0,      "b",    "ii",   ne,     ne              },
-  { "!=.0",     S(RELAT),0,   0,      "B",    "kk",   ne,     ne              },
-  { "!",      S(LOGCL),0,   0,      "b",    "b",    b_not,    b_not         },
-  { "!.0",      S(LOGCL),0, 0,      "B",    "B",    b_not,    b_not         },
-  { "&&",     S(LOGCL),0,   0,      "b",    "bb",   and,    and             },
-  { "&&.0",     S(LOGCL),0,   0,      "B",    "BB",   and,    and             },
-  { "||",     S(LOGCL),0,   0,      "b",    "bb",   or,     or              },
-  { "||.0",     S(LOGCL),0,   0,      "B",    "BB",   or,     or              },
-  { ":cond.i",     S(CONVAL),0,  1,      "i",    "bii",  conval                  },
-  { ":cond.k",     S(CONVAL),0,  2,      "k",    "Bkk",  NULL,   conval          },
-  { ":cond.a",     S(CONVAL),0,  2,      "a",    "Bxx",  NULL,   aconval },
+  { ">",      S(RELAT),PU,   0,      "b",    "ii",   gt,     gt              },
+  { ">.0",      S(RELAT),PU,   0,      "B",    "kk",   gt,     gt              },
+  { ">=",     S(RELAT),PU,   0,      "b",    "ii",   ge,     ge              },
+  { ">=.0",     S(RELAT),PU,   0,      "B",    "kk",   ge,     ge              },
+  { "<",      S(RELAT),PU,   0,      "b",    "ii",   lt,     lt              },
+  { "<.0",      S(RELAT),PU,   0,      "B",    "kk",   lt,     lt              },
+  { "<=",     S(RELAT),PU,   0,      "b",    "ii",   le,     le              },
+  { "<=.0",     S(RELAT),PU,   0,      "B",    "kk",   le,     le              },
+  { "==",     S(RELAT),PU,   0,      "b",    "ii",   eq,     eq              },
+  { "==.0",     S(RELAT),PU,   0,      "B",    "kk",   eq,     eq              },
+  { "!=",     S(RELAT),PU,   0,      "b",    "ii",   ne,     ne              },
+  { "!=.0",     S(RELAT),PU,   0,      "B",    "kk",   ne,     ne              },
+  { "!",      S(LOGCL),PU,   0,      "b",    "b",    b_not,    b_not         },
+  { "!.0",      S(LOGCL),PU, 0,      "B",    "B",    b_not,    b_not         },
+  { "&&",     S(LOGCL),PU,   0,      "b",    "bb",   and,    and             },
+  { "&&.0",     S(LOGCL),PU,   0,      "B",    "BB",   and,    and             },
+  { "||",     S(LOGCL),PU,   0,      "b",    "bb",   or,     or              },
+  { "||.0",     S(LOGCL),PU,   0,      "B",    "BB",   or,     or              },
+  { ":cond.i",     S(CONVAL),PU,  1,      "i",    "bii",  conval                  },
+  { ":cond.k",     S(CONVAL),PU,  2,      "k",    "Bkk",  NULL,   conval          },
+  { ":cond.a",     S(CONVAL),PU,  2,      "a",    "Bxx",  NULL,   aconval },
   { ":cond.s",     S(CONVAL),0,  1,      "S",    "bSS",  conval, NULL         },
   { ":cond.S",     S(CONVAL),0,  3,      "S",    "BSS",  conval, conval       },
-  { "##add.ii",  S(AOP),0,    1,      "i",    "ii",   addkk                   },
-  { "##sub.ii",  S(AOP),0,    1,      "i",    "ii",   subkk                   },
-  { "##mul.ii",  S(AOP),0,    1,      "i",    "ii",   mulkk                   },
-  { "##div.ii",  S(AOP),0,    1,      "i",    "ii",   divkk                   },
-  { "##mod.ii",  S(AOP),0,    1,      "i",    "ii",   modkk                   },
-  { "##add.kk",  S(AOP),0,    2,      "k",    "kk",   NULL,   addkk           },
-  { "##sub.kk",  S(AOP),0,    2,      "k",    "kk",   NULL,   subkk           },
-  { "##mul.kk",  S(AOP),0,    2,      "k",    "kk",   NULL,   mulkk           },
-  { "##div.kk",  S(AOP),0,    2,      "k",    "kk",   NULL,   divkk           },
-  { "##mod.kk",  S(AOP),0,    2,      "k",    "kk",   NULL,   modkk           },
-  { "##add.ka",  S(AOP),0,    2,      "a",    "ka",   NULL,   addka   },
-  { "##sub.ka",  S(AOP),0,    2,      "a",    "ka",   NULL,   subka   },
-  { "##mul.ka",  S(AOP),0,    2,      "a",    "ka",   NULL,   mulka   },
-  { "##div.ka",  S(AOP),0,    2,      "a",    "ka",   NULL,   divka   },
-  { "##mod.ka",  S(AOP),0,    2,      "a",    "ka",   NULL,   modka   },
-  { "##add.ak",  S(AOP),0,    2,      "a",    "ak",   NULL,   addak   },
-  { "##sub.ak",  S(AOP),0,    2,      "a",    "ak",   NULL,   subak   },
-  { "##mul.ak",  S(AOP),0,    2,      "a",    "ak",   NULL,   mulak   },
-  { "##div.ak",  S(AOP),0,    2,      "a",    "ak",   NULL,   divak   },
-  { "##mod.ak",  S(AOP),0,    2,      "a",    "ak",   NULL,   modak   },
-  { "##add.aa",  S(AOP),0,    2,      "a",    "aa",   NULL,   addaa   },
-  { "##sub.aa",  S(AOP),0,    2,      "a",    "aa",   NULL,   subaa   },
-  { "##mul.aa",  S(AOP),0,    2,      "a",    "aa",   NULL,   mulaa   },
-  { "##div.aa",  S(AOP),0,    2,      "a",    "aa",   NULL,   divaa   },
-  { "##mod.aa",  S(AOP),0,    2,      "a",    "aa",   NULL,   modaa   },
+  { "##add.ii",  S(AOP),PU,    1,      "i",    "ii",   addkk                   },
+  { "##sub.ii",  S(AOP),PU,    1,      "i",    "ii",   subkk                   },
+  { "##mul.ii",  S(AOP),PU,    1,      "i",    "ii",   mulkk                   },
+  { "##div.ii",  S(AOP),0,     1,      "i",    "ii",   divkk                   },
+  { "##mod.ii",  S(AOP),PU,    1,      "i",    "ii",   modkk                   },
+  { "##add.kk",  S(AOP),PU,    2,      "k",    "kk",   NULL,   addkk           },
+  { "##sub.kk",  S(AOP),PU,    2,      "k",    "kk",   NULL,   subkk           },
+  { "##mul.kk",  S(AOP),PU,    2,      "k",    "kk",   NULL,   mulkk           },
+  { "##div.kk",  S(AOP),0,     2,      "k",    "kk",   NULL,   divkk           },
+  { "##mod.kk",  S(AOP),PU,    2,      "k",    "kk",   NULL,   modkk           },
+  { "##add.ka",  S(AOP),PU,    2,      "a",    "ka",   NULL,   addka   },
+  { "##sub.ka",  S(AOP),PU,    2,      "a",    "ka",   NULL,   subka   },
+  { "##mul.ka",  S(AOP),PU,    2,      "a",    "ka",   NULL,   mulka   },
+  { "##div.ka",  S(AOP),0,     2,      "a",    "ka",   NULL,   divka   },
+  { "##mod.ka",  S(AOP),PU,    2,      "a",    "ka",   NULL,   modka   },
+  { "##add.ak",  S(AOP),PU,    2,      "a",    "ak",   NULL,   addak   },
+  { "##sub.ak",  S(AOP),PU,    2,      "a",    "ak",   NULL,   subak   },
+  { "##mul.ak",  S(AOP),PU,    2,      "a",    "ak",   NULL,   mulak   },
+  { "##div.ak",  S(AOP),0,     2,      "a",    "ak",   NULL,   divak   },
+  { "##mod.ak",  S(AOP),PU,    2,      "a",    "ak",   NULL,   modak   },
+  { "##add.aa",  S(AOP),PU,    2,      "a",    "aa",   NULL,   addaa   },
+  { "##sub.aa",  S(AOP),PU,    2,      "a",    "aa",   NULL,   subaa   },
+  { "##mul.aa",  S(AOP),PU,    2,      "a",    "aa",   NULL,   mulaa   },
+  { "##div.aa",  S(AOP),0,     2,      "a",    "aa",   NULL,   divaa   },
+  { "##mod.aa",  S(AOP),PU,    2,      "a",    "aa",   NULL,   modaa   },
+  { "##fuse",    S(FUSE),0,    3,      "a",    "SM",   fuse_init, fuse_perf },
   { "##addin.i", S(ASSIGN),0, 1,      "i",    "i",    addin,  NULL    },
   { "##addin.k", S(ASSIGN),0, 2,      "k",    "k",    NULL,   addin   },
   { "##addin.K", S(ASSIGN),0, 2,      "a",    "k",    NULL,   addinak },
@@ -194,94 +195,94 @@ OENTRY opcodlst_1[] = {
   { "##subin.K", S(ASSIGN),0, 2,      "a",    "k",    NULL,   subinak },
   { "##subin.a", S(ASSIGN),0, 2,      "a",    "a",    NULL,   subina  },
   { "divz",   0xfffc                                                      },
-  { "divz.ii", S(DIVZ),0,   1,      "i",    "iii",  divzkk, NULL,   NULL    },
-  { "divz.kk", S(DIVZ),0,   2,      "k",    "kkk",  NULL,   divzkk, NULL    },
-  { "divz.ak", S(DIVZ),0,   2,      "a",    "akk",  NULL,   divzak  },
-  { "divz.ka", S(DIVZ),0,   2,      "a",    "kak",  NULL,   divzka  },
-  { "divz.aa", S(DIVZ),0,   2,      "a",    "aak",  NULL,   divzaa  },
-  { "int.i",  S(EVAL),0,    1,      "i",    "i",    int1                    },
-  { "frac.i", S(EVAL),0,    1,      "i",    "i",    frac1                   },
-  { "round.i",S(EVAL),0,    1,      "i",    "i",    int1_round              },
-  { "floor.i",S(EVAL),0,    1,      "i",    "i",    int1_floor              },
-  { "ceil.i", S(EVAL),0,    1,      "i",    "i",    int1_ceil               },
+  { "divz.ii", S(DIVZ),PU,   1,      "i",    "iii",  divzkk, NULL,   NULL    },
+  { "divz.kk", S(DIVZ),PU,   2,      "k",    "kkk",  NULL,   divzkk, NULL    },
+  { "divz.ak", S(DIVZ),PU,   2,      "a",    "akk",  NULL,   divzak  },
+  { "divz.ka", S(DIVZ),PU,   2,      "a",    "kak",  NULL,   divzka  },
+  { "divz.aa", S(DIVZ),PU,   2,      "a",    "aak",  NULL,   divzaa  },
+  { "int.i",  S(EVAL),PU,    1,      "i",    "i",    int1                    },
+  { "frac.i", S(EVAL),PU,    1,      "i",    "i",    frac1                   },
+  { "round.i",S(EVAL),PU,    1,      "i",    "i",    int1_round              },
+  { "floor.i",S(EVAL),PU,    1,      "i",    "i",    int1_floor              },
+  { "ceil.i", S(EVAL),PU,    1,      "i",    "i",    int1_ceil               },
   { "rnd.i",  S(EVAL),0,    1,      "i",    "i",    rnd1                    },
   { "birnd.i",S(EVAL),0,    1,      "i",    "i",    birnd1                  },
-  { "abs.i",  S(EVAL),0,    1,      "i",    "i",    abs1                    },
-  { "exp.i",  S(EVAL),0,    1,      "i",    "i",    exp01                   },
-  { "log.i",  S(EVAL),0,    1,      "i",    "i",    log01                   },
-  { "sqrt.i", S(EVAL),0,    1,      "i",    "i",    sqrt1                   },
-  { "sin.i",  S(EVAL),0,    1,      "i",    "i",    sin1                    },
-  { "cos.i",  S(EVAL),0,    1,      "i",    "i",    cos1                    },
-  { "tan.i",  S(EVAL),0,    1,      "i",    "i",    tan1                    },
-  { "qinf.i", S(EVAL),0,    1,      "i",    "i",    is_inf                  },
-  { "qnan.i", S(EVAL),0,    1,      "i",    "i",    is_NaN                  },
-  { "sininv.i", S(EVAL),0,  1,      "i",    "i",    asin1                   },
-  { "cosinv.i", S(EVAL),0,  1,      "i",    "i",    acos1                   },
-  { "taninv.i", S(EVAL),0,  1,      "i",    "i",    atan1                   },
-  { "taninv2.i",S(AOP),0,   1,      "i",    "ii",   atan21                  },
-  { "log10.i",S(EVAL),0,    1,      "i",    "i",    log101                  },
-  { "log2.i", S(EVAL),0,    1,      "i",    "i",    log21                   },
-  { "sinh.i", S(EVAL),0,    1,      "i",    "i",    sinh1                   },
-  { "cosh.i", S(EVAL),0,    1,      "i",    "i",    cosh1                   },
-  { "tanh.i", S(EVAL),0,    1,      "i",    "i",    tanh1                   },
-  { "int.k",  S(EVAL),0,    2,      "k",    "k",    NULL,   int1            },
-  { "frac.k", S(EVAL),0,    2,      "k",    "k",    NULL,   frac1           },
-  { "round.k",S(EVAL),0,    2,      "k",    "k",    NULL,   int1_round      },
-  { "floor.k",S(EVAL),0,    2,      "k",    "k",    NULL,   int1_floor      },
-  { "ceil.k", S(EVAL),0,    2,      "k",    "k",    NULL,   int1_ceil       },
+  { "abs.i",  S(EVAL),PU,    1,      "i",    "i",    abs1                    },
+  { "exp.i",  S(EVAL),PU,    1,      "i",    "i",    exp01                   },
+  { "log.i",  S(EVAL),PU,    1,      "i",    "i",    log01                   },
+  { "sqrt.i", S(EVAL),PU,    1,      "i",    "i",    sqrt1                   },
+  { "sin.i",  S(EVAL),PU,    1,      "i",    "i",    sin1                    },
+  { "cos.i",  S(EVAL),PU,    1,      "i",    "i",    cos1                    },
+  { "tan.i",  S(EVAL),PU,    1,      "i",    "i",    tan1                    },
+  { "qinf.i", S(EVAL),PU,    1,      "i",    "i",    is_inf                  },
+  { "qnan.i", S(EVAL),PU,    1,      "i",    "i",    is_NaN                  },
+  { "sininv.i", S(EVAL),PU,  1,      "i",    "i",    asin1                   },
+  { "cosinv.i", S(EVAL),PU,  1,      "i",    "i",    acos1                   },
+  { "taninv.i", S(EVAL),PU,  1,      "i",    "i",    atan1                   },
+  { "taninv2.i",S(AOP),PU,   1,      "i",    "ii",   atan21                  },
+  { "log10.i",S(EVAL),PU,    1,      "i",    "i",    log101                  },
+  { "log2.i", S(EVAL),PU,    1,      "i",    "i",    log21                   },
+  { "sinh.i", S(EVAL),PU,    1,      "i",    "i",    sinh1                   },
+  { "cosh.i", S(EVAL),PU,    1,      "i",    "i",    cosh1                   },
+  { "tanh.i", S(EVAL),PU,    1,      "i",    "i",    tanh1                   },
+  { "int.k",  S(EVAL),PU,    2,      "k",    "k",    NULL,   int1            },
+  { "frac.k", S(EVAL),PU,    2,      "k",    "k",    NULL,   frac1           },
+  { "round.k",S(EVAL),PU,    2,      "k",    "k",    NULL,   int1_round      },
+  { "floor.k",S(EVAL),PU,    2,      "k",    "k",    NULL,   int1_floor      },
+  { "ceil.k", S(EVAL),PU,    2,      "k",    "k",    NULL,   int1_ceil       },
   { "rnd.k",  S(EVAL),0,    2,      "k",    "k",    NULL,   rnd1            },
   { "birnd.k",S(EVAL),0,    2,      "k",    "k",    NULL,   birnd1          },
-  { "abs.k",  S(EVAL),0,    2,      "k",    "k",    NULL,   abs1            },
-  { "exp.k",  S(EVAL),0,    2,      "k",    "k",    NULL,   exp01           },
-  { "log.k",  S(EVAL),0,    2,      "k",    "k",    NULL,   log01           },
-  { "sqrt.k", S(EVAL),0,    2,      "k",    "k",    NULL,   sqrt1           },
-  { "sin.k",  S(EVAL),0,    2,      "k",    "k",    NULL,   sin1            },
-  { "cos.k",  S(EVAL),0,    2,      "k",    "k",    NULL,   cos1            },
-  { "tan.k",  S(EVAL),0,    2,      "k",    "k",    NULL,   tan1            },
-  { "qinf.k", S(EVAL),0,    2,      "k",    "k",    NULL,   is_inf          },
-  { "qnan.k", S(EVAL),0,    2,      "k",    "k",    NULL,   is_NaN          },
-  { "sininv.k", S(EVAL),0,  2,      "k",    "k",    NULL,   asin1           },
-  { "cosinv.k", S(EVAL),0,  2,      "k",    "k",    NULL,   acos1           },
-  { "taninv.k", S(EVAL),0,  2,      "k",    "k",    NULL,   atan1           },
-  { "taninv2.k",S(AOP),0,   2,      "k",    "kk",   NULL,   atan21          },
-  { "sinh.k", S(EVAL),0,    2,      "k",    "k",    NULL,   sinh1           },
-  { "cosh.k", S(EVAL),0,    2,      "k",    "k",    NULL,   cosh1           },
-  { "tanh.k", S(EVAL),0,    2,      "k",    "k",    NULL,   tanh1           },
-  { "log10.k",S(EVAL),0,    2,      "k",    "k",    NULL,   log101          },
-  { "log2.k", S(EVAL),0,    2,      "k",    "k",    NULL,   log21           },
-  { "int.a",  S(EVAL),0,    2,      "a",    "a",    NULL, int1a       },
-  { "frac.a", S(EVAL),0,    2,      "a",    "a",    NULL, frac1a      },
-  { "round.a",S(EVAL),0,    2,      "a",    "a",    NULL, int1a_round },
-  { "floor.a",S(EVAL),0,    2,      "a",    "a",    NULL, int1a_floor },
-  { "ceil.a", S(EVAL),0,    2,      "a",    "a",    NULL, int1a_ceil  },
-  { "abs.a",  S(EVAL),0,    2,      "a",    "a",    NULL,   absa    },
-  { "exp.a",  S(EVAL),0,    2,      "a",    "a",    NULL,   expa    },
-  { "log.a",  S(EVAL),0,    2,      "a",    "a",    NULL,   loga    },
-  { "sqrt.a", S(EVAL),0,    2,      "a",    "a",    NULL,   sqrta   },
-  { "sin.a",  S(EVAL),0,    2,      "a",    "a",    NULL,   sina    },
-  { "cos.a",  S(EVAL),0,    2,      "a",    "a",    NULL,   cosa    },
-  { "tan.a",  S(EVAL),0,    2,      "a",    "a",    NULL,   tana    },
-  { "qinf.a", S(EVAL),0,    2,      "a",    "a",    NULL,   is_infa },
-  { "qnan.a", S(EVAL),0,    2,      "a",    "a",    NULL,   is_NaNa },
-  { "sininv.a", S(EVAL),0,  2,      "a",    "a",    NULL,   asina   },
-  { "cosinv.a", S(EVAL),0,  2,      "a",    "a",    NULL,   acosa   },
-  { "taninv.a", S(EVAL),0,  2,      "a",    "a",    NULL,   atana   },
-  { "taninv2.a",S(AOP),0,   2,      "a",    "aa",   NULL,   atan2aa },
-  { "sinh.a", S(EVAL),0,    2,      "a",    "a",    NULL,   sinha   },
-  { "cosh.a", S(EVAL),0,    2,      "a",    "a",    NULL,   cosha   },
-  { "tanh.a", S(EVAL),0,    2,      "a",    "a",    NULL,   tanha   },
-  { "log10.a",S(EVAL),0,    2,      "a",    "a",    NULL,   log10a  },
-  { "log2.a", S(EVAL),0,    2,      "a",    "a",    NULL,   log2a   },
-  { "ampdb.a",S(EVAL),0,    2,      "a",    "a",    NULL,   aampdb  },
-  { "ampdb.i",S(EVAL),0,    1,      "i",    "i",    ampdb                   },
-  { "ampdb.k",S(EVAL),0,    2,      "k",    "k",    NULL,   ampdb           },
-  { "ampdbfs.a",S(EVAL),0,  2,      "a",    "a",    NULL,   aampdbfs },
-  { "ampdbfs.i",S(EVAL),0,  1,      "i",    "i",    ampdbfs                 },
-  { "ampdbfs.k",S(EVAL),0,  2,      "k",    "k",    NULL,   ampdbfs         },
-  { "dbamp.i",S(EVAL),0,    1,      "i",    "i",    dbamp                   },
-  { "dbamp.k",S(EVAL),0,    2,      "k",    "k",    NULL,   dbamp           },
-  { "dbfsamp.i",S(EVAL),0,  1,      "i",    "i",    dbfsamp                 },
-  { "dbfsamp.k",S(EVAL),0,  2,      "k",    "k",    NULL,   dbfsamp         },
+  { "abs.k",  S(EVAL),PU,    2,      "k",    "k",    NULL,   abs1            },
+  { "exp.k",  S(EVAL),PU,    2,      "k",    "k",    NULL,   exp01           },
+  { "log.k",  S(EVAL),PU,    2,      "k",    "k",    NULL,   log01           },
+  { "sqrt.k", S(EVAL),PU,    2,      "k",    "k",    NULL,   sqrt1           },
+  { "sin.k",  S(EVAL),PU,    2,      "k",    "k",    NULL,   sin1            },
+  { "cos.k",  S(EVAL),PU,    2,      "k",    "k",    NULL,   cos1            },
+  { "tan.k",  S(EVAL),PU,    2,      "k",    "k",    NULL,   tan1            },
+  { "qinf.k", S(EVAL),PU,    2,      "k",    "k",    NULL,   is_inf          },
+  { "qnan.k", S(EVAL),PU,    2,      "k",    "k",    NULL,   is_NaN          },
+  { "sininv.k", S(EVAL),PU,  2,      "k",    "k",    NULL,   asin1           },
+  { "cosinv.k", S(EVAL),PU,  2,      "k",    "k",    NULL,   acos1           },
+  { "taninv.k", S(EVAL),PU,  2,      "k",    "k",    NULL,   atan1           },
+  { "taninv2.k",S(AOP),PU,   2,      "k",    "kk",   NULL,   atan21          },
+  { "sinh.k", S(EVAL),PU,    2,      "k",    "k",    NULL,   sinh1           },
+  { "cosh.k", S(EVAL),PU,    2,      "k",    "k",    NULL,   cosh1           },
+  { "tanh.k", S(EVAL),PU,    2,      "k",    "k",    NULL,   tanh1           },
+  { "log10.k",S(EVAL),PU,    2,      "k",    "k",    NULL,   log101          },
+  { "log2.k", S(EVAL),PU,    2,      "k",    "k",    NULL,   log21           },
+  { "int.a",  S(EVAL),PU,    2,      "a",    "a",    NULL, int1a       },
+  { "frac.a", S(EVAL),PU,    2,      "a",    "a",    NULL, frac1a      },
+  { "round.a",S(EVAL),PU,    2,      "a",    "a",    NULL, int1a_round },
+  { "floor.a",S(EVAL),PU,    2,      "a",    "a",    NULL, int1a_floor },
+  { "ceil.a", S(EVAL),PU,    2,      "a",    "a",    NULL, int1a_ceil  },
+  { "abs.a",  S(EVAL),PU,    2,      "a",    "a",    NULL,   absa    },
+  { "exp.a",  S(EVAL),PU,    2,      "a",    "a",    NULL,   expa    },
+  { "log.a",  S(EVAL),PU,    2,      "a",    "a",    NULL,   loga    },
+  { "sqrt.a", S(EVAL),PU,    2,      "a",    "a",    NULL,   sqrta   },
+  { "sin.a",  S(EVAL),PU,    2,      "a",    "a",    NULL,   sina    },
+  { "cos.a",  S(EVAL),PU,    2,      "a",    "a",    NULL,   cosa    },
+  { "tan.a",  S(EVAL),PU,    2,      "a",    "a",    NULL,   tana    },
+  { "qinf.a", S(EVAL),PU,    2,      "a",    "a",    NULL,   is_infa },
+  { "qnan.a", S(EVAL),PU,    2,      "a",    "a",    NULL,   is_NaNa },
+  { "sininv.a", S(EVAL),PU,  2,      "a",    "a",    NULL,   asina   },
+  { "cosinv.a", S(EVAL),PU,  2,      "a",    "a",    NULL,   acosa   },
+  { "taninv.a", S(EVAL),PU,  2,      "a",    "a",    NULL,   atana   },
+  { "taninv2.a",S(AOP),PU,   2,      "a",    "aa",   NULL,   atan2aa },
+  { "sinh.a", S(EVAL),PU,    2,      "a",    "a",    NULL,   sinha   },
+  { "cosh.a", S(EVAL),PU,    2,      "a",    "a",    NULL,   cosha   },
+  { "tanh.a", S(EVAL),PU,    2,      "a",    "a",    NULL,   tanha   },
+  { "log10.a",S(EVAL),PU,    2,      "a",    "a",    NULL,   log10a  },
+  { "log2.a", S(EVAL),PU,    2,      "a",    "a",    NULL,   log2a   },
+  { "ampdb.a",S(EVAL),PU,    2,      "a",    "a",    NULL,   aampdb  },
+  { "ampdb.i",S(EVAL),PU,    1,      "i",    "i",    ampdb                   },
+  { "ampdb.k",S(EVAL),PU,    2,      "k",    "k",    NULL,   ampdb           },
+  { "ampdbfs.a",S(EVAL),PU,  2,      "a",    "a",    NULL,   aampdbfs },
+  { "ampdbfs.i",S(EVAL),PU,  1,      "i",    "i",    ampdbfs                 },
+  { "ampdbfs.k",S(EVAL),PU,  2,      "k",    "k",    NULL,   ampdbfs         },
+  { "dbamp.i",S(EVAL),PU,    1,      "i",    "i",    dbamp                   },
+  { "dbamp.k",S(EVAL),PU,    2,      "k",    "k",    NULL,   dbamp           },
+  { "dbfsamp.i",S(EVAL),PU,  1,      "i",    "i",    dbfsamp                 },
+  { "dbfsamp.k",S(EVAL),PU,  2,      "k",    "k",    NULL,   dbfsamp         },
   { "rtclock.i",S(EVAL),0,  1,      "i",    "",     rtclock                 },
   { "rtclock.k",S(EVAL),0,  2,      "k",    "",     NULL,   rtclock         },
   { "ftlen.i",S(EVAL),0,    1,      "i",    "i",    ftlen                   },
@@ -289,27 +290,27 @@ OENTRY opcodlst_1[] = {
   { "ftlptim.i",S(EVAL),0,  1,      "i",    "i",    ftlptim                 },
   { "ftchnls.i",S(EVAL),0,  1,      "i",    "i",    ftchnls                 },
   { "ftcps.i",S(EVAL),0,    1,      "i",    "i",    ftcps                   },
-  { "i.i",   S(ASSIGN),0,   1,      "i",    "i",    assign                  },
-  { "i.k",   S(ASSIGN),0,   1,      "i",    "k",    assign                  },
-  { "k.i",   S(ASSIGN),0,   1,      "k",    "i",    assign                  },
+  { "i.i",   S(ASSIGN),PU,   1,      "i",    "i",    assign                  },
+  { "i.k",   S(ASSIGN),PU,   1,      "i",    "k",    assign                  },
+  { "k.i",   S(ASSIGN),PU,   1,      "k",    "i",    assign                  },
   { "k.a",   S(DOWNSAMP),0, 3,      "k",    "ao",   (SUBR)downset,(SUBR)downsamp },
-  { "cpsoct.i",S(EVAL),0,   1,      "i",    "i",    cpsoct                  },
-  { "octpch.i",S(EVAL),0,   1,      "i",    "i",    octpch                  },
-  { "cpspch.i",S(EVAL),0,   1,      "i",    "i",    cpspch                  },
-  { "pchoct.i",S(EVAL),0,   1,      "i",    "i",    pchoct                  },
-  { "octcps.i",S(EVAL),0,   1,      "i",    "i",    octcps                  },
-  { "cpsoct.k",S(EVAL),0,   2,      "k",    "k",    NULL,   cpsoct          },
-  { "octpch.k",S(EVAL),0,   2,      "k",    "k",    NULL,   octpch          },
-  { "cpspch.k",S(EVAL),0,   2,      "k",    "k",    NULL,   cpspch          },
-  { "pchoct.k",S(EVAL),0,   2,      "k",    "k",    NULL,   pchoct          },
-  { "octcps.k",S(EVAL),0,   2,      "k",    "k",    NULL,   octcps          },
-  { "cpsoct.a",S(EVAL),0,   2,      "a",    "a",    NULL,   acpsoct },
-  { "cpsmidinn.i",S(EVAL),0,1,      "i",    "i",    cpsmidinn               },
-  { "octmidinn.i",S(EVAL),0,1,      "i",    "i",    octmidinn               },
-  { "pchmidinn.i",S(EVAL),0,1,      "i",    "i",    pchmidinn               },
-  { "cpsmidinn.k",S(EVAL),0,2,      "k",    "k",    NULL,   cpsmidinn       },
-  { "octmidinn.k",S(EVAL),0,2,      "k",    "k",    NULL,   octmidinn       },
-  { "pchmidinn.k",S(EVAL),0,2,      "k",    "k",    NULL,   pchmidinn       },
+  { "cpsoct.i",S(EVAL),PU,   1,      "i",    "i",    cpsoct                  },
+  { "octpch.i",S(EVAL),PU,   1,      "i",    "i",    octpch                  },
+  { "cpspch.i",S(EVAL),PU,   1,      "i",    "i",    cpspch                  },
+  { "pchoct.i",S(EVAL),PU,   1,      "i",    "i",    pchoct                  },
+  { "octcps.i",S(EVAL),PU,   1,      "i",    "i",    octcps                  },
+  { "cpsoct.k",S(EVAL),PU,   2,      "k",    "k",    NULL,   cpsoct          },
+  { "octpch.k",S(EVAL),PU,   2,      "k",    "k",    NULL,   octpch          },
+  { "cpspch.k",S(EVAL),PU,   2,      "k",    "k",    NULL,   cpspch          },
+  { "pchoct.k",S(EVAL),PU,   2,      "k",    "k",    NULL,   pchoct          },
+  { "octcps.k",S(EVAL),PU,   2,      "k",    "k",    NULL,   octcps          },
+  { "cpsoct.a",S(EVAL),PU,   2,      "a",    "a",    NULL,   acpsoct },
+  { "cpsmidinn.i",S(EVAL),PU,1,      "i",    "i",    cpsmidinn               },
+  { "octmidinn.i",S(EVAL),PU,1,      "i",    "i",    octmidinn               },
+  { "pchmidinn.i",S(EVAL),PU,1,      "i",    "i",    pchmidinn               },
+  { "cpsmidinn.k",S(EVAL),PU,2,      "k",    "k",    NULL,   cpsmidinn       },
+  { "octmidinn.k",S(EVAL),PU,2,      "k",    "k",    NULL,   octmidinn       },
+  { "pchmidinn.k",S(EVAL),PU,2,      "k",    "k",    NULL,   pchmidinn       },
   { "notnum", S(MIDIKMB),0, 1,      "i",    "",     notnum                  },
   { "veloc",  S(MIDIMAP),0, 1,      "i",    "oh",   veloc                   },
   { "pchmidi",S(MIDIKMB),0, 1,      "i",    "",     pchmidi                 },
@@ -555,12 +556,12 @@ OENTRY opcodlst_1[] = {
   { "xyin",   S(XYIN), _QQ, 1,      "kk",   "iiiiioo",xyinset,NULL          },
   { "tempest",  S(TEMPEST),0, 3,    "k","kiiiiiiiiiop",tempeset,tempest},
   { "tempo",    S(TEMPO),0,   3,    "",     "ki",   tempset,tempo           },
-  { "pow.i",    S(POW),0,   1,      "i",    "iip",  ipow,    NULL,  NULL    },
-  { "pow.k",    S(POW),0,   2,      "k",    "kkp",  NULL,    ipow,  NULL    },
-  { "pow.a",    S(POW),0,   2,      "a",    "akp",  NULL,  apow    },
-  { "##pow.i",  S(POW),0,   1,      "i",    "iip",  ipow,    NULL,  NULL    },
-  { "##pow.k",  S(POW),0,   2,      "k",    "kkp",  NULL,    ipow,  NULL    },
-  { "##pow.a",  S(POW),0,   2,      "a",    "akp",  NULL,  apow    },
+  { "pow.i",    S(POW),PU,   1,      "i",    "iip",  ipow,    NULL,  NULL    },
+  { "pow.k",    S(POW),PU,   2,      "k",    "kkp",  NULL,    ipow,  NULL    },
+  { "pow.a",    S(POW),PU,   2,      "a",    "akp",  NULL,  apow    },
+  { "##pow.i",  S(POW),PU,   1,      "i",    "iip",  ipow,    NULL,  NULL    },
+  { "##pow.k",  S(POW),PU,   2,      "k",    "kkp",  NULL,    ipow,  NULL    },
+  { "##pow.a",  S(POW),PU,   2,      "a",    "akp",  NULL,  apow    },
   { "oscilx",   S(OSCILN), TR, 3,   "a",    "kiii", oscnset,   osciln  },
   { "linrand.i",S(PRAND),0, 1,      "i",    "k",    iklinear, NULL, NULL    },
   { "linrand.k",S(PRAND),0, 2,      "k",    "k",    NULL, iklinear, NULL    },
@@ -658,10 +659,10 @@ OENTRY opcodlst_1[] = {
   { "nrpn",   S(NRPN),0,     2,     "",     "kkk",  NULL,  nrpn ,NULL          },
   { "mdelay", S(MDELAY),0,   3,     "",     "kkkkk",mdelay_set, mdelay,   NULL },
   { "nsamp.i", S(EVAL),0,    1,     "i",    "i",    numsamp                    },
-  { "powoftwo.i",S(EVAL),0,  1,     "i",    "i",    powoftwo                   },
-  { "powoftwo.k",S(EVAL),0,  2,     "k",    "k",    NULL, powoftwo             },
-  { "powoftwo.a",S(EVAL),0,  2,     "a",    "a",    NULL, powoftwoa      },
-  { "logbtwo.i",S(EVAL),0,   1,     "i",    "i",    ilogbasetwo                },
+  { "powoftwo.i",S(EVAL),PU,  1,     "i",    "i",    powoftwo                   },
+  { "powoftwo.k",S(EVAL),PU,  2,     "k",    "k",    NULL, powoftwo             },
+  { "powoftwo.a",S(EVAL),PU,  2,     "a",    "a",    NULL, powoftwoa      },
+  { "logbtwo.i",S(EVAL),PU,   1,     "i",    "i",    ilogbasetwo                },
   { "logbtwo.k",S(EVAL),0,   3,     "k",    "k",    logbasetwo_set, logbasetwo },
   { "logbtwo.a",S(EVAL),0,   3,     "a",    "a",
     logbasetwo_set, logbasetwoa },
@@ -842,9 +843,9 @@ OENTRY opcodlst_1[] = {
   { "octave",   0xffff                                                      },
   { "semitone", 0xffff                                                      },
   { "cent",     0xffff                                                      },
-  { "octave.i", S(EVAL),0,    1,    "i",    "i",     powoftwo               },
-  { "octave.k", S(EVAL),0,    2,    "k",    "k",     NULL,  powoftwo        },
-  { "octave.a", S(EVAL),0,    2,    "a",    "a",     NULL, powoftwoa  },
+  { "octave.i", S(EVAL),PU,    1,    "i",    "i",     powoftwo               },
+  { "octave.k", S(EVAL),PU,    2,    "k",    "k",     NULL,  powoftwo        },
+  { "octave.a", S(EVAL),PU,    2,    "a",    "a",     NULL, powoftwoa  },
   { "semitone.i",S(EVAL),0,   1,    "i",    "i",     semitone               },
   { "semitone.k",S(EVAL),0,   2,    "k",    "k",     NULL,  semitone        },
   { "semitone.a",S(EVAL),0,   2,    "a",    "a",     NULL, asemitone  },
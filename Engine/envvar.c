@@ -38,6 +38,7 @@
 
 
 #include "namedins.h"
+#include "fgens.h"
 
 /* list of environment variables used by Csound */
 
@@ -1082,7 +1083,6 @@ void *csoundFileOpenWithType(CSOUND *csound, void *fd, int type,
     p = (CSFILE*) csound->Malloc(csound, (size_t) nbytes);
     if (UNLIKELY(p == NULL))
       goto err_return;
-    p->nxt = (CSFILE*) csound->open_files;
     p->prv = (CSFILE*) NULL;
     p->type = type;
     p->fd = tmp_fd;
@@ -1165,10 +1165,13 @@ void *csoundFileOpenWithType(CSOUND *csound, void *fd, int type,
     default:                                  /* low level I/O */
       *((int*) fd) = tmp_fd;
     }
-    /* link into chain of open files */
+    /* link into chain of open files (shared with table workers) */
+    csoundFTAsyncLock(csound);
+    p->nxt = (CSFILE*) csound->open_files;
     if (csound->open_files != NULL)
       ((CSFILE*) csound->open_files)->prv = p;
     csound->open_files = (void*) p;
+    csoundFTAsyncUnlock(csound);
     /* notify the host if it asked */
     if (csound->FileOpenCallback_ != NULL) {
       int writing = (type == CSFILE_SND_W || type == CSFILE_FD_W ||
@@ -1230,7 +1233,6 @@ void *csoundCreateFileHandle(CSOUND *csound,
     p = (CSFILE*) csound->Malloc(csound, (size_t) nbytes);
     if (p == NULL)
       return NULL;
-    p->nxt = (CSFILE*) csound->open_files;
     p->prv = (CSFILE*) NULL;
     p->type = type;
     p->fd = -1;
@@ -1257,10 +1259,13 @@ void *csoundCreateFileHandle(CSOUND *csound,
       csound->Free(csound, p);
       return NULL;
     }
-    /* link into chain of open files */
+    /* link into chain of open files (shared with table workers) */
+    csoundFTAsyncLock(csound);
+    p->nxt = (CSFILE*) csound->open_files;
     if (csound->open_files != NULL)
       ((CSFILE*) csound->open_files)->prv = p;
     csound->open_files = (void*) p;
+    csoundFTAsyncUnlock(csound);
     /* return with opaque file handle */
     p->cb = NULL;
     return (void*) p;
@@ -1304,12 +1309,14 @@ int csoundFileClose(CSOUND *csound, void *fd)
         break;
       }
       /* unlink from chain of open files */
+      csoundFTAsyncLock(csound);
       if (p->prv == NULL)
         csound->open_files = (void*) p->nxt;
       else
         p->prv->nxt = p->nxt;
       if (p->nxt != NULL)
         p->nxt->prv = p->prv;
+      csoundFTAsyncUnlock(csound);
       if (p->buf != NULL) csound->Free(csound, p->buf);
       p->bufsize = 0;
       csound->DestroyCircularBuffer(csound, p->cb);
@@ -1332,12 +1339,14 @@ int csoundFileClose(CSOUND *csound, void *fd)
         break;
       }
       /* unlink from chain of open files */
+      csoundFTAsyncLock(csound);
       if (p->prv == NULL)
         csound->open_files = (void*) p->nxt;
       else
         p->prv->nxt = p->nxt;
       if (p->nxt != NULL)
         p->nxt->prv = p->prv;
+      csoundFTAsyncUnlock(csound);
     }
     /* free allocated memory */
     csound->Free(csound, fd);
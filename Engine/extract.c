@@ -34,17 +34,17 @@ static  void    include(EXTRACT_STATICS*, SRTBLK *);
 
 static  const   SRTBLK a0 = {
     NULL, NULL, 0, 3, FL(0.0), FL(0.0), FL(0.0), FL(0.0), FL(0.0),
-    0, SP, "a 0 0 0\n"
+    0, SP, 0, "a 0 0 0\n"
 };
 
 static  const   SRTBLK f0 = {
     NULL, NULL, 0, 2, FL(0.0), FL(0.0), FL(0.0), FL(0.0), FL(0.0),
-    0, SP, "f 0 0\n"
+    0, SP, 0, "f 0 0\n"
 };
 
 static  const   SRTBLK e = {
     NULL, NULL, 0, 0, FL(0.0), FL(0.0), FL(0.0), FL(0.0), FL(0.0),
-    0, SP, "e\n"
+    0, SP, 0, "e\n"
 };
 
 static void alloc_globals(EXTRACT_STATICS* extractStatics)
@@ -32,6 +32,7 @@
 #include "fgens.h"
 #include "pstream.h"
 #include "pvfileio.h"
+#include "fftlib.h"
 #include <stdlib.h>
 /* #undef ISSTRCOD */
 
@@ -112,7 +113,13 @@ typedef struct namedgen {
 
 CS_NOINLINE int  fterror(const FGDATA *, const char *, ...);
 static CS_NOINLINE void ftresdisp(const FGDATA *, FUNC *);
-static CS_NOINLINE FUNC *ftalloc(const FGDATA *);
+static void ftdisplay(CSOUND *, FUNC *);
+static CS_NOINLINE FUNC *ftalloc(FGDATA *);
+static int hfgens_(CSOUND *, FUNC **, const EVTBLK *, int, int);
+static int ftasync_safe(CSOUND *, int32);
+static int ftasync_cancel(CSOUND *, int);
+static int ftasync_pending(CSOUND *, int);
+static void ftasync_wait(CSOUND *, int);
 
 static int GENUL(FGDATA *ff, FUNC *ftp)
 {
@@ -124,6 +131,31 @@ static inline unsigned int isPowerOfTwo (unsigned int x) {
   return (x > 0) && !(x & (x - 1)) ? 1 : 0;
 }
 
+static void ftgens_init(CSOUND *csound)
+{
+    if (UNLIKELY(csound->gensub == NULL)) {
+      csound->gensub = (GEN*) csound->Malloc(csound, sizeof(GEN) * (GENMAX + 1));
+      memcpy(csound->gensub, or_sub, sizeof(GEN) * (GENMAX + 1));
+      csound->genmax = GENMAX + 1;
+    }
+}
+
+static void ftlist_extend(CSOUND *csound, int fno)
+{
+    if (UNLIKELY(fno > csound->maxfnum)) {      /* extend list if necessary */
+      FUNC  **nn;
+      int   size, i;
+      for (size = csound->maxfnum; size < fno; size += MAXFNUM)
+        ;
+      nn = (FUNC**) csound->ReAlloc(csound,
+                                    csound->flist, (size + 1) * sizeof(FUNC*));
+      csound->flist = nn;
+      for (i = csound->maxfnum + 1; i <= size; i++)
+        csound->flist[i] = NULL;                /*  Clear new section       */
+      csound->maxfnum = size;
+    }
+}
+
 /**
  * Create ftable using evtblk data, and store pointer to new table in *ftpp.
  * If mode is zero, a zero table number is ignored, otherwise a new table
@@ -132,6 +164,15 @@ static inline unsigned int isPowerOfTwo (unsigned int x) {
  */
 
 int hfgens(CSOUND *csound, FUNC **ftpp, const EVTBLK *evtblkp, int mode)
+{
+    return hfgens_(csound, ftpp, evtblkp, mode, 0);
+}
+
+/* as hfgens(); if 'async', on a worker thread for csoundFTGenAsync(), which
+   has already numbered the table: the new table is returned in *ftpp, but
+   not put in flist */
+static int hfgens_(CSOUND *csound, FUNC **ftpp, const EVTBLK *evtblkp,
+                   int mode, int async)
 {
     int32    genum, ltest;
     int     lobits, msg_enabled, i;
@@ -140,11 +181,9 @@ int hfgens(CSOUND *csound, FUNC **ftpp, const EVTBLK *evtblkp, int mode)
     int nonpowof2_flag=0; /* gab: fixed for non-powoftwo function tables*/
 
     *ftpp = NULL;
-    if (UNLIKELY(csound->gensub == NULL)) {
-      csound->gensub = (GEN*) csound->Malloc(csound, sizeof(GEN) * (GENMAX + 1));
-      memcpy(csound->gensub, or_sub, sizeof(GEN) * (GENMAX + 1));
-      csound->genmax = GENMAX + 1;
-    }
+    ff.async = async;
+    ff.newftp = NULL;
+    ftgens_init(csound);
     msg_enabled = csound->oparms->msglevel & 7;
     ff.csound = csound;
     memcpy((char*) &(ff.e), (char*) evtblkp,
@@ -156,11 +195,16 @@ int hfgens(CSOUND *csound, FUNC **ftpp, const EVTBLK *evtblkp, int mode)
       ff.fno = FTAB_SEARCH_BASE;
       do {                                      /*      or automatic number */
         ++ff.fno;
-      } while (ff.fno <= csound->maxfnum && csound->flist[ff.fno] != NULL);
+      } while ((ff.fno <= csound->maxfnum && csound->flist[ff.fno] != NULL) ||
+               ftasync_pending(csound, ff.fno));
       ff.e.p[1] = (MYFLT) (ff.fno);
     }
     else if (ff.fno < 0) {                      /*  fno < 0: remove         */
       ff.fno = -(ff.fno);
+      if (UNLIKELY(csound->ftgen_async != NULL) &&
+          ftasync_cancel(csound, ff.fno) &&
+          (ff.fno > csound->maxfnum || csound->flist[ff.fno] == NULL))
+        return 0;                               /*  was not made yet        */
       if (UNLIKELY(ff.fno > csound->maxfnum ||
                    (ftp = csound->flist[ff.fno]) == NULL)) {
         return fterror(&ff, Str("ftable does not exist"));
@@ -171,18 +215,8 @@ int hfgens(CSOUND *csound, FUNC **ftpp, const EVTBLK *evtblkp, int mode)
         csoundMessage(csound, Str("ftable %d now deleted\n"), ff.fno);
       return 0;
     }
-    if (UNLIKELY(ff.fno > csound->maxfnum)) {   /* extend list if necessary */
-      FUNC  **nn;
-      int   size;
-      for (size = csound->maxfnum; size < ff.fno; size += MAXFNUM)
-        ;
-      nn = (FUNC**) csound->ReAlloc(csound,
-                                    csound->flist, (size + 1) * sizeof(FUNC*));
-      csound->flist = nn;
-      for (i = csound->maxfnum + 1; i <= size; i++)
-        csound->flist[i] = NULL;                /*  Clear new section       */
-      csound->maxfnum = size;
-    }
+    if (!async)                                 /*  csoundFTGenAsync did it */
+      ftlist_extend(csound, ff.fno);
     if (UNLIKELY(ff.e.pcnt <= 4)) {             /*  chk minimum arg count   */
       return fterror(&ff, Str("insufficient gen arguments"));
     }
@@ -223,6 +257,11 @@ int hfgens(CSOUND *csound, FUNC **ftpp, const EVTBLK *evtblkp, int mode)
         return fterror(&ff, Str("illegal gen number"));
       }
     }
+    if (UNLIKELY(csound->ftgen_async != NULL) && !async) {
+      ftasync_cancel(csound, ff.fno);           /*  this one replaces it    */
+      if (!ftasync_safe(csound, genum))
+        ftasync_wait(csound, 0);                /*  may read pending tables */
+    }
     ff.flen = (int32) MYFLT2LRND(ff.e.p[3]);
     if (!ff.flen) {
       /* defer alloc to gen01|gen23|gen28 */
@@ -234,9 +273,10 @@ int hfgens(CSOUND *csound, FUNC **ftpp, const EVTBLK *evtblkp, int mode)
       if (UNLIKELY(msg_enabled))
         csoundMessage(csound, Str("ftable %d:\n"), ff.fno);
       i = (*csound->gensub[genum])(&ff, NULL);
-      ftp = csound->flist[ff.fno];
+      ftp = (async ? ff.newftp : csound->flist[ff.fno]);
       if (i != 0) {
-        csound->flist[ff.fno] = NULL;
+        if (!async)
+          csound->flist[ff.fno] = NULL;
         csound->Free(csound, ftp);
         return -1;
       }
@@ -288,7 +328,8 @@ int hfgens(CSOUND *csound, FUNC **ftpp, const EVTBLK *evtblkp, int mode)
     if (UNLIKELY(msg_enabled))
       csoundMessage(csound, Str("ftable %d:\n"), ff.fno);
     if ((*csound->gensub[genum])(&ff, ftp) != 0) {
-      csound->flist[ff.fno] = NULL;
+      if (!async)
+        csound->flist[ff.fno] = NULL;
       csound->Free(csound, ftp);
       return -1;
     }
@@ -383,6 +424,9 @@ int csoundFTDelete(CSOUND *csound, int tableNum)
     if (UNLIKELY((unsigned int) (tableNum - 1) >= (unsigned int) csound->maxfnum))
       return -1;
     ftp = csound->flist[tableNum];
+    if (UNLIKELY(csound->ftgen_async != NULL) &&
+        ftasync_cancel(csound, tableNum) && ftp == NULL)
+      return 0;                         /* deleted before it was made */
     if (UNLIKELY(ftp == NULL))
       return -1;
     csound->flist[tableNum] = NULL;
@@ -391,6 +435,356 @@ int csoundFTDelete(CSOUND *csound, int tableNum)
     return 0;
 }
 
+/* Asynchronous table generation.  csoundFTGenAsync() numbers the table and
+   queues a copy of the event; a worker runs the GEN into a table of its
+   own, and the perf thread installs it in flist between k-cycles, so no
+   opcode sees a table half made; an opcode that looks a pending table up
+   at i-time waits for that one table.  GENs that read other tables, draw
+   random numbers or make more than one table (GEN15), and GENs from
+   plugins, are made at once as before.  The workers share the list of
+   open files and the sample cache with the perf thread, under
+   FTASYNC.mutex. */
+
+#define FTASYNC_MAXTHREADS  4
+
+enum { FTJOB_QUEUED, FTJOB_RUNNING, FTJOB_DONE };
+
+typedef struct ftjob_s {
+    struct ftjob_s *nxt;
+    EVTBLK  e;                  /* with its own strarg and c.extra */
+    int     fno;
+    int     state;
+    int     cancelled;          /* replaced or deleted while running */
+    int     err;
+    FUNC    *ftp;
+} FTJOB;
+
+typedef struct {
+    void    *mutex;             /* recursive; guards jobs and the I/O */
+    void    *work, *done;       /* a job was queued / finished */
+    void    *thread[FTASYNC_MAXTHREADS];
+    int     nthreads, stop;
+    FTJOB   *jobs;              /* not yet installed, oldest first */
+    volatile int ndone;         /* jobs in state FTJOB_DONE */
+} FTASYNC;
+
+static int ftasync_safe(CSOUND *csound, int32 genum)
+{
+    if (genum < 1 || genum > GENMAX || csound->gensub[genum] != or_sub[genum])
+      return 0;
+    switch (genum) {
+    case 1: case 2: case 3: case 5: case 6: case 7: case 8: case 9:
+    case 10: case 11: case 12: case 13: case 14: case 16: case 17:
+    case 19: case 20: case 23: case 25: case 27: case 28:
+#ifndef NACL
+    case 49:
+#endif
+      return 1;
+    }
+    return 0;
+}
+
+static void ftjob_free(CSOUND *csound, FTJOB *job)
+{
+    if (job->ftp != NULL) {
+      csound->Free(csound, job->ftp->ftable);
+      csound->Free(csound, job->ftp);
+    }
+    if (job->e.pcnt > PMAX)
+      csound->Free(csound, job->e.c.extra);
+    csound->Free(csound, job->e.strarg);
+    csound->Free(csound, job);
+}
+
+static uintptr_t ftasync_worker(void *data)
+{
+    CSOUND  *csound = (CSOUND*) data;
+    FTASYNC *q = (FTASYNC*) csound->ftgen_async;
+    FTJOB   *job;
+
+    csoundLockMutex(q->mutex);
+    while (1) {
+      for (job = q->jobs; job != NULL; job = job->nxt)
+        if (job->state == FTJOB_QUEUED)
+          break;
+      if (job == NULL) {
+        if (q->stop)
+          break;
+        csoundCondWait(q->work, q->mutex);
+        continue;
+      }
+      job->state = FTJOB_RUNNING;
+      csoundUnlockMutex(q->mutex);
+      job->err = hfgens_(csound, &job->ftp, &job->e, 1, 1);
+      csoundLockMutex(q->mutex);
+      job->state = FTJOB_DONE;
+      ATOMIC_INCR(q->ndone);
+      csoundCondSignal(q->done);
+    }
+    csoundUnlockMutex(q->mutex);
+    return 0;
+}
+
+static int ftasync_stop(CSOUND *csound, void *userData)
+{
+    FTASYNC *q = (FTASYNC*) csound->ftgen_async;
+    FTJOB   *job;
+    int     i;
+
+    (void) userData;
+    if (q == NULL)
+      return OK;
+    csoundLockMutex(q->mutex);
+    q->stop = 1;
+    for (job = q->jobs; job != NULL; job = job->nxt)
+      if (job->state == FTJOB_QUEUED)
+        job->state = FTJOB_DONE;            /* not to be started */
+    for (i = 0; i < q->nthreads; i++)
+      csoundCondSignal(q->work);
+    csoundUnlockMutex(q->mutex);
+    for (i = 0; i < q->nthreads; i++)
+      csoundJoinThread(q->thread[i]);
+    while ((job = q->jobs) != NULL) {
+      q->jobs = job->nxt;
+      ftjob_free(csound, job);
+    }
+    csoundDestroyMutex(q->mutex);
+    free(q->work);
+    free(q->done);
+    csound->ftgen_async = NULL;
+    csound->Free(csound, q);
+    return OK;
+}
+
+static FTASYNC *ftasync_start(CSOUND *csound)
+{
+    FTASYNC *q = (FTASYNC*) csound->ftgen_async;
+    int     i, n;
+
+    if (q != NULL)
+      return q;
+    q = (FTASYNC*) csound->Calloc(csound, sizeof(FTASYNC));
+    q->mutex = csoundCreateMutex(1);
+    q->work = csoundCreateCondVar();
+    q->done = csoundCreateCondVar();
+    csound->ftgen_async = (void*) q;
+    n = csound->oparms->numThreads;
+    n = (n < 1 ? 1 : (n > FTASYNC_MAXTHREADS ? FTASYNC_MAXTHREADS : n));
+    for (i = 0; i < n; i++) {
+      if ((q->thread[q->nthreads] =
+           csoundCreateThread(ftasync_worker, (void*) csound)) != NULL)
+        q->nthreads++;
+    }
+    csound->RegisterResetCallback(csound, NULL, ftasync_stop);
+    return q;
+}
+
+/* drop the jobs for fno that are not installed yet; returns their count */
+static int ftasync_cancel(CSOUND *csound, int fno)
+{
+    FTASYNC *q = (FTASYNC*) csound->ftgen_async;
+    FTJOB   *job, **jp;
+    int     n = 0;
+
+    if (q == NULL)
+      return 0;
+    csoundLockMutex(q->mutex);
+    for (jp = &q->jobs; (job = *jp) != NULL; ) {
+      if (job->fno == fno && !job->cancelled) {
+        n++;
+        if (job->state == FTJOB_QUEUED) {
+          *jp = job->nxt;
+          ftjob_free(csound, job);
+          continue;
+        }
+        job->cancelled = 1;
+      }
+      jp = &(job->nxt);
+    }
+    csoundUnlockMutex(q->mutex);
+    return n;
+}
+
+static int ftasync_pending(CSOUND *csound, int fno)
+{
+    FTASYNC *q = (FTASYNC*) csound->ftgen_async;
+    FTJOB   *job;
+
+    if (q == NULL)
+      return 0;
+    csoundLockMutex(q->mutex);
+    for (job = q->jobs; job != NULL; job = job->nxt)
+      if (job->fno == fno && !job->cancelled)
+        break;
+    csoundUnlockMutex(q->mutex);
+    return (job != NULL);
+}
+
+static void ftasync_publish(CSOUND *csound, int fno);
+
+/* wait until table fno is made and install it, leaving other finished
+   tables to the k-cycle boundary; if fno is 0, wait for and install every
+   table, for a GEN that reads flist itself */
+static void ftasync_wait(CSOUND *csound, int fno)
+{
+    FTASYNC *q = (FTASYNC*) csound->ftgen_async;
+    FTJOB   *job;
+
+    if (q == NULL)
+      return;
+    csoundLockMutex(q->mutex);
+    while (1) {
+      for (job = q->jobs; job != NULL; job = job->nxt)
+        if ((fno == 0 || job->fno == fno) &&
+            !job->cancelled && job->state != FTJOB_DONE)
+          break;
+      if (job == NULL)
+        break;
+      csoundCondWait(q->done, q->mutex);
+    }
+    csoundUnlockMutex(q->mutex);
+    ftasync_publish(csound, fno);
+}
+
+static void ftasync_install(CSOUND *csound, int fno, FUNC *ftp)
+{
+    FUNC    *old = csound->flist[fno];
+
+    if (old != NULL) {
+      csound->Warning(csound, Str("replacing previous ftable %d"), fno);
+      if (old->flen == ftp->flen) {
+        /* same size: in place, as opcodes may hold the data pointer */
+        MYFLT *tmp = old->ftable;
+        memcpy(tmp, ftp->ftable, sizeof(MYFLT) * (ftp->flen + 1));
+        memcpy(old, ftp, sizeof(FUNC));
+        old->ftable = tmp;
+        csound->Free(csound, ftp->ftable);
+        csound->Free(csound, ftp);
+        ftp = old;
+      }
+      else {
+        if (UNLIKELY(csound->actanchor.nxtact != NULL))
+          csound->Warning(csound, Str("ftable %d relocating due to size change"
+                                      "\n         currently active instruments "
+                                      "may find this disturbing"), fno);
+        csound->Free(csound, old->ftable);
+        csound->Free(csound, old);
+        csound->flist[fno] = ftp;
+      }
+    }
+    else csound->flist[fno] = ftp;
+    ftdisplay(csound, ftp);
+}
+
+/* install the finished tables for fno, or all of them if fno is 0 */
+static void ftasync_publish(CSOUND *csound, int fno)
+{
+    FTASYNC *q = (FTASYNC*) csound->ftgen_async;
+    FTJOB   *job, **jp;
+
+    if (q == NULL || ATOMIC_GET(q->ndone) == 0)
+      return;
+    /* under the lock, as -realtime runs init passes on another thread */
+    csoundLockMutex(q->mutex);
+    for (jp = &q->jobs; (job = *jp) != NULL; ) {
+      if (job->state != FTJOB_DONE || (fno != 0 && job->fno != fno)) {
+        jp = &(job->nxt);
+        continue;
+      }
+      *jp = job->nxt;
+      ATOMIC_DECR(q->ndone);
+      if (job->err == 0 && !job->cancelled && job->ftp != NULL) {
+        ftasync_install(csound, job->fno, job->ftp);
+        job->ftp = NULL;
+      }
+      ftjob_free(csound, job);
+    }
+    csoundUnlockMutex(q->mutex);
+}
+
+void csoundFTAsyncPublish(CSOUND *csound)
+{
+    ftasync_publish(csound, 0);
+}
+
+int csoundFTGenAsync(CSOUND *csound, int *fno, const EVTBLK *evtblkp,
+                     int mode)
+{
+    FTASYNC *q;
+    FTJOB   *job, **jp;
+    FUNC    *ftp;
+    int32   genum;
+    int     n, err;
+
+    *fno = 0;
+    ftgens_init(csound);
+    n = (int) MYFLT2LRND(evtblkp->p[1]);
+    genum = (isstrcod(evtblkp->p[4]) ?
+             0 : labs((long) MYFLT2LRND(evtblkp->p[4])));
+    if (n < 0 || (n == 0 && !mode) || evtblkp->pcnt <= 4 ||
+        !ftasync_safe(csound, genum) ||
+        (q = ftasync_start(csound))->nthreads == 0) {
+      /* made now: deletions, GENs that need the perf thread */
+      err = hfgens_(csound, &ftp, evtblkp, mode, 0);
+      if (err == 0 && ftp != NULL)
+        *fno = (int) ftp->fno;
+      return err;
+    }
+    if (n == 0) {                           /* automatic number */
+      n = FTAB_SEARCH_BASE;
+      do {
+        ++n;
+      } while ((n <= csound->maxfnum && csound->flist[n] != NULL) ||
+               ftasync_pending(csound, n));
+    }
+    ftlist_extend(csound, n);
+    ftasync_cancel(csound, n);              /* this one replaces them */
+    job = (FTJOB*) csound->Calloc(csound, sizeof(FTJOB));
+    memcpy(&(job->e), evtblkp, sizeof(EVTBLK));
+    job->e.p[1] = (MYFLT) n;
+    if (evtblkp->strarg != NULL) {
+      job->e.strarg = (char*) csound->Malloc(csound,
+                                             strlen(evtblkp->strarg) + 1);
+      strcpy(job->e.strarg, evtblkp->strarg);
+    }
+    if (evtblkp->pcnt > PMAX) {
+      size_t size = sizeof(MYFLT) * ((int) evtblkp->c.extra[0] + 1);
+      job->e.c.extra = (MYFLT*) csound->Malloc(csound, size);
+      memcpy(job->e.c.extra, evtblkp->c.extra, size);
+    }
+    job->fno = n;
+    job->state = FTJOB_QUEUED;
+    csoundLockMutex(q->mutex);
+    for (jp = &q->jobs; *jp != NULL; jp = &((*jp)->nxt))
+      ;
+    *jp = job;
+    csoundCondSignal(q->work);
+    csoundUnlockMutex(q->mutex);
+    *fno = n;
+    return 0;
+}
+
+int csoundFTReady(CSOUND *csound, int fno)
+{
+    if (UNLIKELY(fno <= 0))
+      return -1;
+    if (ftasync_pending(csound, fno))
+      return 0;
+    return (fno <= csound->maxfnum && csound->flist[fno] != NULL ? 1 : -1);
+}
+
+void csoundFTAsyncLock(CSOUND *csound)
+{
+    if (UNLIKELY(csound->ftgen_async != NULL))
+      csoundLockMutex(((FTASYNC*) csound->ftgen_async)->mutex);
+}
+
+void csoundFTAsyncUnlock(CSOUND *csound)
+{
+    if (UNLIKELY(csound->ftgen_async != NULL))
+      csoundUnlockMutex(((FTASYNC*) csound->ftgen_async)->mutex);
+}
+
 /* read ftable values directly from p-args */
 
 static int gen02(FGDATA *ff, FUNC *ftp)
@@ -757,12 +1151,156 @@ static int gen08(FGDATA *ff, FUNC *ftp)
     return OK;
 }
 
+/* Additive GENs (09, 10, 11, 19) on large tables.  When every partial
+   makes a whole number of cycles over a table whose length is a power of
+   two, the partials are written as bins of a spectrum and the table is
+   made by one inverse FFT, O(flen log flen) rather than a sin() per point
+   per partial.  The result equals the direct sum to rounding: within
+   1e-12 (double builds; 1e-5 with floats) of the sum of the absolute
+   partial amplitudes.  Other tables (inharmonic partials, odd lengths)
+   are still summed point by point, split between the -j threads when
+   there is enough work. */
+
+#define ADDITIVE_FFT_MIN    1024        /* smaller tables are summed */
+#define ADDITIVE_THREAD_MIN (1 << 20)   /* points x partials per thread */
+#define ADDITIVE_FFT_MAXPARTS (1 << 22) /* GEN11 partials written as bins */
+
+typedef struct {
+    double  hno;        /* cycles per table length */
+    double  amp;
+    double  phs;        /* radians: amp * sin(hno * x + phs) + dc */
+    double  dc;
+} ADDPART;
+
+typedef struct {
+    const ADDPART *part;
+    int     cnt;
+    double  tpdlen;
+    MYFLT   *ftable;
+    int32   start, end;         /* points [start, end) */
+} ADDJOB;
+
+/* fill the table from its spectrum; returns 0 if it cannot */
+static int additive_fft(FGDATA *ff, FUNC *ftp, const ADDPART *part, int cnt)
+{
+    int32   flen = ff->flen, k;
+    double  half = 0.5 * (double) flen, re, im, dc = 0.0;
+    MYFLT   *buf = ftp->ftable;
+    int     i;
+
+    if (flen < ADDITIVE_FFT_MIN || (flen & (flen - 1)) != 0)
+      return 0;
+    for (i = 0; i < cnt; i++)
+      if (part[i].hno != floor(part[i].hno) || fabs(part[i].hno) > 2.0e9)
+        return 0;
+    memset(buf, 0, sizeof(MYFLT) * (flen + 1));
+    for (i = 0; i < cnt; i++) {
+      /* amp * sin(x + phs) = Re(C * exp(i * x)) */
+      re = part[i].amp * sin(part[i].phs);
+      im = -part[i].amp * cos(part[i].phs);
+      dc += part[i].dc;
+      k = (int32) fmod(part[i].hno, (double) flen);
+      if (k < 0)
+        k += flen;
+      if (k > flen / 2) {                   /* negative frequency */
+        k = flen - k;
+        im = -im;
+      }
+      if (k == 0)
+        buf[0] += (MYFLT) (re * (double) flen);
+      else if (k == flen / 2)
+        buf[1] += (MYFLT) (re * (double) flen);
+      else {
+        buf[k << 1] += (MYFLT) (re * half);
+        buf[(k << 1) + 1] += (MYFLT) (im * half);
+      }
+    }
+    buf[0] += (MYFLT) (dc * (double) flen);
+    csoundInverseRealFFT(ff->csound, buf, flen);
+    buf[flen] = buf[0];                     /* guard point */
+    return 1;
+}
+
+static void additive_sum(const ADDJOB *job)
+{
+    MYFLT   *fp, *finp = job->ftable + job->end;
+    double  phs, inc, amp, dc;
+    int     i;
+
+    for (i = 0; i < job->cnt; i++) {
+      inc = job->part[i].hno * job->tpdlen;
+      amp = job->part[i].amp;
+      dc = job->part[i].dc;
+      phs = job->part[i].phs;
+      if (job->start > 0) {
+        phs = fmod(phs + inc * (double) job->start, TWOPI);
+        if (phs < 0.0)
+          phs += TWOPI;
+      }
+      for (fp = job->ftable + job->start; fp < finp; fp++) {
+        *fp += (MYFLT) (sin(phs) * amp + dc);
+        if (UNLIKELY((phs += inc) >= TWOPI))
+          phs -= TWOPI;
+      }
+    }
+}
+
+static uintptr_t additive_thread(void *data)
+{
+    additive_sum((const ADDJOB*) data);
+    return 0;
+}
+
+/* threads worth using for cnt partials: at most -j, and at least
+   ADDITIVE_THREAD_MIN points x partials each */
+static int additive_nthreads(FGDATA *ff, int cnt)
+{
+    int     nthreads = ff->csound->oparms->numThreads;
+    double  work = (double) (ff->flen + 1) * cnt;
+
+    if (work < (double) nthreads * ADDITIVE_THREAD_MIN)
+      nthreads = (int) (work / ADDITIVE_THREAD_MIN);
+    if (nthreads > 16)
+      nthreads = 16;
+    return (nthreads < 1 ? 1 : nthreads);
+}
+
+/* sum the partials point by point, split between the threads */
+static void additive_threaded(FGDATA *ff, FUNC *ftp, const ADDPART *part,
+                              int cnt)
+{
+    int     nthreads = additive_nthreads(ff, cnt), i;
+    int32   npts = ff->flen + 1;
+    ADDJOB  job[16];
+    void    *thread[16];
+
+    for (i = 0; i < nthreads; i++) {
+      job[i].part = part;
+      job[i].cnt = cnt;
+      job[i].tpdlen = TWOPI / (double) ff->flen;
+      job[i].ftable = ftp->ftable;
+      job[i].start = (int32) ((int64_t) npts * i / nthreads);
+      job[i].end = (int32) ((int64_t) npts * (i + 1) / nthreads);
+    }
+    for (i = 1; i < nthreads; i++)
+      thread[i] = csoundCreateThread(additive_thread, &job[i]);
+    additive_sum(&job[0]);
+    for (i = 1; i < nthreads; i++)
+      csoundJoinThread(thread[i]);
+}
+
+static void additive_synth(FGDATA *ff, FUNC *ftp, const ADDPART *part,
+                           int cnt)
+{
+    if (!additive_fft(ff, ftp, part, cnt))
+      additive_threaded(ff, ftp, part, cnt);
+}
+
 static int gen09(FGDATA *ff, FUNC *ftp)
 {
-    int     hcnt;
-    MYFLT   *valp, *fp, *finp;
-    double  phs, inc, amp;
-    double  tpdlen = TWOPI / (double) ff->flen;
+    int     hcnt, cnt;
+    MYFLT   *valp;
+    ADDPART *part;
     CSOUND  *csound = ff->csound;
     int nsw = 1;
 
@@ -770,10 +1308,10 @@ static int gen09(FGDATA *ff, FUNC *ftp)
       csound->Warning(csound, Str("using extended arguments\n"));
     if ((hcnt = (ff->e.pcnt - 4) / 3) <= 0)         /* hcnt = nargs / 3 */
       return OK;
+    part = (ADDPART*) csound->Malloc(csound, hcnt * sizeof(ADDPART));
     valp = &ff->e.p[5];
-    finp = &ftp->ftable[ff->flen];
-    do {
-      inc = *(valp++) * tpdlen;
+    for (cnt = 0; cnt < hcnt; cnt++) {
+      part[cnt].hno = *(valp++);
       if (UNLIKELY(nsw && valp>&ff->e.p[PMAX])) {
 #ifdef BETA
         csound->DebugMsg(csound, "Switch to extra args\n");
@@ -781,7 +1319,7 @@ static int gen09(FGDATA *ff, FUNC *ftp)
         nsw = 0;                /* only switch once */
         valp = &(ff->e.c.extra[1]);
       }
-      amp = *(valp++);
+      part[cnt].amp = *(valp++);
       if (UNLIKELY(nsw && valp>&ff->e.p[PMAX])) {
 #ifdef BETA
         csound->DebugMsg(csound, "Switch to extra args\n");
@@ -789,7 +1327,7 @@ static int gen09(FGDATA *ff, FUNC *ftp)
         nsw = 0;                /* only switch once */
         valp = &(ff->e.c.extra[1]);
       }
-      phs = *(valp++) * tpd360;
+      part[cnt].phs = *(valp++) * tpd360;
       if (UNLIKELY(nsw && valp>&ff->e.p[PMAX])) {
 #ifdef BETA
         csound->DebugMsg(csound, "Switch to extra args\n");
@@ -797,12 +1335,10 @@ static int gen09(FGDATA *ff, FUNC *ftp)
         nsw = 0;                /* only switch once */
         valp = &(ff->e.c.extra[1]);
       }
-      for (fp = ftp->ftable; fp <= finp; fp++) {
-        *fp += (MYFLT) (sin(phs) * amp);
-        if (UNLIKELY((phs += inc) >= TWOPI))
-          phs -= TWOPI;
-      }
-    } while (--hcnt);
+      part[cnt].dc = 0.0;
+    }
+    additive_synth(ff, ftp, part, hcnt);
+    csound->Free(csound, part);
 
     return OK;
 }
@@ -814,25 +1350,79 @@ static int gen10(FGDATA *ff, FUNC *ftp)
     int32   flen = ff->flen;
     double  tpdlen = TWOPI / (double) flen;
     CSOUND  *csound = ff->csound;
+    ADDPART *part;
+    int     cnt = 0;
 
     if (UNLIKELY(ff->e.pcnt>=PMAX))
       csound->Warning(csound, Str("using extended arguments\n"));
     hcnt = ff->e.pcnt - 4;                              /* hcnt is nargs    */
-    finp = &ftp->ftable[flen];
+    if (hcnt <= 0)
+      return OK;
+    part = (ADDPART*) csound->Malloc(csound, hcnt * sizeof(ADDPART));
     do {
       MYFLT *valp = (hcnt+4>=PMAX ? &ff->e.c.extra[hcnt+5-PMAX] :
                                     &ff->e.p[hcnt + 4]);
-      if ((amp = *valp) != FL(0.0))         /* for non-0 amps,  */
-        for (phs = 0, fp = ftp->ftable; fp <= finp; fp++) {
-          *fp += (MYFLT) sin(phs * tpdlen) * amp;         /* accum sin pts    */
-          phs += hcnt;                                    /* phsinc is hno    */
-          phs %= flen;
-        }
+      if ((amp = *valp) != FL(0.0)) {       /* for non-0 amps,  */
+        part[cnt].hno = (double) hcnt;
+        part[cnt].amp = (double) amp;
+        part[cnt].phs = 0.0;
+        part[cnt++].dc = 0.0;
+      }
     } while (--hcnt);
+    if (cnt > 0 && !additive_fft(ff, ftp, part, cnt)) {
+      if (additive_nthreads(ff, cnt) > 1)
+        additive_threaded(ff, ftp, part, cnt);
+      else {
+        finp = &ftp->ftable[flen];
+        for (hcnt = 0; hcnt < cnt; hcnt++) {
+          amp = (MYFLT) part[hcnt].amp;
+          for (phs = 0, fp = ftp->ftable; fp <= finp; fp++) {
+            *fp += (MYFLT) sin(phs * tpdlen) * amp;       /* accum sin pts  */
+            phs += (int32) part[hcnt].hno;                /* phsinc is hno  */
+            phs %= flen;
+          }
+        }
+      }
+    }
+    csound->Free(csound, part);
 
     return OK;
 }
 
+/* GEN11 as a sum of n cosine partials from k with ratio r, made by the
+   inverse FFT on large power of two tables */
+static int gen11_fft(FGDATA *ff, FUNC *ftp, int n, int k, double r, int buzz)
+{
+    CSOUND  *csound = ff->csound;
+    ADDPART *part;
+    double  amp, absr, rtn;
+    int     i, done;
+
+    if (ff->flen < ADDITIVE_FFT_MIN || (ff->flen & (ff->flen - 1)) != 0
+        || n > ADDITIVE_FFT_MAXPARTS)
+      return 0;
+    if (buzz)
+      amp = 1.0 / n;
+    else {
+      rtn = intpow((MYFLT) r, (int32) n);
+      if ((absr = fabs(r)) > 0.999 && absr < 1.001)
+        amp = 1.0 / n;
+      else amp = (1.0 - absr) / (1.0 - fabs(rtn));
+    }
+    part = (ADDPART*) csound->Malloc(csound, n * sizeof(ADDPART));
+    for (i = 0; i < n; i++) {
+      part[i].hno = (double) (buzz ? i + 1 : k + i);
+      part[i].amp = amp;
+      part[i].phs = PI * 0.5;                   /* cosines */
+      part[i].dc = 0.0;
+      if (!buzz)
+        amp *= r;
+    }
+    done = additive_fft(ff, ftp, part, n);
+    csound->Free(csound, part);
+    return done;
+}
+
 static int gen11(FGDATA *ff, FUNC *ftp)
 {
     MYFLT   *fp, *finp;
@@ -851,6 +1441,9 @@ static int gen11(FGDATA *ff, FUNC *ftp)
       k = (int) ff->e.p[6];
     if (nargs > 2)
       r = ff->e.p[7];
+    if (gen11_fft(ff, ftp, n, k, (double) r,
+                  ff->e.pcnt == 5 || (k == 1 && r == FL(1.0))))
+      return OK;
     fp = ftp->ftable;
     finp = fp + ff->flen;
     if (ff->e.pcnt == 5 || (k == 1 && r == FL(1.0))) {  /* simple "buzz" case */
@@ -1204,9 +1797,9 @@ static int gen18(FGDATA *ff, FUNC *ftp)
 
 static int gen19(FGDATA *ff, FUNC *ftp)
 {
-    int     hcnt;
-    MYFLT   *valp, *fp, *finp;
-    double  phs, inc, amp, dc, tpdlen = TWOPI / (double) ff->flen;
+    int     hcnt, cnt;
+    MYFLT   *valp;
+    ADDPART *part;
     int     nargs = ff->e.pcnt - 4;
     CSOUND  *csound = ff->csound;
     int nsw = 1;
@@ -1215,27 +1808,24 @@ static int gen19(FGDATA *ff, FUNC *ftp)
       csound->Warning(csound, Str("using extended arguments\n"));
     if ((hcnt = nargs / 4) <= 0)                /* hcnt = nargs / 4 */
       return OK;
+    part = (ADDPART*) csound->Malloc(csound, hcnt * sizeof(ADDPART));
     valp = &ff->e.p[5];
-    finp = &ftp->ftable[ff->flen];
-    do {
-      inc = *(valp++) * tpdlen;
+    for (cnt = 0; cnt < hcnt; cnt++) {
+      part[cnt].hno = *(valp++);
       if (UNLIKELY(nsw && valp>=&ff->e.p[PMAX-1]))
         nsw =0, valp = &(ff->e.c.extra[1]);
-      amp = *(valp++);
+      part[cnt].amp = *(valp++);
       if (UNLIKELY(nsw && valp>=&ff->e.p[PMAX-1]))
         nsw =0, valp = &(ff->e.c.extra[1]);
-      phs = *(valp++) * tpd360;
+      part[cnt].phs = *(valp++) * tpd360;
       if (UNLIKELY(nsw && valp>=&ff->e.p[PMAX-1]))
         nsw =0, valp = &(ff->e.c.extra[1]);
-      dc = *(valp++);
+      part[cnt].dc = *(valp++);                 /* dc after str scale */
       if (UNLIKELY(nsw && valp>=&ff->e.p[PMAX-1]))
         nsw =0, valp = &(ff->e.c.extra[1]);
-      for (fp = ftp->ftable; fp <= finp; fp++) {
-        *fp += (MYFLT) (sin(phs) * amp + dc);   /* dc after str scale */
-        if ((phs += inc) >= TWOPI)
-          phs -= TWOPI;
-      }
-    } while (--hcnt);
+    }
+    additive_synth(ff, ftp, part, hcnt);
+    csound->Free(csound, part);
 
     return OK;
 }
@@ -2286,6 +2876,20 @@ CS_NOINLINE int fterror(const FGDATA *ff, const char *s, ...)
     return -1;
 }
 
+static void ftdisplay(CSOUND *csound, FUNC *ftp)
+{
+    WINDAT  dwindow;
+    char    strmsg[64];
+
+    if (!csound->oparms->displays)
+      return;
+    memset(&dwindow, 0, sizeof(WINDAT));
+    snprintf(strmsg, 64, Str("ftable %d:"), (int) ftp->fno);
+    dispset(csound, &dwindow, ftp->ftable, (int32) (ftp->flen),
+                    strmsg, 0, "ftable");
+    display(csound, &dwindow);
+}
+
 /* set guardpt, rescale the function, and display it */
 
 static CS_NOINLINE void ftresdisp(const FGDATA *ff, FUNC *ftp)
@@ -2293,8 +2897,6 @@ static CS_NOINLINE void ftresdisp(const FGDATA *ff, FUNC *ftp)
     CSOUND  *csound = ff->csound;
     MYFLT   *fp, *finp = &ftp->ftable[ff->flen];
     MYFLT   abs, maxval;
-    WINDAT  dwindow;
-    char    strmsg[64];
 
     if (!ff->guardreq)                      /* if no guardpt yet, do it */
       ftp->ftable[ff->flen] = ftp->ftable[0];
@@ -2309,13 +2911,8 @@ static CS_NOINLINE void ftresdisp(const FGDATA *ff, FUNC *ftp)
         for (fp=ftp->ftable; fp<=finp; fp++)
           *fp /= maxval;
     }
-    if (!csound->oparms->displays)
-      return;
-    memset(&dwindow, 0, sizeof(WINDAT));
-    snprintf(strmsg, 64, Str("ftable %d:"), (int) ff->fno);
-    dispset(csound, &dwindow, ftp->ftable, (int32) (ff->flen),
-                    strmsg, 0, "ftable");
-    display(csound, &dwindow);
+    if (!ff->async)                         /* else when installed */
+      ftdisplay(csound, ftp);
 }
 
 static void generate_sine_tab(CSOUND *csound)
@@ -2349,10 +2946,10 @@ static void generate_sine_tab(CSOUND *csound)
 /* alloc ftable space for fno (or replace one) */
 /*  set ftp to point to that structure         */
 
-static CS_NOINLINE FUNC *ftalloc(const FGDATA *ff)
+static CS_NOINLINE FUNC *ftalloc(FGDATA *ff)
 {
     CSOUND  *csound = ff->csound;
-    FUNC    *ftp = csound->flist[ff->fno];
+    FUNC    *ftp = (ff->async ? NULL : csound->flist[ff->fno]);
 
     if (UNLIKELY(ftp != NULL)) {
       csound->Warning(csound, Str("replacing previous ftable %d"), ff->fno);
@@ -2375,8 +2972,16 @@ static CS_NOINLINE FUNC *ftalloc(const FGDATA *ff)
       }
     }
     if (ftp == NULL) {                      /*   alloc space as reqd */
-      csound->flist[ff->fno] = ftp = (FUNC*) csound->Calloc(csound, sizeof(FUNC));
+      ftp = (FUNC*) csound->Calloc(csound, sizeof(FUNC));
       ftp->ftable = (MYFLT*) csound->Calloc(csound, (1+ff->flen) * sizeof(MYFLT));
+      if (ff->async) {                  /* replaces any earlier one */
+        if (ff->newftp != NULL) {
+          csound->Free(csound, ff->newftp->ftable);
+          csound->Free(csound, ff->newftp);
+        }
+        ff->newftp = ftp;
+      }
+      else csound->flist[ff->fno] = ftp;
     }
     ftp->fno = (int32) ff->fno;
     ftp->flen = ff->flen;
@@ -2392,6 +2997,8 @@ FUNC *csoundFTFind(CSOUND *csound, MYFLT *argp)
     int     fno;
 
     fno = MYFLT2LONG(*argp);
+    if (UNLIKELY(csound->ftgen_async != NULL) && fno > 0)
+      ftasync_wait(csound, fno);
     if (UNLIKELY(fno == -1)) {
       if (UNLIKELY(csound->sinetable==NULL)) generate_sine_tab(csound);
       return csound->sinetable;
@@ -2424,6 +3031,8 @@ FUNC *csoundFTFind2(CSOUND *csound, MYFLT *argp)
     int     fno;
 
     fno = MYFLT2LONG(*argp);
+    if (UNLIKELY(csound->ftgen_async != NULL) && fno > 0)
+      ftasync_wait(csound, fno);
     if (UNLIKELY(fno == -1)) {
       if (UNLIKELY(csound->sinetable==NULL)) generate_sine_tab(csound);
       return csound->sinetable;
@@ -2515,7 +3124,10 @@ FUNC *csoundFTFindP(CSOUND *csound, MYFLT *argp)
     if (UNLIKELY(fno <= 0                 ||
                  fno > csound->maxfnum    ||
                  (ftp = csound->flist[fno]) == NULL)) {
-      csound->ErrorMsg(csound, Str("Invalid ftable no. %f"), *argp);
+      if (UNLIKELY(csound->ftgen_async != NULL) && ftasync_pending(csound, fno))
+        csound->ErrorMsg(csound, Str("ftable %f is not ready"), *argp);
+      else
+        csound->ErrorMsg(csound, Str("Invalid ftable no. %f"), *argp);
       return NULL;
     }
     else if (UNLIKELY(!ftp->lenmask)) {
@@ -2536,6 +3148,9 @@ FUNC *csoundFTnp2Find(CSOUND *csound, MYFLT *argp)
     FUNC    *ftp;
     int     fno = MYFLT2LONG(*argp);
 
+    if (UNLIKELY(csound->ftgen_async != NULL) && fno > 0)
+      ftasync_wait(csound, fno);
+
     if (UNLIKELY(fno == -1)) {
       if (UNLIKELY(csound->sinetable==NULL)) generate_sine_tab(csound);
       return csound->sinetable;
@@ -2599,6 +3214,70 @@ static const int gen01_format_table[10] = {
     AE_FLOAT,   AE_UNCH,    AE_24INT,   AE_DOUBLE
 };
 
+/* as sndgetset(), for a file from the sample cache: the read starts at
+   frame *pos (negative for leading silence) */
+
+static int gen01_memfile_set(CSOUND *csound, SOUNDIN *p, SNDMEMFILE *smf,
+                             const SF_INFO *sfinfo, int64_t *pos)
+{
+    int64_t skipframes;
+
+    p->format = SF2FORMAT(sfinfo->format);
+    p->filetyp = SF2TYPE(sfinfo->format);
+    p->nchanls = smf->nChannels;
+    p->sr = (int) (smf->sampleRate + 0.5);
+    if (UNLIKELY(p->sr != (int) ((double) csound->esr + 0.5)))
+      csound->Warning(csound, "%s sr = %d, orch sr = %7.1f",
+                      smf->fullName, p->sr, csound->esr);
+    if (UNLIKELY(p->channel != ALLCHNLS && p->channel > p->nchanls)) {
+      csound->ErrorMsg(csound, Str("error: req chan %d, file %s has only %d"),
+                       (int) p->channel, smf->fullName, (int) p->nchanls);
+      return NOTOK;
+    }
+    skipframes = (int64_t) ((double) p->skiptime * (double) p->sr
+                            + (p->skiptime >= FL(0.0) ? 0.5 : -0.5));
+    if (UNLIKELY(-skipframes > (int64_t) (SNDINBUFSIZ / p->nchanls))) {
+      csound->ErrorMsg(csound, Str("soundin: invalid skip time"));
+      return NOTOK;
+    }
+    p->framesrem = (int64_t) smf->nFrames - skipframes;
+    p->audrem = p->framesrem * p->nchanls;
+    *pos = skipframes;
+    return OK;
+}
+
+/* as getsndin(), from a file in memory */
+
+static int gen01_memfile_read(CSOUND *csound, SNDMEMFILE *smf, MYFLT *fp,
+                              int nlocs, SOUNDIN *p, int64_t pos)
+{
+    int64_t nFrames = (int64_t) smf->nFrames;
+    int     nch = smf->nChannels, chn = 0, i, n = 0;
+    MYFLT   scalefac = csound->e0dbfs;
+
+    if ((p->format == AE_FLOAT || p->format == AE_DOUBLE) &&
+        !(p->filetyp == TYP_WAV || p->filetyp == TYP_AIFF ||
+          p->filetyp == TYP_W64))
+      scalefac = FL(1.0);
+    if (p->nchanls == 1 || p->channel == ALLCHNLS) {  /* MONO or ALLCHNLS */
+      int64_t j = pos * nch, end = nFrames * nch;
+      for (i = 0; i < nlocs && j < end; i++, j++)
+        fp[i] = (j < 0 ? FL(0.0) : (MYFLT) smf->data[j] * scalefac);
+      n = i;
+      p->audrem = end - j;
+    }
+    else {                                /* MULTI-CHANNEL, SELECT ONE */
+      chn = p->channel - 1;
+      for (i = 0; i < nlocs && pos < nFrames; i++, pos++)
+        fp[i] = (pos < 0 ? FL(0.0) :
+                 (MYFLT) smf->data[pos * nch + chn] * scalefac);
+      n = i;
+      p->audrem = (nFrames - pos) * nch;
+    }
+    memset(&(fp[n]), 0, (nlocs-n)*sizeof(MYFLT)); /* if incomplete PAD */
+    return n;
+}
+
 /* read ftable values from a sound file */
 /* stops reading when table is full     */
 
@@ -2607,7 +3286,10 @@ static int gen01raw(FGDATA *ff, FUNC *ftp)
     CSOUND  *csound = ff->csound;
     SOUNDIN *p;
     SOUNDIN tmpspace;
-    SNDFILE *fd;
+    SNDFILE *fd = NULL;
+    SNDMEMFILE *smf;
+    SF_INFO sfinfo;
+    int64_t smfpos = 0;
     int     truncmsg = 0;
     int32   inlocs = 0;
     int     def = 0, table_length = ff->flen + 1;
@@ -2666,7 +3348,18 @@ static int gen01raw(FGDATA *ff, FUNC *ftp)
     if (UNLIKELY(ff->flen == 0 && (csound->oparms->msglevel & 7))) {
       csoundMessage(csound, Str("deferred alloc for %s\n"), p->sfname);
     }
-    if (UNLIKELY((fd = sndgetset(csound, p))==NULL)) {
+    /* a file that fits the cache is decoded once and shared with other
+       GEN01 tables and diskin2; a larger one is read as before */
+    memset(&sfinfo, 0, sizeof(SF_INFO));
+    sfinfo.channels = 1;
+    sfinfo.samplerate = (int) ((double) csound->esr + 0.5);
+    if ((smf = csoundAcquireSoundFile(csound, p->sfname, &sfinfo, 1)) != NULL) {
+      if (UNLIKELY(gen01_memfile_set(csound, p, smf, &sfinfo, &smfpos) != OK)) {
+        csoundReleaseSoundFile(csound, smf);
+        return fterror(ff, Str("Failed to open file %s"), p->sfname);
+      }
+    }
+    else if (UNLIKELY((fd = sndgetset(csound, p))==NULL)) {
       /* sndinset to open the file  */
       return fterror(ff, Str("Failed to open file %s"), p->sfname);
     }
@@ -2700,7 +3393,12 @@ static int gen01raw(FGDATA *ff, FUNC *ftp)
     ftp->cvtbas = LOFACT * p->sr * csound->onedsr;
     {
       SF_INSTRUMENT lpd;
-      int ans = sf_command(fd, SFC_GET_INSTRUMENT, &lpd, sizeof(SF_INSTRUMENT));
+      int ans;
+      if (smf != NULL) {
+        ans = csoundSoundFileInstrument(smf, &lpd);
+      }
+      else
+        ans = sf_command(fd, SFC_GET_INSTRUMENT, &lpd, sizeof(SF_INSTRUMENT));
       if (ans) {
         double natcps;
 #ifdef BETA
@@ -2763,7 +3461,11 @@ static int gen01raw(FGDATA *ff, FUNC *ftp)
     }
     /* read sound with opt gain */
 
-    if (UNLIKELY((inlocs=getsndin(csound, fd, ftp->ftable, table_length, p)) < 0)) {
+    if (smf != NULL)
+      inlocs = gen01_memfile_read(csound, smf, ftp->ftable, table_length, p,
+                                  smfpos);
+    else if (UNLIKELY((inlocs=getsndin(csound, fd, ftp->ftable,
+                                       table_length, p)) < 0)) {
       return fterror(ff, Str("GEN1 read error"));
     }
 
@@ -2775,7 +3477,10 @@ static int gen01raw(FGDATA *ff, FUNC *ftp)
       needsiz(csound, ff, p->framesrem);     /* ????????????  */
     }
     ftp->soundend = inlocs / ftp->nchanls;   /* record end of sound samps */
-    csound->FileClose(csound, p->fd);
+    if (smf != NULL)
+      csoundReleaseSoundFile(csound, smf);
+    else
+      csound->FileClose(csound, p->fd);
     if (def) {
       MYFLT *tab = ftp->ftable;
       ftresdisp(ff, ftp);       /* VL: 11.01.05  for deferred alloc tables */
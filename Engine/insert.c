@@ -1023,18 +1023,27 @@ void free_instr_var_memory(CSOUND* csound, INSDS* ip) {
 }
 
 void orcompact(CSOUND *csound)          /* free all inactive instr spaces */
-{
+{                                       /*   beyond each instr's prealloc */
   INSTRTXT  *txtp;
   INSDS     *ip, *nxtip, *prvip, **prvnxtloc;
   int       cnt = 0;
   for (txtp = &(csound->engineState.instxtanchor);
        txtp != NULL;  txtp = txtp->nxtinstxt) {
+    int     keep = txtp->prealloc;
+    INSDS   *freechain = NULL;
     if ((ip = txtp->instance) != NULL) {        /* if instance exists */
 
       prvip = NULL;
       prvnxtloc = &txtp->instance;
       do {
-        if (!ip->actflg) {
+        if (!ip->actflg && keep > 0) {          /* keep for reuse */
+          keep--;
+          ip->nxtact = freechain;
+          freechain = ip;
+          prvip = ip;
+          prvnxtloc = &ip->nxtinstance;
+        }
+        else if (!ip->actflg) {
           cnt++;
           if (ip->opcod_iobufs && ip->insno > csound->engineState.maxinsno)
             csound->Free(csound, ip->opcod_iobufs);   /* IV - Nov 10 2002 */
@@ -1065,7 +1074,7 @@ void orcompact(CSOUND *csound)          /* free all inactive instr spaces */
       txtp->lst_instance = ip;
     }
 
-    txtp->act_instance = NULL;                /* no free instances */
+    txtp->act_instance = freechain;           /* only those kept */
   }
   /* check current items in deadpool to see if they need deleting */
   {
@@ -1364,6 +1373,54 @@ int subinstrset(CSOUND *csound, SUBINST *p){
 */
 int useropcd1(CSOUND *, UOPCODE*), useropcd2(CSOUND *, UOPCODE*);
 
+/* Resolve one argument of a UDO call into a copy from src to dst.
+   i-time arguments are copied by xin/xout only and get no entry. */
+static int udo_plan_arg(UDO_ARGCOPY *c, CS_VARIABLE *var,
+                        void *src, void *dst)
+{
+  if (var->varType == &CS_VAR_TYPE_I ||
+      var->varType == &CS_VAR_TYPE_b ||
+      var->subType == &CS_VAR_TYPE_I ||
+      src == NULL || dst == NULL)
+    return 0;
+  c->src = src;
+  c->dst = dst;
+  c->type = var->varType;
+  if (var->varType == &CS_VAR_TYPE_K)
+    c->kind = UDO_COPY_K;
+  else if (var->varType == &CS_VAR_TYPE_A)
+    c->kind = UDO_COPY_A;
+  else if (var->varType == &CS_VAR_TYPE_ARRAY &&
+           var->subType == &CS_VAR_TYPE_A)
+    c->kind = UDO_COPY_AARR;
+  else
+    c->kind = UDO_COPY_VALUE;
+  return 1;
+}
+
+/* Compile the perf-time argument copies of a UDO call into flat lists,
+   once xin and xout have recorded where the UDO keeps its arguments,
+   so that useropcd1() and useropcd2() do not walk the arg pools. */
+static void udo_plan(UOPCODE *p)
+{
+  OPCOD_IOBUFS *buf = p->buf;
+  OPCODINFO    *inm = buf->opcode_info;
+  CS_VARIABLE  *current;
+  int i, n;
+
+  current = inm->in_arg_pool->head;
+  for (i = n = 0; i < inm->inchns; i++, current = current->next)
+    n += udo_plan_arg(&buf->in_plan[n], current,
+                      p->ar[i + inm->outchns],
+                      buf->iobufp_ptrs[i + inm->outchns]);
+  buf->in_cnt = n;
+  current = inm->out_arg_pool->head;
+  for (i = n = 0; i < inm->outchns; i++, current = current->next)
+    n += udo_plan_arg(&buf->out_plan[n], current,
+                      buf->iobufp_ptrs[i], p->ar[i]);
+  buf->out_cnt = n;
+}
+
 int useropcdset(CSOUND *csound, UOPCODE *p)
 {
   OPDS         *saved_ids = csound->ids;
@@ -1514,6 +1571,7 @@ int useropcdset(CSOUND *csound, UOPCODE *p)
     (*csound->ids->iopadr)(csound, csound->ids);
     csound->ids = csound->ids->nxti;
   }
+  udo_plan(p);          /* xin and xout have now run */
   ATOMIC_SET(p->ip->init_done, 1);
   /* copy length related parameters back to caller instr */
   parent_ip->relesing = lcurip->relesing;
@@ -1776,6 +1834,7 @@ int subinstr(CSOUND *csound, SUBINST *p)
   unsigned int nsmps = CS_KSMPS;
   INSDS *ip = p->ip;
   int done = ATOMIC_GET(p->ip->init_done);
+  int saved_spoutactive = csound->spoutactive;
 
   if (UNLIKELY(!done)) /* init not done, exit */
     return OK;
@@ -1863,6 +1922,8 @@ int subinstr(CSOUND *csound, SUBINST *p)
   }
   endin:
   CS_PDS = saved_pds;
+  /* the subinstrument wrote to its own buffer, not to spraw */
+  csound->spoutactive = saved_spoutactive;
   /* check if instrument was deactivated (e.g. by perferror) */
   if (!p->ip) {                                  /* loop to last opds */
     while (CS_PDS->nxtp) {
@@ -1872,17 +1933,97 @@ int subinstr(CSOUND *csound, SUBINST *p)
   return OK;
 }
 
+/* number of a-signals in an array */
+static inline int aarr_count(const ARRAYDAT *a)
+{
+  int j, count = a->sizes[0];
+  for (j = 1; j < a->dimensions; j++)
+    count *= a->sizes[j];
+  return count;
+}
+
+/* copy n samples of each member of an a-signal array */
+static void aarr_copy(const ARRAYDAT *src, int src_ofs,
+                      ARRAYDAT *dst, int dst_ofs, uint32_t n)
+{
+  int j, count = aarr_count(src);
+  int stride = src->arrayMemberSize / sizeof(MYFLT);
+  for (j = 0; j < count; j++)
+    memcpy(dst->data + j * stride + dst_ofs,
+           src->data + j * stride + src_ofs, sizeof(MYFLT) * n);
+}
+
+/* Run a copy plan; a-signals are nsmps long at both ends (useropcd2) */
+static inline void udo_copy(CSOUND *csound, const UDO_ARGCOPY *c, int cnt,
+                            uint32_t nsmps)
+{
+  for ( ; cnt > 0; c++, cnt--) {
+    switch (c->kind) {
+    case UDO_COPY_K:
+      *(MYFLT*) c->dst = *(MYFLT*) c->src;
+      break;
+    case UDO_COPY_A:
+      memcpy(c->dst, c->src, sizeof(MYFLT) * nsmps);
+      break;
+    default:
+      c->type->copyValue(csound, c->dst, c->src);
+    }
+  }
+}
+
+/* Inputs of one local k-cycle of useropcd1(): n samples from sample ofs
+   of the caller's a-signals, and all of the other perf-time args */
+static inline void udo_copy_in(CSOUND *csound, const OPCOD_IOBUFS *buf,
+                               int ofs, uint32_t n)
+{
+  const UDO_ARGCOPY *c = buf->in_plan, *end = c + buf->in_cnt;
+  for ( ; c < end; c++) {
+    switch (c->kind) {
+    case UDO_COPY_K:
+      *(MYFLT*) c->dst = *(MYFLT*) c->src;
+      break;
+    case UDO_COPY_A:
+      memcpy(c->dst, (MYFLT*) c->src + ofs, sizeof(MYFLT) * n);
+      break;
+    case UDO_COPY_AARR:
+      aarr_copy((ARRAYDAT*) c->src, ofs, (ARRAYDAT*) c->dst, 0, n);
+      break;
+    default:
+      c->type->copyValue(csound, c->dst, c->src);
+    }
+  }
+}
+
+/* a-signal outputs of one local k-cycle of useropcd1(), to sample ofs */
+static inline void udo_copy_out_asig(const OPCOD_IOBUFS *buf,
+                                     int ofs, uint32_t n)
+{
+  const UDO_ARGCOPY *c = buf->out_plan, *end = c + buf->out_cnt;
+  for ( ; c < end; c++) {
+    if (c->kind == UDO_COPY_A)
+      memcpy((MYFLT*) c->dst + ofs, c->src, sizeof(MYFLT) * n);
+    else if (c->kind == UDO_COPY_AARR)
+      aarr_copy((ARRAYDAT*) c->src, 0, (ARRAYDAT*) c->dst, ofs, n);
+  }
+}
+
+/* clear the first offset and the last early samples of an a-signal */
+static inline void asig_clear_edges(MYFLT *out, int offset, int early,
+                                    int g_ksmps)
+{
+  if (offset) memset(out, '\0', sizeof(MYFLT) * offset);
+  if (early) memset(out + g_ksmps, '\0', sizeof(MYFLT) * early);
+}
+
 /* IV - Sep 17 2002 -- case 1: local ksmps is used */
 
 int useropcd1(CSOUND *csound, UOPCODE *p)
 {
   OPDS    *saved_pds = CS_PDS;
-  int    g_ksmps, ofs, early, offset, i;
-  OPCODINFO   *inm;
-  CS_VARIABLE* current;
+  int    g_ksmps, ofs, early, offset;
+  OPCOD_IOBUFS *buf = p->buf;
+  const UDO_ARGCOPY *c, *end;
   INSDS    *this_instr = p->ip;
-  MYFLT** internal_ptrs = p->buf->iobufp_ptrs;
-  MYFLT** external_ptrs = p->ar;
   int done;
 
   done = ATOMIC_GET(p->ip->init_done);
@@ -1894,7 +2035,6 @@ int useropcd1(CSOUND *csound, UOPCODE *p)
   offset = p->h.insdshead->ksmps_offset;
   p->ip->spin = p->parent_ip->spin;
   p->ip->spout = p->parent_ip->spout;
-  inm = p->buf->opcode_info;
 
   /* global ksmps is the caller instr ksmps minus sample-accurate end */
   g_ksmps = CS_KSMPS - early;
@@ -1912,45 +2052,7 @@ int useropcd1(CSOUND *csound, UOPCODE *p)
   if (this_instr->ksmps == 1) {           /* special case for local kr == sr */
     do {
       /* copy inputs */
-      current = inm->in_arg_pool->head;
-      for (i = 0; i < inm->inchns; i++) {
-        // this hardcoded type check for non-perf time vars needs to change
-        //to use generic code...
-        // skip a-vars for now, handle uniquely within performance loop
-        if (current->varType != &CS_VAR_TYPE_I &&
-            current->varType != &CS_VAR_TYPE_b &&
-            current->varType != &CS_VAR_TYPE_A &&
-            current->subType != &CS_VAR_TYPE_I &&
-            current->subType != &CS_VAR_TYPE_A) {
-          // This one checks if an array has a subtype of 'i'
-          void* in = (void*)external_ptrs[i + inm->outchns];
-          void* out = (void*)internal_ptrs[i + inm->outchns];
-          current->varType->copyValue(csound, out, in);
-        } else if (current->varType == &CS_VAR_TYPE_A) {
-          MYFLT* in = (void*)external_ptrs[i + inm->outchns];
-          MYFLT* out = (void*)internal_ptrs[i + inm->outchns];
-          *out = *(in + ofs);
-        } else if (current->varType == &CS_VAR_TYPE_ARRAY &&
-                   current->subType == &CS_VAR_TYPE_A) {
-          ARRAYDAT* src = (ARRAYDAT*)external_ptrs[i + inm->outchns];
-          ARRAYDAT* target = (ARRAYDAT*)internal_ptrs[i + inm->outchns];
-          int count = src->sizes[0];
-          int j;
-          if (src->dimensions > 1) {
-            for (j = 0; j < src->dimensions; j++) {
-              count *= src->sizes[j];
-            }
-          }
-
-          for (j = 0; j < count; j++) {
-            int memberOffset = j * (src->arrayMemberSize / sizeof(MYFLT));
-            MYFLT* in = src->data + memberOffset;
-            MYFLT* out = target->data + memberOffset;
-            *out = *(in + ofs);
-          }
-        }
-        current = current->next;
-      }
+      udo_copy_in(csound, buf, ofs, 1);
 
       if ((CS_PDS = (OPDS *) (this_instr->nxtp)) != NULL) {
         int error = 0;
@@ -1968,35 +2070,7 @@ int useropcd1(CSOUND *csound, UOPCODE *p)
       }
 
       /* copy a-sig outputs, accounting for offset */
-      current = inm->out_arg_pool->head;
-      for (i = 0; i < inm->outchns; i++) {
-        if (current->varType == &CS_VAR_TYPE_A) {
-          MYFLT* in = (void*)internal_ptrs[i];
-          MYFLT* out = (void*)external_ptrs[i];
-          *(out + ofs) = *in;
-        } else if (current->varType == &CS_VAR_TYPE_ARRAY &&
-                   current->subType == &CS_VAR_TYPE_A) {
-          ARRAYDAT* src = (ARRAYDAT*)internal_ptrs[i];
-          ARRAYDAT* target = (ARRAYDAT*)external_ptrs[i];
-          int count = src->sizes[0];
-          int j;
-          if (src->dimensions > 1) {
-            for (j = 0; j < src->dimensions; j++) {
-              count *= src->sizes[j];
-            }
-          }
-
-          for (j = 0; j < count; j++) {
-            int memberOffset = j * (src->arrayMemberSize / sizeof(MYFLT));
-            MYFLT* in = src->data + memberOffset;
-            MYFLT* out = target->data + memberOffset;
-            *(out + ofs) = *in;
-          }
-        }
-
-        current = current->next;
-      }
-
+      udo_copy_out_asig(buf, ofs, 1);
 
       this_instr->kcounter++;
       this_instr->spout += csound->nchnls;
@@ -2020,47 +2094,8 @@ int useropcd1(CSOUND *csound, UOPCODE *p)
     if (UNLIKELY(early)) this_instr->ksmps_no_end = early % lksmps;
 
     do {
-      /* copy a-sig inputs, accounting for offset */
-      size_t asigSize = (this_instr->ksmps * sizeof(MYFLT));
-      current = inm->in_arg_pool->head;
-      for (i = 0; i < inm->inchns; i++) {
-        // this hardcoded type check for non-perf time vars needs to change
-        // to use generic code...
-        // skip a-vars for now, handle uniquely within performance loop
-        if (current->varType != &CS_VAR_TYPE_I &&
-            current->varType != &CS_VAR_TYPE_b &&
-            current->varType != &CS_VAR_TYPE_A &&
-            current->subType != &CS_VAR_TYPE_I &&
-            current->subType != &CS_VAR_TYPE_A) {
-          // This one checks if an array has a subtype of 'i'
-          void* in = (void*)external_ptrs[i + inm->outchns];
-          void* out = (void*)internal_ptrs[i + inm->outchns];
-          current->varType->copyValue(csound, out, in);
-        } else if (current->varType == &CS_VAR_TYPE_A) {
-          MYFLT* in = (void*)external_ptrs[i + inm->outchns];
-          MYFLT* out = (void*)internal_ptrs[i + inm->outchns];
-          memcpy(out, in + ofs, asigSize);
-        } else if (current->varType == &CS_VAR_TYPE_ARRAY &&
-                   current->subType == &CS_VAR_TYPE_A) {
-          ARRAYDAT* src = (ARRAYDAT*)external_ptrs[i + inm->outchns];
-          ARRAYDAT* target = (ARRAYDAT*)internal_ptrs[i + inm->outchns];
-          int count = src->sizes[0];
-          int j;
-          if (src->dimensions > 1) {
-            for (j = 0; j < src->dimensions; j++) {
-              count *= src->sizes[j];
-            }
-          }
-
-          for (j = 0; j < count; j++) {
-            int memberOffset = j * (src->arrayMemberSize / sizeof(MYFLT));
-            MYFLT* in = src->data + memberOffset;
-            MYFLT* out = target->data + memberOffset;
-            memcpy(out, in + ofs, asigSize);
-          }
-        }
-        current = current->next;
-      }
+      /* copy inputs, a-sigs accounting for offset */
+      udo_copy_in(csound, buf, ofs, lksmps);
 
       /*  run each opcode  */
       if ((CS_PDS = (OPDS *) (this_instr->nxtp)) != NULL) {
@@ -2079,35 +2114,7 @@ int useropcd1(CSOUND *csound, UOPCODE *p)
       }
 
       /* copy a-sig outputs, accounting for offset */
-      current = inm->out_arg_pool->head;
-      for (i = 0; i < inm->outchns; i++) {
-        if (current->varType == &CS_VAR_TYPE_A) {
-          MYFLT* in = (void*)internal_ptrs[i];
-          MYFLT* out = (void*)external_ptrs[i];
-          memcpy(out + ofs, in, asigSize);
-        } else if (current->varType == &CS_VAR_TYPE_ARRAY &&
-                   current->subType == &CS_VAR_TYPE_A) {
-          ARRAYDAT* src = (ARRAYDAT*)internal_ptrs[i];
-          ARRAYDAT* target = (ARRAYDAT*)external_ptrs[i];
-          int count = src->sizes[0];
-          int j;
-          if (src->dimensions > 1) {
-            for (j = 0; j < src->dimensions; j++) {
-              count *= src->sizes[j];
-            }
-          }
-
-          for (j = 0; j < count; j++) {
-            int memberOffset = j * (src->arrayMemberSize / sizeof(MYFLT));
-            MYFLT* in = src->data + memberOffset;
-            MYFLT* out = target->data + memberOffset;
-            memcpy(out + ofs, in, asigSize);
-          }
-
-        }
-
-        current = current->next;
-      }
+      udo_copy_out_asig(buf, ofs, lksmps);
 
       this_instr->spout += csound->nchnls*lksmps;
       this_instr->spin  += csound->nchnls*lksmps;
@@ -2115,62 +2122,25 @@ int useropcd1(CSOUND *csound, UOPCODE *p)
     } while ((ofs += this_instr->ksmps) < g_ksmps);
   }
 
-
   /* copy outputs */
-  current = inm->out_arg_pool->head;
-  for (i = 0; i < inm->outchns; i++) {
-    // this hardcoded type check for non-perf time vars needs to change
-    // to use generic code...
-    if (current->varType != &CS_VAR_TYPE_I &&
-        current->varType != &CS_VAR_TYPE_b &&
-        current->subType != &CS_VAR_TYPE_I) {
-      void* in = (void*)internal_ptrs[i];
-      void* out = (void*)external_ptrs[i];
-
-      if (current->varType == &CS_VAR_TYPE_A) {
-        /* clear the beginning portion of outputs for sample accurate end */
-        if (offset) {
-          memset(out, '\0', sizeof(MYFLT) * offset);
-        }
-
-        /* clear the end portion of outputs for sample accurate end */
-        if (early) {
-          memset((char*)out + g_ksmps, '\0', sizeof(MYFLT) * early);
-        }
-      } else if (current->varType == &CS_VAR_TYPE_ARRAY &&
-                 current->subType == &CS_VAR_TYPE_A) {
-        if (offset || early) {
-          ARRAYDAT* outDat = (ARRAYDAT*)out;
-          int count = outDat->sizes[0];
-          int j;
-          if (outDat->dimensions > 1) {
-            for (j = 0; j < outDat->dimensions; j++) {
-              count *= outDat->sizes[j];
-            }
-          }
-
-          if (offset) {
-            for (j = 0; j < count; j++) {
-              int memberOffset = j * (outDat->arrayMemberSize / sizeof(MYFLT));
-              MYFLT* outMem = outDat->data + memberOffset;
-              memset(outMem, '\0', sizeof(MYFLT) * offset);
-            }
-          }
-
-          if (early) {
-            for (j = 0; j < count; j++) {
-              int memberOffset = j * (outDat->arrayMemberSize / sizeof(MYFLT));
-              MYFLT* outMem = outDat->data + memberOffset;
-              memset(outMem + g_ksmps, '\0', sizeof(MYFLT) * early);
-            }
-          }
-        }
-
-      } else {
-        current->varType->copyValue(csound, out, in);
+  for (c = buf->out_plan, end = c + buf->out_cnt; c < end; c++) {
+    if (c->kind == UDO_COPY_A) {
+      /* clear the portions of outputs outside the sample-accurate span */
+      asig_clear_edges((MYFLT*) c->dst, offset, early, g_ksmps);
+    }
+    else if (c->kind == UDO_COPY_AARR) {
+      if (offset || early) {
+        ARRAYDAT *outDat = (ARRAYDAT*) c->dst;
+        int j, count = aarr_count(outDat);
+        int stride = outDat->arrayMemberSize / sizeof(MYFLT);
+        for (j = 0; j < count; j++)
+          asig_clear_edges(outDat->data + j * stride, offset, early, g_ksmps);
       }
     }
-    current = current->next;
+    else if (c->kind == UDO_COPY_K)
+      *(MYFLT*) c->dst = *(MYFLT*) c->src;
+    else
+      c->type->copyValue(csound, c->dst, c->src);
   }
  endop:
   CS_PDS = saved_pds;
@@ -2185,13 +2155,10 @@ int useropcd1(CSOUND *csound, UOPCODE *p)
 int useropcd2(CSOUND *csound, UOPCODE *p)
 {
   OPDS    *saved_pds = CS_PDS;
-  MYFLT   **tmp;
   INSDS    *this_instr = p->ip;
-  OPCODINFO   *inm;
-  CS_VARIABLE* current;
-  int i, done;
+  OPCOD_IOBUFS *buf;
+  int done;
 
-  inm = (OPCODINFO*) p->h.optext->t.oentry->useropinfo;
   done = ATOMIC_GET(p->ip->init_done);
 
   if (UNLIKELY(!done)) /* init not done, exit */
@@ -2206,31 +2173,10 @@ int useropcd2(CSOUND *csound, UOPCODE *p)
 
   /* IV - Nov 16 2002: update release flag */
   p->ip->relesing = p->parent_ip->relesing;
-  tmp = p->buf->iobufp_ptrs;
-  inm = p->buf->opcode_info;
-
-  MYFLT** internal_ptrs = tmp;
-  MYFLT** external_ptrs = p->ar;
+  buf = p->buf;
 
   /* copy inputs */
-  current = inm->in_arg_pool->head;
-  for (i = 0; i < inm->inchns; i++) {
-    // this hardcoded type check for non-perf time vars needs to
-    //change to use generic code...
-    if (current->varType != &CS_VAR_TYPE_I &&
-        current->varType != &CS_VAR_TYPE_b &&
-        current->subType != &CS_VAR_TYPE_I) {
-      if (current->varType == &CS_VAR_TYPE_A && CS_KSMPS == 1) {
-        *internal_ptrs[i + inm->outchns] = *external_ptrs[i + inm->outchns];
-      } else {
-        void* in = (void*)external_ptrs[i + inm->outchns];
-        void* out = (void*)internal_ptrs[i + inm->outchns];
-        current->varType->copyValue(csound, out, in);
-        //                memcpy(out, in, p->buf->in_arg_sizes[i]);
-      }
-    }
-    current = current->next;
-  }
+  udo_copy(csound, buf->in_plan, buf->in_cnt, CS_KSMPS);
 
   /*  run each opcode  */
   {
@@ -2250,24 +2196,7 @@ int useropcd2(CSOUND *csound, UOPCODE *p)
   this_instr->kcounter++;
 
   /* copy outputs */
-  current = inm->out_arg_pool->head;
-  for (i = 0; i < inm->outchns; i++) {
-    // this hardcoded type check for non-perf time vars needs to change to
-    // use generic code...
-    if (current->varType != &CS_VAR_TYPE_I &&
-        current->varType != &CS_VAR_TYPE_b &&
-        current->subType != &CS_VAR_TYPE_I) {
-      if (current->varType == &CS_VAR_TYPE_A && CS_KSMPS == 1) {
-        *external_ptrs[i] = *internal_ptrs[i];
-      } else {
-        void* in = (void*)internal_ptrs[i];
-        void* out = (void*)external_ptrs[i];
-        //            memcpy(out, in, p->buf->out_arg_sizes[i]);
-        current->varType->copyValue(csound, out, in);
-      }
-    }
-    current = current->next;
-  }
+  udo_copy(csound, buf->out_plan, buf->out_cnt, CS_KSMPS);
 
  endop:
 
@@ -2302,12 +2231,92 @@ int findLabelMemOffset(CSOUND* csound, INSTRTXT* ip, char* labelName) {
   return offset;
 }
 
-/* create instance of an instr template */
-/*   allocates and sets up all pntrs    */
+/* Offsets of the pointers instance() stores in an instance block that
+   point back into the same block.  They are recorded the first time an
+   instrument is built, together with an image of the finished block,
+   so that further instances are a copy of the image with these
+   pointers moved, instead of a rebuild (see instance_clone()).
+*/
+typedef struct {
+  int32 *off;
+  int   n, size;
+} INIT_RELOC;
 
-static void instance(CSOUND *csound, int insno)
+static void init_reloc(CSOUND *csound, INIT_RELOC *rl, INSDS *ip, void *field)
+{
+  if (rl->n == rl->size) {
+    rl->size = rl->size ? rl->size * 2 : 64;
+    rl->off = (int32 *) csound->ReAlloc(csound, rl->off,
+                                        rl->size * sizeof(int32));
+  }
+  rl->off[rl->n++] = (int32) ((char *) field - (char *) ip);
+}
+
+/* initialise local variables of a new instance */
+static void instance_vars(CSOUND *csound, INSTRTXT *tp, MYFLT *lclbas)
+{
+  CS_VARIABLE* current;
+
+  initializeVarPool((void *)csound, lclbas, tp->varPool);
+  /* initialize vars for CS_TYPE */
+  for (current = tp->varPool->head; current != NULL; current = current->next) {
+    char* ptr = (char*)(lclbas + current->memBlockIndex);
+    CS_TYPE** typePtr = (CS_TYPE**)(ptr - CS_VAR_TYPE_OFFSET);
+    *typePtr = current->varType;
+  }
+}
+
+/* keep the finished block as the instrument's init image, with its
+   inner pointers stored as offsets and its variables left to be
+   initialised afresh */
+static void instance_image(CSOUND *csound, INSTRTXT *tp, INSDS *ip,
+                           size_t size, INIT_RELOC *rl)
+{
+  char  *img;
+  int   i;
+
+  if (tp->init_image != NULL) csound->Free(csound, tp->init_image);
+  if (tp->init_reloc != NULL) csound->Free(csound, tp->init_reloc);
+  img = (char *) csound->Malloc(csound, size);
+  memcpy(img, ip, size);
+  memset(img + ((char *) ip->lclbas - (char *) ip), 0,
+         tp->varPool->poolSize +
+         tp->varPool->varCount * CS_FLOAT_ALIGN(CS_VAR_TYPE_OFFSET));
+  for (i = 0; i < rl->n; i++) {
+    char     *p;
+    intptr_t d;
+    memcpy(&p, img + rl->off[i], sizeof(char *));
+    d = p - (char *) ip;
+    memcpy(img + rl->off[i], &d, sizeof(intptr_t));
+  }
+  tp->init_image = img;
+  tp->init_reloc = rl->off;
+  tp->init_nreloc = rl->n;
+  tp->init_size = size;
+  tp->init_version = csound->init_image_version;
+}
+
+static INSDS *instance_clone(CSOUND *csound, INSTRTXT *tp)
+{
+  char  *blk = (char *) csound->Malloc(csound, tp->init_size);
+  int32 *off = tp->init_reloc;
+  int   i;
+
+  memcpy(blk, tp->init_image, tp->init_size);
+  for (i = 0; i < tp->init_nreloc; i++) {
+    char     *p;
+    intptr_t d;
+    memcpy(&d, blk + off[i], sizeof(intptr_t));
+    p = blk + d;
+    memcpy(blk + off[i], &p, sizeof(char *));
+  }
+  instance_vars(csound, tp, ((INSDS *) blk)->lclbas);
+  return (INSDS *) blk;
+}
+
+/* allocate and set up all pntrs of a new instance */
+static INSDS *instance_build(CSOUND *csound, INSTRTXT *tp, int insno)
 {
-  INSTRTXT  *tp;
   INSDS     *ip;
   OPTXT     *optxt;
   OPDS      *opds, *prvids, *prvpds;
@@ -2317,14 +2326,14 @@ static void instance(CSOUND *csound, int insno)
   MYFLT     **argpp, *lclbas;
   CS_VAR_MEM *lcloffbas; // start of pfields
   char*     opMemStart;
+  size_t    size;
+  INIT_RELOC rl = { NULL, 0, 0 };
 
   OPARMS    *O = csound->oparms;
   int       odebug = O->odebug;
   ARG*      arg;
   int       argStringCount;
-  CS_VARIABLE* current;
 
-  tp = csound->engineState.instrtxtp[insno];
   n = 3;
   if (O->midiKey>n) n = O->midiKey;
   if (O->midiKeyCps>n) n = O->midiKeyCps;
@@ -2336,45 +2345,22 @@ static void instance(CSOUND *csound, int insno)
   pextrab = ((i = tp->pmax - 3L) > 0 ? (int) i * sizeof(CS_VAR_MEM) : 0);
   /* alloc new space,  */
   pextent = sizeof(INSDS) + pextrab + pextra*sizeof(CS_VAR_MEM);
-  ip =
-    (INSDS*) csound->Calloc(csound,
-                            (size_t) pextent + tp->varPool->poolSize +
-                            (tp->varPool->varCount *
-                             CS_FLOAT_ALIGN(CS_VAR_TYPE_OFFSET)) +
-                            (tp->varPool->varCount * sizeof(CS_VARIABLE*)) +
-                            tp->opdstot);
+  size = (size_t) pextent + tp->varPool->poolSize +
+    (tp->varPool->varCount * CS_FLOAT_ALIGN(CS_VAR_TYPE_OFFSET)) +
+    (tp->varPool->varCount * sizeof(CS_VARIABLE*)) +
+    tp->opdstot;
+  ip = (INSDS*) csound->Calloc(csound, size);
   ip->csound = csound;
   ip->m_chnbp = (MCHNBLK*) NULL;
   ip->instr = tp;
-  /* IV - Oct 26 2002: replaced with faster version (no search) */
-  ip->prvinstance = tp->lst_instance;
-  if (tp->lst_instance)
-    tp->lst_instance->nxtinstance = ip;
-  else
-    tp->instance = ip;
-  tp->lst_instance = ip;
-  /* link into free instance chain */
-  ip->nxtact = tp->act_instance;
-  tp->act_instance = ip;
   ip->insno = insno;
-  if (UNLIKELY(csound->oparms->odebug))
-    csoundMessage(csound,"instance(): tp->act_instance = %p\n",
-                  tp->act_instance);
-
-
-  if (insno > csound->engineState.maxinsno) {
-    //      size_t pcnt = (size_t) tp->opcode_info->perf_incnt;
-    //      pcnt += (size_t) tp->opcode_info->perf_outcnt;
-    OPCODINFO* info = tp->opcode_info;
-    size_t pcnt = sizeof(OPCOD_IOBUFS) +
-      sizeof(MYFLT*) * (info->inchns + info->outchns);
-    ip->opcod_iobufs = (void*) csound->Malloc(csound, pcnt);
-  }
 
   /* gbloffbas = csound->globalVarPool; */
   lcloffbas = (CS_VAR_MEM*)&ip->p0;
   lclbas = (MYFLT*) ((char*) ip + pextent);   /* split local space */
-  initializeVarPool((void *)csound, lclbas, tp->varPool);
+  ip->lclbas = lclbas;
+  init_reloc(csound, &rl, ip, &ip->lclbas);
+  instance_vars(csound, tp, lclbas);
 
   opMemStart = nxtopds = (char*) lclbas + tp->varPool->poolSize +
     (tp->varPool->varCount * CS_FLOAT_ALIGN(CS_VAR_TYPE_OFFSET));
@@ -2387,13 +2373,6 @@ static void instance(CSOUND *csound, int insno)
   prvids = prvpds = (OPDS*) ip;
   //    prvids->insdshead = ip;
 
-  /* initialize vars for CS_TYPE */
-  for (current = tp->varPool->head; current != NULL; current = current->next) {
-    char* ptr = (char*)(lclbas + current->memBlockIndex);
-    CS_TYPE** typePtr = (CS_TYPE**)(ptr - CS_VAR_TYPE_OFFSET);
-    *typePtr = current->varType;
-  }
-
   while ((optxt = optxt->nxtop) != NULL) {    /* for each op in instr */
     TEXT *ttp = &optxt->t;
     ep = ttp->oentry;
@@ -2412,31 +2391,38 @@ static void instance(CSOUND *csound, int insno)
                       ep->opname, opds);
     opds->optext = optxt;                     /* set common headata */
     opds->insdshead = ip;
+    init_reloc(csound, &rl, ip, &opds->insdshead);
     if (strcmp(ep->opname, "$label") == 0) {     /* LABEL:       */
       LBLBLK  *lblbp = (LBLBLK *) opds;
       lblbp->prvi = prvids;                   /*    save i/p links */
       lblbp->prvp = prvpds;
+      init_reloc(csound, &rl, ip, &lblbp->prvi);
+      init_reloc(csound, &rl, ip, &lblbp->prvp);
       continue;                               /*    for later refs */
     }
     // ******** This needs revisipn with no distinction between k- anda- rate ****
     if ((ep->thread & 07) == 0) {             /* thread 1 OR 2:  */
       if (ttp->pftype == 'b') {
+        init_reloc(csound, &rl, ip, &prvids->nxti);
         prvids = prvids->nxti = opds;
         opds->iopadr = ep->iopadr;
       }
       else {
+        init_reloc(csound, &rl, ip, &prvpds->nxtp);
         prvpds = prvpds->nxtp = opds;
         opds->opadr = ep->kopadr;
       }
       goto args;
     }
     if ((ep->thread & 01) != 0) {             /* thread 1:        */
+      init_reloc(csound, &rl, ip, &prvids->nxti);
       prvids = prvids->nxti = opds;           /* link into ichain */
       opds->iopadr = ep->iopadr;              /*   & set exec adr */
       if (UNLIKELY(opds->iopadr == NULL))
         csoundDie(csound, Str("null iopadr"));
     }
     if ((n = ep->thread & 06) != 0) {         /* thread 2 OR 4:   */
+      init_reloc(csound, &rl, ip, &prvpds->nxtp);
       prvpds = prvpds->nxtp = opds;           /* link into pchain */
       if (!(n & 04) ||
           ((ttp->pftype == 'k' || ttp->pftype == 'c') && ep->kopadr != NULL))
@@ -2462,10 +2448,12 @@ static void instance(CSOUND *csound, int insno)
       }
       else if (arg->type == ARG_LOCAL) {
         fltp = lclbas + var->memBlockIndex;
+        init_reloc(csound, &rl, ip, &argpp[n]);
       }
       else if (arg->type == ARG_PFIELD) {
         CS_VAR_MEM* pfield = lcloffbas + arg->index;
         fltp = &(pfield->value);
+        init_reloc(csound, &rl, ip, &argpp[n]);
       }
       else {
         csound->Message(csound, Str("FIXME: Unhandled out-arg type: %d\n"),
@@ -2482,7 +2470,6 @@ static void instance(CSOUND *csound, int insno)
       argpp[n] = NULL;
 
     arg = ttp->inArgs;
-    ip->lclbas = lclbas;
     for (; arg != NULL; n++, arg = arg->next) {
       CS_VARIABLE* var = (CS_VARIABLE*)(arg->argPtr);
       if (arg->type == ARG_CONSTANT) {
@@ -2495,16 +2482,19 @@ static void instance(CSOUND *csound, int insno)
       else if (arg->type == ARG_PFIELD) {
         CS_VAR_MEM* pfield = lcloffbas + arg->index;
         argpp[n] = &(pfield->value);
+        init_reloc(csound, &rl, ip, &argpp[n]);
       }
       else if (arg->type == ARG_GLOBAL) {
         argpp[n] =  &(var->memBlock->value); /*gbloffbas + var->memBlockIndex; */
       }
       else if (arg->type == ARG_LOCAL){
         argpp[n] = lclbas + var->memBlockIndex;
+        init_reloc(csound, &rl, ip, &argpp[n]);
       }
       else if (arg->type == ARG_LABEL) {
         argpp[n] = (MYFLT*)(opMemStart +
                             findLabelMemOffset(csound, tp, (char*)arg->argPtr));
+        init_reloc(csound, &rl, ip, &argpp[n]);
       }
       else {
         csound->Message(csound, Str("FIXME: instance unexpected arg: %d\n"),
@@ -2514,6 +2504,62 @@ static void instance(CSOUND *csound, int insno)
 
   }
 
+  if (UNLIKELY(nxtopds > opdslim))
+    csoundDie(csound, Str("inconsistent opds total"));
+
+  instance_image(csound, tp, ip, size, &rl);
+  return ip;
+}
+
+/* create instance of an instr template */
+/*   and link it into the free instance chain */
+
+static void instance(CSOUND *csound, int insno)
+{
+  INSTRTXT  *tp;
+  INSDS     *ip;
+  MYFLT     *lclbas;
+
+  tp = csound->engineState.instrtxtp[insno];
+  if (tp->init_image != NULL &&
+      tp->init_version == csound->init_image_version)
+    ip = instance_clone(csound, tp);
+  else
+    ip = instance_build(csound, tp, insno);
+  lclbas = ip->lclbas;
+
+  /* IV - Oct 26 2002: replaced with faster version (no search) */
+  ip->prvinstance = tp->lst_instance;
+  if (tp->lst_instance)
+    tp->lst_instance->nxtinstance = ip;
+  else
+    tp->instance = ip;
+  tp->lst_instance = ip;
+  /* link into free instance chain */
+  ip->nxtact = tp->act_instance;
+  tp->act_instance = ip;
+  ip->insno = insno;
+  if (UNLIKELY(csound->oparms->odebug))
+    csoundMessage(csound,"instance(): tp->act_instance = %p\n",
+                  tp->act_instance);
+
+
+  if (insno > csound->engineState.maxinsno) {
+    //      size_t pcnt = (size_t) tp->opcode_info->perf_incnt;
+    //      pcnt += (size_t) tp->opcode_info->perf_outcnt;
+    OPCODINFO* info = tp->opcode_info;
+    size_t nargs = (size_t) (info->inchns + info->outchns);
+    size_t pcnt = sizeof(OPCOD_IOBUFS) + sizeof(MYFLT*) * nargs;
+    OPCOD_IOBUFS *buf;
+    /* the copy plans go after the I/O pointers */
+    ip->opcod_iobufs = (void*) csound->Malloc(csound, pcnt +
+                                              sizeof(UDO_ARGCOPY) * nargs);
+    buf = (OPCOD_IOBUFS*) ip->opcod_iobufs;
+    buf->in_plan = (UDO_ARGCOPY*) ((char*) buf + pcnt);
+    buf->out_plan = buf->in_plan + info->inchns;
+    buf->in_cnt = buf->out_cnt = 0;
+  }
+
   /* VL 13-12-13: point the memory to the local ksmps & kr variables,
      and initialise them */
   CS_VARIABLE* var = csoundFindVariableWithName(csound,
@@ -2529,15 +2575,43 @@ static void instance(CSOUND *csound, int insno)
     var->memBlock = (CS_VAR_MEM*)(temp - CS_VAR_TYPE_OFFSET);
     var->memBlock->value = csound->ekr;
   }
+}
 
-  if (UNLIKELY(nxtopds > opdslim))
-    csoundDie(csound, Str("inconsistent opds total"));
+/* Raise the prealloc mark of instr insno to count, and create instances
+   until that many are active or free.  orcompact() keeps up to this
+   many free instances, so notes within the mark never allocate. */
+static void instr_prealloc(CSOUND *csound, int insno, int count)
+{
+    INSTRTXT *tp = csound->engineState.instrtxtp[insno];
+    INSDS    *ip;
+    int      a = count - tp->active;
+    if (count > tp->prealloc) tp->prealloc = count;
+    for (ip = tp->act_instance; ip != NULL && a > 0; ip = ip->nxtact)
+      a--;
+    for ( ; a > 0; a--)
+      instance(csound, insno);
+}
 
+int csoundPreallocInstrInternal(CSOUND *csound, MYFLT instr,
+                                const char *instrName, int count)
+{
+    int insno;
+
+    if (instrName)
+      insno = named_instr_find(csound, (char *) instrName);
+    else insno = (int) instr;
+    if (UNLIKELY(insno < 1 || insno > (int) csound->engineState.maxinsno ||
+                 csound->engineState.instrtxtp[insno] == NULL || count < 0))
+      return CSOUND_ERROR;
+    csoundLockMutex(csound->API_lock);
+    instr_prealloc(csound, insno, count);
+    csoundUnlockMutex(csound->API_lock);
+    return CSOUND_SUCCESS;
 }
 
 int prealloc_(CSOUND *csound, AOP *p, int instname)
 {
-    int     n, a;
+    int     n;
 
     if (instname)
       n = (int) strarg2opcno(csound, ((STRINGDAT*)p->r)->data, 1,
@@ -2552,9 +2626,7 @@ int prealloc_(CSOUND *csound, AOP *p, int instname)
     if (UNLIKELY(n == NOT_AN_INSTRUMENT)) return NOTOK;
     if (csound->oparms->realtime)
       csoundSpinLock(&csound->alloc_spinlock);
-    a = (int) *p->a - csound->engineState.instrtxtp[n]->active;
-    for ( ; a > 0; a--)
-      instance(csound, n);
+    instr_prealloc(csound, n, (int) *p->a);
     if (csound->oparms->realtime)
       csoundSpinUnLock(&csound->alloc_spinlock);
     return OK;
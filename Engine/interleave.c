@@ -0,0 +1,492 @@
+/*
+    interleave.c:
+
+    Copyright (C) 2018 The Csound Developers
+
+    This file is part of Csound.
+
+    The Csound Library is free software; you can redistribute it
+    and/or modify it under the terms of the GNU Lesser General Public
+    License as published by the Free Software Foundation; either
+    version 2.1 of the License, or (at your option) any later version.
+
+    Csound is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public
+    License along with Csound; if not, write to the Free Software
+    Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA
+    02110-1301 USA
+*/
+
+/* Conversion between planar (one buffer per channel) and interleaved
+   (frame by frame) audio.  Channels are handled four at a time as a
+   4 x N transpose; the kernel is picked on first use from what the CPU
+   offers (AVX or SSE2 on x86, NEON on ARM), with a plain C fallback.
+   Leftover channels (nchnls % 4) are copied one by one.  */
+
+#include "csoundCore.h"
+
+#if defined(__x86_64__) || defined(__i386__) || \
+    defined(_M_X64) || defined(_M_IX86)
+#  define ILV_X86 1
+#  include <immintrin.h>
+#  if defined(_MSC_VER)
+#    include <intrin.h>
+#    define ILV_TARGET(x)
+#  else
+#    define ILV_TARGET(x) __attribute__((target(x)))
+#  endif
+#elif defined(__aarch64__) || defined(__ARM_NEON) || defined(__ARM_NEON__)
+#  define ILV_NEON 1
+#  include <arm_neon.h>
+#endif
+
+typedef void (*ilv_group_fn)(MYFLT *out, uint32_t stride,
+                             const MYFLT *const *in, uint32_t nsmps);
+typedef void (*dlv_group_fn)(MYFLT *const *out, const MYFLT *in,
+                             uint32_t stride, uint32_t nsmps);
+
+/* out[n*stride + c] = in[c][n], c = 0..3 */
+static void ilv_group_c(MYFLT *out, uint32_t stride,
+                        const MYFLT *const *in, uint32_t nsmps)
+{
+    const MYFLT *a = in[0], *b = in[1], *c = in[2], *d = in[3];
+    uint32_t n;
+    for (n = 0; n < nsmps; n++, out += stride) {
+      out[0] = a[n]; out[1] = b[n]; out[2] = c[n]; out[3] = d[n];
+    }
+}
+
+/* out[c][n] = in[n*stride + c], c = 0..3 */
+static void dlv_group_c(MYFLT *const *out, const MYFLT *in,
+                        uint32_t stride, uint32_t nsmps)
+{
+    MYFLT *a = out[0], *b = out[1], *c = out[2], *d = out[3];
+    uint32_t n;
+    for (n = 0; n < nsmps; n++, in += stride) {
+      a[n] = in[0]; b[n] = in[1]; c[n] = in[2]; d[n] = in[3];
+    }
+}
+
+#ifdef ILV_X86
+#ifdef USE_DOUBLE
+
+ILV_TARGET("sse2")
+static void ilv_group_sse2(MYFLT *out, uint32_t stride,
+                           const MYFLT *const *in, uint32_t nsmps)
+{
+    uint32_t n = 0;
+    for ( ; n + 2 <= nsmps; n += 2, out += 2*stride) {
+      __m128d a = _mm_loadu_pd(in[0] + n), b = _mm_loadu_pd(in[1] + n);
+      __m128d c = _mm_loadu_pd(in[2] + n), d = _mm_loadu_pd(in[3] + n);
+      _mm_storeu_pd(out, _mm_unpacklo_pd(a, b));
+      _mm_storeu_pd(out + 2, _mm_unpacklo_pd(c, d));
+      _mm_storeu_pd(out + stride, _mm_unpackhi_pd(a, b));
+      _mm_storeu_pd(out + stride + 2, _mm_unpackhi_pd(c, d));
+    }
+    if (n < nsmps) {
+      const MYFLT *rest[4] = { in[0] + n, in[1] + n, in[2] + n, in[3] + n };
+      ilv_group_c(out, stride, rest, nsmps - n);
+    }
+}
+
+ILV_TARGET("sse2")
+static void dlv_group_sse2(MYFLT *const *out, const MYFLT *in,
+                           uint32_t stride, uint32_t nsmps)
+{
+    uint32_t n = 0;
+    for ( ; n + 2 <= nsmps; n += 2, in += 2*stride) {
+      __m128d ab0 = _mm_loadu_pd(in), cd0 = _mm_loadu_pd(in + 2);
+      __m128d ab1 = _mm_loadu_pd(in + stride);
+      __m128d cd1 = _mm_loadu_pd(in + stride + 2);
+      _mm_storeu_pd(out[0] + n, _mm_unpacklo_pd(ab0, ab1));
+      _mm_storeu_pd(out[1] + n, _mm_unpackhi_pd(ab0, ab1));
+      _mm_storeu_pd(out[2] + n, _mm_unpacklo_pd(cd0, cd1));
+      _mm_storeu_pd(out[3] + n, _mm_unpackhi_pd(cd0, cd1));
+    }
+    if (n < nsmps) {
+      MYFLT *rest[4] = { out[0] + n, out[1] + n, out[2] + n, out[3] + n };
+      dlv_group_c(rest, in, stride, nsmps - n);
+    }
+}
+
+/* 4 x 4 transpose of the rows x0..x3 */
+#define TRANSPOSE4_PD(x0, x1, x2, x3) {                         \
+      __m256d t0 = _mm256_unpacklo_pd(x0, x1);                  \
+      __m256d t1 = _mm256_unpackhi_pd(x0, x1);                  \
+      __m256d t2 = _mm256_unpacklo_pd(x2, x3);                  \
+      __m256d t3 = _mm256_unpackhi_pd(x2, x3);                  \
+      x0 = _mm256_permute2f128_pd(t0, t2, 0x20);                \
+      x1 = _mm256_permute2f128_pd(t1, t3, 0x20);                \
+      x2 = _mm256_permute2f128_pd(t0, t2, 0x31);                \
+      x3 = _mm256_permute2f128_pd(t1, t3, 0x31);                \
+  }
+
+ILV_TARGET("avx")
+static void ilv_group_avx(MYFLT *out, uint32_t stride,
+                          const MYFLT *const *in, uint32_t nsmps)
+{
+    uint32_t n = 0;
+    for ( ; n + 4 <= nsmps; n += 4, out += 4*stride) {
+      __m256d a = _mm256_loadu_pd(in[0] + n), b = _mm256_loadu_pd(in[1] + n);
+      __m256d c = _mm256_loadu_pd(in[2] + n), d = _mm256_loadu_pd(in[3] + n);
+      TRANSPOSE4_PD(a, b, c, d);
+      _mm256_storeu_pd(out, a);
+      _mm256_storeu_pd(out + stride, b);
+      _mm256_storeu_pd(out + 2*stride, c);
+      _mm256_storeu_pd(out + 3*stride, d);
+    }
+    if (n < nsmps) {
+      const MYFLT *rest[4] = { in[0] + n, in[1] + n, in[2] + n, in[3] + n };
+      ilv_group_c(out, stride, rest, nsmps - n);
+    }
+}
+
+ILV_TARGET("avx")
+static void dlv_group_avx(MYFLT *const *out, const MYFLT *in,
+                          uint32_t stride, uint32_t nsmps)
+{
+    uint32_t n = 0;
+    for ( ; n + 4 <= nsmps; n += 4, in += 4*stride) {
+      __m256d a = _mm256_loadu_pd(in), b = _mm256_loadu_pd(in + stride);
+      __m256d c = _mm256_loadu_pd(in + 2*stride);
+      __m256d d = _mm256_loadu_pd(in + 3*stride);
+      TRANSPOSE4_PD(a, b, c, d);
+      _mm256_storeu_pd(out[0] + n, a);
+      _mm256_storeu_pd(out[1] + n, b);
+      _mm256_storeu_pd(out[2] + n, c);
+      _mm256_storeu_pd(out[3] + n, d);
+    }
+    if (n < nsmps) {
+      MYFLT *rest[4] = { out[0] + n, out[1] + n, out[2] + n, out[3] + n };
+      dlv_group_c(rest, in, stride, nsmps - n);
+    }
+}
+
+#else   /* float */
+
+ILV_TARGET("sse2")
+static void ilv_group_sse2(MYFLT *out, uint32_t stride,
+                           const MYFLT *const *in, uint32_t nsmps)
+{
+    uint32_t n = 0;
+    for ( ; n + 4 <= nsmps; n += 4, out += 4*stride) {
+      __m128 a = _mm_loadu_ps(in[0] + n), b = _mm_loadu_ps(in[1] + n);
+      __m128 c = _mm_loadu_ps(in[2] + n), d = _mm_loadu_ps(in[3] + n);
+      _MM_TRANSPOSE4_PS(a, b, c, d);
+      _mm_storeu_ps(out, a);
+      _mm_storeu_ps(out + stride, b);
+      _mm_storeu_ps(out + 2*stride, c);
+      _mm_storeu_ps(out + 3*stride, d);
+    }
+    if (n < nsmps) {
+      const MYFLT *rest[4] = { in[0] + n, in[1] + n, in[2] + n, in[3] + n };
+      ilv_group_c(out, stride, rest, nsmps - n);
+    }
+}
+
+ILV_TARGET("sse2")
+static void dlv_group_sse2(MYFLT *const *out, const MYFLT *in,
+                           uint32_t stride, uint32_t nsmps)
+{
+    uint32_t n = 0;
+    for ( ; n + 4 <= nsmps; n += 4, in += 4*stride) {
+      __m128 a = _mm_loadu_ps(in), b = _mm_loadu_ps(in + stride);
+      __m128 c = _mm_loadu_ps(in + 2*stride), d = _mm_loadu_ps(in + 3*stride);
+      _MM_TRANSPOSE4_PS(a, b, c, d);
+      _mm_storeu_ps(out[0] + n, a);
+      _mm_storeu_ps(out[1] + n, b);
+      _mm_storeu_ps(out[2] + n, c);
+      _mm_storeu_ps(out[3] + n, d);
+    }
+    if (n < nsmps) {
+      MYFLT *rest[4] = { out[0] + n, out[1] + n, out[2] + n, out[3] + n };
+      dlv_group_c(rest, in, stride, nsmps - n);
+    }
+}
+
+/* two 4 x 4 transposes at once, one in each 128-bit lane */
+#define TRANSPOSE4X2_PS(x0, x1, x2, x3) {                       \
+      __m256 t0 = _mm256_unpacklo_ps(x0, x1);                   \
+      __m256 t1 = _mm256_unpackhi_ps(x0, x1);                   \
+      __m256 t2 = _mm256_unpacklo_ps(x2, x3);                   \
+      __m256 t3 = _mm256_unpackhi_ps(x2, x3);                   \
+      x0 = _mm256_shuffle_ps(t0, t2, 0x44);                     \
+      x1 = _mm256_shuffle_ps(t0, t2, 0xEE);                     \
+      x2 = _mm256_shuffle_ps(t1, t3, 0x44);                     \
+      x3 = _mm256_shuffle_ps(t1, t3, 0xEE);                     \
+  }
+
+ILV_TARGET("avx")
+static void ilv_group_avx(MYFLT *out, uint32_t stride,
+                          const MYFLT *const *in, uint32_t nsmps)
+{
+    uint32_t n = 0;
+    for ( ; n + 8 <= nsmps; n += 8, out += 8*stride) {
+      __m256 a = _mm256_loadu_ps(in[0] + n), b = _mm256_loadu_ps(in[1] + n);
+      __m256 c = _mm256_loadu_ps(in[2] + n), d = _mm256_loadu_ps(in[3] + n);
+      TRANSPOSE4X2_PS(a, b, c, d);
+      /* frames n..n+3 in the low lanes, n+4..n+7 in the high ones */
+      _mm_storeu_ps(out, _mm256_castps256_ps128(a));
+      _mm_storeu_ps(out + stride, _mm256_castps256_ps128(b));
+      _mm_storeu_ps(out + 2*stride, _mm256_castps256_ps128(c));
+      _mm_storeu_ps(out + 3*stride, _mm256_castps256_ps128(d));
+      _mm_storeu_ps(out + 4*stride, _mm256_extractf128_ps(a, 1));
+      _mm_storeu_ps(out + 5*stride, _mm256_extractf128_ps(b, 1));
+      _mm_storeu_ps(out + 6*stride, _mm256_extractf128_ps(c, 1));
+      _mm_storeu_ps(out + 7*stride, _mm256_extractf128_ps(d, 1));
+    }
+    if (n < nsmps) {
+      const MYFLT *rest[4] = { in[0] + n, in[1] + n, in[2] + n, in[3] + n };
+      ilv_group_sse2(out, stride, rest, nsmps - n);
+    }
+}
+
+ILV_TARGET("avx")
+static void dlv_group_avx(MYFLT *const *out, const MYFLT *in,
+                          uint32_t stride, uint32_t nsmps)
+{
+    uint32_t n = 0;
+    for ( ; n + 8 <= nsmps; n += 8, in += 8*stride) {
+      __m256 a = _mm256_insertf128_ps(
+                   _mm256_castps128_ps256(_mm_loadu_ps(in)),
+                   _mm_loadu_ps(in + 4*stride), 1);
+      __m256 b = _mm256_insertf128_ps(
+                   _mm256_castps128_ps256(_mm_loadu_ps(in + stride)),
+                   _mm_loadu_ps(in + 5*stride), 1);
+      __m256 c = _mm256_insertf128_ps(
+                   _mm256_castps128_ps256(_mm_loadu_ps(in + 2*stride)),
+                   _mm_loadu_ps(in + 6*stride), 1);
+      __m256 d = _mm256_insertf128_ps(
+                   _mm256_castps128_ps256(_mm_loadu_ps(in + 3*stride)),
+                   _mm_loadu_ps(in + 7*stride), 1);
+      TRANSPOSE4X2_PS(a, b, c, d);
+      _mm256_storeu_ps(out[0] + n, a);
+      _mm256_storeu_ps(out[1] + n, b);
+      _mm256_storeu_ps(out[2] + n, c);
+      _mm256_storeu_ps(out[3] + n, d);
+    }
+    if (n < nsmps) {
+      MYFLT *rest[4] = { out[0] + n, out[1] + n, out[2] + n, out[3] + n };
+      dlv_group_sse2(rest, in, stride, nsmps - n);
+    }
+}
+
+#endif  /* USE_DOUBLE */
+
+/* x86: can the CPU (and OS) run AVX code, or if avx is 0, SSE2 code */
+int cs_cpu_has(int avx)
+{
+#if defined(_MSC_VER)
+    int info[4];
+    __cpuid(info, 1);
+    if (!avx)
+      return (info[3] >> 26) & 1;
+    /* AVX needs OS support for the YMM state as well */
+    return ((info[2] >> 28) & 1) && ((info[2] >> 27) & 1) &&
+           (_xgetbv(0) & 6) == 6;
+#else
+    __builtin_cpu_init();
+    return avx ? __builtin_cpu_supports("avx")
+               : __builtin_cpu_supports("sse2");
+#endif
+}
+
+#endif  /* ILV_X86 */
+
+#ifdef ILV_NEON
+#ifdef USE_DOUBLE
+#ifdef __aarch64__
+
+static void ilv_group_neon(MYFLT *out, uint32_t stride,
+                           const MYFLT *const *in, uint32_t nsmps)
+{
+    uint32_t n = 0;
+    for ( ; n + 2 <= nsmps; n += 2, out += 2*stride) {
+      float64x2_t a = vld1q_f64(in[0] + n), b = vld1q_f64(in[1] + n);
+      float64x2_t c = vld1q_f64(in[2] + n), d = vld1q_f64(in[3] + n);
+      vst1q_f64(out, vzip1q_f64(a, b));
+      vst1q_f64(out + 2, vzip1q_f64(c, d));
+      vst1q_f64(out + stride, vzip2q_f64(a, b));
+      vst1q_f64(out + stride + 2, vzip2q_f64(c, d));
+    }
+    if (n < nsmps) {
+      const MYFLT *rest[4] = { in[0] + n, in[1] + n, in[2] + n, in[3] + n };
+      ilv_group_c(out, stride, rest, nsmps - n);
+    }
+}
+
+static void dlv_group_neon(MYFLT *const *out, const MYFLT *in,
+                           uint32_t stride, uint32_t nsmps)
+{
+    uint32_t n = 0;
+    for ( ; n + 2 <= nsmps; n += 2, in += 2*stride) {
+      float64x2_t ab0 = vld1q_f64(in), cd0 = vld1q_f64(in + 2);
+      float64x2_t ab1 = vld1q_f64(in + stride);
+      float64x2_t cd1 = vld1q_f64(in + stride + 2);
+      vst1q_f64(out[0] + n, vzip1q_f64(ab0, ab1));
+      vst1q_f64(out[1] + n, vzip2q_f64(ab0, ab1));
+      vst1q_f64(out[2] + n, vzip1q_f64(cd0, cd1));
+      vst1q_f64(out[3] + n, vzip2q_f64(cd0, cd1));
+    }
+    if (n < nsmps) {
+      MYFLT *rest[4] = { out[0] + n, out[1] + n, out[2] + n, out[3] + n };
+      dlv_group_c(rest, in, stride, nsmps - n);
+    }
+}
+
+#else
+#undef ILV_NEON                 /* no double precision vectors on ARMv7 */
+#endif
+#else   /* float */
+
+#define TRANSPOSE4_NEON(x0, x1, x2, x3) {                               \
+      float32x4x2_t t01 = vtrnq_f32(x0, x1);                            \
+      float32x4x2_t t23 = vtrnq_f32(x2, x3);                            \
+      x0 = vcombine_f32(vget_low_f32(t01.val[0]), vget_low_f32(t23.val[0])); \
+      x1 = vcombine_f32(vget_low_f32(t01.val[1]), vget_low_f32(t23.val[1])); \
+      x2 = vcombine_f32(vget_high_f32(t01.val[0]), vget_high_f32(t23.val[0])); \
+      x3 = vcombine_f32(vget_high_f32(t01.val[1]), vget_high_f32(t23.val[1])); \
+  }
+
+static void ilv_group_neon(MYFLT *out, uint32_t stride,
+                           const MYFLT *const *in, uint32_t nsmps)
+{
+    uint32_t n = 0;
+    for ( ; n + 4 <= nsmps; n += 4, out += 4*stride) {
+      float32x4_t a = vld1q_f32(in[0] + n), b = vld1q_f32(in[1] + n);
+      float32x4_t c = vld1q_f32(in[2] + n), d = vld1q_f32(in[3] + n);
+      TRANSPOSE4_NEON(a, b, c, d);
+      vst1q_f32(out, a);
+      vst1q_f32(out + stride, b);
+      vst1q_f32(out + 2*stride, c);
+      vst1q_f32(out + 3*stride, d);
+    }
+    if (n < nsmps) {
+      const MYFLT *rest[4] = { in[0] + n, in[1] + n, in[2] + n, in[3] + n };
+      ilv_group_c(out, stride, rest, nsmps - n);
+    }
+}
+
+static void dlv_group_neon(MYFLT *const *out, const MYFLT *in,
+                           uint32_t stride, uint32_t nsmps)
+{
+    uint32_t n = 0;
+    for ( ; n + 4 <= nsmps; n += 4, in += 4*stride) {
+      float32x4_t a = vld1q_f32(in), b = vld1q_f32(in + stride);
+      float32x4_t c = vld1q_f32(in + 2*stride), d = vld1q_f32(in + 3*stride);
+      TRANSPOSE4_NEON(a, b, c, d);
+      vst1q_f32(out[0] + n, a);
+      vst1q_f32(out[1] + n, b);
+      vst1q_f32(out[2] + n, c);
+      vst1q_f32(out[3] + n, d);
+    }
+    if (n < nsmps) {
+      MYFLT *rest[4] = { out[0] + n, out[1] + n, out[2] + n, out[3] + n };
+      dlv_group_c(rest, in, stride, nsmps - n);
+    }
+}
+
+#endif  /* USE_DOUBLE */
+#endif  /* ILV_NEON */
+
+static ilv_group_fn ilv_group = NULL;
+static dlv_group_fn dlv_group = NULL;
+
+/* Pick the kernels; racing callers all store the same values */
+static void interleave_select(void)
+{
+    ilv_group_fn ilv = ilv_group_c;
+    dlv_group_fn dlv = dlv_group_c;
+#if defined(ILV_X86)
+    if (cs_cpu_has(1)) {
+      ilv = ilv_group_avx; dlv = dlv_group_avx;
+    }
+    else if (cs_cpu_has(0)) {
+      ilv = ilv_group_sse2; dlv = dlv_group_sse2;
+    }
+#elif defined(ILV_NEON)
+    ilv = ilv_group_neon; dlv = dlv_group_neon;
+#endif
+    dlv_group = dlv;
+    ilv_group = ilv;
+}
+
+/* Use kernel set 'set' of those this CPU can run, 0 being the plain C
+   one and -1 the best, so that tests can check each of them against the
+   C loops; returns how many there are, at most 3.  Not for use while
+   another thread converts audio */
+int cs_interleave_kernels(int set)
+{
+    ilv_group_fn ilv[3];
+    dlv_group_fn dlv[3];
+    int n = 0;
+    ilv[n] = ilv_group_c; dlv[n++] = dlv_group_c;
+#if defined(ILV_X86)
+    if (cs_cpu_has(0)) { ilv[n] = ilv_group_sse2; dlv[n++] = dlv_group_sse2; }
+    if (cs_cpu_has(1)) { ilv[n] = ilv_group_avx; dlv[n++] = dlv_group_avx; }
+#elif defined(ILV_NEON)
+    ilv[n] = ilv_group_neon; dlv[n++] = dlv_group_neon;
+#endif
+    if (set < 0) interleave_select();
+    else if (set < n) {
+      dlv_group = dlv[set];
+      ilv_group = ilv[set];
+    }
+    return n;
+}
+
+/* Interleave nchnls channels of nsmps samples: out[n*stride + c] = in[c][n] */
+void cs_interleave(MYFLT *out, uint32_t stride,
+                   const MYFLT *const *in, uint32_t nchnls, uint32_t nsmps)
+{
+    uint32_t c, n;
+    if (UNLIKELY(ilv_group == NULL)) interleave_select();
+    for (c = 0; c + 4 <= nchnls; c += 4)
+      ilv_group(out + c, stride, in + c, nsmps);
+    for ( ; c < nchnls; c++)
+      for (n = 0; n < nsmps; n++)
+        out[n*stride + c] = in[c][n];
+}
+
+/* As above, with the channels one after another in a single buffer,
+   the layout of csound->spraw */
+void cs_interleave_planar(MYFLT *out, const MYFLT *in,
+                          uint32_t nchnls, uint32_t nsmps)
+{
+    uint32_t c, n;
+    if (UNLIKELY(ilv_group == NULL)) interleave_select();
+    for (c = 0; c + 4 <= nchnls; c += 4) {
+      const MYFLT *grp[4];
+      grp[0] = in + c*nsmps;
+      grp[1] = grp[0] + nsmps;
+      grp[2] = grp[1] + nsmps;
+      grp[3] = grp[2] + nsmps;
+      ilv_group(out + c, nchnls, grp, nsmps);
+    }
+    for ( ; c < nchnls; c++)
+      for (n = 0; n < nsmps; n++)
+        out[n*nchnls + c] = in[c*nsmps + n];
+}
+
+/* Deinterleave nchnls channels: out[c][ofs + n] = in[n*stride + c] */
+void cs_deinterleave(MYFLT *const *out, uint32_t ofs, const MYFLT *in,
+                     uint32_t stride, uint32_t nchnls, uint32_t nsmps)
+{
+    uint32_t c, n;
+    if (UNLIKELY(dlv_group == NULL)) interleave_select();
+    for (c = 0; c + 4 <= nchnls; c += 4) {
+      MYFLT *grp[4];
+      grp[0] = out[c] + ofs;
+      grp[1] = out[c+1] + ofs;
+      grp[2] = out[c+2] + ofs;
+      grp[3] = out[c+3] + ofs;
+      dlv_group(grp, in + c, stride, nsmps);
+    }
+    for ( ; c < nchnls; c++)
+      for (n = 0; n < nsmps; n++)
+        out[c][ofs + n] = in[n*stride + c];
+}
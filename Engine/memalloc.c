@@ -24,33 +24,77 @@
 
 #include "csoundCore.h"                 /*              MEMALLOC.C      */
 
-/* This code wraps malloc etc with maintaining a list of allocated memory
-   so it can be freed on a reset.  It would not be necessary with a zoned
-   allocator.
+/* This code wraps malloc etc with maintaining a record of allocated memory
+   so it can be freed on a reset.
+
+   Memory is kept in a small number of arenas, each with its own spinlock,
+   so that threads allocating at the same time (performance threads, the
+   event insert thread, the host) rarely meet on one lock.  A thread starts
+   at the arena chosen by its stack address and moves on to the next free
+   one if that is taken.  Blocks up to MEM_SMALL_MAX bytes are rounded up
+   to a size class and cut from large chunks; freed ones go on the owning
+   arena's free list for the class and are reused.  Larger blocks come
+   straight from malloc and are chained in their arena as before.  A reset
+   frees the chunks and the large blocks of every arena.
 */
 #if defined(BETA) && !defined(MEMDEBUG)
 #define MEMDEBUG  1
 #endif
 
 #define MEMALLOC_MAGIC  0x6D426C6B
-/* The memory list must be controlled by mutex */
+/* The arena database is created under this lock */
 #define CSOUND_MEM_SPINLOCK csoundSpinLock(&csound->memlock);
 #define CSOUND_MEM_SPINUNLOCK csoundSpinUnLock(&csound->memlock);
 
+#define MEM_ARENAS      (8)             /* power of two */
+#define MEM_NCLASSES    (14)
+#define MEM_SMALL_MAX   (2048)
+#define MEM_CHUNK_SIZE  ((size_t) 65536)
+
 typedef struct memAllocBlock_s {
 #ifdef MEMDEBUG
     int                     magic;      /* 0x6D426C6B ("mBlk")          */
     void                    *ptr;       /* pointer to allocated area    */
 #endif
     struct memAllocBlock_s  *prv;       /* previous structure in chain  */
-    struct memAllocBlock_s  *nxt;       /* next structure in chain      */
+    struct memAllocBlock_s  *nxt;       /* next in chain or free list   */
+    size_t                  size;       /* usable bytes                 */
+    int16_t                 arena;      /* owning arena                 */
+    int16_t                 sclass;     /* size class, -1 if large      */
 } memAllocBlock_t;
 
-#define HDR_SIZE    (((int) sizeof(memAllocBlock_t) + 7) & (~7))
+#define HDR_SIZE    (((int) sizeof(memAllocBlock_t) + 15) & (~15))
 #define ALLOC_BYTES(n)  ((size_t) HDR_SIZE + (size_t) (n))
 #define DATA_PTR(p) ((void*) ((unsigned char*) (p) + (int) HDR_SIZE))
 #define HDR_PTR(p)  ((memAllocBlock_t*) ((unsigned char*) (p) - (int) HDR_SIZE))
 
+typedef struct memChunk_s {
+    struct memChunk_s       *nxt;
+} memChunk_t;
+
+#define CHUNK_HDR   (((int) sizeof(memChunk_t) + 15) & (~15))
+
+typedef struct {
+    spin_lock_t             lock;
+    memAllocBlock_t         *free_list[MEM_NCLASSES];
+    memAllocBlock_t         *large;     /* chain of large blocks        */
+    memChunk_t              *chunks;
+    unsigned char           *bump, *bump_end;  /* rest of newest chunk  */
+    uint64_t                allocs, frees, reallocs, contended;
+    uint64_t                in_use, reserved, small_blocks, large_blocks;
+    uint8_t                 pad[64];    /* keep arenas off each other's
+                                           cache lines                  */
+} memArena_t;
+
+typedef struct {
+    memArena_t              arenas[MEM_ARENAS];
+    uint8_t                 sclass[MEM_SMALL_MAX/16 + 1];
+} memDatabase_t;
+
+static const size_t class_size[MEM_NCLASSES] = {
+    16, 32, 48, 64, 96, 128, 192, 256, 384, 512, 768, 1024, 1536, 2048
+};
+
 #define MEMALLOC_DB (csound->memalloc_db)
 
 static void memdie(CSOUND *csound, size_t nbytes)
@@ -60,10 +104,155 @@ static void memdie(CSOUND *csound, size_t nbytes)
     csound->LongJmp(csound, CSOUND_MEMORY);
 }
 
-void *mmalloc(CSOUND *csound, size_t size)
+static memDatabase_t *mem_database(CSOUND *csound)
+{
+    memDatabase_t *db = (memDatabase_t*) MEMALLOC_DB;
+    if (LIKELY(db != NULL))
+      return db;
+    CSOUND_MEM_SPINLOCK
+    if ((db = (memDatabase_t*) MEMALLOC_DB) == NULL) {
+      int i, c;
+      db = (memDatabase_t*) calloc(1, sizeof(memDatabase_t));
+      if (UNLIKELY(db == NULL)) {
+        CSOUND_MEM_SPINUNLOCK
+        memdie(csound, sizeof(memDatabase_t));
+      }
+      for (i = 0; i < MEM_ARENAS; i++)
+        csoundSpinLockInit(&db->arenas[i].lock);
+      for (i = 0, c = 0; i <= MEM_SMALL_MAX/16; i++) {
+        while (class_size[c] < (size_t) i * 16) c++;
+        db->sclass[i] = (uint8_t) c;
+      }
+      MEMALLOC_DB = (void*) db;
+    }
+    CSOUND_MEM_SPINUNLOCK
+    return db;
+}
+
+/* Lock and return an arena for the calling thread.  Different threads
+   run on different stacks, so the address of a local tells them apart
+   well enough to spread them over the arenas. */
+static memArena_t *arena_lock(memDatabase_t *db)
+{
+    char    here;
+    uint32_t home = ((uint32_t) ((uintptr_t) &here >> 16) * 0x9E3779B1U)
+                      >> 29;
+    int     i;
+
+    for (i = 0; i < MEM_ARENAS; i++) {
+      memArena_t *a = &db->arenas[(home + i) & (MEM_ARENAS - 1)];
+      if (csoundSpinTryLock(&a->lock) == CSOUND_SUCCESS) {
+        if (i > 0) a->contended++;
+        return a;
+      }
+    }
+    csoundSpinLock(&db->arenas[home].lock);
+    db->arenas[home].contended++;
+    return &db->arenas[home];
+}
+
+/* Take a block of class c from arena a, which must be locked;
+   returns NULL if a new chunk is needed and cannot be had. */
+static memAllocBlock_t *arena_small(memDatabase_t *db, memArena_t *a, int c)
 {
-    void  *p;
+    memAllocBlock_t *pp = a->free_list[c];
+    size_t          need;
+
+    if (pp != NULL) {
+      a->free_list[c] = pp->nxt;
+    }
+    else {
+      need = ALLOC_BYTES(class_size[c]);
+      if (UNLIKELY(a->bump == NULL || a->bump + need > a->bump_end)) {
+        memChunk_t *chunk = (memChunk_t*) malloc(MEM_CHUNK_SIZE);
+        if (UNLIKELY(chunk == NULL))
+          return NULL;
+        chunk->nxt = a->chunks;
+        a->chunks = chunk;
+        a->bump = (unsigned char*) chunk + CHUNK_HDR;
+        a->bump_end = (unsigned char*) chunk + MEM_CHUNK_SIZE;
+        a->reserved += MEM_CHUNK_SIZE;
+      }
+      pp = (memAllocBlock_t*) a->bump;
+      a->bump += need;
+      pp->prv = NULL;
+      pp->size = class_size[c];
+      pp->arena = (int16_t) (a - db->arenas);
+      pp->sclass = (int16_t) c;
+    }
+    pp->nxt = NULL;
+    a->allocs++;
+    a->small_blocks++;
+    a->in_use += pp->size;
+    return pp;
+}
+
+/* Link a large block into arena a, which must be locked */
+static void arena_link(memDatabase_t *db, memArena_t *a,
+                       memAllocBlock_t *pp, size_t size)
+{
+    pp->size = size;
+    pp->arena = (int16_t) (a - db->arenas);
+    pp->sclass = -1;
+    pp->prv = NULL;
+    pp->nxt = a->large;
+    if (a->large != NULL)
+      a->large->prv = pp;
+    a->large = pp;
+    a->large_blocks++;
+    a->in_use += size;
+    a->reserved += ALLOC_BYTES(size);
+}
+
+static void arena_unlink(memArena_t *a, memAllocBlock_t *pp)
+{
+    memAllocBlock_t *prv = pp->prv, *nxt = pp->nxt;
+    if (nxt != NULL)
+      nxt->prv = prv;
+    if (prv != NULL)
+      prv->nxt = nxt;
+    else
+      a->large = nxt;
+    a->large_blocks--;
+    a->in_use -= pp->size;
+    a->reserved -= ALLOC_BYTES(pp->size);
+}
+
+static void *memalloc(CSOUND *csound, size_t size, int zero)
+{
+    memDatabase_t   *db = mem_database(csound);
+    memArena_t      *a;
+    memAllocBlock_t *pp;
+
+    if (size <= MEM_SMALL_MAX) {
+      a = arena_lock(db);
+      pp = arena_small(db, a, db->sclass[(size + 15) >> 4]);
+      csoundSpinUnLock(&a->lock);
+      if (UNLIKELY(pp == NULL))
+        memdie(csound, size);   /* does a long jump */
+      if (zero)
+        memset(DATA_PTR(pp), 0, size);
+    }
+    else {
+      pp = (memAllocBlock_t*) (zero ? calloc(ALLOC_BYTES(size), (size_t) 1)
+                                    : malloc(ALLOC_BYTES(size)));
+      if (UNLIKELY(pp == NULL))
+        memdie(csound, size);   /* does a long jump */
+      a = arena_lock(db);
+      arena_link(db, a, pp, size);
+      a->allocs++;
+      csoundSpinUnLock(&a->lock);
+    }
+#ifdef MEMDEBUG
+    pp->magic = MEMALLOC_MAGIC;
+    pp->ptr = DATA_PTR(pp);
+#endif
+    /* return with data pointer */
+    return DATA_PTR(pp);
+}
 
+void *mmalloc(CSOUND *csound, size_t size)
+{
 #ifdef MEMDEBUG
     if (UNLIKELY(size == (size_t) 0)) {
       csound->DebugMsg(csound,
@@ -71,24 +260,7 @@ void *mmalloc(CSOUND *csound, size_t size)
       return NULL;
     }
 #endif
-    /* allocate memory */
-    if (UNLIKELY((p = malloc(ALLOC_BYTES(size))) == NULL)) {
-        memdie(csound, size);     /* does a long jump */
-    }
-    /* link into chain */
-#ifdef MEMDEBUG
-    ((memAllocBlock_t*) p)->magic = MEMALLOC_MAGIC;
-    ((memAllocBlock_t*) p)->ptr = DATA_PTR(p);
-#endif
-    CSOUND_MEM_SPINLOCK
-    ((memAllocBlock_t*) p)->prv = (memAllocBlock_t*) NULL;
-    ((memAllocBlock_t*) p)->nxt = (memAllocBlock_t*) MEMALLOC_DB;
-    if (MEMALLOC_DB != NULL)
-      ((memAllocBlock_t*) MEMALLOC_DB)->prv = (memAllocBlock_t*) p;
-    MEMALLOC_DB = (void*) p;
-    CSOUND_MEM_SPINUNLOCK
-    /* return with data pointer */
-    return DATA_PTR(p);
+    return memalloc(csound, size, 0);
 }
 
 void *mmallocDebug(CSOUND *csound, size_t size, char *file, int line)
@@ -100,8 +272,6 @@ void *mmallocDebug(CSOUND *csound, size_t size, char *file, int line)
 
 void *mcalloc(CSOUND *csound, size_t size)
 {
-    void  *p;
-
 #ifdef MEMDEBUG
     if (UNLIKELY(size == (size_t) 0)) {
       csound->DebugMsg(csound,
@@ -109,24 +279,7 @@ void *mcalloc(CSOUND *csound, size_t size)
       return NULL;
     }
 #endif
-    /* allocate memory */
-    if (UNLIKELY((p = calloc(ALLOC_BYTES(size), (size_t) 1)) == NULL)) {
-      memdie(csound, size);     /* does longjump */
-    }
-    /* link into chain */
-#ifdef MEMDEBUG
-    ((memAllocBlock_t*) p)->magic = MEMALLOC_MAGIC;
-    ((memAllocBlock_t*) p)->ptr = DATA_PTR(p);
-#endif
-    CSOUND_MEM_SPINLOCK
-    ((memAllocBlock_t*) p)->prv = (memAllocBlock_t*) NULL;
-    ((memAllocBlock_t*) p)->nxt = (memAllocBlock_t*) MEMALLOC_DB;
-    if (MEMALLOC_DB != NULL)
-      ((memAllocBlock_t*) MEMALLOC_DB)->prv = (memAllocBlock_t*) p;
-    MEMALLOC_DB = (void*) p;
-    CSOUND_MEM_SPINUNLOCK
-    /* return with data pointer */
-    return DATA_PTR(p);
+    return memalloc(csound, size, 1);
 }
 
 void *mcallocDebug(CSOUND *csound, size_t size, char *file, int line)
@@ -139,7 +292,9 @@ void *mcallocDebug(CSOUND *csound, size_t size, char *file, int line)
 
 void mfree(CSOUND *csound, void *p)
 {
+    memDatabase_t   *db = (memDatabase_t*) MEMALLOC_DB;
     memAllocBlock_t *pp;
+    memArena_t      *a;
 
     if (UNLIKELY(p == NULL))
       return;
@@ -157,21 +312,23 @@ void mfree(CSOUND *csound, void *p)
     }
     pp->magic = 0;
  #endif
-    CSOUND_MEM_SPINLOCK
-    /* unlink from chain */
-    {
-      memAllocBlock_t *prv = pp->prv, *nxt = pp->nxt;
-      if (nxt != NULL)
-        nxt->prv = prv;
-      if (prv != NULL)
-        prv->nxt = nxt;
-      else
-        MEMALLOC_DB = (void*)nxt;
+    a = &db->arenas[pp->arena];
+    csoundSpinLock(&a->lock);
+    a->frees++;
+    if (pp->sclass >= 0) {
+      /* back on the free list of its class */
+      a->small_blocks--;
+      a->in_use -= pp->size;
+      pp->nxt = a->free_list[pp->sclass];
+      a->free_list[pp->sclass] = pp;
+      csoundSpinUnLock(&a->lock);
+    }
+    else {
+      arena_unlink(a, pp);
+      csoundSpinUnLock(&a->lock);
+      /* free memory */
+      free((void*) pp);
     }
-    //csound->Message(csound, "free\n");
-    /* free memory */
-    free((void*) pp);
-    CSOUND_MEM_SPINUNLOCK
 }
 
 void mfreeDebug(CSOUND *csound, void *ans, char *file, int line)
@@ -182,7 +339,9 @@ void mfreeDebug(CSOUND *csound, void *ans, char *file, int line)
 
 void *mrealloc(CSOUND *csound, void *oldp, size_t size)
 {
+    memDatabase_t   *db;
     memAllocBlock_t *pp;
+    memArena_t      *a;
     void            *p;
 
     if (UNLIKELY(oldp == NULL))
@@ -191,6 +350,7 @@ void *mrealloc(CSOUND *csound, void *oldp, size_t size)
       mfree(csound, oldp);
       return NULL;
     }
+    db = (memDatabase_t*) MEMALLOC_DB;
     pp = HDR_PTR(oldp);
 #ifdef MEMDEBUG
     if (UNLIKELY(pp->magic != MEMALLOC_MAGIC || pp->ptr != oldp)) {
@@ -200,6 +360,29 @@ void *mrealloc(CSOUND *csound, void *oldp, size_t size)
       /* as a result of a bug */
       exit(-1);
     }
+#endif
+    a = &db->arenas[pp->arena];
+    if (pp->sclass >= 0) {
+      /* small block: keep it if the class is big enough, else move it */
+      if (size <= pp->size) {
+        csoundSpinLock(&a->lock);
+        a->reallocs++;
+        csoundSpinUnLock(&a->lock);
+        return oldp;
+      }
+      p = mmalloc(csound, size);
+      memcpy(p, oldp, pp->size);
+      mfree(csound, oldp);
+      a = &db->arenas[HDR_PTR(p)->arena];
+      csoundSpinLock(&a->lock);
+      a->reallocs++;
+      csoundSpinUnLock(&a->lock);
+      return p;
+    }
+    csoundSpinLock(&a->lock);
+    arena_unlink(a, pp);
+    csoundSpinUnLock(&a->lock);
+#ifdef MEMDEBUG
     /* mark old header as invalid */
     pp->magic = 0;
     pp->ptr = NULL;
@@ -207,33 +390,27 @@ void *mrealloc(CSOUND *csound, void *oldp, size_t size)
     /* allocate memory */
     p = realloc((void*) pp, ALLOC_BYTES(size));
     if (UNLIKELY(p == NULL)) {
+      /* alloc failed, restore original block */
+      csoundSpinLock(&a->lock);
+      arena_link(db, a, pp, pp->size);
+      csoundSpinUnLock(&a->lock);
 #ifdef MEMDEBUG
-      CSOUND_MEM_SPINLOCK
-      /* alloc failed, restore original header */
       pp->magic = MEMALLOC_MAGIC;
       pp->ptr = oldp;
-      CSOUND_MEM_SPINUNLOCK
 #endif
       memdie(csound, size);
       return NULL;
     }
-    CSOUND_MEM_SPINLOCK
-    /* create new header and update chain pointers */
+    /* create new header and link it back in */
     pp = (memAllocBlock_t*) p;
 #ifdef MEMDEBUG
     pp->magic = MEMALLOC_MAGIC;
     pp->ptr = DATA_PTR(pp);
 #endif
-    {
-      memAllocBlock_t *prv = pp->prv, *nxt = pp->nxt;
-      if (nxt != NULL)
-        nxt->prv = pp;
-      if (prv != NULL)
-        prv->nxt = pp;
-      else
-        MEMALLOC_DB = (void*) pp;
-    }
-    CSOUND_MEM_SPINUNLOCK
+    csoundSpinLock(&a->lock);
+    arena_link(db, a, pp, size);
+    a->reallocs++;
+    csoundSpinUnLock(&a->lock);
     /* return with data pointer */
     return DATA_PTR(pp);
 }
@@ -247,16 +424,53 @@ void *mreallocDebug(CSOUND *csound, void *oldp, size_t size, char *file, int lin
 
 void memRESET(CSOUND *csound)
 {
+    memDatabase_t   *db = (memDatabase_t*) MEMALLOC_DB;
     memAllocBlock_t *pp, *nxtp;
+    memChunk_t      *chunk, *nxtc;
+    int             i;
 
-    pp = (memAllocBlock_t*) MEMALLOC_DB;
+    if (db == NULL)
+      return;
     MEMALLOC_DB = NULL;
-    while (pp != NULL) {
-      nxtp = pp->nxt;
+    for (i = 0; i < MEM_ARENAS; i++) {
+      pp = db->arenas[i].large;
+      while (pp != NULL) {
+        nxtp = pp->nxt;
 #ifdef MEMDEBUG
-      pp->magic = 0;
+        pp->magic = 0;
 #endif
-      free((void*) pp);
-      pp = nxtp;
+        free((void*) pp);
+        pp = nxtp;
+      }
+      chunk = db->arenas[i].chunks;
+      while (chunk != NULL) {
+        nxtc = chunk->nxt;
+        free((void*) chunk);
+        chunk = nxtc;
+      }
+    }
+    free((void*) db);
+}
+
+PUBLIC void csoundGetMemoryStats(CSOUND *csound, CSOUND_MEMORY_STATS *stats)
+{
+    memDatabase_t   *db = (memDatabase_t*) MEMALLOC_DB;
+    int             i;
+
+    memset(stats, 0, sizeof(CSOUND_MEMORY_STATS));
+    if (db == NULL)
+      return;
+    for (i = 0; i < MEM_ARENAS; i++) {
+      memArena_t *a = &db->arenas[i];
+      csoundSpinLock(&a->lock);
+      stats->allocs += a->allocs;
+      stats->frees += a->frees;
+      stats->reallocs += a->reallocs;
+      stats->contended += a->contended;
+      stats->bytesInUse += a->in_use;
+      stats->bytesReserved += a->reserved;
+      stats->smallBlocks += a->small_blocks;
+      stats->largeBlocks += a->large_blocks;
+      csoundSpinUnLock(&a->lock);
     }
 }
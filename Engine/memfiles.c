@@ -29,9 +29,26 @@
 #include "lpc.h"
 #include "pstream.h"
 #include "namedins.h"
+#include "fgens.h"
 #include <sndfile.h>
 #include <string.h>
 #include <inttypes.h>
+#include <stddef.h>
+#include <sys/stat.h>
+
+/* what the sound file cache keeps with each SNDMEMFILE; the public
+   structure ends with its sample data, so it comes last */
+typedef struct {
+    int         refCount;       /* users; unused files may be dropped */
+    uint64_t    lastUse;        /* orders unused files, oldest first */
+    void        *instrument;    /* SF_INSTRUMENT chunk, or NULL */
+    SNDMEMFILE  f;
+} SNDMEMENTRY;
+
+#define SNDMEM_ENTRY(p) \
+    ((SNDMEMENTRY*) ((char*) (p) - offsetof(SNDMEMENTRY, f)))
+
+static void sound_file_free(CSOUND *csound, SNDMEMENTRY *p);
 
 static int Load_Het_File_(CSOUND *csound, const char *filnam,
                           char **allocp, int32 *len)
@@ -394,6 +411,20 @@ void rlsmemfiles(CSOUND *csound)
     csound->memfiles = NULL;
 }
 
+/* free the sound files in memory, at reset */
+
+void rlssndmemfiles(CSOUND *csound)
+{
+    if (csound->sndmemfiles != NULL) {
+      CONS_CELL *vals = cs_hash_table_values(csound, csound->sndmemfiles), *v;
+      for (v = vals; v != NULL; v = v->next)
+        sound_file_free(csound, (SNDMEMENTRY*) v->value);
+      cs_cons_free(csound, vals);
+      cs_hash_table_free(csound, csound->sndmemfiles);
+      csound->sndmemfiles = NULL;
+    }
+}
+
 int delete_memfile(CSOUND *csound, const char *filnam)
 {
     MEMFIL  *mfp, *prv;
@@ -564,68 +595,175 @@ int PVOCEX_LoadFile(CSOUND *csound, const char *fname, PVOCEX_MEMFILE *p)
 
  /* ------------------------------------------------------------------------ */
 
-/**
- * Load an entire sound file into memory.
- * 'fileName' is the file name (searched in the current directory first,
- * then search path defined by SSDIR, then SFDIR), and sfinfo (optional,
- * may be NULL) stores the default parameters for opening a raw file.
- * On success, a pointer to an SNDMEMFILE structure (see csoundCore.h) is
- * returned, and sound file parameters are stored in sfinfo (assuming that
- * it is not NULL).
- * Multiple calls of csoundLoadSoundFile() with the same file name will
- * share the same SNDMEMFILE structure, and the file is loaded only once
- * from disk.
- * The return value is NULL if an error occurs (the contents of sfinfo may
- * be undefined in this case).
- */
+/* Sound files in memory are shared by every user of the same file: the
+   key is the full path, the modification time and size of the file, and
+   the raw format defaults, so a file rewritten on disk is loaded again.
+   csoundLoadSoundFile() keeps its files until reset; GEN01 and diskin2
+   go through csoundAcquireSoundFile() and csoundReleaseSoundFile(), and
+   files nobody uses are dropped, least recently used first, once they add
+   up to more than the cache size (CS_SAMPLE_CACHE, in megabytes).  Files are decoded to float, not
+   mapped: a file rewritten in place would fault in every user.          */
 
-SNDMEMFILE *csoundLoadSoundFile(CSOUND *csound, const char *fileName, void *sfi)
+#define SAMPLE_CACHE_DEFAULT    64      /* megabytes */
+
+static int64_t sample_cache_size(CSOUND *csound)
+{
+    const char  *s = csoundGetEnv(csound, "CS_SAMPLE_CACHE");
+    if (s == NULL || s[0] == '\0')
+      return (int64_t) SAMPLE_CACHE_DEFAULT << 20;
+    return (int64_t) atoi(s) << 20;
+}
+
+static int64_t sound_file_bytes(const SNDMEMENTRY *p)
+{
+    return (int64_t) p->f.nFrames * p->f.nChannels * (int64_t) sizeof(float);
+}
+
+static void sound_file_free(CSOUND *csound, SNDMEMENTRY *p)
+{
+    if (p->instrument != NULL)
+      csound->Free(csound, p->instrument);
+    csound->Free(csound, p->f.name);
+    csound->Free(csound, p->f.fullName);
+    csound->Free(csound, p);
+}
+
+/* drop unused files, oldest first, until those left fit in 'size' bytes;
+   'released' is a file that has just lost its last user, or NULL */
+static void sound_file_trim(CSOUND *csound, int64_t size,
+                            SNDMEMENTRY *released)
+{
+    CONS_CELL   *keys, *k, *oldestKey;
+    int64_t     unused = 0;
+    uint64_t    last = 0;
+    SNDMEMENTRY *p, *oldest;
+
+    if (csound->sndmemfiles == NULL)
+      return;
+    keys = cs_hash_table_keys(csound, csound->sndmemfiles);
+    for (k = keys; k != NULL; k = k->next) {
+      p = cs_hash_table_get(csound, csound->sndmemfiles, (char*) k->value);
+      if (p->lastUse > last)
+        last = p->lastUse;
+      if (p->refCount <= 0)
+        unused += sound_file_bytes(p);
+    }
+    if (released != NULL)
+      released->lastUse = last + 1;
+    while (unused > size) {
+      oldest = NULL; oldestKey = NULL;
+      for (k = keys; k != NULL; k = k->next) {
+        if (k->value == NULL)
+          continue;
+        p = cs_hash_table_get(csound, csound->sndmemfiles, (char*) k->value);
+        if (p->refCount <= 0 &&
+            (oldest == NULL || p->lastUse < oldest->lastUse)) {
+          oldest = p; oldestKey = k;
+        }
+      }
+      if (oldest == NULL)
+        break;
+      unused -= sound_file_bytes(oldest);
+      /* cs_hash_table_remove() leaves the key to the caller */
+      cs_hash_table_remove(csound, csound->sndmemfiles,
+                           (char*) oldestKey->value);
+      csound->Free(csound, oldestKey->value);
+      oldestKey->value = NULL;
+      sound_file_free(csound, oldest);
+    }
+    cs_cons_free(csound, keys);
+}
+
+static SNDMEMFILE *sound_file_get(CSOUND *csound, const char *fileName,
+                                  SF_INFO *sfinfo, int acquire, int fitCache,
+                                  int cachedOnly)
 {
-    SF_INFO       *sfinfo = sfi;
     SNDFILE       *sf;
     void          *fd;
-    SNDMEMFILE    *p = NULL;
+    SNDMEMENTRY   *e = NULL;
+    SNDMEMFILE    *p;
     SF_INFO       tmp;
-
+    char          key[1024], *fullName;
+    struct stat   st;
+    int           raw;
 
     if (UNLIKELY(fileName == NULL || fileName[0] == '\0'))
       return NULL;
-
-    /* check if file is already loaded */
+    if (sfinfo == NULL) {
+      memset(&tmp, 0, sizeof(SF_INFO));
+      sfinfo = &tmp;
+    }
+    fullName = csoundFindInputFile(csound, fileName, "SFDIR;SSDIR");
+    if (fullName == NULL || stat(fullName, &st) != 0)
+      st.st_mtime = 0, st.st_size = 0;
+    /* the defaults only matter to a raw file */
+    raw = ((sfinfo->format & SF_FORMAT_TYPEMASK) == SF_FORMAT_RAW);
+    snprintf(key, sizeof(key), "%s\037%" PRId64 "\037%" PRId64 "\037%x/%d/%d",
+             fullName != NULL ? fullName : fileName, (int64_t) st.st_mtime,
+             (int64_t) st.st_size, raw ? (unsigned) sfinfo->format : 0U,
+             raw ? sfinfo->channels : 0, raw ? sfinfo->samplerate : 0);
+
+    /* check if file is already loaded; table workers of
+       csoundFTGenAsync() may be here too, so the database is locked, but
+       not while a file is read */
+    csoundFTAsyncLock(csound);
     if (csound->sndmemfiles != NULL) {
-      p = cs_hash_table_get(csound, csound->sndmemfiles, (char*)fileName);
+      e = cs_hash_table_get(csound, csound->sndmemfiles, key);
     }
     else {
       csound->sndmemfiles = cs_hash_table_create(csound);
     }
 
-    if (p != NULL) {
+    if (e != NULL) {
       /* if file was loaded earlier: */
-      if (sfinfo != NULL) {
-        memset(sfinfo, 0, sizeof(SF_INFO));
-        sfinfo->frames = (sf_count_t) p->nFrames;
-        sfinfo->samplerate = ((int) p->sampleRate + 0.5);
-        sfinfo->channels = p->nChannels;
-        sfinfo->format = FORMAT2SF(p->sampleFormat) | TYPE2SF(p->fileType);
-      }
+      e->refCount++;
+      csoundFTAsyncUnlock(csound);
+      p = &(e->f);
+      if (fullName != NULL)
+        csound->Free(csound, fullName);
+      memset(sfinfo, 0, sizeof(SF_INFO));
+      sfinfo->frames = (sf_count_t) p->nFrames;
+      sfinfo->samplerate = ((int) p->sampleRate + 0.5);
+      sfinfo->channels = p->nChannels;
+      sfinfo->format = FORMAT2SF(p->sampleFormat) | TYPE2SF(p->fileType);
       return p;
     }
-    /* open file */
-    if (sfinfo == NULL) {
-      memset(&tmp, 0, sizeof(SF_INFO));
-      sfinfo = &tmp;
+    csoundFTAsyncUnlock(csound);
+    if (cachedOnly) {
+      if (fullName != NULL)
+        csound->Free(csound, fullName);
+      return NULL;
     }
-    fd = csound->FileOpen2(csound, &sf, CSFILE_SND_R, fileName, sfinfo,
-                            "SFDIR;SSDIR", CSFTYPE_UNKNOWN_AUDIO, 0);
+    /* open file */
+    fd = csound->FileOpen2(csound, &sf, CSFILE_SND_R,
+                           fullName != NULL ? fullName : fileName, sfinfo,
+                           "SFDIR;SSDIR", CSFTYPE_UNKNOWN_AUDIO, 0);
+    if (fullName != NULL)
+      csound->Free(csound, fullName);
     if (UNLIKELY(fd == NULL)) {
-      csound->ErrorMsg(csound,
-                       Str("csoundLoadSoundFile(): failed to open '%s' %s"),
-                       fileName, Str(sf_strerror(NULL)));
+      if (!acquire)
+        csound->ErrorMsg(csound,
+                         Str("csoundLoadSoundFile(): failed to open '%s' %s"),
+                         fileName, Str(sf_strerror(NULL)));
       return NULL;
     }
-    p = (SNDMEMFILE*)
-            csound->Malloc(csound, sizeof(SNDMEMFILE)
-                           + (size_t)  sfinfo->frames * sizeof(float));
+    if (acquire) {
+      /* GEN01 and diskin2 read these at full precision, or not at all */
+      int sub = sfinfo->format & SF_FORMAT_SUBMASK;
+      int64_t nbytes =
+        (int64_t) sfinfo->frames * sfinfo->channels * (int64_t) sizeof(float);
+      if (sfinfo->frames <= 0 || sfinfo->frames >= (sf_count_t) 0x7FFFFFFF ||
+          sub == SF_FORMAT_PCM_32 || sub == SF_FORMAT_DOUBLE ||
+          (fitCache && nbytes > sample_cache_size(csound))) {
+        csound->FileClose(csound, fd);
+        return NULL;
+      }
+    }
+    e = (SNDMEMENTRY*) csound->Calloc(csound, offsetof(SNDMEMENTRY, f)
+                                      + sizeof(SNDMEMFILE)
+                                      + (size_t) sfinfo->frames
+                                      * sfinfo->channels * sizeof(float));
+    p = &(e->f);
     /* set parameters */
     p->name = (char*) csound->Malloc(csound, strlen(fileName) + 1);
     strcpy(p->name, fileName);
@@ -662,29 +800,112 @@ SNDMEMFILE *csoundLoadSoundFile(CSOUND *csound, const char *fileName, void *sfi)
         p->baseFreq = pow(2.0, (double) (((int) lpd.basenote - 69) * 100
                                          + (int) lpd.detune) / 1200.0) * csound->A4;
         p->scaleFac = pow(10.0, (double) lpd.gain * 0.05);
+        e->instrument = csound->Malloc(csound, sizeof(SF_INSTRUMENT));
+        memcpy(e->instrument, &lpd, sizeof(SF_INSTRUMENT));
       }
     }
-    if (UNLIKELY((size_t) sf_readf_float(sf, &(p->data[0]), (sf_count_t) p->nFrames)
+    if (UNLIKELY((size_t) sf_readf_float(sf, &(p->data[0]),
+                                         (sf_count_t) p->nFrames)
                  != p->nFrames)) {
       csound->FileClose(csound, fd);
-      csound->Free(csound, p->name);
-      csound->Free(csound, p->fullName);
-      csound->Free(csound, p);
-      csound->ErrorMsg(csound, Str("csoundLoadSoundFile(): error reading '%s'"),
-                               fileName);
+      sound_file_free(csound, e);
+      csound->ErrorMsg(csound,
+                       Str("csoundLoadSoundFile(): error reading '%s'"),
+                       fileName);
       return NULL;
     }
-    p->data[p->nFrames] = 0.0f;
+    p->data[p->nFrames * p->nChannels] = 0.0f;
     csound->FileClose(csound, fd);
     csound->Message(csound, "%s '%s' (sr = %d Hz, %d %s, %" PRId64 " %s) %s",
                     Str("File"), p->fullName, sfinfo->samplerate,
                     sfinfo->channels, Str("channel(s)"), (int64_t)sfinfo->frames,
-                    Str("sample frames"),
-                    Str("loaded into memory\n"));
+                    Str("sample frames"), Str("loaded into memory\n"));
 
-    /* link into database */
-    cs_hash_table_put(csound, csound->sndmemfiles, (char*)fileName, p);
+    /* link into database, unless another thread got there first */
+    csoundFTAsyncLock(csound);
+    {
+      SNDMEMENTRY *q = cs_hash_table_get(csound, csound->sndmemfiles, key);
+      if (UNLIKELY(q != NULL)) {
+        q->refCount++;
+        csoundFTAsyncUnlock(csound);
+        sound_file_free(csound, e);
+        return &(q->f);
+      }
+    }
+    cs_hash_table_put(csound, csound->sndmemfiles, key, e);
+    e->refCount = 1;
+    if (acquire)
+      sound_file_trim(csound, sample_cache_size(csound), NULL);
+    csoundFTAsyncUnlock(csound);
 
     /* return with pointer to file structure */
     return p;
 }
+
+/**
+ * Load an entire sound file into memory.
+ * 'fileName' is the file name (searched in the current directory first,
+ * then search path defined by SSDIR, then SFDIR), and sfinfo (optional,
+ * may be NULL) stores the default parameters for opening a raw file.
+ * On success, a pointer to an SNDMEMFILE structure (see csoundCore.h) is
+ * returned, and sound file parameters are stored in sfinfo (assuming that
+ * it is not NULL).
+ * Multiple calls of csoundLoadSoundFile() with the same file name will
+ * share the same SNDMEMFILE structure, and the file is loaded only once
+ * from disk.  The file stays in memory until the next reset.
+ * The return value is NULL if an error occurs (the contents of sfinfo may
+ * be undefined in this case).
+ */
+
+SNDMEMFILE *csoundLoadSoundFile(CSOUND *csound, const char *fileName, void *sfi)
+{
+    return sound_file_get(csound, fileName, (SF_INFO*) sfi, 0, 0, 0);
+}
+
+/**
+ * As csoundLoadSoundFile(), for a user that calls csoundReleaseSoundFile()
+ * when it is done.  Returns NULL, without a message, if the file cannot be
+ * opened, has a 32-bit integer or double sample format (which would lose
+ * precision as floats), has no known length, or, if 'fitCache' is
+ * non-zero, is larger than the cache size: the caller is then expected to
+ * read the file itself.
+ */
+
+SNDMEMFILE *csoundAcquireSoundFile(CSOUND *csound, const char *fileName,
+                                   void *sfi, int fitCache)
+{
+    return sound_file_get(csound, fileName, (SF_INFO*) sfi, 1, fitCache, 0);
+}
+
+/**
+ * As csoundAcquireSoundFile(), but only if the file is already in memory:
+ * never reads it, so it is safe where a decode would stall performance.
+ */
+
+SNDMEMFILE *csoundAcquireCachedSoundFile(CSOUND *csound, const char *fileName,
+                                         void *sfi)
+{
+    return sound_file_get(csound, fileName, (SF_INFO*) sfi, 1, 1, 1);
+}
+
+void csoundReleaseSoundFile(CSOUND *csound, SNDMEMFILE *p)
+{
+    if (p == NULL)
+      return;
+    csoundFTAsyncLock(csound);
+    if (--(SNDMEM_ENTRY(p)->refCount) <= 0)
+      sound_file_trim(csound, sample_cache_size(csound), SNDMEM_ENTRY(p));
+    csoundFTAsyncUnlock(csound);
+}
+
+/* the SF_INSTRUMENT chunk of a file from csoundLoadSoundFile() or
+   csoundAcquireSoundFile(), copied to 'lpd'; returns 0 if it has none */
+
+int csoundSoundFileInstrument(SNDMEMFILE *p, void *lpd)
+{
+    SNDMEMENTRY *e = SNDMEM_ENTRY(p);
+    if (e->instrument == NULL)
+      return 0;
+    memcpy(lpd, e->instrument, sizeof(SF_INSTRUMENT));
+    return 1;
+}
@@ -229,6 +229,7 @@ int musmon(CSOUND *csound)
     csound->spin  = (MYFLT *) csound->Calloc(csound, csound->nspin*sizeof(MYFLT));
     csound->spraw = (MYFLT *) csound->Calloc(csound, csound->nspout*sizeof(MYFLT));
     csound->spout = (MYFLT *) csound->Calloc(csound, csound->nspout*sizeof(MYFLT));
+    csound->spout_dirty = 0;
     csound->auxspin = (MYFLT *) csound->Calloc(csound, csound->nspin*sizeof(MYFLT));
     /* memset(csound->maxamp, '\0', sizeof(MYFLT)*MAXCHNLS); */
     /* memset(csound->smaxamp, '\0', sizeof(MYFLT)*MAXCHNLS); */
@@ -369,6 +370,7 @@ int musmon(CSOUND *csound)
       csound->Message(csound, Str("sorting cscore.out ..\n"));
       /* csound->scorestr = copy_to_corefile(csound, "cscore.srt", NULL, 1); */
       scsortstr(csound, csound->scorestr);  /* call the sorter again */
+      scbin_close(csound);                  /* and play what it sorted */
       fclose(csound->scfp); csound->scfp = NULL;
       fputs(corfile_body(csound->scstr), csound->oscfp);
       fclose(csound->oscfp); csound->oscfp = NULL;
@@ -414,12 +416,73 @@ static void deactivate_all_notes(CSOUND *csound)
     }
 }
 
+/* Pending real-time events are kept in a binary min-heap ordered on
+   start_kcnt, ties broken by insertion order, so that insertion and
+   dispatch are O(log n).  csound->OrcTrigEvts is always the top. */
+
+static inline int evtnode_before(EVTNODE *a, EVTNODE *b)
+{
+  return (a->start_kcnt < b->start_kcnt ||
+          (a->start_kcnt == b->start_kcnt && a->seqno < b->seqno));
+}
+
+static int rt_event_push(CSOUND *csound, EVTNODE *e)
+{
+  EVTNODE **heap = csound->OrcTrigHeap;
+  int     i = csound->OrcTrigCnt;
+
+  if (UNLIKELY(i >= csound->OrcTrigSize)) {
+    int size = (csound->OrcTrigSize ? csound->OrcTrigSize*2 : 256);
+    heap = (EVTNODE**) csound->ReAlloc(csound, heap, size*sizeof(EVTNODE*));
+    if (UNLIKELY(heap == NULL))
+      return CSOUND_MEMORY;
+    csound->OrcTrigHeap = heap;
+    csound->OrcTrigSize = size;
+  }
+  e->seqno = csound->OrcTrigSeqno++;
+  while (i > 0) {                               /* sift up */
+    int parent = (i-1) >> 1;
+    if (!evtnode_before(e, heap[parent])) break;
+    heap[i] = heap[parent];
+    i = parent;
+  }
+  heap[i] = e;
+  csound->OrcTrigCnt++;
+  csound->OrcTrigEvts = heap[0];
+  return 0;
+}
+
+static EVTNODE *rt_event_pop(CSOUND *csound)
+{
+  EVTNODE **heap = csound->OrcTrigHeap;
+  EVTNODE *top, *last;
+  int     i = 0, n;
+
+  if (csound->OrcTrigCnt == 0)
+    return NULL;
+  top = heap[0];
+  n = --csound->OrcTrigCnt;
+  last = heap[n];
+  while (1) {                                   /* sift down */
+    int child = 2*i+1;
+    if (child >= n) break;
+    if (child+1 < n && evtnode_before(heap[child+1], heap[child]))
+      child++;
+    if (!evtnode_before(heap[child], last)) break;
+    heap[i] = heap[child];
+    i = child;
+  }
+  if (n > 0) heap[i] = last;
+  csound->OrcTrigEvts = (n > 0 ? heap[0] : NULL);
+  return top;
+}
+
 static void delete_pending_rt_events(CSOUND *csound)
 {
-  EVTNODE *ep = csound->OrcTrigEvts;
+  int i;
 
-  while (ep != NULL) {
-    EVTNODE *nxt = ep->nxt;
+  for (i = 0; i < csound->OrcTrigCnt; i++) {
+    EVTNODE *ep = csound->OrcTrigHeap[i];
     if (ep->evt.strarg != NULL) {
       csound->Free(csound,ep->evt.strarg);
       ep->evt.strarg = NULL;
@@ -427,8 +490,8 @@ static void delete_pending_rt_events(CSOUND *csound)
     /* push to stack of free event nodes */
     ep->nxt = csound->freeEvtNodes;
     csound->freeEvtNodes = ep;
-    ep = nxt;
   }
+  csound->OrcTrigCnt = 0;
   csound->OrcTrigEvts = NULL;
 }
 
@@ -464,6 +527,9 @@ PUBLIC int csoundCleanup(CSOUND *csound)
     /* will not clean up more than once */
     csound->engineStatus &= ~(CS_STATE_CLN);
 
+    if (csound->profile_file != NULL)
+      csoundDumpProfile(csound, csound->profile_file);
+
     deactivate_all_notes(csound);
 
     if (csound->engineState.instrtxtp &&
@@ -487,10 +553,17 @@ PUBLIC int csoundCleanup(CSOUND *csound)
       csound->freeEvtNodes = ((EVTNODE*) p)->nxt;
       csound->Free(csound,p);
     }
+    if (csound->OrcTrigHeap != NULL) {
+      csound->Free(csound, csound->OrcTrigHeap);
+      csound->OrcTrigHeap = NULL;
+      csound->OrcTrigSize = 0;
+    }
 
     orcompact(csound);
 
     corfile_rm(csound, &csound->scstr);
+    scsortstream_stop(csound);
+    scbin_close(csound);
 
     /* print stats only if musmon was actually run */
     /* NOT SURE HOW   ************************** */
@@ -902,8 +975,8 @@ static int process_rt_event(CSOUND *csound, int sensType)
         insSendevt(csound, evt, rfd);  /* RM: or send to single remote Csound */
       return 0;
     }
-    /* pop from the list */
-    csound->OrcTrigEvts = e->nxt;
+    /* pop from the queue */
+    rt_event_pop(csound);
     retval = process_score_event(csound, evt, 1);
     if (evt->strarg != NULL) {
       csound->Free(csound, evt->strarg);
@@ -1238,7 +1311,7 @@ static inline uint64_t time2kcnt(CSOUND *csound, double tval)
 int insert_score_event_at_sample(CSOUND *csound, EVTBLK *evt, int64_t time_ofs)
 {
   double        start_time;
-  EVTNODE       *e, *prv;
+  EVTNODE       *e;
   CSOUND        *st = csound;
   MYFLT         *p;
   uint32        start_kcnt;
@@ -1371,17 +1444,10 @@ int insert_score_event_at_sample(CSOUND *csound, EVTBLK *evt, int64_t time_ofs)
   }
   /* queue new event */
   e->start_kcnt = start_kcnt;
-  prv = csound->OrcTrigEvts;
-  /* if list is empty, or at beginning of list: */
-  if (prv == NULL || start_kcnt < prv->start_kcnt) {
-    e->nxt = prv;
-    csound->OrcTrigEvts = e;
-  }
-  else {                                      /* otherwise sort by time */
-    while (prv->nxt != NULL && start_kcnt >= prv->nxt->start_kcnt)
-      prv = prv->nxt;
-    e->nxt = prv->nxt;
-    prv->nxt = e;
+  e->nxt = NULL;
+  if (UNLIKELY(rt_event_push(csound, e) != 0)) {
+    retval = CSOUND_MEMORY;
+    goto err_return;
   }
   /* Make sure sensevents() looks for RT events */
   csound->oparms->RTevents = 1;
@@ -1440,7 +1506,12 @@ void musmon_rewind_score(CSOUND *csound)
   csound->advanceCnt = 0;
   if (csound->csoundScoreOffsetSeconds_ > FL(0.0))
     csoundSetScoreOffsetSeconds(csound, csound->csoundScoreOffsetSeconds_);
-  if (csound->scstr)
+  if (UNLIKELY(csound->score_stream != NULL))
+    csound->Warning(csound, Str("cannot rewind score: it is sorted in "
+                                "windows\n"));
+  else if (csound->score_binary != NULL)
+    scbin_rewind(csound);
+  else if (csound->scstr)
     corfile_rewind(csound->scstr);
   else csound->Warning(csound, Str("cannot rewind score: no score in memory\n"));
 }
@@ -131,6 +131,9 @@ TREE *csoundParseOrc(CSOUND *csound, const char *str)
 {
     int err;
     OPARMS *O = csound->oparms;
+    /* the parallel dispatcher needs what the parser learns on the way */
+    int cached = (csound->orc_cache_dir != NULL && O->numThreads <= 1);
+    uint64_t cache_key = 0;
     csound->parserNamedInstrFlag = 2;
     {
       PRE_PARM    qq;
@@ -193,6 +196,15 @@ TREE *csoundParseOrc(CSOUND *csound, const char *str)
       corfile_rm(csound, &csound->orchstr);
 
     }
+    if (cached) {
+      TREE *root;
+      cache_key = orc_cache_key(csound, corfile_body(csound->expanded_orc),
+                                corfile_tell(csound->expanded_orc));
+      if ((root = orc_cache_load(csound, cache_key)) != NULL) {
+        corfile_rm(csound, &csound->expanded_orc);
+        return root;
+      }
+    }
     {
       /* VL 15.3.2015 allocating memory here will cause
          unwanted growth.
@@ -309,6 +321,7 @@ TREE *csoundParseOrc(CSOUND *csound, const char *str)
       newRoot = make_leaf(csound, 0, 0, 0, NULL);
       newRoot->markup = typeTable;
       newRoot->next = astTree;
+      if (cached) orc_cache_save(csound, cache_key, newRoot);
 
       /* if (str!=NULL){ */
       /*        if (typeTable != NULL) { */
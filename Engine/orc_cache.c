@@ -0,0 +1,690 @@
+/*
+    orc_cache.c:
+
+    Copyright (C) 2018 The Csound Developers
+
+    This file is part of Csound.
+
+    The Csound Library is free software; you can redistribute it
+    and/or modify it under the terms of the GNU Lesser General Public
+    License as published by the Free Software Foundation; either
+    version 2.1 of the License, or (at your option) any later version.
+
+    Csound is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public
+    License along with Csound; if not, write to the Free Software
+    Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA
+    02110-1301 USA
+*/
+
+/* Compiled-orchestra cache.  csoundParseOrc() keys the preprocessed
+   source, together with the opcode set and the globals it was checked
+   against, and keeps
+   the verified and optimised TREE in a file named after the key; a later
+   parse of the same source loads that file instead of running the parser,
+   the semantic checker and the optimiser again.
+
+   The file holds, in order: a header, the UDO signatures (replayed through
+   add_udo_definition() so that the OENTRYs and OPCODINFOs the parser would
+   have made exist again; the whole file is read and checked before the
+   first of them is), the table of OENTRYs the tree refers to, the
+   global and instr 0 variable pools, and the tree itself, each instr and
+   UDO node followed by its local pool.  OENTRYs are named by opname and
+   signature, variables by name and type, so nothing in the file depends
+   on addresses. */
+
+#include "csoundCore.h"
+#include "csound_orc.h"
+#include "csound_standard_types.h"
+#include "find_opcode.h"
+#include "csmodule.h"
+#include "namedins.h"
+#include <string.h>
+
+#if defined(HAVE_UNISTD_H)
+#include <unistd.h>
+#endif
+
+extern void init_symbtab(CSOUND *);
+extern int  add_udo_definition(CSOUND *, char *, char *, char *);
+extern void delete_tree(CSOUND *, TREE *);
+extern const char *SYNTHESIZED_ARG;
+
+#define ORC_CACHE_MAGIC   0x4353434fU   /* "OCSC" */
+#define ORC_CACHE_VERSION 1
+#define ORC_CACHE_NULL    0xffffffffU   /* length of a NULL string */
+
+enum { MARK_NONE, MARK_SYNTH, MARK_POOL, MARK_OENTRY };
+
+/* ---- keys ---- */
+
+static uint64_t fnv64(uint64_t h, const void *data, size_t len)
+{
+    const unsigned char *p = (const unsigned char *) data;
+    while (len--) {
+      h ^= *p++;
+      h *= 0x100000001b3ULL;
+    }
+    return h;
+}
+
+#define FNV64_INIT 0xcbf29ce484222325ULL
+
+static uint64_t fnv64_str(uint64_t h, const char *s)
+{
+    return fnv64(h, s != NULL ? s : "", (s != NULL ? strlen(s) : 0) + 1);
+}
+
+/* Every OENTRY a name resolves to, in list order, since the order decides
+   which overload the checker picks; names are summed so that the bucket
+   order of the table does not matter. */
+static uint64_t opcode_set_hash(CSOUND *csound)
+{
+    CS_HASH_TABLE *table = csound->opcodes;
+    uint64_t sum = 0;
+    uint32_t i;
+
+    for (i = 0; i < table->table_size; i++) {
+      CS_HASH_TABLE_ITEM *item;
+      for (item = table->buckets[i]; item != NULL; item = item->next) {
+        CONS_CELL *c;
+        uint64_t h = fnv64_str(FNV64_INIT, item->key);
+        for (c = (CONS_CELL *) item->value; c != NULL; c = c->next) {
+          OENTRY *ep = (OENTRY *) c->value;
+          h = fnv64_str(h, ep->opname);
+          h = fnv64_str(h, ep->outypes);
+          h = fnv64_str(h, ep->intypes);
+          h = fnv64(h, &ep->flags, sizeof(ep->flags));
+          h = fnv64(h, &ep->thread, sizeof(ep->thread));
+        }
+        sum += h;
+      }
+    }
+    return sum;
+}
+
+/* The globals defined by earlier compiles, which names in the source
+   may resolve to; summed like the opcodes */
+static uint64_t global_vars_hash(CSOUND *csound)
+{
+    CS_VARIABLE *var;
+    uint64_t sum = 0;
+
+    if (csound->engineState.varPool == NULL)
+      return 0;
+    for (var = csound->engineState.varPool->head; var != NULL;
+         var = var->next) {
+      uint64_t h = fnv64_str(FNV64_INIT, var->varName);
+      h = fnv64_str(h, var->varType->varTypeName);
+      h = fnv64(h, &var->dimensions, sizeof(var->dimensions));
+      h = fnv64_str(h, var->subType ? var->subType->varTypeName : NULL);
+      sum += h;
+    }
+    return sum;
+}
+
+uint64_t orc_cache_key(CSOUND *csound, const char *src, size_t len)
+{
+    uint64_t h = fnv64(FNV64_INIT, src, len);
+    uint64_t ops = opcode_set_hash(csound);
+    uint64_t globals = global_vars_hash(csound);
+    int32_t  sa = csound->oparms->sampleAccurate;
+    int32_t  fsize = (int32_t) sizeof(MYFLT);
+
+    h = fnv64(h, &ops, sizeof(ops));
+    h = fnv64(h, &globals, sizeof(globals));
+    h = fnv64(h, &sa, sizeof(sa));
+    h = fnv64(h, &fsize, sizeof(fsize));
+    return h;
+}
+
+static char *cache_path(CSOUND *csound, uint64_t key)
+{
+    const char *dir = csound->orc_cache_dir;
+    size_t n = strlen(dir) + 32;
+    char *path = (char *) csound->Malloc(csound, n);
+    snprintf(path, n, "%s/orc-%016llx.cache", dir, (unsigned long long) key);
+    return path;
+}
+
+/* OENTRYs are named by opname and signature, plus the number of earlier
+   entries with the same name and signature, which plugins may register
+   twice; entry_find() returns the nth, entry_nth() the number of ep */
+static OENTRY *entry_scan(CSOUND *csound, const char *opname,
+                          const char *outypes, const char *intypes,
+                          const OENTRY *ep, int *nth)
+{
+    char *shortName = get_opcode_short_name(csound, (char *) opname);
+    CONS_CELL *c = cs_hash_table_get(csound, csound->opcodes, shortName);
+    OENTRY *found = NULL;
+    int n = 0;
+
+    if (c == NULL && csoundLoadModuleForOpcode(csound, shortName))
+      c = cs_hash_table_get(csound, csound->opcodes, shortName);
+
+    for ( ; c != NULL; c = c->next) {
+      OENTRY *p = (OENTRY *) c->value;
+      if (strcmp(p->opname, opname) == 0 &&
+          strcmp(p->outypes, outypes) == 0 &&
+          strcmp(p->intypes, intypes) == 0) {
+        if (ep != NULL ? p == ep : n == *nth) {
+          found = p;
+          break;
+        }
+        n++;
+      }
+    }
+    if (shortName != opname) csound->Free(csound, shortName);
+    *nth = n;
+    return found;
+}
+
+static OENTRY *entry_find(CSOUND *csound, const char *opname,
+                          const char *outypes, const char *intypes, int nth)
+{
+    return entry_scan(csound, opname, outypes, intypes, NULL, &nth);
+}
+
+static int entry_nth(CSOUND *csound, OENTRY *ep)
+{
+    int nth = 0;
+    if (entry_scan(csound, ep->opname, ep->outypes, ep->intypes, ep, &nth)
+        == NULL) return -1;
+    return nth;
+}
+
+/* ---- writing ---- */
+
+typedef struct {
+    unsigned char *data;
+    size_t  len, size;
+} OBUF;
+
+typedef struct {
+    CSOUND  *csound;
+    OBUF    head, body;
+    OENTRY  **ents;             /* distinct OENTRYs, in order of use */
+    int     nents, maxents;
+    OENTRY  **slot;             /* open addressing index into ents */
+    int32_t *slotidx;
+    int     nslots;
+    int     err;
+} OWRITER;
+
+static void put(OWRITER *w, OBUF *b, const void *p, size_t n)
+{
+    if (b->len + n > b->size) {
+      size_t size = b->size ? b->size : 65536;
+      while (size < b->len + n) size *= 2;
+      b->data = (unsigned char *) w->csound->ReAlloc(w->csound, b->data, size);
+      b->size = size;
+    }
+    memcpy(b->data + b->len, p, n);
+    b->len += n;
+}
+
+static void put_i32(OWRITER *w, OBUF *b, int32_t v) { put(w, b, &v, 4); }
+
+static void put_str(OWRITER *w, OBUF *b, const char *s)
+{
+    uint32_t n = s != NULL ? (uint32_t) strlen(s) : ORC_CACHE_NULL;
+    put(w, b, &n, 4);
+    if (s != NULL) put(w, b, s, n);
+}
+
+static int32_t oentry_index(OWRITER *w, OENTRY *ep)
+{
+    CSOUND *csound = w->csound;
+    uintptr_t h;
+    int i;
+
+    if (2 * (w->nents + 1) > w->nslots) {
+      int nslots = w->nslots ? 2 * w->nslots : 256;
+      csound->Free(csound, w->slot);
+      csound->Free(csound, w->slotidx);
+      w->slot = (OENTRY **) csound->Calloc(csound, nslots * sizeof(OENTRY *));
+      w->slotidx = (int32_t *) csound->Malloc(csound, nslots * sizeof(int32_t));
+      w->nslots = nslots;
+      for (i = 0; i < w->nents; i++) {
+        h = ((uintptr_t) w->ents[i] >> 4) & (nslots - 1);
+        while (w->slot[h] != NULL) h = (h + 1) & (nslots - 1);
+        w->slot[h] = w->ents[i];
+        w->slotidx[h] = i;
+      }
+    }
+    h = ((uintptr_t) ep >> 4) & (w->nslots - 1);
+    while (w->slot[h] != NULL) {
+      if (w->slot[h] == ep) return w->slotidx[h];
+      h = (h + 1) & (w->nslots - 1);
+    }
+    if (w->nents == w->maxents) {
+      w->maxents = w->maxents ? 2 * w->maxents : 256;
+      w->ents = (OENTRY **) csound->ReAlloc(csound, w->ents,
+                                            w->maxents * sizeof(OENTRY *));
+    }
+    w->ents[w->nents] = ep;
+    w->slot[h] = ep;
+    w->slotidx[h] = w->nents;
+    return w->nents++;
+}
+
+static void write_pool(OWRITER *w, CS_VAR_POOL *pool)
+{
+    CS_VARIABLE *var;
+    put_i32(w, &w->body, pool->varCount);
+    put_i32(w, &w->body, pool->synthArgCount);
+    for (var = pool->head; var != NULL; var = var->next) {
+      put_str(w, &w->body, var->varName);
+      put_str(w, &w->body, var->varType->varTypeName);
+      put_i32(w, &w->body, var->dimensions);
+      put_str(w, &w->body, var->subType ? var->subType->varTypeName : NULL);
+    }
+}
+
+static void write_tree(OWRITER *w, TREE *t)
+{
+    OBUF *b = &w->body;
+    for ( ; t != NULL; t = t->next) {
+      put(w, b, "\1", 1);
+      put_i32(w, b, t->type);
+      put_i32(w, b, t->rate);
+      put_i32(w, b, t->len);
+      put_i32(w, b, t->line);
+      put(w, b, &t->locn, sizeof(uint64_t));
+      if (t->value != NULL) {
+        put(w, b, "\1", 1);
+        put_i32(w, b, t->value->type);
+        put_str(w, b, t->value->lexeme);
+        put_i32(w, b, t->value->value);
+        put(w, b, &t->value->fvalue, sizeof(double));
+        put_str(w, b, t->value->optype);
+      }
+      else put(w, b, "\0", 1);
+      if (t->markup == NULL)
+        put_i32(w, b, MARK_NONE);
+      else if (t->markup == &SYNTHESIZED_ARG)
+        put_i32(w, b, MARK_SYNTH);
+      else if (t->type == INSTR_TOKEN || t->type == UDO_TOKEN) {
+        put_i32(w, b, MARK_POOL);
+        write_pool(w, (CS_VAR_POOL *) t->markup);
+      }
+      else {
+        put_i32(w, b, MARK_OENTRY);
+        put_i32(w, b, oentry_index(w, (OENTRY *) t->markup));
+      }
+      write_tree(w, t->left);
+      write_tree(w, t->right);
+    }
+    put(w, b, "\0", 1);
+}
+
+void orc_cache_save(CSOUND *csound, uint64_t key, TREE *root)
+{
+    TYPE_TABLE *typeTable = (TYPE_TABLE *) root->markup;
+    OWRITER w;
+    TREE    *t;
+    char    *path, *tmp;
+    FILE    *f;
+    int32_t i, nudos = 0;
+    uint32_t magic = ORC_CACHE_MAGIC;
+    int     ok;
+
+    memset(&w, 0, sizeof(OWRITER));
+    w.csound = csound;
+    write_pool(&w, typeTable->globalPool);
+    write_pool(&w, typeTable->instr0LocalPool);
+    write_tree(&w, root->next);
+
+    put(&w, &w.head, &magic, 4);
+    put_i32(&w, &w.head, ORC_CACHE_VERSION);
+    put_i32(&w, &w.head, (int32_t) sizeof(MYFLT));
+    put(&w, &w.head, &key, sizeof(uint64_t));
+    for (t = root->next; t != NULL; t = t->next)
+      nudos += (t->type == UDO_TOKEN);
+    put_i32(&w, &w.head, nudos);
+    for (t = root->next; t != NULL; t = t->next)
+      if (t->type == UDO_TOKEN) {
+        put_str(&w, &w.head, t->left->value->lexeme);
+        put_str(&w, &w.head, t->left->left->value->lexeme);
+        put_str(&w, &w.head, t->left->right->value->lexeme);
+      }
+    put_i32(&w, &w.head, w.nents);
+    for (i = 0; i < w.nents; i++) {
+      OENTRY *ep = w.ents[i];
+      int32_t nth = entry_nth(csound, ep);
+      if (UNLIKELY(nth < 0)) {      /* not reachable by name: do not cache */
+        w.err = 1;
+        break;
+      }
+      put_str(&w, &w.head, ep->opname);
+      put_str(&w, &w.head, ep->outypes);
+      put_str(&w, &w.head, ep->intypes);
+      put_i32(&w, &w.head, nth);
+    }
+
+    path = cache_path(csound, key);
+    tmp = (char *) csound->Malloc(csound, strlen(path) + 24);
+#if defined(HAVE_UNISTD_H)
+    sprintf(tmp, "%s.%d", path, (int) getpid());
+#else
+    sprintf(tmp, "%s.%p", path, (void *) csound);
+#endif
+    if (!w.err && (f = fopen(tmp, "wb")) != NULL) {
+      ok = fwrite(w.head.data, 1, w.head.len, f) == w.head.len &&
+           fwrite(w.body.data, 1, w.body.len, f) == w.body.len;
+      ok = (fclose(f) == 0) && ok;
+      /* readers see either no file or a whole one */
+      if (!ok || rename(tmp, path) != 0) {
+        remove(tmp);
+        ok = 0;
+      }
+    }
+    else ok = 0;
+    if (UNLIKELY(!ok))
+      csound->Warning(csound, Str("could not write orchestra cache %s"), path);
+    else if (UNLIKELY(csound->oparms->odebug))
+      csound->Message(csound, Str("orchestra cached in %s\n"), path);
+
+    csound->Free(csound, tmp);
+    csound->Free(csound, path);
+    csound->Free(csound, w.head.data);
+    csound->Free(csound, w.body.data);
+    csound->Free(csound, w.ents);
+    csound->Free(csound, w.slot);
+    csound->Free(csound, w.slotidx);
+}
+
+/* ---- reading ---- */
+
+typedef struct {
+    CSOUND  *csound;
+    const unsigned char *p, *end;
+    OENTRY  **ents;
+    int32_t nents;
+    char    **udos;             /* UDO names, on the checking pass */
+    int32_t nudos;
+    int     err;
+} OREADER;
+
+/* stands for the OENTRY of a UDO that the checking pass does not define */
+static OENTRY pending_udo;
+
+static void get(OREADER *r, void *v, size_t n)
+{
+    if (UNLIKELY(r->err || (size_t) (r->end - r->p) < n)) {
+      r->err = 1;
+      memset(v, 0, n);
+      return;
+    }
+    memcpy(v, r->p, n);
+    r->p += n;
+}
+
+static int32_t get_i32(OREADER *r)
+{
+    int32_t v;
+    get(r, &v, 4);
+    return v;
+}
+
+static char *get_str(OREADER *r)
+{
+    uint32_t n;
+    char *s;
+    get(r, &n, 4);
+    if (n == ORC_CACHE_NULL || r->err) return NULL;
+    if (UNLIKELY((size_t) (r->end - r->p) < n)) {
+      r->err = 1;
+      return NULL;
+    }
+    s = (char *) r->csound->Calloc(r->csound, n + 1);
+    memcpy(s, r->p, n);
+    r->p += n;
+    return s;
+}
+
+static CS_VAR_POOL *read_pool(OREADER *r)
+{
+    CSOUND *csound = r->csound;
+    CS_VAR_POOL *pool = csoundCreateVarPool(csound);
+    int32_t i, n = get_i32(r);
+
+    pool->synthArgCount = get_i32(r);
+    for (i = 0; i < n && !r->err; i++) {
+      char *name = get_str(r), *type = get_str(r), *sub;
+      ARRAY_VAR_INIT varInit;
+      CS_VARIABLE *var = NULL;
+
+      varInit.dimensions = get_i32(r);
+      sub = get_str(r);
+      varInit.type = sub ? csoundGetTypeWithVarTypeName(csound->typePool, sub)
+                         : NULL;
+      if (name != NULL && type != NULL)
+        var = csoundCreateVariable(csound, csound->typePool,
+                                   csoundGetTypeWithVarTypeName(csound->typePool,
+                                                                type),
+                                   name, &varInit);
+      if (UNLIKELY(var == NULL)) r->err = 1;
+      else csoundAddVariable(csound, pool, var);
+      csound->Free(csound, name);
+      csound->Free(csound, type);
+      csound->Free(csound, sub);
+    }
+    return pool;
+}
+
+static TREE *read_tree(OREADER *r)
+{
+    CSOUND *csound = r->csound;
+    TREE *head = NULL, **tail = &head;
+    char more;
+
+    for (get(r, &more, 1); more && !r->err; get(r, &more, 1)) {
+      TREE *t = (TREE *) csound->Calloc(csound, sizeof(TREE));
+      char hasval;
+      int32_t mark;
+
+      *tail = t;
+      tail = &t->next;
+      t->type = get_i32(r);
+      t->rate = get_i32(r);
+      t->len = get_i32(r);
+      t->line = get_i32(r);
+      get(r, &t->locn, sizeof(uint64_t));
+      get(r, &hasval, 1);
+      if (hasval) {
+        ORCTOKEN *v = (ORCTOKEN *) csound->Calloc(csound, sizeof(ORCTOKEN));
+        t->value = v;
+        v->type = get_i32(r);
+        v->lexeme = get_str(r);
+        v->value = get_i32(r);
+        get(r, &v->fvalue, sizeof(double));
+        v->optype = get_str(r);
+      }
+      switch ((mark = get_i32(r))) {
+      case MARK_NONE:
+        break;
+      case MARK_SYNTH:
+        t->markup = &SYNTHESIZED_ARG;
+        break;
+      case MARK_POOL:
+        t->markup = read_pool(r);
+        break;
+      case MARK_OENTRY:
+        mark = get_i32(r);
+        if (LIKELY(mark >= 0 && mark < r->nents)) t->markup = r->ents[mark];
+        else r->err = 1;
+        break;
+      default:
+        r->err = 1;
+      }
+      t->left = read_tree(r);
+      t->right = read_tree(r);
+    }
+    return head;
+}
+
+/* local pools of a tree that failed to load, before delete_tree() */
+static void free_pools(CSOUND *csound, TREE *t)
+{
+    for ( ; t != NULL; t = t->next) {
+      if ((t->type == INSTR_TOKEN || t->type == UDO_TOKEN) && t->markup)
+        csoundFreeVarPool(csound, (CS_VAR_POOL *) t->markup);
+      free_pools(csound, t->left);
+      free_pools(csound, t->right);
+    }
+}
+
+/* Everything after the header.  On the checking pass (apply clear) no
+   UDO is defined and the OENTRYs named after one in the file are taken
+   on trust, so a damaged file changes nothing; the second pass defines
+   the UDOs. */
+static TREE *read_body(OREADER *r, int apply,
+                       CS_VAR_POOL **globals, CS_VAR_POOL **instr0)
+{
+    CSOUND *csound = r->csound;
+    TREE   *tree;
+    int32_t i, j, n;
+
+    n = get_i32(r);
+    if (UNLIKELY(r->err || n < 0 || (size_t) n > (size_t) (r->end - r->p)))
+      r->err = 1;
+    else if (!apply)
+      r->udos = (char **) csound->Calloc(csound, (n + 1) * sizeof(char *));
+    for (i = 0; i < n && !r->err; i++) {
+      char *name = get_str(r), *outs = get_str(r), *ins = get_str(r);
+      if (name != NULL && outs != NULL && ins != NULL &&
+          (apply ? add_udo_definition(csound, name, outs, ins) == 0
+                 : check_instr_name(name))) {
+        if (!apply) {
+          r->udos[r->nudos++] = name;
+          name = NULL;
+          csound->Free(csound, outs);
+          csound->Free(csound, ins);
+        }                       /* else the OPCODINFO keeps outs and ins */
+      }
+      else {
+        r->err = 1;
+        csound->Free(csound, outs);
+        csound->Free(csound, ins);
+      }
+      csound->Free(csound, name);
+    }
+    r->nents = get_i32(r);
+    if (!r->err && r->nents >= 0 &&
+        (size_t) r->nents <= (size_t) (r->end - r->p))
+      r->ents = (OENTRY **) csound->Calloc(csound,
+                                           (r->nents + 1) * sizeof(OENTRY *));
+    else r->err = 1;
+    for (i = 0; i < r->nents && !r->err; i++) {
+      char *name = get_str(r), *outs = get_str(r), *ins = get_str(r);
+      int32_t nth = get_i32(r);
+      if (name != NULL && outs != NULL && ins != NULL) {
+        for (j = 0; j < r->nudos; j++)
+          if (strcmp(r->udos[j], name) == 0) break;
+        r->ents[i] = j < r->nudos ? &pending_udo
+                                  : entry_find(csound, name, outs, ins, nth);
+      }
+      if (r->ents[i] == NULL) r->err = 1;
+      csound->Free(csound, name);
+      csound->Free(csound, outs);
+      csound->Free(csound, ins);
+    }
+
+    *globals = read_pool(r);
+    *instr0 = read_pool(r);
+    tree = read_tree(r);
+    csound->Free(csound, r->ents);
+    r->ents = NULL;
+    for (j = 0; j < r->nudos; j++)
+      csound->Free(csound, r->udos[j]);
+    csound->Free(csound, r->udos);
+    r->udos = NULL;
+    r->nudos = 0;
+    return tree;
+}
+
+TREE *orc_cache_load(CSOUND *csound, uint64_t key)
+{
+    char    *path = cache_path(csound, key);
+    FILE    *f = fopen(path, "rb");
+    unsigned char *data;
+    OREADER r;
+    TYPE_TABLE *typeTable;
+    TREE    *root, *tree;
+    CS_VAR_POOL *globals, *instr0;
+    const unsigned char *body;
+    uint64_t fkey;
+    uint32_t magic;
+    long    len;
+
+    if (f == NULL) {
+      csound->Free(csound, path);
+      return NULL;
+    }
+    fseek(f, 0L, SEEK_END);
+    len = ftell(f);
+    fseek(f, 0L, SEEK_SET);
+    data = (unsigned char *) csound->Malloc(csound, len > 0 ? len : 1);
+    memset(&r, 0, sizeof(OREADER));
+    r.csound = csound;
+    r.p = data;
+    r.end = data + (len > 0 && fread(data, 1, len, f) == (size_t) len ? len : 0);
+    fclose(f);
+
+    get(&r, &magic, 4);
+    if (magic != ORC_CACHE_MAGIC || get_i32(&r) != ORC_CACHE_VERSION ||
+        get_i32(&r) != (int32_t) sizeof(MYFLT) ||
+        (get(&r, &fkey, sizeof(uint64_t)), fkey != key) || r.err) {
+      csound->Free(csound, data);
+      csound->Free(csound, path);
+      return NULL;
+    }
+
+    /* check the whole file, then do what the parser does on the way:
+       symbols, then UDO signatures */
+    body = r.p;
+    tree = read_body(&r, 0, &globals, &instr0);
+    free_pools(csound, tree);
+    delete_tree(csound, tree);
+    csoundFreeVarPool(csound, globals);
+    csoundFreeVarPool(csound, instr0);
+    if (!r.err && r.p == r.end) {
+      r.p = body;
+      init_symbtab(csound);
+      tree = read_body(&r, 1, &globals, &instr0);
+      if (UNLIKELY(r.err || r.p != r.end)) {
+        free_pools(csound, tree);
+        delete_tree(csound, tree);
+        csoundFreeVarPool(csound, globals);
+        csoundFreeVarPool(csound, instr0);
+        r.err = 1;
+      }
+    }
+    else r.err = 1;
+    csound->Free(csound, data);
+    if (UNLIKELY(r.err)) {
+      csound->Warning(csound, Str("orchestra cache %s is damaged, ignored"),
+                      path);
+      csound->Free(csound, path);
+      return NULL;
+    }
+    if (UNLIKELY(csound->oparms->odebug))
+      csound->Message(csound, Str("orchestra loaded from cache %s\n"), path);
+    csound->Free(csound, path);
+
+    typeTable = csound->Malloc(csound, sizeof(TYPE_TABLE));
+    typeTable->udos = NULL;
+    typeTable->globalPool = globals;
+    typeTable->instr0LocalPool = instr0;
+    typeTable->localPool = instr0;
+    typeTable->labelList = NULL;
+    root = make_leaf(csound, 0, 0, 0, NULL);
+    root->markup = typeTable;
+    root->next = tree;
+    return root;
+}
@@ -144,6 +144,8 @@ int rdscor(CSOUND *csound, EVTBLK *e) /* read next score-line from scorefile */
     int     c;
 
     e->pinstance = NULL;
+    if (csound->score_binary != NULL)       /* mapped binary score */
+      return rdscorbin(csound, e);
     if (csound->scstr == NULL ||
         csound->scstr->body[0] == '\0') {   /* if no concurrent scorefile  */
       e->opcod = 'f';             /*     return an 'f 0 3600'    */
@@ -198,6 +200,8 @@ int rdscor(CSOUND *csound, EVTBLK *e) /* read next score-line from scorefile */
         e->pcnt = 0;
         return(1);
       case EOF:                          /* necessary for cscoreGetEvent */
+        if (csound->score_stream != NULL && scsortstream(csound))
+          continue;                      /* sorted the next score window */
         return(0);
       default:                                /* WARPED scorefile:       */
         if (!csound->warped) goto unwarped;
@@ -0,0 +1,338 @@
+/*
+    scbin.c:
+
+    Copyright (C) 2018 The Csound Developers
+
+    This file is part of Csound.
+
+    The Csound Library is free software; you can redistribute it
+    and/or modify it under the terms of the GNU Lesser General Public
+    License as published by the Free Software Foundation; either
+    version 2.1 of the License, or (at your option) any later version.
+
+    Csound is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public
+    License along with Csound; if not, write to the Free Software
+    Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA
+    02110-1301 USA
+*/
+
+#include "csoundCore.h"         /*                              SCBIN.C */
+#include "corfile.h"
+#include <stdint.h>
+#include <string.h>
+#if !defined(WIN32)
+#define HAVE_MMAP 1
+#include <sys/mman.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+/* file sizes past 2 GB, where long is 32 bits (LLP64, 32-bit systems) */
+#if defined(WIN32)
+#define SCBIN_SEEK(f, o, w)     _fseeki64(f, (__int64) (o), w)
+#define SCBIN_TELL(f)           ((int64_t) _ftelli64(f))
+#else
+#define SCBIN_SEEK(f, o, w)     fseeko(f, (off_t) (o), w)
+#define SCBIN_TELL(f)           ((int64_t) ftello(f))
+#endif
+
+/* Binary scores: the events rdscor() returns for a sorted and warped
+   score, stored so that they can be played again without the text
+   score being read, sorted and warped.  The file is a header followed
+   by one record per event, up to and including the final 'e':
+
+     SCBIN_EVENT      opcode, counts and unwarped p2 and p3
+     double[pcnt]     p1 .. pcnt, with p2 and p3 warped (seconds)
+     char[slen]       scnt NUL-terminated strings, padded to 8 bytes
+
+   A string p-field is a NaN whose low 16 bits index the event's strings.
+   Everything is 8-byte aligned, so a mapped file is read in place; the
+   byte order is that of the machine that wrote it.                      */
+
+#define SCBIN_MAGIC     "CsScBin1"
+#define SCBIN_ORDER     (0x01020304)
+#define SCBIN_VERSION   (1)
+#define SCBIN_STRING    (0x7FF8000000000000ULL)
+
+typedef struct {
+    char      magic[8];
+    uint32_t  order;            /* SCBIN_ORDER as written */
+    uint32_t  version;
+    uint64_t  nevents;          /* 0 if the writer could not seek back */
+} SCBIN_HEADER;
+
+typedef struct {
+    uint8_t   opcod;
+    uint8_t   unused1;
+    uint16_t  pcnt;
+    uint16_t  scnt;
+    uint16_t  unused2;
+    uint32_t  slen;
+    uint32_t  unused3;
+    double    p2orig, p3orig;
+} SCBIN_EVENT;
+
+typedef struct {
+    char      *base;            /* file contents */
+    size_t    len;
+    int       mapped;
+    const char *first, *p, *end;
+} SCBIN;
+
+void scbin_close(CSOUND *csound)
+{
+    SCBIN   *sb = (SCBIN*) csound->score_binary;
+
+    if (sb == NULL)
+      return;
+#ifdef HAVE_MMAP
+    if (sb->mapped)
+      munmap(sb->base, sb->len);
+    else
+#endif
+      csound->Free(csound, sb->base);
+    csound->Free(csound, sb);
+    csound->score_binary = NULL;
+}
+
+/* Opens 'name' as the score if it is a binary score.  Returns 1 if it
+   is, 0 if it is not (or cannot be opened), and -1 if it is damaged. */
+
+int scbin_open(CSOUND *csound, const char *name)
+{
+    FILE    *ff = NULL;
+    void    *fd;
+    SCBIN_HEADER hdr;
+    SCBIN   *sb;
+    int64_t len;
+
+    fd = csound->FileOpen2(csound, &ff, CSFILE_STD, name, "rb", NULL,
+                           CSFTYPE_SCORE, 0);
+    if (fd == NULL)
+      return 0;
+    if (fread(&hdr, sizeof(SCBIN_HEADER), 1, ff) != 1 ||
+        memcmp(hdr.magic, SCBIN_MAGIC, 8) != 0) {
+      csoundFileClose(csound, fd);
+      return 0;
+    }
+    if (UNLIKELY(hdr.order != SCBIN_ORDER || hdr.version != SCBIN_VERSION)) {
+      csound->ErrorMsg(csound, Str("binary score %s was written for another "
+                                   "byte order or version"), name);
+      csoundFileClose(csound, fd);
+      return -1;
+    }
+    if (UNLIKELY(SCBIN_SEEK(ff, 0, SEEK_END) != 0 ||
+                 (len = SCBIN_TELL(ff)) < (int64_t) sizeof(SCBIN_HEADER))) {
+      csound->ErrorMsg(csound, Str("cannot read binary score %s"), name);
+      csoundFileClose(csound, fd);
+      return -1;
+    }
+    if (UNLIKELY((uint64_t) len > (uint64_t) SIZE_MAX)) {
+      csound->ErrorMsg(csound, Str("binary score %s is too large"), name);
+      csoundFileClose(csound, fd);
+      return -1;
+    }
+    sb = (SCBIN*) csound->Calloc(csound, sizeof(SCBIN));
+    sb->len = (size_t) len;
+#ifdef HAVE_MMAP
+    sb->base = (char*) mmap(NULL, sb->len, PROT_READ, MAP_PRIVATE,
+                            fileno(ff), 0);
+    if (sb->base != (char*) MAP_FAILED) {
+      sb->mapped = 1;
+      madvise(sb->base, sb->len, MADV_SEQUENTIAL);
+    }
+    else
+#endif
+    {
+      sb->base = (char*) csound->Malloc(csound, sb->len);
+      if (UNLIKELY(SCBIN_SEEK(ff, 0, SEEK_SET) != 0 ||
+                   fread(sb->base, 1, sb->len, ff) != sb->len)) {
+        csound->ErrorMsg(csound, Str("cannot read binary score %s"), name);
+        csound->Free(csound, sb->base);
+        csound->Free(csound, sb);
+        csoundFileClose(csound, fd);
+        return -1;
+      }
+    }
+    csoundFileClose(csound, fd);
+    sb->first = sb->p = sb->base + sizeof(SCBIN_HEADER);
+    sb->end = sb->base + sb->len;
+    scbin_close(csound);
+    csound->score_binary = sb;
+    if (hdr.nevents)
+      csound->Message(csound, Str("using binary score %s (%lu events)\n"),
+                      name, (unsigned long) hdr.nevents);
+    else
+      csound->Message(csound, Str("using binary score %s\n"), name);
+    return 1;
+}
+
+void scbin_rewind(CSOUND *csound)
+{
+    SCBIN   *sb = (SCBIN*) csound->score_binary;
+    sb->p = sb->first;
+}
+
+/* rdscor() for a binary score */
+
+int rdscorbin(CSOUND *csound, EVTBLK *e)
+{
+    SCBIN   *sb = (SCBIN*) csound->score_binary;
+    const SCBIN_EVENT *ev = (const SCBIN_EVENT*) sb->p;
+    const double *pf;
+    size_t  n;
+    int     i;
+
+    if ((size_t) (sb->end - sb->p) < sizeof(SCBIN_EVENT))
+      return 0;
+    n = sizeof(SCBIN_EVENT) + (size_t) ev->pcnt * sizeof(double) + ev->slen;
+    if (UNLIKELY(ev->pcnt >= PMAX || (size_t) (sb->end - sb->p) < n ||
+                 (ev->slen & 7) != 0)) {
+      csound->ErrorMsg(csound, Str("damaged event in binary score"));
+      sb->p = sb->end;
+      return 0;
+    }
+    sb->p += n;
+    e->opcod = (char) ev->opcod;
+    e->p2orig = (MYFLT) ev->p2orig;
+    e->p3orig = (MYFLT) ev->p3orig;
+    e->c.extra = NULL;
+    pf = (const double*) (ev + 1);
+    for (i = 0; i < ev->pcnt; i++) {
+      union {
+        double   d;
+        uint64_t u;
+      } v;
+      v.d = pf[i];
+      if (ev->scnt && isnan(v.d)) {
+        union {
+          MYFLT d;
+          int32 i;
+        } ch;
+        ch.d = SSTRCOD; ch.i += (int32) (v.u & 0xffff);
+        e->p[i + 1] = ch.d;
+      }
+      else
+        e->p[i + 1] = (MYFLT) v.d;
+    }
+    if (!csound->csoundIsScorePending_ && e->opcod == 'i') {
+      /* FIXME: should pause and not mute */
+      e->opcod = 'f'; e->p[1] = FL(0.0); e->pcnt = 2; e->scnt = 0;
+      return 1;
+    }
+    e->pcnt = ev->pcnt;
+    if (ev->scnt == 0) {
+      e->strarg = NULL; e->scnt = 0;
+      return 1;
+    }
+    /* insert_event() keeps the pointer, so each event has its own copy */
+    e->strarg = (char*) csound->Malloc(csound, ev->slen);
+    memcpy(e->strarg, pf + ev->pcnt, ev->slen);
+    e->scnt = ev->scnt;
+    return 1;
+}
+
+/* Writes the sorted score in csound->scstr to 'out' as a binary score.
+   Returns zero on success. */
+
+int scbin_write(CSOUND *csound, FILE *out)
+{
+    SCBIN_HEADER hdr;
+    EVTBLK  *e;
+    double  pf[PMAX];
+    int     i, err = 0, ended = 0;
+
+    memset(&hdr, 0, sizeof(SCBIN_HEADER));
+    memcpy(hdr.magic, SCBIN_MAGIC, 8);
+    hdr.order = SCBIN_ORDER;
+    hdr.version = SCBIN_VERSION;
+    if (UNLIKELY(fwrite(&hdr, sizeof(SCBIN_HEADER), 1, out) != 1))
+      return -1;
+    e = (EVTBLK*) csound->Calloc(csound, sizeof(EVTBLK));
+    /* rdscor() reads an empty score as an endless 'f 0' */
+    while (!ended && csound->scstr != NULL &&
+           corfile_body(csound->scstr)[0] != '\0' && rdscor(csound, e)) {
+      SCBIN_EVENT ev;
+      char    pad[8] = { 0 };
+      size_t  slen = 0;
+      if (UNLIKELY(e->pcnt >= PMAX)) {
+        csound->ErrorMsg(csound, Str("binary score: an event has more than "
+                                     "%d p-fields"), PMAX - 1);
+        err = -1;
+        break;
+      }
+      for (i = 1; i <= e->pcnt; i++) {
+        if (e->scnt && csound->ISSTRCOD(e->p[i])) {
+          union {
+            MYFLT d;
+            int32 i;
+          } ch;
+          union {
+            double   d;
+            uint64_t u;
+          } v;
+          ch.d = e->p[i];
+          v.u = SCBIN_STRING | (uint64_t) (ch.i & 0xffff);
+          pf[i - 1] = v.d;
+        }
+        else
+          pf[i - 1] = (double) e->p[i];
+      }
+      if (e->strarg == NULL)
+        e->scnt = 0;            /* 'e' does not clear the last event's */
+      if (e->scnt) {
+        const char *s = e->strarg;
+        for (i = 0; i < e->scnt; i++)
+          s += strlen(s) + 1;
+        slen = s - e->strarg;
+      }
+      memset(&ev, 0, sizeof(SCBIN_EVENT));
+      ev.opcod = (uint8_t) e->opcod;
+      ev.pcnt = (uint16_t) e->pcnt;
+      ev.scnt = (uint16_t) e->scnt;
+      ev.slen = (uint32_t) ((slen + 7) & ~(size_t) 7);
+      ev.p2orig = (double) e->p2orig;
+      ev.p3orig = (double) e->p3orig;
+      if (UNLIKELY(fwrite(&ev, sizeof(SCBIN_EVENT), 1, out) != 1 ||
+                   fwrite(pf, sizeof(double), e->pcnt, out) !=
+                   (size_t) e->pcnt ||
+                   (slen && (fwrite(e->strarg, 1, slen, out) != slen ||
+                             fwrite(pad, 1, ev.slen - slen, out) !=
+                             ev.slen - slen)))) {
+        err = -1;
+        break;
+      }
+      if (e->strarg != NULL) {
+        csound->Free(csound, e->strarg);
+        e->strarg = NULL;
+      }
+      hdr.nevents++;
+      ended = (e->opcod == 'e');
+    }
+    if (e->strarg != NULL)
+      csound->Free(csound, e->strarg);
+    csound->Free(csound, e);
+    if (err)
+      return err;
+    if (!ended) {
+      /* an empty score, or one that ended without 'e' */
+      SCBIN_EVENT ev;
+      memset(&ev, 0, sizeof(SCBIN_EVENT));
+      ev.opcod = 'e';
+      if (UNLIKELY(fwrite(&ev, sizeof(SCBIN_EVENT), 1, out) != 1))
+        return -1;
+      hdr.nevents++;
+    }
+    /* record the count if the output can seek; readers do not need it */
+    if (fseek(out, 0L, SEEK_SET) == 0) {
+      if (UNLIKELY(fwrite(&hdr, sizeof(SCBIN_HEADER), 1, out) != 1))
+        return -1;
+      fseek(out, 0L, SEEK_END);
+    }
+    return fflush(out) == 0 ? 0 : -1;
+}
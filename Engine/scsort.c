@@ -32,6 +32,193 @@ extern void sfree(CSOUND *csound);
 //extern void sread_init(CSOUND *csound);
 extern int  sread(CSOUND *csound);
 
+extern int  sreadwin(CSOUND *, int newsect, int nblk);
+extern void sread_compact(CSOUND *);
+extern void twarpwin(CSOUND *, int *tempo, int first);
+
+/* With --score-window a section is not read whole before it is sorted.
+   Statements are read a window at a time; everything starting more
+   than score_window beats before the latest start read so far is
+   sorted and written to scstr, and rdscor() asks for the next window
+   when it runs out.  Events that arrive later than the window allows
+   are played late.  Ramps and np/pp see only the current window. */
+
+#define SCSTREAM_MINBLK (65536) /* statements read between sorts */
+
+typedef struct {
+    MYFLT   window;             /* = csound->score_window */
+    MYFLT   maxp2;              /* latest start read in this section */
+    MYFLT   lastp2;             /* latest start written */
+    int     nblk;               /* statements to read for this window */
+    int     newsect;            /* the next read starts a section */
+    int     started;            /* some of this section has been written */
+    int     tempo;              /* and its t statement has been set */
+    int     nout;               /* events written in the whole score */
+    int     done;               /* score written to the end */
+    int32   late;               /* events written after later ones */
+    /* sorter state kept while csoundReadScore() sorts another score */
+    struct sreadStatics__ sread;
+    CORFIL  *expanded_sco;
+    SRTBLK  *frstbp;
+    void    *tseg, *tpsave;
+    int     sectcnt;
+} SCSTREAM;
+
+static inline int timed(int c)
+{
+    return (c == 'i' || c == 'f' || c == 'a' || c == 'q' || c == 'd');
+}
+
+/* read, sort and write one window; returns 0 at the end of the score */
+static int scstream_window(CSOUND *csound, SCSTREAM *st, CORFIL *sco)
+{
+    SRTBLK  *bp, *prv, **rd;
+    MYFLT   horizon;
+    int     rc, n, i, live, final, newsect = st->newsect;
+
+    rc = sreadwin(csound, newsect, st->nblk);
+    st->newsect = 0;
+    final = (rc != 2);
+    for (n = 0, bp = csound->frstbp; bp != NULL; bp = bp->nxtblk)
+      n++;
+    if (n == 0)
+      return rc;
+    if (newsect && rc == 1 && csound->frstbp->text[0] == 's') {
+      st->newsect = 1;                  /* ignore empty segment */
+      return 1;
+    }
+    /* keep the read order, which sread() needs for carries */
+    rd = (SRTBLK**) csound->Malloc(csound, n * sizeof(SRTBLK*));
+    for (i = 0, bp = csound->frstbp; i < n; i++, bp = bp->nxtblk)
+      rd[i] = bp;
+    /* sort the blocks not yet written */
+    csound->frstbp = prv = NULL;
+    for (i = live = 0; i < n; i++) {
+      if ((bp = rd[i])->written)
+        continue;
+      if (timed(bp->text[0]) && bp->newp2 > st->maxp2)
+        st->maxp2 = bp->newp2;
+      bp->prvblk = prv;
+      if (prv != NULL) prv->nxtblk = bp;
+      else csound->frstbp = bp;
+      prv = bp;
+      live++;
+    }
+    if (prv != NULL)
+      prv->nxtblk = NULL;
+    if (live > 0) {
+      sort(csound);
+      /* and write those that nothing still to come may precede */
+      horizon = st->maxp2 - st->window;
+      for (bp = csound->frstbp, prv = NULL; bp != NULL; bp = bp->nxtblk) {
+        if (timed(bp->text[0])) {
+          if (!final && bp->newp2 >= horizon)
+            break;
+          if (bp->newp2 < st->lastp2)
+            st->late++;
+          else st->lastp2 = bp->newp2;
+          st->nout++;
+        }
+        bp->written = 1;
+        prv = bp;
+      }
+      if (prv != NULL) {
+        prv->nxtblk = NULL;
+        twarpwin(csound, &st->tempo, !st->started);
+        swritestr(csound, sco, st->started ? 2 : 1);
+        st->started = 1;
+      }
+    }
+    /* relink everything in read order */
+    for (i = 0; i < n; i++) {
+      rd[i]->prvblk = i > 0 ? rd[i-1] : NULL;
+      rd[i]->nxtblk = i < n - 1 ? rd[i+1] : NULL;
+    }
+    csound->frstbp = rd[0];
+    csound->Free(csound, rd);
+    if (!final) {
+      sread_compact(csound);
+      for (live = 0, bp = csound->frstbp; bp != NULL; bp = bp->nxtblk)
+        if (!bp->written) live++;
+      st->nblk = live > SCSTREAM_MINBLK ? live : SCSTREAM_MINBLK;
+      return 1;
+    }
+    st->newsect = 1;                    /* section done */
+    st->started = st->tempo = 0;
+    st->maxp2 = st->lastp2 = FL(0.0);
+    st->nblk = SCSTREAM_MINBLK;
+    return rc;
+}
+
+/* called from rdscor() when it has read all of scstr: sorts the next
+   window of a score in its place.  Returns 0 when the score is done. */
+
+int scsortstream(CSOUND *csound)
+{
+    SCSTREAM *st = (SCSTREAM*) csound->score_stream;
+    CORFIL   *sco = csound->scstr;
+    int      more;
+
+    if (st == NULL || st->done || sco == NULL)
+      return 0;
+    corfile_reset(sco);
+    do {
+      more = scstream_window(csound, st, sco);
+    } while (more && sco->body[0] == '\0');
+    if (!more) {
+      if (st->nout == 0) {              /* as scsortstr() for an empty score */
+        corfile_reset(sco);
+        corfile_puts(csound, "f0 800000000000.0\ne\n", sco);
+      }
+      else corfile_puts(csound, "e\n", sco);
+      if (UNLIKELY(st->late > 0))
+        csound->Warning(csound, Str("%d score events started more than the "
+                                    "score window before a previous one "
+                                    "and were played late"), (int) st->late);
+      st->done = 1;
+      sfree(csound);
+    }
+    corfile_rewind(sco);
+    return (sco->body[0] != '\0');
+}
+
+void scsortstream_stop(CSOUND *csound)
+{
+    SCSTREAM *st = (SCSTREAM*) csound->score_stream;
+
+    if (st != NULL) {
+      if (!st->done)
+        sfree(csound);
+      csound->Free(csound, st);
+      csound->score_stream = NULL;
+    }
+}
+
+static void scstream_save(CSOUND *csound, SCSTREAM *st)
+{
+    st->sread = csound->sreadStatics;
+    st->expanded_sco = csound->expanded_sco;
+    st->frstbp = csound->frstbp;
+    st->tseg = csound->tseg;
+    st->tpsave = csound->tpsave;
+    st->sectcnt = csound->sectcnt;
+    csound->sreadStatics.curmem = NULL;
+    csound->expanded_sco = NULL;
+    csound->tseg = csound->tpsave = NULL;
+}
+
+static void scstream_restore(CSOUND *csound, SCSTREAM *st)
+{
+    corfile_rm(csound, &csound->expanded_sco);
+    csound->Free(csound, csound->tseg);
+    csound->sreadStatics = st->sread;
+    csound->expanded_sco = st->expanded_sco;
+    csound->frstbp = st->frstbp;
+    csound->tseg = st->tseg;
+    csound->tpsave = st->tpsave;
+    csound->sectcnt = st->sectcnt;
+}
+
 /* called from smain.c or some other main */
 /* reads,sorts,timewarps each score sect in turn */
 
@@ -41,6 +228,7 @@ char *scsortstr(CSOUND *csound, CORFIL *scin)
     int     n;
     int     first = 0;
     CORFIL *sco;
+    SCSTREAM *st = (SCSTREAM*) csound->score_stream;
 
     csound->scoreout = NULL;
     if (csound->scstr == NULL && (csound->engineStatus & CS_STATE_COMP) == 0) {
@@ -48,9 +236,23 @@ char *scsortstr(CSOUND *csound, CORFIL *scin)
       sco = csound->scstr = corfile_create_w(csound);
     }
     else sco = corfile_create_w(csound);
+    if (st != NULL && !st->done)
+      scstream_save(csound, st);        /* still reading a windowed score */
+    else st = NULL;
     csound->sectcnt = 0;
     sread_initstr(csound, scin);
 
+    if (first && csound->score_window > FL(0.0) && csound->xfilename == NULL &&
+        !csound->keep_tmp && !csound->oparms->usingcscore) {
+      st = (SCSTREAM*) csound->Calloc(csound, sizeof(SCSTREAM));
+      st->window = csound->score_window;
+      st->newsect = 1;
+      st->nblk = SCSTREAM_MINBLK;
+      csound->score_stream = st;
+      scsortstream(csound);             /* first window now, rest on demand */
+      return sco->body;
+    }
+
     while ((n = sread(csound)) > 0) {
       if (csound->frstbp->text[0] == 's') { // ignore empty segment
         // should this free memory?
@@ -75,6 +277,8 @@ char *scsortstr(CSOUND *csound, CORFIL *scin)
     }
     corfile_flush(csound, sco);
     sfree(csound);
+    if (st != NULL)
+      scstream_restore(csound, st);
     if (first) {
       return sco->body;
     }
@@ -299,19 +299,44 @@ void sread_initstr(CSOUND *csound, CORFIL *sco)
     }
 }
 
-int sread(CSOUND *csound)       /*  called from main,  reads from SCOREIN   */
-{                               /*  each score statement gets a sortblock   */
-    int  rtncod;                /* return code to calling program:      */
-                                /*   1 = section read                   */
-                                /*   0 = end of file                    */
+static void sread_section(CSOUND *csound)   /* start a new section */
+{
     /* sread_alloc_globals(csound); */
     STA(bp) = STA(prvibp) = csound->frstbp = NULL;
     STA(nxp) = NULL;
     STA(warpin) = 0;
     STA(lincnt) = 1;
     csound->sectcnt++;
-    rtncod = 0;
     salcinit(csound);           /* init the mem space for this section  */
+}
+
+static int sread_(CSOUND *csound, int nblk);
+
+int sread(CSOUND *csound)       /*  called from main,  reads from SCOREIN   */
+{                               /*  each score statement gets a sortblock   */
+    sread_section(csound);
+    return sread_(csound, 0);
+}
+
+/* Windowed reading for scsortstream(): read at most nblk statements,
+   starting a new section if newsect is set, else appending to the
+   blocks of the current one.  Returns 2 if the section continues. */
+
+int sreadwin(CSOUND *csound, int newsect, int nblk)
+{
+    if (newsect)
+      sread_section(csound);
+    return sread_(csound, nblk);
+}
+
+static int sread_(CSOUND *csound, int nblk)
+{
+    int  rtncod;                /* return code to calling program:      */
+                                /*   2 = nblk statements read           */
+                                /*   1 = section read                   */
+                                /*   0 = end of file                    */
+    int  nread = 0;
+    rtncod = 0;
 #ifdef never
     if (csound->score_parser) {
       extern int scope(CSOUND*);
@@ -579,6 +604,8 @@ int sread(CSOUND *csound)       /*  called from main,  reads from SCOREIN   */
                         STA(op), STA(op));
         break;
       }
+      if (nblk > 0 && ++nread >= nblk)
+        return 2;
     }
  ending:
     /* if (STA(repeat_cnt) > 0) { */
@@ -880,6 +907,7 @@ static void salcblk(CSOUND *csound)
     STA(bp)->prvblk = prvbp;
     STA(bp)->insno = 0;
     STA(bp)->pcnt = 0;
+    STA(bp)->written = 0;
     STA(bp)->lineno = STA(lincnt);
     STA(nxp) = &(STA(bp)->text[0]);
     *STA(nxp)++ = STA(op);                /* place op, blank into text    */
@@ -887,6 +915,66 @@ static void salcblk(CSOUND *csound)
     *STA(nxp) = '\0';
 }
 
+/* Windowed sorting: after a window has been written, drop the blocks
+   sent to scstr except those a carry may still copy (the latest of each
+   instrument, the last statement and prvibp), and move the rest, still
+   in read order, to fresh memory so the space stays O(window). */
+
+void sread_compact(CSOUND *csound)
+{
+    SRTBLK  *bp, *nbp, *prv = NULL;
+    uint32  *seen;
+    char    *mem, *p;
+    size_t  size = 0, n;
+
+    if ((bp = STA(bp)) == NULL)
+      return;
+    seen = (uint32*) csound->Calloc(csound, 65536 / 8);
+    do {                        /* newest first: find the carry sources */
+      uint16 k = (uint16) bp->insno;
+      if (bp->written) {
+        bp->written = (bp == STA(bp) || bp == STA(prvibp) ||
+                       (bp->insno != 0 && !(seen[k >> 5] & (1U << (k & 31)))))
+                      ? 2 : 1;
+      }
+      seen[k >> 5] |= 1U << (k & 31);
+    } while ((bp = bp->prvblk) != NULL);
+    csound->Free(csound, seen);
+    /* blocks lie in read order, so each ends where the next begins */
+    for (bp = csound->frstbp; bp != NULL; bp = bp->nxtblk)
+      if (bp->written != 1)
+        size += (bp->nxtblk != NULL ? (char*) bp->nxtblk : STA(nxp))
+                - (char*) bp;
+    size = (size + (size_t) (MEMSIZ - 1)) & ~((size_t) (MEMSIZ - 1));
+    mem = p = (char*) csound->Calloc(csound, size + MEMSIZ + MARGIN);
+    bp = csound->frstbp;
+    csound->frstbp = NULL;
+    for ( ; bp != NULL; bp = nbp) {
+      nbp = bp->nxtblk;
+      if (bp->written == 1)
+        continue;
+      n = (nbp != NULL ? (char*) nbp : STA(nxp)) - (char*) bp;
+      memcpy(p, bp, n);
+      if (bp == STA(prvibp))
+        STA(prvibp) = (SRTBLK*) p;
+      if (bp == STA(bp))
+        STA(bp) = (SRTBLK*) p;
+      bp = (SRTBLK*) p;
+      bp->prvblk = prv;
+      bp->nxtblk = NULL;
+      if (prv != NULL)
+        prv->nxtblk = bp;
+      else csound->frstbp = bp;
+      prv = bp;
+      p += n;
+    }
+    csound->Free(csound, STA(curmem));
+    STA(curmem) = mem;
+    STA(memend) = mem + size + MEMSIZ;
+    STA(nxp) = p;
+    STA(sp) = NULL;
+}
+
 void sfree(CSOUND *csound)       /* free all sorter allocated space */
 {                                /*    called at completion of sort */
     /* sread_alloc_globals(csound); */
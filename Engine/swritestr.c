@@ -59,6 +59,9 @@ static void fltout(CSOUND *csound, MYFLT n, CORFIL *sco)
    p2 and p3 values. In this case, swritestr() is
    called with first = 1;
    VL - new in Csound 6.
+   A later window of a section sorted by scsortstream()
+   is written with first = 2: warped, but without another
+   w statement.
 */
 
 void swritestr(CSOUND *csound, CORFIL *sco, int first)
@@ -74,7 +77,7 @@ void swritestr(CSOUND *csound, CORFIL *sco, int first)
     if ((c = bp->text[0]) != 'w'
         && c != 's' && c != 'e') {      /*   if no warp stmnt but real data,  */
       /* create warp-format indicator */
-      if (first) corfile_puts(csound, "w 0 60\n", sco);
+      if (first == 1) corfile_puts(csound, "w 0 60\n", sco);
       lincnt++;
     }
  nxtlin:
@@ -33,6 +33,7 @@
 #include "interlocks.h"
 #include "csound_orc_semantics.h"
 #include "csound_standard_types.h"
+#include "csmodule.h"
 
 #ifndef PARSER_DEBUG
 #define PARSER_DEBUG (0)
@@ -171,6 +172,20 @@ int isUDOAnsList(char *s)
     return 1;
 }
 
+/* tokens for an opcode that a deferred plugin has just added */
+static ORCTOKEN *add_plugin_token(CSOUND *csound, char *s)
+{
+    CONS_CELL *items = cs_hash_table_get(csound, csound->opcodes, s);
+    ORCTOKEN *ans = NULL;
+
+    for ( ; items != NULL; items = items->next) {
+      OENTRY *ep = items->value;
+      if (ep->dsblksiz < 0xfffb)
+        ans = add_token(csound, s, get_opcode_type(ep));
+    }
+    return ans;
+}
+
 ORCTOKEN *lookup_token(CSOUND *csound, char *s, void *yyscanner)
 {
     IGN(yyscanner);
@@ -201,6 +216,8 @@ ORCTOKEN *lookup_token(CSOUND *csound, char *s, void *yyscanner)
     }
 
     a = cs_hash_table_get(csound, csound->symbtab, s);
+    if (a == NULL && csoundLoadModuleForOpcode(csound, s))
+      a = add_plugin_token(csound, s);
 
     if (a != NULL) {
       ans = (ORCTOKEN*)csound->Malloc(csound, sizeof(ORCTOKEN));
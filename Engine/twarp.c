@@ -33,12 +33,11 @@ typedef struct {
 int     realtset(CSOUND *, SRTBLK *);
 MYFLT   realt(CSOUND *, MYFLT);
 
+static void twarpblks(CSOUND *);
+
 void twarp(CSOUND *csound) /* time-warp a score section acc to T-statement */
 {
     SRTBLK  *bp;
-    MYFLT   absp3;
-    MYFLT   endtime;
-    int     negp3;
 
     if (UNLIKELY((bp = csound->frstbp) == NULL))      /* if null file,         */
       return;
@@ -48,6 +47,40 @@ void twarp(CSOUND *csound) /* time-warp a score section acc to T-statement */
     bp->text[0] = 'w';                      /* else mark the t used  */
     if (!realtset(csound, bp))              /*  and init the t-array */
       return;                               /* (done if t0 60 or err) */
+    twarpblks(csound);
+}
+
+/* time-warp one window of a section sorted by scsortstream(); the
+   t-array set up by the first window is kept in *tempo for the rest */
+void twarpwin(CSOUND *csound, int *tempo, int first)
+{
+    SRTBLK  *bp;
+
+    for (bp = csound->frstbp; bp != NULL; bp = bp->nxtblk) {
+      if (bp->text[0] != 't')
+        continue;
+      if (first) {
+        bp->text[0] = 'w';
+        *tempo = realtset(csound, bp);
+        first = 0;
+      }
+      else {
+        csound->Warning(csound, Str("t statement after the first score "
+                                    "window ignored"));
+        bp->text[0] = 'x';
+      }
+    }
+    if (*tempo)
+      twarpblks(csound);
+}
+
+static void twarpblks(CSOUND *csound)
+{
+    SRTBLK  *bp;
+    MYFLT   absp3;
+    MYFLT   endtime;
+    int     negp3;
+
     bp  = csound->frstbp;
     negp3 = 0;
     do {
@@ -77,6 +110,7 @@ void twarp(CSOUND *csound) /* time-warp a score section acc to T-statement */
         break;
       case 't':
       case 'w':
+      case 'x':
         break;
       case 's':
       case 'e':
@@ -88,6 +88,35 @@ typedef struct {
     MYFLT   *r, *a, *b, *def;
 } DIVZ;
 
+/* ##fuse: an a-rate expression collapsed by the orchestra optimiser.
+   prog is the expression in postfix: 'a' and 'k' push the next argument
+   as a vector or a scalar, + - * / % pop two, and an upper-case letter
+   applies a function of one argument (see fuse_init). */
+#define FUSE_MAXARGS  32
+#define FUSE_MAXOPS   32
+#define FUSE_DEPTH    8
+
+typedef struct {
+    char    op, form;       /* form: FUSE_VV, FUSE_VS, FUSE_SV or FUSE_V */
+    union {
+      vop_vv_fn vv;
+      vop_vs_fn vs;
+      vop_sv_fn sv;
+      vop_v_fn  v;
+    } fn;
+    MYFLT   *d, *x, *y;     /* a scalar operand is read at each k-cycle */
+} FUSE_OP;
+
+typedef struct {
+    OPDS    h;
+    MYFLT   *r;
+    STRINGDAT *prog;
+    MYFLT   *args[FUSE_MAXARGS];
+    FUSE_OP code[FUSE_MAXOPS];
+    int32_t ncode, divk;    /* divk: some division has a scalar divisor */
+    AUXCH   regs;
+} FUSE;
+
 typedef struct {
     OPDS    h;
     MYFLT   *r, *a;
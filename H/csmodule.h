@@ -103,6 +103,15 @@ extern "C" {
    */
   int csoundDestroyModules(CSOUND *csound);
 
+  /**
+   * Load and initialise the plugin library that the plugin index
+   * (CS_PLUGIN_INDEX) names for opcode 'opname', if it was deferred;
+   * with 'opname' NULL, load all deferred libraries.
+   * Returns non-zero if 'opname' comes from a deferred library, which is
+   * now loaded.
+   */
+  int csoundLoadModuleForOpcode(CSOUND *csound, const char *opname);
+
   /**
    * Initialise opcodes not in entry1.c
    */
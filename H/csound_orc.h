@@ -66,6 +66,11 @@ ORCTOKEN *make_token(CSOUND *csound, char *s);
 /* extern double sr, kr;
 extern int ksmps, nchnls; */
 
+/* compiled-orchestra cache (orc_cache.c) */
+uint64_t orc_cache_key(CSOUND *, const char *, size_t);
+TREE* orc_cache_load(CSOUND *, uint64_t);
+void orc_cache_save(CSOUND *, uint64_t, TREE *);
+
 void query_deprecated_opcode(CSOUND *, ORCTOKEN *);
 int  query_reversewrite_opcode(CSOUND *, ORCTOKEN *);
 
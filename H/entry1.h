@@ -91,6 +91,7 @@ int32_t subin(CSOUND *, void *), subina(CSOUND *, void *);
 int32_t addinak(CSOUND *, void *), subinak(CSOUND *, void *);
 int32_t divzkk(CSOUND *, void *), divzka(CSOUND *, void *);
 int32_t divzak(CSOUND *, void *), divzaa(CSOUND *, void *);
+int32_t fuse_init(CSOUND *, void *), fuse_perf(CSOUND *, void *);
 int32_t int1(CSOUND *, void *), int1a(CSOUND *, void *);
 int32_t frac1(CSOUND *, void *), frac1a(CSOUND *, void *);
 int32_t int1_round(CSOUND *, void *), int1a_round(CSOUND *, void *);
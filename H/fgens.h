@@ -48,5 +48,35 @@ int csoundFTAlloc(CSOUND *csound, int tableNum, int len);
  */
 int csoundFTDelete(CSOUND *csound, int tableNum);
 
+/**
+ * As hfgens(), but unless the GEN needs other tables or shared state,
+ * the table is made by a worker thread and installed in flist at the
+ * start of a later k-cycle.  The table number, assigned now if p1 is
+ * zero and 'mode' non-zero, is stored in *fno; until the table is
+ * installed, csoundFTFind() waits for it and csoundFTFindP() fails.
+ * Returns zero if the arguments were accepted.
+ */
+int csoundFTGenAsync(CSOUND *csound, int *fno, const EVTBLK *evtblkp,
+                     int mode);
+
+/**
+ * Returns 1 if table 'fno' is installed, 0 while csoundFTGenAsync() is
+ * still making it, and -1 if it does not exist.
+ */
+int csoundFTReady(CSOUND *csound, int fno);
+
+/**
+ * Installs the tables finished by the workers; called by the perf thread
+ * at the start of each k-cycle.
+ */
+void csoundFTAsyncPublish(CSOUND *csound);
+
+/**
+ * The lock the table workers take around the list of open files and the
+ * sample cache; does nothing until the first csoundFTGenAsync().
+ */
+void csoundFTAsyncLock(CSOUND *csound);
+void csoundFTAsyncUnlock(CSOUND *csound);
+
 #endif  /* CSOUND_FGENS_H */
 
@@ -30,3 +30,7 @@ PUBLIC OENTRY* find_opcode_exact(CSOUND* csound, char* opname,
 /* find OENTRY with the specified name in opcode list */
 
 OENTRY* find_opcode(CSOUND *, char *);
+
+/* forget cached overload resolutions; called when the opcode list changes */
+
+void csoundClearOpcodeResolution(CSOUND *);
@@ -57,10 +57,25 @@ typedef struct {
 /* the number of optional outputs defined in entry.c */
 #define SUBINSTNUMOUTS  8
 
+/* kinds of UDO_ARGCOPY */
+#define UDO_COPY_K      0       /* one MYFLT */
+#define UDO_COPY_A      1       /* ksmps MYFLTs */
+#define UDO_COPY_AARR   2       /* array of a-signals */
+#define UDO_COPY_VALUE  3       /* anything else, through copyValue() */
+
+/* One perf-time argument copy of a UDO call, resolved by useropcdset() */
+typedef struct {
+    int     kind;
+    void    *src, *dst;
+    const CS_TYPE *type;
+} UDO_ARGCOPY;
+
 typedef struct {
     OPCODINFO *opcode_info;
     void    *uopcode_struct;
     INSDS   *parent_ip;
+    UDO_ARGCOPY *in_plan, *out_plan;  /* caller to UDO, and back */
+    int     in_cnt, out_cnt;
     MYFLT   *iobufp_ptrs[12];  /* expandable IV - Oct 26 2002 */ /* was 8 */
 } OPCOD_IOBUFS;
 
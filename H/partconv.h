@@ -0,0 +1,80 @@
+/*
+    partconv.h:
+
+    Copyright (C) 2018 The Csound Developers
+
+    This file is part of Csound.
+
+    The Csound Library is free software; you can redistribute it
+    and/or modify it under the terms of the GNU Lesser General Public
+    License as published by the Free Software Foundation; either
+    version 2.1 of the License, or (at your option) any later version.
+
+    Csound is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public
+    License along with Csound; if not, write to the Free Software
+    Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA
+    02110-1301 USA
+*/
+
+#ifndef CSOUND_PARTCONV_H
+#define CSOUND_PARTCONV_H
+
+#if !defined(__BUILDING_LIBCSOUND)
+#  error "Csound plugins and host applications should not include partconv.h"
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+  /**
+   * Non-uniform partitioned convolution; plugins reach these through
+   * csound->PartConvCreate() and friends.
+   *
+   * Creates a convolver of one input and 'nChannels' outputs for impulse
+   * responses of up to 'irLen' samples, with a latency of 'headSize'
+   * samples.  Partitions start at 'headSize' and double up to 'maxSize'
+   * (both powers of two); blocks longer than the head are computed over
+   * the following k-cycles, or by a background thread if 'threaded' is
+   * non-zero.  The impulse responses are silent until loaded.
+   * Returns NULL if the sizes are invalid.
+   */
+  void *csoundPartConvCreate(CSOUND *csound, int headSize, int maxSize,
+                             int irLen, int nChannels, int threaded);
+
+  /**
+   * Loads the partitions of channel 'chn' whose impulse response segment
+   * ends after 'start' and no later than 'end' samples, reading sample i
+   * from ir[i * stride] (zero at or beyond 'len').  A NULL 'ir' silences
+   * them.  start = -1, end = INT_MAX loads the whole response.
+   */
+  void csoundPartConvLoad(CSOUND *csound, void *pc, int chn,
+                          const MYFLT *ir, int stride, int len,
+                          int start, int end);
+
+  /**
+   * Convolves 'nsmps' samples of 'in' into out[0 .. nChannels - 1].
+   */
+  void csoundPartConvProcess(CSOUND *csound, void *pc, const MYFLT *in,
+                             MYFLT **out, int nsmps);
+
+  /**
+   * Clears the input history and pending output, keeping the responses.
+   */
+  void csoundPartConvClear(CSOUND *csound, void *pc);
+
+  /**
+   * Stops the background thread, if any, and frees the convolver.
+   */
+  void csoundPartConvDestroy(CSOUND *csound, void *pc);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif      /* CSOUND_PARTCONV_H */
@@ -58,8 +58,51 @@ TEXT    *getoptxt(CSOUND *, int *);
 void    reverbinit(CSOUND *);
 void    dispinit(CSOUND *);
 int     init0(CSOUND *);
+void    cs_interleave(MYFLT *, uint32_t, const MYFLT *const *,
+                      uint32_t, uint32_t);
+void    cs_interleave_planar(MYFLT *, const MYFLT *, uint32_t, uint32_t);
+void    cs_deinterleave(MYFLT *const *, uint32_t, const MYFLT *,
+                        uint32_t, uint32_t, uint32_t);
+int     cs_interleave_kernels(int set);
+int     cs_cpu_has(int avx);
+enum { VOP_ADD, VOP_SUB, VOP_MUL, VOP_DIV };
+typedef void (*vop_vv_fn)(MYFLT *r, const MYFLT *a, const MYFLT *b,
+                          uint32_t n);
+typedef void (*vop_vs_fn)(MYFLT *r, const MYFLT *a, MYFLT b, uint32_t n);
+typedef void (*vop_sv_fn)(MYFLT *r, MYFLT a, const MYFLT *b, uint32_t n);
+typedef void (*vop_divz_vv_fn)(MYFLT *r, const MYFLT *a, const MYFLT *b,
+                               MYFLT def, uint32_t n);
+typedef void (*vop_divz_sv_fn)(MYFLT *r, MYFLT a, const MYFLT *b,
+                               MYFLT def, uint32_t n);
+typedef void (*vop_v_fn)(MYFLT *r, const MYFLT *a, uint32_t n);
+
+typedef struct {
+    vop_vv_fn       vv[4];      /* indexed by VOP_ADD ... VOP_DIV */
+    vop_vs_fn       vs[4];
+    vop_sv_fn       sv[4];
+    vop_divz_vv_fn  divz_vv;
+    vop_divz_sv_fn  divz_sv;
+    vop_v_fn        vint, vfrac;
+} VOP_KERNELS;
+const VOP_KERNELS *cs_vop_kernels(void);
+int     cs_vop_kernel_sets(const VOP_KERNELS **);
+void    cs_vop_aa(int, MYFLT *, const MYFLT *, const MYFLT *, uint32_t);
+void    cs_vop_ak(int, MYFLT *, const MYFLT *, MYFLT, uint32_t);
+void    cs_vop_ka(int, MYFLT *, MYFLT, const MYFLT *, uint32_t);
+void    cs_vdivz_aa(MYFLT *, const MYFLT *, const MYFLT *, MYFLT, uint32_t);
+void    cs_vdivz_ka(MYFLT *, MYFLT, const MYFLT *, MYFLT, uint32_t);
+void    cs_vint(MYFLT *, const MYFLT *, uint32_t);
+void    cs_vfrac(MYFLT *, const MYFLT *, uint32_t);
+void    spoutsf_planar(CSOUND *);
 void    scsort(CSOUND *, FILE *, FILE *);
 char    *scsortstr(CSOUND *, CORFIL *);
+int     scsortstream(CSOUND *);
+void    scsortstream_stop(CSOUND *);
+int     scbin_open(CSOUND *, const char *);
+int     rdscorbin(CSOUND *, EVTBLK *);
+void    scbin_rewind(CSOUND *);
+void    scbin_close(CSOUND *);
+int     scbin_write(CSOUND *, FILE *);
 int     scxtract(CSOUND *, CORFIL *, FILE *);
 int     rdscor(CSOUND *, EVTBLK *);
 int     musmon(CSOUND *);
@@ -91,6 +134,7 @@ int     insert_score_event(CSOUND *, EVTBLK *, double);
 MEMFIL  *ldmemfile2withCB(CSOUND *csound, const char *filnam, int csFileType,
                           int (*callback)(CSOUND*, MEMFIL*));
 void    rlsmemfiles(CSOUND *);
+void    rlssndmemfiles(CSOUND *);
 int     delete_memfile(CSOUND *, const char *);
 char    *csoundTmpFileName(CSOUND *, const char *);
 void    *SAsndgetset(CSOUND *, char *, void *, MYFLT *, MYFLT *, MYFLT *, int);
@@ -99,6 +143,12 @@ void    *sndgetset(CSOUND *, void *);
 void    dbfs_init(CSOUND *, MYFLT dbfs);
 int     csoundLoadExternals(CSOUND *);
 SNDMEMFILE  *csoundLoadSoundFile(CSOUND *, const char *name, void *sfinfo);
+SNDMEMFILE  *csoundAcquireSoundFile(CSOUND *, const char *name, void *sfinfo,
+                                    int fitCache);
+SNDMEMFILE  *csoundAcquireCachedSoundFile(CSOUND *, const char *name,
+                                          void *sfinfo);
+void    csoundReleaseSoundFile(CSOUND *, SNDMEMFILE *);
+int     csoundSoundFileInstrument(SNDMEMFILE *, void *lpd);
 int     PVOCEX_LoadFile(CSOUND *, const char *fname, PVOCEX_MEMFILE *p);
 void    print_opcodedir_warning(CSOUND *);
 int     check_rtaudio_name(char *fName, char **devName, int isOutput);
@@ -40,6 +40,7 @@ typedef struct srtblk {
         MYFLT   newp3;
         int16   lineno;
         char    preced;
+        char    written;        /* windowed sort: already sent to scstr */
         char    text[9];
 } SRTBLK;
 
@@ -115,6 +115,33 @@ static void spoutsf(CSOUND *csound)
     csound->libsndStatics.nframes = nframes;
 }
 
+/* Level and range statistics of spoutsf, taken straight from the planar
+   spraw; used when a host reads planar output and no file or device
+   needs the interleaved spout. */
+void spoutsf_planar(CSOUND *csound)
+{
+    uint32_t chn, n, nsmps = csound->ksmps;
+    uint32   nframes = csound->libsndStatics.nframes;
+
+    if (csound->spoutactive) {
+      for (chn = 0; chn < (uint32_t) csound->nchnls; chn++) {
+        MYFLT *sp = csound->spraw + chn*nsmps;
+        for (n = 0; n < nsmps; n++) {
+          MYFLT absamp = sp[n] < FL(0.0) ? -sp[n] : sp[n];
+          if (absamp > csound->maxamp[chn]) {   /*  maxamp this seg  */
+            csound->maxamp[chn] = absamp;
+            csound->maxpos[chn] = nframes + n;
+          }
+          if (absamp > csound->e0dbfs) {        /* out of range?     */
+            csound->rngcnt[chn]++;              /*  report it        */
+            csound->rngflg = 1;
+          }
+        }
+      }
+    }
+    csound->libsndStatics.nframes = nframes + nsmps;
+}
+
 /* special version of spoutsf for "raw" floating point files */
 
 static void spoutsf_noscale(CSOUND *csound)
@@ -275,9 +275,9 @@ int32_t modkk(CSOUND *csound, AOP *p)
     return OK;
 }
 
-#define KA(OPNAME,OP)                                  \
+#define KA(OPNAME,OP,VOP)                              \
   int32_t OPNAME(CSOUND *csound, AOP *p) {             \
-    uint32_t n, nsmps = CS_KSMPS;                      \
+    uint32_t nsmps = CS_KSMPS;                         \
     IGN(csound);                                       \
     if (LIKELY(nsmps!=1)) {                            \
       MYFLT   *r, a, *b;                               \
@@ -291,8 +291,8 @@ int32_t modkk(CSOUND *csound, AOP *p)
         nsmps -= early;                                \
         memset(&r[nsmps], '\0', early*sizeof(MYFLT));  \
       }                                                \
-      for (n=offset; n<nsmps; n++)                     \
-        r[n] = a OP b[n];                              \
+      if (LIKELY(offset < nsmps))                      \
+        cs_vop_ka(VOP, r+offset, a, b+offset, nsmps-offset); \
       return OK;                                       \
     }                                                  \
     else {                                             \
@@ -302,10 +302,10 @@ int32_t modkk(CSOUND *csound, AOP *p)
   }
 
 
-KA(addka,+)
-KA(subka,-)
-KA(mulka,*)
-KA(divka,/)
+KA(addka,+,VOP_ADD)
+KA(subka,-,VOP_SUB)
+KA(mulka,*,VOP_MUL)
+KA(divka,/,VOP_DIV)
 
 int32_t modka(CSOUND *csound, AOP *p)
 {
@@ -328,9 +328,9 @@ int32_t modka(CSOUND *csound, AOP *p)
     return OK;
 }
 
-#define AK(OPNAME,OP)                           \
+#define AK(OPNAME,OP,VOP)                       \
   int32_t OPNAME(CSOUND *csound, AOP *p) {      \
-    uint32_t n, nsmps = CS_KSMPS;               \
+    uint32_t nsmps = CS_KSMPS;                  \
     IGN(csound);                                \
     if (LIKELY(nsmps != 1)) {                   \
       MYFLT   *r, *a, b;                        \
@@ -345,8 +345,8 @@ int32_t modka(CSOUND *csound, AOP *p)
         nsmps -= early;                         \
         memset(&r[nsmps], '\0', early*sizeof(MYFLT)); \
       }                                         \
-      for (n=offset; n<nsmps; n++)              \
-        r[n] = a[n] OP b;                       \
+      if (LIKELY(offset < nsmps))               \
+        cs_vop_ak(VOP, r+offset, a+offset, b, nsmps-offset); \
       return OK;                                \
     }                                           \
     else {                                      \
@@ -355,12 +355,12 @@ int32_t modka(CSOUND *csound, AOP *p)
     }                                           \
 }
 
-AK(addak,+)
-AK(subak,-)
-AK(mulak,*)
-//AK(divak,/)
+AK(addak,+,VOP_ADD)
+AK(subak,-,VOP_SUB)
+AK(mulak,*,VOP_MUL)
+//AK(divak,/,VOP_DIV)
 int32_t divak(CSOUND *csound, AOP *p) {
-    uint32_t n, nsmps = CS_KSMPS;
+    uint32_t nsmps = CS_KSMPS;
     MYFLT b = *p->b;
     if (LIKELY(nsmps != 1)) {
       MYFLT   *r, *a;
@@ -377,8 +377,8 @@ int32_t divak(CSOUND *csound, AOP *p) {
         nsmps -= early;
         memset(&r[nsmps], '\0', early*sizeof(MYFLT));
       }
-      for (n=offset; n<nsmps; n++)
-        r[n] = a[n] / b;
+      if (LIKELY(offset < nsmps))
+        cs_vop_ak(VOP_DIV, r+offset, a+offset, b, nsmps-offset);
       return OK;
     }
     else {
@@ -411,11 +411,11 @@ int32_t modak(CSOUND *csound, AOP *p)
     return OK;
 }
 
-#define AA(OPNAME,OP)                           \
+#define AA(OPNAME,OP,VOP)                       \
   int32_t OPNAME(CSOUND *csound, AOP *p) {      \
   MYFLT   *r, *a, *b;                           \
   IGN(csound);                                  \
-  uint32_t n, nsmps = CS_KSMPS;                 \
+  uint32_t nsmps = CS_KSMPS;                    \
   if (LIKELY(nsmps!=1)) {                       \
     uint32_t offset = p->h.insdshead->ksmps_offset;  \
     uint32_t early  = p->h.insdshead->ksmps_no_end;  \
@@ -427,8 +427,8 @@ int32_t modak(CSOUND *csound, AOP *p)
       nsmps -= early;                           \
       memset(&r[nsmps], '\0', early*sizeof(MYFLT)); \
     }                                           \
-    for (n=offset; n<nsmps; n++)                \
-      r[n] = a[n] OP b[n];                      \
+    if (LIKELY(offset < nsmps))                 \
+      cs_vop_aa(VOP, r+offset, a+offset, b+offset, nsmps-offset); \
     return OK;                                  \
   }                                             \
     else {                                      \
@@ -437,52 +437,11 @@ int32_t modak(CSOUND *csound, AOP *p)
     }                                           \
   }
 
-/* VL
-   experimental code using SSE for operations
-   needs memory alignment - 16 bytes
-*/
-#ifdef USE_SSE
-#include "emmintrin.h"
-#define AA_VEC(OPNAME,OP)                   \
-int32_t OPNAME(CSOUND *csound, AOP *p){     \
-  MYFLT   *r, *a, *b;                       \
-  __m128d va, vb;                           \
-  uint32_t n, nsmps = CS_KSMPS, end;        \
-  if (LIKELY(nsmps!=1)) {                   \
-  uint32_t offset = p->h.insdshead->ksmps_offset; \
-  uint32_t early  = p->h.insdshead->ksmps_no_end; \
-  r = p->r; a = p->a; b = p->b;             \
-  if (UNLIKELY(offset)) memset(r, '\0', offset*sizeof(MYFLT)); \
-  if (UNLIKELY(early)) {                    \
-      nsmps -= early;                       \
-      memset(&r[nsmps], '\0', early*sizeof(MYFLT));  \
-  } \
-  end = nsmps; \
-  for (n=offset; n<end; n+=2) { \
-   va = _mm_loadu_pd(&a[n]); \
-   vb = _mm_loadu_pd(&b[n]); \
-   va = OP(va,vb);\
-   _mm_storeu_pd(&r[n],va); \
-  }     \
-  return OK; \
-  } \
-   else { \
-     *p->r = *p->a + *p->b;\
-      return OK; \
-   }             \
-} \
-
-AA_VEC(addaa,_mm_add_pd)
-AA_VEC(subaa,_mm_sub_pd)
-AA_VEC(mulaa,_mm_mul_pd)
-AA_VEC(divaa,_mm_div_pd)
-
-#else
-AA(addaa,+)
-AA(subaa,-)
-AA(mulaa,*)
-AA(divaa,/)
-#endif
+/* the loops run in the vector kernels of aops_simd.c */
+AA(addaa,+,VOP_ADD)
+AA(subaa,-,VOP_SUB)
+AA(mulaa,*,VOP_MUL)
+AA(divaa,/,VOP_DIV)
 
 int32_t modaa(CSOUND *csound, AOP *p)
 {
@@ -514,7 +473,6 @@ int32_t divzkk(CSOUND *csound, DIVZ *p)
 
 int32_t divzka(CSOUND *csound, DIVZ *p)
 {
-    uint32_t n;
     IGN(csound);
     MYFLT    *r, a, *b, def;
     uint32_t offset = p->h.insdshead->ksmps_offset;
@@ -530,10 +488,8 @@ int32_t divzka(CSOUND *csound, DIVZ *p)
       nsmps -= early;
       memset(&r[nsmps], '\0', early*sizeof(MYFLT));
     }
-    for (n=offset; n<nsmps; n++) {
-      MYFLT bb = b[n];
-      r[n] = (bb==FL(0.0) ? def : a / bb);
-    }
+    if (LIKELY(offset < nsmps))
+      cs_vdivz_ka(r+offset, a, b+offset, def, nsmps-offset);
     return OK;
 }
 
@@ -558,15 +514,13 @@ int32_t divzak(CSOUND *csound, DIVZ *p)
     if (UNLIKELY(b==FL(0.0))) {
       for (n=offset; n<nsmps; n++) r[n] = def;
     }
-    else {
-      for (n=offset; n<nsmps; n++) r[n] = a[n] / b;
-    }
+    else if (LIKELY(offset < nsmps))
+      cs_vop_ak(VOP_DIV, r+offset, a+offset, b, nsmps-offset);
     return OK;
 }
 
 int32_t divzaa(CSOUND *csound, DIVZ *p)
 {
-    uint32_t n;
     IGN(csound);
     MYFLT    *r, *a, *b, def;
     uint32_t offset = p->h.insdshead->ksmps_offset;
@@ -582,10 +536,8 @@ int32_t divzaa(CSOUND *csound, DIVZ *p)
       nsmps -= early;
       memset(&r[nsmps], '\0', early*sizeof(MYFLT));
     }
-    for (n=offset; n<nsmps; n++) {
-      MYFLT bb=b[n];
-      r[n] = (bb==FL(0.0) ? def : a[n] / bb);
-    }
+    if (LIKELY(offset < nsmps))
+      cs_vdivz_aa(r+offset, a+offset, b+offset, def, nsmps-offset);
     return OK;
 }
 
@@ -629,10 +581,10 @@ int32_t int1(CSOUND *csound, EVAL *p)               /* returns signed whole no.
 
 int32_t int1a(CSOUND *csound, EVAL *p)              /* returns signed whole no. */
 {
-    MYFLT        intpart, *a=p->a, *r=p->r;
+    MYFLT        *a=p->a, *r=p->r;
     uint32_t offset = p->h.insdshead->ksmps_offset;
     uint32_t early  = p->h.insdshead->ksmps_no_end;
-    uint32_t n, nsmps =CS_KSMPS;
+    uint32_t nsmps =CS_KSMPS;
     IGN(csound);
 
     if (UNLIKELY(offset)) memset(r, '\0', offset*sizeof(MYFLT));
@@ -640,10 +592,8 @@ int32_t int1a(CSOUND *csound, EVAL *p)              /* returns signed whole no.
       nsmps -= early;
       memset(&r[nsmps], '\0', early*sizeof(MYFLT));
     }
-    for (n = offset; n < nsmps; n++) {
-      MODF(a[n], &intpart);
-      r[n] = intpart;
-    }
+    if (LIKELY(offset < nsmps))
+      cs_vint(r+offset, a+offset, nsmps-offset);
     return OK;
 }
 
@@ -658,10 +608,10 @@ int32_t frac1(CSOUND *csound, EVAL *p)              /* returns positive frac par
 
 int32_t frac1a(CSOUND *csound, EVAL *p)             /* returns positive frac part */
 {
-    MYFLT intpart, fracpart, *r = p->r, *a = p->a;
+    MYFLT *r = p->r, *a = p->a;
     uint32_t offset = p->h.insdshead->ksmps_offset;
     uint32_t early  = p->h.insdshead->ksmps_no_end;
-    uint32_t n, nsmps =CS_KSMPS;
+    uint32_t nsmps =CS_KSMPS;
     IGN(csound);
 
     if (UNLIKELY(offset)) memset(r, '\0', offset*sizeof(MYFLT));
@@ -669,10 +619,8 @@ int32_t frac1a(CSOUND *csound, EVAL *p)             /* returns positive frac par
       nsmps -= early;
       memset(&r[nsmps], '\0', early*sizeof(MYFLT));
     }
-    for (n = offset; n < nsmps; n++) {
-      fracpart = MODF(a[n], &intpart);
-      r[n] = fracpart;
-    }
+    if (LIKELY(offset < nsmps))
+      cs_vfrac(r+offset, a+offset, nsmps-offset);
     return OK;
 }
 
@@ -857,6 +805,183 @@ int32_t atan2aa(CSOUND *csound, AOP *p)
     return OK;
 }
 
+/* ##fuse: the postfix program is turned into a list of vector kernel
+   calls once, at init time, each writing a scratch register of ksmps
+   samples (the last one writes the output).  Every call is the kernel
+   the unfused opcode would have run, in the same order, so the result
+   is the same to the bit. */
+
+enum { FUSE_VV, FUSE_VS, FUSE_SV, FUSE_V };
+
+static void fuse_mod_vv(MYFLT *r, const MYFLT *a, const MYFLT *b, uint32_t n)
+{
+    uint32_t i;
+    for (i = 0; i < n; i++) r[i] = MOD(a[i], b[i]);
+}
+
+static void fuse_mod_vs(MYFLT *r, const MYFLT *a, MYFLT b, uint32_t n)
+{
+    uint32_t i;
+    for (i = 0; i < n; i++) r[i] = MOD(a[i], b);
+}
+
+static void fuse_mod_sv(MYFLT *r, MYFLT a, const MYFLT *b, uint32_t n)
+{
+    uint32_t i;
+    for (i = 0; i < n; i++) r[i] = MOD(a, b[i]);
+}
+
+#define FUSE_LIB(NAME, LIBNAME)                                 \
+static void NAME(MYFLT *r, const MYFLT *a, uint32_t n)          \
+{                                                               \
+    uint32_t i;                                                 \
+    for (i = 0; i < n; i++) r[i] = LIBNAME(a[i]);               \
+}
+
+FUSE_LIB(fuse_abs, FABS)
+FUSE_LIB(fuse_exp, EXP)
+FUSE_LIB(fuse_log, LOG)
+FUSE_LIB(fuse_sqrt, SQRT)
+FUSE_LIB(fuse_sin, SIN)
+FUSE_LIB(fuse_cos, COS)
+FUSE_LIB(fuse_tan, TAN)
+FUSE_LIB(fuse_asin, ASIN)
+FUSE_LIB(fuse_acos, ACOS)
+FUSE_LIB(fuse_atan, ATAN)
+FUSE_LIB(fuse_sinh, SINH)
+FUSE_LIB(fuse_cosh, COSH)
+FUSE_LIB(fuse_tanh, TANH)
+FUSE_LIB(fuse_log10, LOG10)
+FUSE_LIB(fuse_log2, LOG2)
+
+static vop_v_fn fuse_unary(const VOP_KERNELS *k, char op)
+{
+    switch (op) {
+    case 'I': return k->vint;
+    case 'F': return k->vfrac;
+    case 'A': return fuse_abs;
+    case 'E': return fuse_exp;
+    case 'L': return fuse_log;
+    case 'Q': return fuse_sqrt;
+    case 'S': return fuse_sin;
+    case 'C': return fuse_cos;
+    case 'T': return fuse_tan;
+    case 'J': return fuse_asin;
+    case 'K': return fuse_acos;
+    case 'M': return fuse_atan;
+    case 'H': return fuse_sinh;
+    case 'O': return fuse_cosh;
+    case 'N': return fuse_tanh;
+    case 'G': return fuse_log10;
+    case 'B': return fuse_log2;
+    }
+    return NULL;
+}
+
+int32_t fuse_init(CSOUND *csound, FUSE *p)
+{
+    const VOP_KERNELS *k = cs_vop_kernels();
+    const char *s = p->prog->data, *t = s, *ops = "+-*/%";
+    uint32_t ksmps = CS_KSMPS;
+    int32_t nargs = (int32_t) p->INOCOUNT - 1, narg = 0, sp = 0, depth = 0;
+    MYFLT   *stk[FUSE_DEPTH], *reg;
+    char    vec[FUSE_DEPTH];
+    FUSE_OP *c;
+
+    if (UNLIKELY(nargs > FUSE_MAXARGS))
+      return csound->InitError(csound, Str("##fuse: too many arguments"));
+    for (; *t != '\0'; t++) {          /* one register per stack slot */
+      sp += (*t == 'a' || *t == 'k') ? 1 : (strchr(ops, *t) != NULL ? -1 : 0);
+      if (sp > depth) depth = sp;
+    }
+    if (UNLIKELY(depth == 0 || depth > FUSE_DEPTH)) goto bad;
+    if (p->regs.auxp == NULL ||
+        p->regs.size < depth * ksmps * sizeof(MYFLT))
+      csound->AuxAlloc(csound, depth * ksmps * sizeof(MYFLT), &p->regs);
+    reg = (MYFLT *) p->regs.auxp;
+
+    p->ncode = p->divk = sp = 0;
+    for (; *s != '\0'; s++) {
+      if (*s == 'a' || *s == 'k') {
+        if (UNLIKELY(narg >= nargs)) goto bad;
+        stk[sp] = p->args[narg++];
+        vec[sp++] = (*s == 'a');
+        continue;
+      }
+      if (UNLIKELY(p->ncode >= FUSE_MAXOPS)) goto bad;
+      c = &p->code[p->ncode++];
+      c->op = *s;
+      if (strchr(ops, *s) != NULL) {
+        int vop = (int) (strchr(ops, *s) - ops);
+        if (UNLIKELY(sp < 2 || !(vec[sp-2] | vec[sp-1]))) goto bad;
+        c->x = stk[sp-2];
+        c->y = stk[sp-1];
+        if (vec[sp-2] && vec[sp-1]) {
+          c->form = FUSE_VV;
+          c->fn.vv = *s == '%' ? fuse_mod_vv : k->vv[vop];
+        }
+        else if (vec[sp-2]) {
+          c->form = FUSE_VS;
+          c->fn.vs = *s == '%' ? fuse_mod_vs : k->vs[vop];
+          p->divk |= (*s == '/');
+        }
+        else {
+          c->form = FUSE_SV;
+          c->fn.sv = *s == '%' ? fuse_mod_sv : k->sv[vop];
+        }
+        sp--;
+      }
+      else if ((c->fn.v = fuse_unary(k, *s)) != NULL) {
+        if (UNLIKELY(sp < 1 || !vec[sp-1])) goto bad;
+        c->form = FUSE_V;
+        c->x = stk[sp-1];
+        c->y = NULL;
+      }
+      else goto bad;
+      c->d = stk[sp-1] = reg + (sp - 1) * ksmps;
+      vec[sp-1] = 1;
+    }
+    if (UNLIKELY(sp != 1 || narg != nargs || p->ncode == 0)) goto bad;
+    p->code[p->ncode-1].d = p->r;       /* last result goes to the output */
+    return OK;
+ bad:
+    return csound->InitError(csound, Str("##fuse: invalid program \"%s\""),
+                             p->prog->data);
+}
+
+int32_t fuse_perf(CSOUND *csound, FUSE *p)
+{
+    MYFLT   *r = p->r;
+    uint32_t offset = p->h.insdshead->ksmps_offset;
+    uint32_t early  = p->h.insdshead->ksmps_no_end;
+    uint32_t nsmps = CS_KSMPS, len;
+    const FUSE_OP *c, *end = p->code + p->ncode;
+
+    if (UNLIKELY(offset)) memset(r, '\0', offset*sizeof(MYFLT));
+    if (UNLIKELY(early)) {
+      nsmps -= early;
+      memset(&r[nsmps], '\0', early*sizeof(MYFLT));
+    }
+    if (UNLIKELY(p->divk))              /* as ##div.ak */
+      for (c = p->code; c < end; c++)
+        if (c->op == '/' && c->form == FUSE_VS && *c->y == FL(0.0))
+          csound->Warning(csound, Str("Division by zero"));
+    if (UNLIKELY(nsmps <= offset)) return OK;
+    len = nsmps - offset;
+    for (c = p->code; c < end; c++) {
+      switch (c->form) {
+      case FUSE_VV: c->fn.vv(c->d + offset, c->x + offset, c->y + offset, len);
+        break;
+      case FUSE_VS: c->fn.vs(c->d + offset, c->x + offset, *c->y, len);
+        break;
+      case FUSE_SV: c->fn.sv(c->d + offset, *c->x, c->y + offset, len);
+        break;
+      default:      c->fn.v(c->d + offset, c->x + offset, len);
+      }
+    }
+    return OK;
+}
+
 int32_t dbamp(CSOUND *csound, EVAL *p)
 {
     IGN(csound);
@@ -1482,7 +1607,7 @@ int32_t inq(CSOUND *csound, INQ *p)
                                *ar3 = p->ar3, *ar4 = p->ar4;
     uint32_t offset = p->h.insdshead->ksmps_offset;
     uint32_t early  = p->h.insdshead->ksmps_no_end;
-    uint32_t n, nsmps =CS_KSMPS, k;
+    uint32_t nsmps =CS_KSMPS;
     if (UNLIKELY(csound->inchnls != 4))
       return csound->PerfError(csound,
                                &(p->h),
@@ -1501,11 +1626,9 @@ int32_t inq(CSOUND *csound, INQ *p)
       memset(&ar3[nsmps], '\0', early * sizeof(MYFLT));
       memset(&ar4[nsmps], '\0', early * sizeof(MYFLT));
     }
-    for (n=offset, k=0; n<nsmps; n++, k+=4) {
-      ar1[n] = sp[k];
-      ar2[n] = sp[k+1];
-      ar3[n] = sp[k+2];
-      ar4[n] = sp[k+3];
+    if (offset < nsmps) {
+      MYFLT *ar[4] = { ar1, ar2, ar3, ar4 };
+      cs_deinterleave(ar, offset, sp, 4, 4, nsmps - offset);
     }
     CSOUND_SPIN_SPINUNLOCK
     return OK;
@@ -1517,7 +1640,7 @@ int32_t inh(CSOUND *csound, INH *p)
                                *ar4 = p->ar4, *ar5 = p->ar5, *ar6 = p->ar6;
     uint32_t offset = p->h.insdshead->ksmps_offset;
     uint32_t early  = p->h.insdshead->ksmps_no_end;
-    uint32_t n, nsmps =CS_KSMPS, k;
+    uint32_t nsmps =CS_KSMPS;
     if (UNLIKELY(csound->inchnls != 6))
       return csound->PerfError(csound,
                                &(p->h),
@@ -1540,13 +1663,9 @@ int32_t inh(CSOUND *csound, INH *p)
       memset(&ar5[nsmps], '\0', early * sizeof(MYFLT));
       memset(&ar6[nsmps], '\0', early * sizeof(MYFLT));
     }
-    for (n=offset, k=0; n<nsmps; n++, k+=6) {
-      ar1[n] = sp[k];
-      ar2[n] = sp[k+1];
-      ar3[n] = sp[k+2];
-      ar4[n] = sp[k+3];
-      ar5[n] = sp[k+4];
-      ar6[n] = sp[k+5];
+    if (offset < nsmps) {
+      MYFLT *ar[6] = { ar1, ar2, ar3, ar4, ar5, ar6 };
+      cs_deinterleave(ar, offset, sp, 6, 6, nsmps - offset);
     }
     CSOUND_SPIN_SPINUNLOCK
     return OK;
@@ -1559,7 +1678,7 @@ int32_t ino(CSOUND *csound, INO *p)
                                *ar7 = p->ar7, *ar8 = p->ar8;
     uint32_t offset = p->h.insdshead->ksmps_offset;
     uint32_t early  = p->h.insdshead->ksmps_no_end;
-    uint32_t n, nsmps =CS_KSMPS, k;
+    uint32_t nsmps =CS_KSMPS;
     if (UNLIKELY(csound->inchnls != 8))
       return csound->PerfError(csound,
                                &(p->h),
@@ -1586,15 +1705,9 @@ int32_t ino(CSOUND *csound, INO *p)
       memset(&ar7[nsmps], '\0', early * sizeof(MYFLT));
       memset(&ar8[nsmps], '\0', early * sizeof(MYFLT));
     }
-    for (n=offset, k=0; n<nsmps; n++, k+=8) {
-      ar1[n] = sp[k];
-      ar2[n] = sp[k+1];
-      ar3[n] = sp[k+2];
-      ar4[n] = sp[k+3];
-      ar5[n] = sp[k+4];
-      ar6[n] = sp[k+5];
-      ar7[n] = sp[k+6];
-      ar8[n] = sp[k+7];
+    if (offset < nsmps) {
+      MYFLT *ar[8] = { ar1, ar2, ar3, ar4, ar5, ar6, ar7, ar8 };
+      cs_deinterleave(ar, offset, sp, 8, 8, nsmps - offset);
     }
     CSOUND_SPIN_SPINUNLOCK
     return OK;
@@ -1605,7 +1718,7 @@ static int32_t inn(CSOUND *csound, INALL *p, uint32_t n)
     MYFLT *sp = CS_SPIN, **ara = p->ar;
     uint32_t offset = p->h.insdshead->ksmps_offset;
     uint32_t early  = p->h.insdshead->ksmps_no_end;
-    uint32_t m, nsmps =CS_KSMPS, i;
+    uint32_t nsmps =CS_KSMPS, i;
     if (UNLIKELY(csound->inchnls != (int32_t) n))
       return csound->PerfError(csound,
                                &(p->h),
@@ -1618,12 +1731,10 @@ static int32_t inn(CSOUND *csound, INALL *p, uint32_t n)
     if (UNLIKELY(early)) {
       nsmps -= early;
       for (i = 0; i < n; i++)
-        memset(ara[i], '\0', early*sizeof(MYFLT));
-    }
-    for (m = offset; m < nsmps; m++) {
-      for (i = 0; i < n; i++)
-        *ara[i] = *sp++;
+        memset(&ara[i][nsmps], '\0', early*sizeof(MYFLT));
     }
+    if (offset < nsmps)
+      cs_deinterleave(ara, offset, sp, n, n, nsmps - offset);
     CSOUND_SPIN_SPINUNLOCK
     return OK;
 }
@@ -1736,25 +1847,23 @@ int32_t inall_opcode(CSOUND *csound, INALL *p)
 {
     uint32_t n = (int32_t)p->OUTOCOUNT, m;
     uint32_t offset = p->h.insdshead->ksmps_offset;
-    uint32_t    i,j = 0, k = 0, nsmps = CS_KSMPS;
+    uint32_t    i, nsmps = CS_KSMPS;
     uint32_t early  = nsmps - p->h.insdshead->ksmps_no_end;
     MYFLT *spin = CS_SPIN;
 
     CSOUND_SPIN_SPINLOCK
     m = (n < (uint32_t)csound->inchnls ? n : (uint32_t)csound->inchnls);
-    for (j=0; j<nsmps; j++)
-      if (j<offset || j>early) {
-        for (i=0 ; i < n; i++)
-          p->ar[i][j] = FL(0.0);
-      }
-      else {
-        for (i=0; i<m; i++) {
-          p->ar[i][j] = spin[k + i];
-        }
-        for ( ; i < n; i++)
-          p->ar[i][j] = FL(0.0);
-        k += csound->inchnls;
+    for (i=0; i<n; i++) {
+      if (i >= m || offset >= early) {
+        memset(p->ar[i], '\0', nsmps*sizeof(MYFLT));
+        continue;
       }
+      if (UNLIKELY(offset)) memset(p->ar[i], '\0', offset*sizeof(MYFLT));
+      if (UNLIKELY(early < nsmps))
+        memset(&p->ar[i][early], '\0', (nsmps-early)*sizeof(MYFLT));
+    }
+    if (offset < early)
+      cs_deinterleave(p->ar, offset, spin, csound->inchnls, m, early - offset);
     CSOUND_SPIN_SPINUNLOCK
     return OK;
 }
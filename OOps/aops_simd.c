@@ -0,0 +1,543 @@
+/*
+    aops_simd.c:
+
+    Copyright (C) 2018 The Csound Developers
+
+    This file is part of Csound.
+
+    The Csound Library is free software; you can redistribute it
+    and/or modify it under the terms of the GNU Lesser General Public
+    License as published by the Free Software Foundation; either
+    version 2.1 of the License, or (at your option) any later version.
+
+    Csound is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public
+    License along with Csound; if not, write to the Free Software
+    Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA
+    02110-1301 USA
+*/
+
+/* Vector kernels for the a-rate arithmetic of aops.c: + - * / between
+   two signals or a signal and a scalar, divz, int and frac.  The opcodes
+   deal with the sample-accurate offset and early end and pass the span
+   in between.  As in interleave.c, the kernels are picked on first use
+   (AVX or SSE2 on x86, NEON on ARM) with plain C as the fallback; each
+   vector kernel finishes the last few samples in C.  */
+
+#include "csoundCore.h"
+#include <math.h>
+
+#if defined(__x86_64__) || defined(__i386__) || \
+    defined(_M_X64) || defined(_M_IX86)
+#  define VOP_X86 1
+#  include <immintrin.h>
+#  if defined(_MSC_VER)
+#    define VOP_TARGET(x)
+#  else
+#    define VOP_TARGET(x) __attribute__((target(x)))
+#  endif
+#elif defined(__aarch64__)
+#  define VOP_NEON 1          /* with division, rounding and doubles */
+#  include <arm_neon.h>
+#elif (defined(__ARM_NEON) || defined(__ARM_NEON__)) && !defined(USE_DOUBLE)
+#  define VOP_NEON 1
+#  define VOP_NEON_V7 1       /* + - * only */
+#  include <arm_neon.h>
+#endif
+
+/* Each instruction set fills one VOP_KERNELS table; cs_vop_*() call
+   through the table picked for the running CPU. */
+
+/* Kernel generators: VT is the vector type holding W MYFLTs, LD/ST/SET1
+   load, store and broadcast, VOP the vector operation and OP the scalar
+   one used for the remaining samples. */
+
+#define VOP_VV(NAME, TGT, VT, W, LD, ST, VOP, OP)                       \
+  TGT static void NAME(MYFLT *r, const MYFLT *a, const MYFLT *b,        \
+                       uint32_t n)                                      \
+  {                                                                     \
+      uint32_t i = 0;                                                   \
+      for ( ; i + W <= n; i += W)                                       \
+        ST(r + i, VOP(LD(a + i), LD(b + i)));                           \
+      for ( ; i < n; i++) r[i] = a[i] OP b[i];                          \
+  }
+
+#define VOP_VS(NAME, TGT, VT, W, LD, ST, SET1, VOP, OP)                 \
+  TGT static void NAME(MYFLT *r, const MYFLT *a, MYFLT b, uint32_t n)   \
+  {                                                                     \
+      uint32_t i = 0;                                                   \
+      VT vb = SET1(b);                                                  \
+      for ( ; i + W <= n; i += W)                                       \
+        ST(r + i, VOP(LD(a + i), vb));                                  \
+      for ( ; i < n; i++) r[i] = a[i] OP b;                             \
+  }
+
+#define VOP_SV(NAME, TGT, VT, W, LD, ST, SET1, VOP, OP)                 \
+  TGT static void NAME(MYFLT *r, MYFLT a, const MYFLT *b, uint32_t n)   \
+  {                                                                     \
+      uint32_t i = 0;                                                   \
+      VT va = SET1(a);                                                  \
+      for ( ; i + W <= n; i += W)                                       \
+        ST(r + i, VOP(va, LD(b + i)));                                  \
+      for ( ; i < n; i++) r[i] = a OP b[i];                             \
+  }
+
+/* the twelve + - * / kernels of one instruction set, named OP_xx_SFX */
+#define VOP_ARITH(SFX, TGT, VT, W, LD, ST, SET1, ADD, SUB, MUL, DIV)    \
+  VOP_VV(add_vv_##SFX, TGT, VT, W, LD, ST, ADD, +)                      \
+  VOP_VV(sub_vv_##SFX, TGT, VT, W, LD, ST, SUB, -)                      \
+  VOP_VV(mul_vv_##SFX, TGT, VT, W, LD, ST, MUL, *)                      \
+  VOP_VV(div_vv_##SFX, TGT, VT, W, LD, ST, DIV, /)                      \
+  VOP_VS(add_vs_##SFX, TGT, VT, W, LD, ST, SET1, ADD, +)                \
+  VOP_VS(sub_vs_##SFX, TGT, VT, W, LD, ST, SET1, SUB, -)                \
+  VOP_VS(mul_vs_##SFX, TGT, VT, W, LD, ST, SET1, MUL, *)                \
+  VOP_VS(div_vs_##SFX, TGT, VT, W, LD, ST, SET1, DIV, /)                \
+  VOP_SV(add_sv_##SFX, TGT, VT, W, LD, ST, SET1, ADD, +)                \
+  VOP_SV(sub_sv_##SFX, TGT, VT, W, LD, ST, SET1, SUB, -)                \
+  VOP_SV(mul_sv_##SFX, TGT, VT, W, LD, ST, SET1, MUL, *)                \
+  VOP_SV(div_sv_##SFX, TGT, VT, W, LD, ST, SET1, DIV, /)
+
+#define VOP_ARITH_TABLE(SFX)                                            \
+  { add_vv_##SFX, sub_vv_##SFX, mul_vv_##SFX, div_vv_##SFX },           \
+  { add_vs_##SFX, sub_vs_##SFX, mul_vs_##SFX, div_vs_##SFX },           \
+  { add_sv_##SFX, sub_sv_##SFX, mul_sv_##SFX, div_sv_##SFX }
+
+/* divz: SELZ(b, q, d) is d where b is zero and q elsewhere */
+#define VOP_DIVZ(SFX, TGT, VT, W, LD, ST, SET1, DIV, SELZ)              \
+  TGT static void divz_vv_##SFX(MYFLT *r, const MYFLT *a,               \
+                                const MYFLT *b, MYFLT def, uint32_t n)  \
+  {                                                                     \
+      uint32_t i = 0;                                                   \
+      VT vd = SET1(def);                                                \
+      for ( ; i + W <= n; i += W) {                                     \
+        VT vb = LD(b + i);                                              \
+        ST(r + i, SELZ(vb, DIV(LD(a + i), vb), vd));                    \
+      }                                                                 \
+      for ( ; i < n; i++) r[i] = (b[i] == FL(0.0) ? def : a[i] / b[i]); \
+  }                                                                     \
+  TGT static void divz_sv_##SFX(MYFLT *r, MYFLT a, const MYFLT *b,      \
+                                MYFLT def, uint32_t n)                  \
+  {                                                                     \
+      uint32_t i = 0;                                                   \
+      VT va = SET1(a), vd = SET1(def);                                  \
+      for ( ; i + W <= n; i += W) {                                     \
+        VT vb = LD(b + i);                                              \
+        ST(r + i, SELZ(vb, DIV(va, vb), vd));                           \
+      }                                                                 \
+      for ( ; i < n; i++) r[i] = (b[i] == FL(0.0) ? def : a / b[i]);    \
+  }
+
+/* int and frac, as the whole and fractional parts returned by modf() */
+#define VOP_MODF(SFX, TGT, VT, W, LD, ST, TRUNC, FRAC)                  \
+  TGT static void int_##SFX(MYFLT *r, const MYFLT *a, uint32_t n)       \
+  {                                                                     \
+      uint32_t i = 0;                                                   \
+      MYFLT    ip;                                                      \
+      for ( ; i + W <= n; i += W)                                       \
+        ST(r + i, TRUNC(LD(a + i)));                                    \
+      for ( ; i < n; i++) {                                             \
+        MODF(a[i], &ip);                                                \
+        r[i] = ip;                                                      \
+      }                                                                 \
+  }                                                                     \
+  TGT static void frac_##SFX(MYFLT *r, const MYFLT *a, uint32_t n)      \
+  {                                                                     \
+      uint32_t i = 0;                                                   \
+      MYFLT    ip;                                                      \
+      for ( ; i + W <= n; i += W)                                       \
+        ST(r + i, FRAC(LD(a + i)));                                     \
+      for ( ; i < n; i++) r[i] = MODF(a[i], &ip);                       \
+  }
+
+/* ---- plain C ---- */
+
+#define C_VV(NAME, OP)                                                  \
+  static void NAME(MYFLT *r, const MYFLT *a, const MYFLT *b, uint32_t n)\
+  {                                                                     \
+      uint32_t i;                                                       \
+      for (i = 0; i < n; i++) r[i] = a[i] OP b[i];                      \
+  }
+#define C_VS(NAME, OP)                                                  \
+  static void NAME(MYFLT *r, const MYFLT *a, MYFLT b, uint32_t n)       \
+  {                                                                     \
+      uint32_t i;                                                       \
+      for (i = 0; i < n; i++) r[i] = a[i] OP b;                         \
+  }
+#define C_SV(NAME, OP)                                                  \
+  static void NAME(MYFLT *r, MYFLT a, const MYFLT *b, uint32_t n)       \
+  {                                                                     \
+      uint32_t i;                                                       \
+      for (i = 0; i < n; i++) r[i] = a OP b[i];                         \
+  }
+
+C_VV(add_vv_c, +) C_VV(sub_vv_c, -) C_VV(mul_vv_c, *) C_VV(div_vv_c, /)
+C_VS(add_vs_c, +) C_VS(sub_vs_c, -) C_VS(mul_vs_c, *) C_VS(div_vs_c, /)
+C_SV(add_sv_c, +) C_SV(sub_sv_c, -) C_SV(mul_sv_c, *) C_SV(div_sv_c, /)
+
+static void divz_vv_c(MYFLT *r, const MYFLT *a, const MYFLT *b,
+                      MYFLT def, uint32_t n)
+{
+    uint32_t i;
+    for (i = 0; i < n; i++) r[i] = (b[i] == FL(0.0) ? def : a[i] / b[i]);
+}
+
+static void divz_sv_c(MYFLT *r, MYFLT a, const MYFLT *b,
+                      MYFLT def, uint32_t n)
+{
+    uint32_t i;
+    for (i = 0; i < n; i++) r[i] = (b[i] == FL(0.0) ? def : a / b[i]);
+}
+
+static void int_c(MYFLT *r, const MYFLT *a, uint32_t n)
+{
+    uint32_t i;
+    MYFLT    ip;
+    for (i = 0; i < n; i++) {
+      MODF(a[i], &ip);
+      r[i] = ip;
+    }
+}
+
+static void frac_c(MYFLT *r, const MYFLT *a, uint32_t n)
+{
+    uint32_t i;
+    MYFLT    ip;
+    for (i = 0; i < n; i++) r[i] = MODF(a[i], &ip);
+}
+
+static const VOP_KERNELS vop_c = {
+    VOP_ARITH_TABLE(c), divz_vv_c, divz_sv_c, int_c, frac_c
+};
+
+/* values of this magnitude or more have no fractional part */
+#ifdef USE_DOUBLE
+#define VOP_INTEGRAL    (4503599627370496.0)            /* 2^52 */
+#else
+#define VOP_INTEGRAL    (8388608.0f)                    /* 2^23 */
+#endif
+
+#ifdef VOP_X86
+
+/* ---- SSE2 ---- */
+
+#ifdef USE_DOUBLE
+#define SSE_T           __m128d
+#define SSE_W           2
+#define SSE_LD          _mm_loadu_pd
+#define SSE_ST          _mm_storeu_pd
+#define SSE_SET1        _mm_set1_pd
+#define SSE_ADD         _mm_add_pd
+#define SSE_SUB         _mm_sub_pd
+#define SSE_MUL         _mm_mul_pd
+#define SSE_DIV         _mm_div_pd
+#define SSE_AND         _mm_and_pd
+#define SSE_ANDNOT      _mm_andnot_pd
+#define SSE_OR          _mm_or_pd
+#define SSE_CMPEQ       _mm_cmpeq_pd
+#define SSE_CMPLT       _mm_cmplt_pd
+#define SSE_CMPGT       _mm_cmpgt_pd
+#define SSE_ZERO        _mm_setzero_pd
+#else
+#define SSE_T           __m128
+#define SSE_W           4
+#define SSE_LD          _mm_loadu_ps
+#define SSE_ST          _mm_storeu_ps
+#define SSE_SET1        _mm_set1_ps
+#define SSE_ADD         _mm_add_ps
+#define SSE_SUB         _mm_sub_ps
+#define SSE_MUL         _mm_mul_ps
+#define SSE_DIV         _mm_div_ps
+#define SSE_AND         _mm_and_ps
+#define SSE_ANDNOT      _mm_andnot_ps
+#define SSE_OR          _mm_or_ps
+#define SSE_CMPEQ       _mm_cmpeq_ps
+#define SSE_CMPLT       _mm_cmplt_ps
+#define SSE_CMPGT       _mm_cmpgt_ps
+#define SSE_ZERO        _mm_setzero_ps
+#endif
+
+VOP_ARITH(sse2, VOP_TARGET("sse2"), SSE_T, SSE_W, SSE_LD, SSE_ST, SSE_SET1,
+          SSE_ADD, SSE_SUB, SSE_MUL, SSE_DIV)
+
+VOP_TARGET("sse2")
+static inline SSE_T selz_sse2(SSE_T b, SSE_T q, SSE_T d)
+{
+    SSE_T z = SSE_CMPEQ(b, SSE_ZERO());
+    return SSE_OR(SSE_AND(z, d), SSE_ANDNOT(z, q));
+}
+
+/* SSE2 has no rounding instruction: adding and taking away 2^52 (2^23)
+   rounds |x| to an integer, which is then brought down to the floor */
+VOP_TARGET("sse2")
+static inline SSE_T trunc_sse2(SSE_T x)
+{
+    SSE_T sign = SSE_SET1(-FL(0.0)), big = SSE_SET1(VOP_INTEGRAL);
+    SSE_T ax = SSE_ANDNOT(sign, x);
+    SSE_T t = SSE_SUB(SSE_ADD(ax, big), big);
+    SSE_T small = SSE_CMPLT(ax, big);
+    t = SSE_SUB(t, SSE_AND(SSE_CMPGT(t, ax), SSE_SET1(FL(1.0))));
+    t = SSE_OR(t, SSE_AND(sign, x));
+    return SSE_OR(SSE_AND(small, t), SSE_ANDNOT(small, x));
+}
+
+/* x - trunc(x) with the sign of x, as modf() gives it: -3 and -0 give
+   -0, +-inf gives +-0 and NaN passes through */
+VOP_TARGET("sse2")
+static inline SSE_T frac_sse2_v(SSE_T x)
+{
+    SSE_T sign = SSE_SET1(-FL(0.0));
+    SSE_T inf = SSE_CMPEQ(SSE_ANDNOT(sign, x), SSE_SET1((MYFLT) INFINITY));
+    SSE_T f = SSE_ANDNOT(inf, SSE_SUB(x, trunc_sse2(x)));
+    return SSE_OR(f, SSE_AND(sign, x));
+}
+
+VOP_DIVZ(sse2, VOP_TARGET("sse2"), SSE_T, SSE_W, SSE_LD, SSE_ST, SSE_SET1,
+         SSE_DIV, selz_sse2)
+VOP_MODF(sse2, VOP_TARGET("sse2"), SSE_T, SSE_W, SSE_LD, SSE_ST,
+         trunc_sse2, frac_sse2_v)
+
+static const VOP_KERNELS vop_sse2 = {
+    VOP_ARITH_TABLE(sse2), divz_vv_sse2, divz_sv_sse2, int_sse2, frac_sse2
+};
+
+/* ---- AVX ---- */
+
+#ifdef USE_DOUBLE
+#define AVX_T           __m256d
+#define AVX_W           4
+#define AVX_LD          _mm256_loadu_pd
+#define AVX_ST          _mm256_storeu_pd
+#define AVX_SET1        _mm256_set1_pd
+#define AVX_ADD         _mm256_add_pd
+#define AVX_SUB         _mm256_sub_pd
+#define AVX_MUL         _mm256_mul_pd
+#define AVX_DIV         _mm256_div_pd
+#define AVX_AND         _mm256_and_pd
+#define AVX_ANDNOT      _mm256_andnot_pd
+#define AVX_OR          _mm256_or_pd
+#define AVX_CMP         _mm256_cmp_pd
+#define AVX_BLENDV      _mm256_blendv_pd
+#define AVX_ROUND       _mm256_round_pd
+#define AVX_ZERO        _mm256_setzero_pd
+#else
+#define AVX_T           __m256
+#define AVX_W           8
+#define AVX_LD          _mm256_loadu_ps
+#define AVX_ST          _mm256_storeu_ps
+#define AVX_SET1        _mm256_set1_ps
+#define AVX_ADD         _mm256_add_ps
+#define AVX_SUB         _mm256_sub_ps
+#define AVX_MUL         _mm256_mul_ps
+#define AVX_DIV         _mm256_div_ps
+#define AVX_AND         _mm256_and_ps
+#define AVX_ANDNOT      _mm256_andnot_ps
+#define AVX_OR          _mm256_or_ps
+#define AVX_CMP         _mm256_cmp_ps
+#define AVX_BLENDV      _mm256_blendv_ps
+#define AVX_ROUND       _mm256_round_ps
+#define AVX_ZERO        _mm256_setzero_ps
+#endif
+
+VOP_ARITH(avx, VOP_TARGET("avx"), AVX_T, AVX_W, AVX_LD, AVX_ST, AVX_SET1,
+          AVX_ADD, AVX_SUB, AVX_MUL, AVX_DIV)
+
+VOP_TARGET("avx")
+static inline AVX_T selz_avx(AVX_T b, AVX_T q, AVX_T d)
+{
+    return AVX_BLENDV(q, d, AVX_CMP(b, AVX_ZERO(), _CMP_EQ_OQ));
+}
+
+VOP_TARGET("avx")
+static inline AVX_T trunc_avx(AVX_T x)
+{
+    return AVX_ROUND(x, _MM_FROUND_TO_ZERO | _MM_FROUND_NO_EXC);
+}
+
+/* as frac_sse2_v() */
+VOP_TARGET("avx")
+static inline AVX_T frac_avx_v(AVX_T x)
+{
+    AVX_T sign = AVX_SET1(-FL(0.0));
+    AVX_T inf = AVX_CMP(AVX_ANDNOT(sign, x), AVX_SET1((MYFLT) INFINITY),
+                        _CMP_EQ_OQ);
+    AVX_T f = AVX_ANDNOT(inf, AVX_SUB(x, trunc_avx(x)));
+    return AVX_OR(f, AVX_AND(sign, x));
+}
+
+VOP_DIVZ(avx, VOP_TARGET("avx"), AVX_T, AVX_W, AVX_LD, AVX_ST, AVX_SET1,
+         AVX_DIV, selz_avx)
+VOP_MODF(avx, VOP_TARGET("avx"), AVX_T, AVX_W, AVX_LD, AVX_ST,
+         trunc_avx, frac_avx_v)
+
+static const VOP_KERNELS vop_avx = {
+    VOP_ARITH_TABLE(avx), divz_vv_avx, divz_sv_avx, int_avx, frac_avx
+};
+
+#endif  /* VOP_X86 */
+
+#ifdef VOP_NEON
+
+#ifdef USE_DOUBLE
+#define NEON_T          float64x2_t
+#define NEON_W          2
+#define NEON_LD         vld1q_f64
+#define NEON_ST         vst1q_f64
+#define NEON_SET1       vdupq_n_f64
+#define NEON_ADD        vaddq_f64
+#define NEON_SUB        vsubq_f64
+#define NEON_MUL        vmulq_f64
+#define NEON_DIV        vdivq_f64
+#define NEON_CMPEQ      vceqq_f64
+#define NEON_BSL        vbslq_f64
+#define NEON_ABS        vabsq_f64
+#define NEON_TRUNC      vrndq_f64
+#define NEON_SIGN       vdupq_n_u64(0x8000000000000000ULL)
+#else
+#define NEON_T          float32x4_t
+#define NEON_W          4
+#define NEON_LD         vld1q_f32
+#define NEON_ST         vst1q_f32
+#define NEON_SET1       vdupq_n_f32
+#define NEON_ADD        vaddq_f32
+#define NEON_SUB        vsubq_f32
+#define NEON_MUL        vmulq_f32
+#define NEON_DIV        vdivq_f32
+#define NEON_CMPEQ      vceqq_f32
+#define NEON_BSL        vbslq_f32
+#define NEON_ABS        vabsq_f32
+#define NEON_TRUNC      vrndq_f32
+#define NEON_SIGN       vdupq_n_u32(0x80000000U)
+#endif
+
+#ifdef VOP_NEON_V7
+/* ARMv7 NEON has no vector division or rounding */
+VOP_VV(add_vv_neon, , NEON_T, NEON_W, NEON_LD, NEON_ST, NEON_ADD, +)
+VOP_VV(sub_vv_neon, , NEON_T, NEON_W, NEON_LD, NEON_ST, NEON_SUB, -)
+VOP_VV(mul_vv_neon, , NEON_T, NEON_W, NEON_LD, NEON_ST, NEON_MUL, *)
+VOP_VS(add_vs_neon, , NEON_T, NEON_W, NEON_LD, NEON_ST, NEON_SET1, NEON_ADD, +)
+VOP_VS(sub_vs_neon, , NEON_T, NEON_W, NEON_LD, NEON_ST, NEON_SET1, NEON_SUB, -)
+VOP_VS(mul_vs_neon, , NEON_T, NEON_W, NEON_LD, NEON_ST, NEON_SET1, NEON_MUL, *)
+VOP_SV(add_sv_neon, , NEON_T, NEON_W, NEON_LD, NEON_ST, NEON_SET1, NEON_ADD, +)
+VOP_SV(sub_sv_neon, , NEON_T, NEON_W, NEON_LD, NEON_ST, NEON_SET1, NEON_SUB, -)
+VOP_SV(mul_sv_neon, , NEON_T, NEON_W, NEON_LD, NEON_ST, NEON_SET1, NEON_MUL, *)
+
+static const VOP_KERNELS vop_neon = {
+    { add_vv_neon, sub_vv_neon, mul_vv_neon, div_vv_c },
+    { add_vs_neon, sub_vs_neon, mul_vs_neon, div_vs_c },
+    { add_sv_neon, sub_sv_neon, mul_sv_neon, div_sv_c },
+    divz_vv_c, divz_sv_c, int_c, frac_c
+};
+
+#else
+
+VOP_ARITH(neon, , NEON_T, NEON_W, NEON_LD, NEON_ST, NEON_SET1,
+          NEON_ADD, NEON_SUB, NEON_MUL, NEON_DIV)
+
+static inline NEON_T selz_neon(NEON_T b, NEON_T q, NEON_T d)
+{
+    return NEON_BSL(NEON_CMPEQ(b, NEON_SET1(FL(0.0))), d, q);
+}
+
+/* as frac_sse2_v() */
+static inline NEON_T frac_neon_v(NEON_T x)
+{
+    NEON_T f = NEON_BSL(NEON_CMPEQ(NEON_ABS(x), NEON_SET1((MYFLT) INFINITY)),
+                        NEON_SET1(FL(0.0)), NEON_SUB(x, NEON_TRUNC(x)));
+    return NEON_BSL(NEON_SIGN, x, f);
+}
+
+VOP_DIVZ(neon, , NEON_T, NEON_W, NEON_LD, NEON_ST, NEON_SET1,
+         NEON_DIV, selz_neon)
+VOP_MODF(neon, , NEON_T, NEON_W, NEON_LD, NEON_ST, NEON_TRUNC, frac_neon_v)
+
+static const VOP_KERNELS vop_neon = {
+    VOP_ARITH_TABLE(neon), divz_vv_neon, divz_sv_neon, int_neon, frac_neon
+};
+
+#endif  /* VOP_NEON_V7 */
+#endif  /* VOP_NEON */
+
+static const VOP_KERNELS *vop = NULL;
+
+/* Pick the kernels; racing callers all store the same value */
+static const VOP_KERNELS *vop_select(void)
+{
+    const VOP_KERNELS *k = &vop_c;
+#if defined(VOP_X86)
+    if (cs_cpu_has(1)) k = &vop_avx;
+    else if (cs_cpu_has(0)) k = &vop_sse2;
+#elif defined(VOP_NEON)
+    k = &vop_neon;
+#endif
+    vop = k;
+    return k;
+}
+
+#define VOP_KERN  (LIKELY(vop != NULL) ? vop : vop_select())
+
+/* r[i] = a[i] op b[i] */
+void cs_vop_aa(int op, MYFLT *r, const MYFLT *a, const MYFLT *b, uint32_t n)
+{
+    VOP_KERN->vv[op](r, a, b, n);
+}
+
+/* r[i] = a[i] op b */
+void cs_vop_ak(int op, MYFLT *r, const MYFLT *a, MYFLT b, uint32_t n)
+{
+    VOP_KERN->vs[op](r, a, b, n);
+}
+
+/* r[i] = a op b[i] */
+void cs_vop_ka(int op, MYFLT *r, MYFLT a, const MYFLT *b, uint32_t n)
+{
+    VOP_KERN->sv[op](r, a, b, n);
+}
+
+/* r[i] = a[i] / b[i], or def where b[i] is zero */
+void cs_vdivz_aa(MYFLT *r, const MYFLT *a, const MYFLT *b,
+                 MYFLT def, uint32_t n)
+{
+    VOP_KERN->divz_vv(r, a, b, def, n);
+}
+
+/* r[i] = a / b[i], or def where b[i] is zero */
+void cs_vdivz_ka(MYFLT *r, MYFLT a, const MYFLT *b, MYFLT def, uint32_t n)
+{
+    VOP_KERN->divz_sv(r, a, b, def, n);
+}
+
+/* whole and fractional parts, as by modf() */
+void cs_vint(MYFLT *r, const MYFLT *a, uint32_t n)
+{
+    VOP_KERN->vint(r, a, n);
+}
+
+void cs_vfrac(MYFLT *r, const MYFLT *a, uint32_t n)
+{
+    VOP_KERN->vfrac(r, a, n);
+}
+
+/* for callers that pick their kernels once, at init time */
+const VOP_KERNELS *cs_vop_kernels(void)
+{
+    return VOP_KERN;
+}
+
+/* every table this build can run on this CPU, the plain C one first,
+   so that tests can check each against it; returns how many, at most 4 */
+int cs_vop_kernel_sets(const VOP_KERNELS **k)
+{
+    int n = 0;
+    k[n++] = &vop_c;
+#if defined(VOP_X86)
+    if (cs_cpu_has(0)) k[n++] = &vop_sse2;
+    if (cs_cpu_has(1)) k[n++] = &vop_avx;
+#elif defined(VOP_NEON)
+    k[n++] = &vop_neon;
+#endif
+    return n;
+}
@@ -336,12 +336,20 @@ static int32_t delete_channel_db(CSOUND *csound, void *p)
     return 0;
 }
 
+/* the host looks channels up from its own threads while i-time code on
+   the perf thread creates them, and an insert may grow the table, so
+   chn_db is only used under chn_db_lock */
+
 static inline CHNENTRY *find_channel(CSOUND *csound, const char *name)
 {
+    CHNENTRY  *pp = NULL;
+
     if (csound->chn_db != NULL && name[0]) {
-      return (CHNENTRY*) cs_hash_table_get(csound, csound->chn_db, (char*) name);
+      csoundSpinLock(&csound->chn_db_lock);
+      pp = (CHNENTRY*) cs_hash_table_get(csound, csound->chn_db, (char*) name);
+      csoundSpinUnLock(&csound->chn_db_lock);
     }
-    return NULL;
+    return pp;
 }
 
 void set_channel_data_ptr(CSOUND *csound,
@@ -392,19 +400,11 @@ static CS_NOINLINE int32_t create_new_channel(CSOUND *csound, const char *name,
                                           int32_t type)
 {
     CHNENTRY      *pp;
+    int32_t       err = CSOUND_SUCCESS;
     /* check for valid parameters and calculate hash value */
     if (UNLIKELY(!(type & 48)))
       return CSOUND_ERROR;
 
-    /* create new empty database if not allocated */
-    if (csound->chn_db == NULL) {
-      csound->chn_db = cs_hash_table_create(csound);
-      if (UNLIKELY(csound->RegisterResetCallback(csound, NULL,
-                                                 delete_channel_db) != 0))
-          return CSOUND_MEMORY;
-      if (UNLIKELY(csound->chn_db == NULL))
-        return CSOUND_MEMORY;
-    }
     /* allocate new entry */
     pp = alloc_channel(csound, name, type);
     if (UNLIKELY(pp == NULL))
@@ -413,9 +413,29 @@ static CS_NOINLINE int32_t create_new_channel(CSOUND *csound, const char *name,
     pp->type = type;
     strcpy(&(pp->name[0]), name);
 
-    cs_hash_table_put(csound, csound->chn_db, (char*)name, pp);
-
-    return CSOUND_SUCCESS;
+    csoundSpinLock(&csound->chn_db_lock);
+    /* create new empty database if not allocated */
+    if (csound->chn_db == NULL) {
+      csound->chn_db = cs_hash_table_create(csound);
+      if (UNLIKELY(csound->chn_db == NULL ||
+                   csound->RegisterResetCallback(csound, NULL,
+                                                 delete_channel_db) != 0))
+        err = CSOUND_MEMORY;
+    }
+    /* another thread may have made the same channel meanwhile */
+    if (err == CSOUND_SUCCESS &&
+        cs_hash_table_get(csound, csound->chn_db, (char*) name) == NULL) {
+      cs_hash_table_put(csound, csound->chn_db, (char*)name, pp);
+      pp = NULL;
+    }
+    csoundSpinUnLock(&csound->chn_db_lock);
+    if (pp != NULL) {
+      if ((type & CSOUND_CHANNEL_TYPE_MASK) == CSOUND_STRING_CHANNEL)
+        csound->Free(csound, ((STRINGDAT*) pp->data)->data);
+      csound->Free(csound, pp->data);
+      csound->Free(csound, pp);
+    }
+    return err;
 }
 
 
@@ -443,6 +463,19 @@ PUBLIC int32_t csoundGetChannelPtr(CSOUND *csound,
     return CSOUND_ERROR;
 }
 
+PUBLIC int32_t csoundGetChannelHandle(CSOUND *csound, CSOUND_CHANNEL *handle,
+                                      const char *name, int32_t type)
+{
+    MYFLT   *p;
+    int32_t err;
+
+    *handle = (CSOUND_CHANNEL) NULL;
+    if ((err = csoundGetChannelPtr(csound, &p, name, type)) != CSOUND_SUCCESS)
+      return err;
+    *handle = find_channel(csound, name);
+    return CSOUND_SUCCESS;
+}
+
 PUBLIC int32_t csoundGetChannelDatasize(CSOUND *csound, const char *name){
 
     CHNENTRY  *pp;
@@ -489,7 +522,9 @@ PUBLIC int32_t csoundListChannels(CSOUND *csound, controlChannelInfo_t **lst)
     if (csound->chn_db == NULL)
       return 0;
 
+    csoundSpinLock(&csound->chn_db_lock);
     channels = cs_hash_table_values(csound, csound->chn_db);
+    csoundSpinUnLock(&csound->chn_db_lock);
     n = cs_cons_length(channels);
 
     if (!n)
@@ -68,11 +68,20 @@ static CS_NOINLINE void diskin2_read_buffer(CSOUND *csound,
         if (nsmps > (int32_t) p->bufSize)
           nsmps = (int32_t) p->bufSize;
         nsmps *= (int32_t) p->nChannels;
-        sf_seek(p->sf, (sf_count_t) p->bufStartPos, SEEK_SET);
-        /* convert sample count to mono samples and read file */
-        i = (int32_t)sf_read_MYFLT(p->sf, p->buf, (sf_count_t) nsmps);
-        if (UNLIKELY(i < 0))  /* error ? */
-          i = 0;    /* clear entire buffer to zero */
+        if (p->smf != NULL) {
+          /* shared copy of the file in memory */
+          const float *src =
+            p->smf->data + (size_t) p->bufStartPos * p->nChannels;
+          for (i = 0; i < nsmps; i++)
+            p->buf[i] = (MYFLT) src[i];
+        }
+        else {
+          sf_seek(p->sf, (sf_count_t) p->bufStartPos, SEEK_SET);
+          /* convert sample count to mono samples and read file */
+          i = (int32_t)sf_read_MYFLT(p->sf, p->buf, (sf_count_t) nsmps);
+          if (UNLIKELY(i < 0))  /* error ? */
+            i = 0;    /* clear entire buffer to zero */
+        }
       }
     }
     /* fill rest of buffer with zero samples */
@@ -296,13 +305,22 @@ int32_t soundin(CSOUND *csound, DISKIN2 *p){
 
 int32_t diskin2_async_deinit(CSOUND *csound, void *p);
 
+static int32_t diskin2_release(CSOUND *csound, void *pp)
+{
+    DISKIN2 *p = (DISKIN2*) pp;
+    csoundReleaseSoundFile(csound, p->smf);
+    p->smf = NULL;
+    return OK;
+}
+
 static int32_t diskin2_init_(CSOUND *csound, DISKIN2 *p, int32_t stringname)
 {
     double  pos;
     char    name[1024];
+    const char *fname;
     void    *fd;
     SF_INFO sfinfo;
-    int32_t     n;
+    int32_t     n, hasRelease = 0;
 
     /* check number of channels */
     p->nChannels = (int32_t)(p->OUTOCOUNT);
@@ -311,11 +329,17 @@ static int32_t diskin2_init_(CSOUND *csound, DISKIN2 *p, int32_t stringname)
                                Str("diskin2: invalid number of channels"));
     }
     /* if already open, close old file first */
-    if (p->fdch.fd != NULL) {
+    if (p->fdch.fd != NULL || p->smf != NULL) {
       /* skip initialisation if requested */
       if (p->SkipInit != FL(0.0))
         return OK;
-      fdclose(csound, &(p->fdch));
+      if (p->fdch.fd != NULL)
+        fdclose(csound, &(p->fdch));
+      if (p->smf != NULL) {           /* the release callback stays */
+        csoundReleaseSoundFile(csound, p->smf);
+        p->smf = NULL;
+        hasRelease = 1;
+      }
     }
     /* set default format parameters */
     memset(&sfinfo, 0, sizeof(SF_INFO));
@@ -335,17 +359,32 @@ static int32_t diskin2_init_(CSOUND *csound, DISKIN2 *p, int32_t stringname)
     }
     else strNcpy(name, ((STRINGDAT *)p->iFileCode)->data, 1023);
 
-    fd = csound->FileOpen2(csound, &(p->sf), CSFILE_SND_R, name, &sfinfo,
-                           "SFDIR;SSDIR", CSFTYPE_UNKNOWN_AUDIO, 0);
-    if (UNLIKELY(fd == NULL)) {
-      return csound->InitError(csound,
-                               Str("diskin2: %s: failed to open file (%s)"),
-                               name, Str(sf_strerror(NULL)));
+    /* files that fit the sample cache are shared by all instances; with
+       -realtime only one already in memory is, as decoding it here would
+       stall the perf thread, and others stream as before */
+    p->smf = (csound->oparms->realtime ?
+              csoundAcquireCachedSoundFile(csound, name, &sfinfo) :
+              csoundAcquireSoundFile(csound, name, &sfinfo, 1));
+    if (p->smf != NULL) {
+      fd = NULL;
+      fname = p->smf->fullName;
+      if (!hasRelease)
+        csound->RegisterDeinitCallback(csound, p, diskin2_release);
+    }
+    else {
+      fd = csound->FileOpen2(csound, &(p->sf), CSFILE_SND_R, name, &sfinfo,
+                             "SFDIR;SSDIR", CSFTYPE_UNKNOWN_AUDIO, 0);
+      if (UNLIKELY(fd == NULL)) {
+        return csound->InitError(csound,
+                                 Str("diskin2: %s: failed to open file (%s)"),
+                                 name, Str(sf_strerror(NULL)));
+      }
+      /* record file handle so that it will be closed at note-off */
+      memset(&(p->fdch), 0, sizeof(FDCH));
+      p->fdch.fd = fd;
+      fdrecord(csound, &(p->fdch));
+      fname = csound->GetFileName(fd);
     }
-    /* record file handle so that it will be closed at note-off */
-    memset(&(p->fdch), 0, sizeof(FDCH));
-    p->fdch.fd = fd;
-    fdrecord(csound, &(p->fdch));
 
     /* check number of channels in file (must equal the number of outargs) */
     if (UNLIKELY(sfinfo.channels != p->nChannels)) {
@@ -415,7 +454,8 @@ static int32_t diskin2_init_(CSOUND *csound, DISKIN2 *p, int32_t stringname)
     memset(p->buf, 0, n*sizeof(MYFLT));
 
     // create circular buffer, on fail set mode to synchronous
-    if (csound->oparms->realtime==1 && p->fforceSync==0 &&
+    // (a file in memory is read synchronously)
+    if (csound->oparms->realtime==1 && p->fforceSync==0 && p->smf == NULL &&
         (p->cb = csound->CreateCircularBuffer(csound,
                                               p->bufSize*p->nChannels*2,
                                               sizeof(MYFLT))) != NULL){
@@ -474,7 +514,7 @@ static int32_t diskin2_init_(CSOUND *csound, DISKIN2 *p, int32_t stringname)
         csound->Message(csound, "%s '%s'\n"
                         "         %d Hz, %d %s, %"  PRId64 " %s",
                         Str("diskin2: opened (asynchronously)"),
-                        csound->GetFileName(fd),
+                        fname,
                         sfinfo.samplerate, sfinfo.channels,
                         Str("channel(s)"),
                         (int64_t)sfinfo.frames,
@@ -490,7 +530,7 @@ static int32_t diskin2_init_(CSOUND *csound, DISKIN2 *p, int32_t stringname)
         csound->Message(csound, "%s '%s':\n"
                         "         %d Hz, %d %s, %" PRId64 " %s\n",
                         Str("diskin2: opened"),
-                        csound->GetFileName(fd),
+                        fname,
                         sfinfo.samplerate, sfinfo.channels,
                         Str("channel(s)"),
                         (int64_t)sfinfo.frames,
@@ -567,7 +607,7 @@ int32_t diskin2_perf_synchronous(CSOUND *csound, DISKIN2 *p)
     int32_t     wsized2, warp;
 
 
-    if (UNLIKELY(p->fdch.fd == NULL) ) goto file_error;
+    if (UNLIKELY(p->fdch.fd == NULL && p->smf == NULL) ) goto file_error;
     if (!p->initDone && !p->SkipInit){
       return csound->PerfError(csound, &(p->h),
                                Str("diskin2: not initialised"));
@@ -753,7 +793,7 @@ int32_t diskin_file_read(CSOUND *csound, DISKIN2 *p)
     int32_t     wsized2, warp;
     MYFLT  *aOut = (MYFLT *)p->aOut_buf; /* needs to be allocated */
 
-    if (UNLIKELY(p->fdch.fd == NULL) ) goto file_error;
+    if (UNLIKELY(p->fdch.fd == NULL && p->smf == NULL) ) goto file_error;
     if (!p->initDone && !p->SkipInit) {
       return csound->PerfError(csound, &(p->h),
                                Str("diskin2: not initialised"));
@@ -949,7 +989,7 @@ int32_t diskin2_perf_asynchronous(CSOUND *csound, DISKIN2 *p)
       if (UNLIKELY(early)) nsmps -= early;
     }
 
-    if (UNLIKELY(p->fdch.fd == NULL)) return NOTOK;
+    if (UNLIKELY(p->fdch.fd == NULL && p->smf == NULL)) return NOTOK;
     if (!p->initDone && !p->SkipInit){
       return csound->PerfError(csound, &(p->h),
                                Str("diskin2: not initialised"));
@@ -1188,11 +1228,20 @@ static CS_NOINLINE void diskin2_read_buffer_array(CSOUND *csound,
         if (nsmps > (int32_t) p->bufSize)
           nsmps = (int32_t) p->bufSize;
         nsmps *= (int32_t) p->nChannels;
-        sf_seek(p->sf, (sf_count_t) p->bufStartPos, SEEK_SET);
-        /* convert sample count to mono samples and read file */
-        i = (int32_t)sf_read_MYFLT(p->sf, p->buf, (sf_count_t) nsmps);
-        if (UNLIKELY(i < 0))  /* error ? */
-          i = 0;    /* clear entire buffer to zero */
+        if (p->smf != NULL) {
+          /* shared copy of the file in memory */
+          const float *src =
+            p->smf->data + (size_t) p->bufStartPos * p->nChannels;
+          for (i = 0; i < nsmps; i++)
+            p->buf[i] = (MYFLT) src[i];
+        }
+        else {
+          sf_seek(p->sf, (sf_count_t) p->bufStartPos, SEEK_SET);
+          /* convert sample count to mono samples and read file */
+          i = (int32_t)sf_read_MYFLT(p->sf, p->buf, (sf_count_t) nsmps);
+          if (UNLIKELY(i < 0))  /* error ? */
+            i = 0;    /* clear entire buffer to zero */
+        }
       }
     }
     /* fill rest of buffer with zero samples */
@@ -1355,7 +1404,7 @@ int32_t diskin_file_read_array(CSOUND *csound, DISKIN2_ARRAY *p)
     int32_t     wsized2, warp;
     MYFLT  *aOut = (MYFLT *)p->aOut_buf; /* needs to be allocated */
 
-    if (UNLIKELY(p->fdch.fd == NULL) ) goto file_error;
+    if (UNLIKELY(p->fdch.fd == NULL && p->smf == NULL) ) goto file_error;
     if (!p->initDone && !p->SkipInit) {
       return csound->PerfError(csound, &(p->h),
                                Str("diskin2: not initialised"));
@@ -1552,22 +1601,37 @@ uintptr_t diskin_io_thread_array(void *p){
 }
 
 
+static int32_t diskin2_release_array(CSOUND *csound, void *pp)
+{
+    DISKIN2_ARRAY *p = (DISKIN2_ARRAY*) pp;
+    csoundReleaseSoundFile(csound, p->smf);
+    p->smf = NULL;
+    return OK;
+}
+
 static int32_t diskin2_init_array(CSOUND *csound, DISKIN2_ARRAY *p,
                                   int32_t stringname)
 {
     double  pos;
     char    name[1024];
+    const char *fname;
     void    *fd;
     SF_INFO sfinfo;
-    int32_t     n;
+    int32_t     n, hasRelease = 0;
     ARRAYDAT *t = p->aOut;
 
     /* if already open, close old file first */
-    if (p->fdch.fd != NULL) {
+    if (p->fdch.fd != NULL || p->smf != NULL) {
       /* skip initialisation if requested */
       if (p->SkipInit != FL(0.0))
         return OK;
-      fdclose(csound, &(p->fdch));
+      if (p->fdch.fd != NULL)
+        fdclose(csound, &(p->fdch));
+      if (p->smf != NULL) {           /* the release callback stays */
+        csoundReleaseSoundFile(csound, p->smf);
+        p->smf = NULL;
+        hasRelease = 1;
+      }
     }
     // to handle raw files number of channels
     if (t->data) p->nChannels = t->sizes[0];
@@ -1589,17 +1653,32 @@ static int32_t diskin2_init_array(CSOUND *csound, DISKIN2_ARRAY *p,
     }
     else strNcpy(name, ((STRINGDAT *)p->iFileCode)->data, 1023);
 
-    fd = csound->FileOpen2(csound, &(p->sf), CSFILE_SND_R, name, &sfinfo,
-                           "SFDIR;SSDIR", CSFTYPE_UNKNOWN_AUDIO, 0);
-    if (UNLIKELY(fd == NULL)) {
-      return csound->InitError(csound,
-                               Str("diskin2: %s: failed to open file: %s"),
-                               name, Str(sf_strerror(NULL)));
+    /* files that fit the sample cache are shared by all instances; with
+       -realtime only one already in memory is, as decoding it here would
+       stall the perf thread, and others stream as before */
+    p->smf = (csound->oparms->realtime ?
+              csoundAcquireCachedSoundFile(csound, name, &sfinfo) :
+              csoundAcquireSoundFile(csound, name, &sfinfo, 1));
+    if (p->smf != NULL) {
+      fd = NULL;
+      fname = p->smf->fullName;
+      if (!hasRelease)
+        csound->RegisterDeinitCallback(csound, p, diskin2_release_array);
+    }
+    else {
+      fd = csound->FileOpen2(csound, &(p->sf), CSFILE_SND_R, name, &sfinfo,
+                             "SFDIR;SSDIR", CSFTYPE_UNKNOWN_AUDIO, 0);
+      if (UNLIKELY(fd == NULL)) {
+        return csound->InitError(csound,
+                                 Str("diskin2: %s: failed to open file: %s"),
+                                 name, Str(sf_strerror(NULL)));
+      }
+      /* record file handle so that it will be closed at note-off */
+      memset(&(p->fdch), 0, sizeof(FDCH));
+      p->fdch.fd = fd;
+      fdrecord(csound, &(p->fdch));
+      fname = csound->GetFileName(fd);
     }
-    /* record file handle so that it will be closed at note-off */
-    memset(&(p->fdch), 0, sizeof(FDCH));
-    p->fdch.fd = fd;
-    fdrecord(csound, &(p->fdch));
 
     /* get number of channels in file */
     p->nChannels = sfinfo.channels;
@@ -1688,7 +1767,8 @@ static int32_t diskin2_init_array(CSOUND *csound, DISKIN2_ARRAY *p,
     memset(p->buf, 0, n*sizeof(MYFLT));
 
     // create circular buffer, on fail set mode to synchronous
-    if (csound->oparms->realtime==1 && p->fforceSync==0 &&
+    // (a file in memory is read synchronously)
+    if (csound->oparms->realtime==1 && p->fforceSync==0 && p->smf == NULL &&
         (p->cb = csound->CreateCircularBuffer(csound,
                                               p->bufSize*p->nChannels*2,
                                               sizeof(MYFLT))) != NULL){
@@ -1758,7 +1838,7 @@ static int32_t diskin2_init_array(CSOUND *csound, DISKIN2_ARRAY *p,
         csound->Message(csound, "%s '%s':\n"
                                 "         %d Hz, %d %schannel(s), %" PRId64 " %s",
                         Str("diskin2: opened (asynchronously)"),
-                        csound->GetFileName(fd),
+                        fname,
                         sfinfo.samplerate, sfinfo.channels,
                         Str("channel(s)"),
                         (int64_t)sfinfo.frames,
@@ -1774,7 +1854,7 @@ static int32_t diskin2_init_array(CSOUND *csound, DISKIN2_ARRAY *p,
         csound->Message(csound, "%s '%s':\n"
                         "         %d Hz, %d %s, %"  PRId64 " %s",
                         Str("diskin2: opened"),
-                        csound->GetFileName(fd),
+                        fname,
                         sfinfo.samplerate, sfinfo.channels,
                         Str("channel(s)"),
                         (int64_t)sfinfo.frames,
@@ -1802,7 +1882,7 @@ int32_t diskin2_perf_synchronous_array(CSOUND *csound, DISKIN2_ARRAY *p)
     MYFLT *aOut = (MYFLT *) p->aOut->data;
 
 
-    if (UNLIKELY(p->fdch.fd == NULL) ) goto file_error;
+    if (UNLIKELY(p->fdch.fd == NULL && p->smf == NULL) ) goto file_error;
     if (!p->initDone && !p->SkipInit){
       return csound->PerfError(csound, &(p->h),
                                Str("diskin2: not initialised"));
@@ -1995,7 +2075,7 @@ int32_t diskin2_perf_asynchronous_array(CSOUND *csound, DISKIN2_ARRAY *p)
       if (UNLIKELY(early)) nsmps -= early;
     }
 
-    if (UNLIKELY(p->fdch.fd == NULL)) return NOTOK;
+    if (UNLIKELY(p->fdch.fd == NULL && p->smf == NULL)) return NOTOK;
     if (!p->initDone && !p->SkipInit){
       return csound->PerfError(csound, &(p->h),
                                Str("diskin2: not initialised"));
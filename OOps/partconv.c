@@ -0,0 +1,431 @@
+/*
+    partconv.c:
+
+    Copyright (C) 2018 The Csound Developers
+
+    This file is part of Csound.
+
+    The Csound Library is free software; you can redistribute it
+    and/or modify it under the terms of the GNU Lesser General Public
+    License as published by the Free Software Foundation; either
+    version 2.1 of the License, or (at your option) any later version.
+
+    Csound is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public
+    License along with Csound; if not, write to the Free Software
+    Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA
+    02110-1301 USA
+*/
+
+/* Non-uniform partitioned convolution, shared by ftconvnu and liveconvnu.
+
+   The impulse response is cut into stages.  Stage 0 has four partitions
+   of the head size B, which sets the latency as in ftconv; each later
+   stage has two partitions of twice the previous size, until the maximum
+   size, whose stage takes the rest of the response.  Every stage is a
+   uniformly partitioned convolver (frequency-domain delay line of input
+   spectra times partition spectra, overlap-add of 2N-point inverse FFTs).
+
+   Output is kept in a ring indexed by emission time, B samples after the
+   input.  A stage of block N at IR offset O completes an input block at
+   time T and must have added its output, which starts at T - N + O + B,
+   by then; with this layout O >= 2N - B, so a block of N samples may take
+   the next N / B head blocks.  Its work (forward FFT, one multiply per
+   partition and channel, one inverse FFT per channel) is spread evenly
+   over them, or handed to a worker thread and collected at the deadline.
+   Stage 0 runs at once. */
+
+#include "csoundCore.h"
+#include "fftlib.h"
+#include "partconv.h"
+#include <limits.h>
+
+#define PARTCONV_MAXSTAGES  32
+
+typedef struct {
+    int32_t N;                  /* block length; FFT length 2N              */
+    int32_t nParts;             /* partitions in this stage                 */
+    int32_t offset;             /* IR offset of the first partition         */
+    int32_t spread;             /* head blocks a job may take, 0 = at once  */
+    int32_t fill;               /* samples collected in inBuf               */
+    int32_t slot;               /* delay line slot of the newest block      */
+    int32_t tick;               /* head blocks since the job started        */
+    int32_t nTasks;             /* 1 + nChannels * (nParts + 1)             */
+    int32_t done;               /* tasks of the job done, -1 when idle      */
+    int32_t posted;             /* the job is with the worker               */
+    int64_t outPos;             /* emission time of the job's first sample  */
+    MYFLT   *inBuf;             /* N samples of input                       */
+    MYFLT   *fdl;               /* nParts spectra of past input blocks      */
+    MYFLT   *ir;                /* nChannels * nParts partition spectra     */
+    MYFLT   *acc;               /* nChannels spectral sums, then outputs    */
+    void    *fwdsetup, *invsetup;
+    void    *doneLock;          /* notified by the worker                   */
+} PCSTAGE;
+
+typedef struct {
+    CSOUND  *csound;
+    int32_t headSize;           /* B */
+    int32_t nChannels;
+    int32_t nStages;
+    int32_t cnt;                /* position in the head block               */
+    int64_t time;               /* input samples taken at the last tick     */
+    int32_t ringMask;
+    MYFLT   *in;                /* head block of input                      */
+    MYFLT   *out;               /* nChannels head blocks being played       */
+    MYFLT   *ring;              /* nChannels rings of ringMask + 1 samples  */
+    PCSTAGE *stage;
+    void    *thread, *workLock, *queueLock;
+    PCSTAGE **queue;            /* jobs for the worker, nStages + 1 slots   */
+    int32_t qHead, qTail;
+    int32_t quit;               /* under queueLock */
+} PARTCONV;
+
+/* acc += x * h, spectra as returned by csoundRealFFT2() */
+
+static void spectrum_mac(MYFLT *acc, const MYFLT *x, const MYFLT *h,
+                         int32_t len)
+{
+    int32_t i;
+    acc[0] += x[0] * h[0];              /* DC */
+    acc[1] += x[1] * h[1];              /* Nyquist */
+    for (i = 2; i < len; i += 2) {
+      acc[i]     += x[i] * h[i] - x[i + 1] * h[i + 1];
+      acc[i + 1] += x[i] * h[i + 1] + x[i + 1] * h[i];
+    }
+}
+
+/* run the tasks of the current job up to 'upto' */
+
+static void stage_work(CSOUND *csound, PARTCONV *p, PCSTAGE *st,
+                       int32_t upto)
+{
+    int32_t len = st->N << 1, per = st->nParts + 1;
+
+    while (st->done < upto) {
+      int32_t t = st->done++;
+      if (t == 0) {
+        csoundRealFFT2(csound, st->fwdsetup, st->fdl + st->slot * len);
+        memset(st->acc, 0, sizeof(MYFLT) * len * p->nChannels);
+      }
+      else {
+        int32_t c = (t - 1) / per, k = (t - 1) % per;
+        MYFLT   *acc = st->acc + c * len;
+        if (k < st->nParts) {
+          int32_t slot = st->slot - k;
+          if (slot < 0) slot += st->nParts;
+          spectrum_mac(acc, st->fdl + slot * len,
+                       st->ir + (c * st->nParts + k) * len, len);
+        }
+        else
+          csoundRealFFT2(csound, st->invsetup, acc);
+      }
+    }
+}
+
+/* add the finished job's output to the ring */
+
+static void stage_finish(PARTCONV *p, PCSTAGE *st)
+{
+    int32_t len = st->N << 1, size = p->ringMask + 1, c, i;
+    int32_t pos = (int32_t) (st->outPos & p->ringMask);
+
+    for (c = 0; c < p->nChannels; c++) {
+      MYFLT *ring = p->ring + c * size, *y = st->acc + c * len;
+      for (i = 0; i < len; i++)
+        ring[(pos + i) & p->ringMask] += y[i];
+    }
+    st->done = -1;
+}
+
+static void stage_join(PARTCONV *p, PCSTAGE *st)
+{
+    IGN(p);
+    if (st->posted) {
+      csoundWaitThreadLockNoTimeout(st->doneLock);
+      st->posted = 0;
+    }
+}
+
+static void stage_post(PARTCONV *p, PCSTAGE *st)
+{
+    st->posted = 1;
+    csoundLockMutex(p->queueLock);
+    p->queue[p->qTail] = st;
+    p->qTail = (p->qTail + 1) % (p->nStages + 1);
+    csoundUnlockMutex(p->queueLock);
+    csoundNotifyThreadLock(p->workLock);
+}
+
+static PCSTAGE *stage_pop(PARTCONV *p)
+{
+    PCSTAGE *st = NULL;
+    csoundLockMutex(p->queueLock);
+    if (p->qHead != p->qTail) {
+      st = p->queue[p->qHead];
+      p->qHead = (p->qHead + 1) % (p->nStages + 1);
+    }
+    csoundUnlockMutex(p->queueLock);
+    return st;
+}
+
+static uintptr_t partconv_worker(void *data)
+{
+    PARTCONV *p = (PARTCONV*) data;
+    PCSTAGE  *st;
+    int32_t  quit;
+
+    do {
+      csoundWaitThreadLockNoTimeout(p->workLock);
+      while ((st = stage_pop(p)) != NULL) {
+        stage_work(p->csound, p, st, st->nTasks);
+        csoundNotifyThreadLock(st->doneLock);
+      }
+      csoundLockMutex(p->queueLock);
+      quit = p->quit;
+      csoundUnlockMutex(p->queueLock);
+    } while (!quit);
+    return 0;
+}
+
+/* a block of N samples is complete: move it to the delay line */
+
+static void stage_start(CSOUND *csound, PARTCONV *p, PCSTAGE *st)
+{
+    MYFLT *x;
+
+    st->slot = (st->slot + 1 < st->nParts ? st->slot + 1 : 0);
+    x = st->fdl + st->slot * (st->N << 1);
+    memcpy(x, st->inBuf, sizeof(MYFLT) * st->N);
+    memset(x + st->N, 0, sizeof(MYFLT) * st->N);
+    st->fill = 0;
+    st->outPos = p->time - st->N + st->offset + p->headSize;
+    st->done = 0;
+    st->tick = 0;
+    if (st->spread == 0) {
+      stage_work(csound, p, st, st->nTasks);
+      stage_finish(p, st);
+    }
+    else if (p->thread != NULL)
+      stage_post(p, st);
+}
+
+static void partconv_tick(CSOUND *csound, PARTCONV *p)
+{
+    int32_t B = p->headSize, size = p->ringMask + 1, s, c, pos;
+
+    p->time += B;
+    for (s = 0; s < p->nStages; s++) {
+      PCSTAGE *st = &(p->stage[s]);
+      memcpy(st->inBuf + st->fill, p->in, sizeof(MYFLT) * B);
+      st->fill += B;
+      if (st->posted) {                 /* done is the worker's until joined */
+        if (++st->tick >= st->spread) {
+          stage_join(p, st);
+          stage_finish(p, st);
+        }
+      }
+      else if (st->done >= 0) {
+        st->tick++;
+        stage_work(csound, p, st,
+                   (st->nTasks * st->tick + st->spread - 1) / st->spread);
+        if (st->done >= st->nTasks)
+          stage_finish(p, st);
+      }
+      if (st->fill == st->N)
+        stage_start(csound, p, st);
+    }
+    /* everything due in the next B samples is in the ring now */
+    pos = (int32_t) (p->time & p->ringMask);
+    for (c = 0; c < p->nChannels; c++) {
+      MYFLT *ring = p->ring + c * size + pos;
+      memcpy(p->out + c * B, ring, sizeof(MYFLT) * B);
+      memset(ring, 0, sizeof(MYFLT) * B);
+    }
+}
+
+void *csoundPartConvCreate(CSOUND *csound, int headSize, int maxSize,
+                           int irLen, int nChannels, int threaded)
+{
+    PARTCONV *p;
+    int32_t  N[PARTCONV_MAXSTAGES], P[PARTCONV_MAXSTAGES];
+    int32_t  O[PARTCONV_MAXSTAGES];
+    int32_t  s, n, pos, ext, size, tail = 0;
+
+    if (UNLIKELY(headSize < 4 || (headSize & (headSize - 1)) != 0 ||
+                 irLen <= 0 || nChannels < 1))
+      return NULL;
+    if (maxSize < headSize) maxSize = headSize;
+    if (UNLIKELY((maxSize & (maxSize - 1)) != 0))
+      return NULL;
+
+    /* stage layout: 4 x B, then 2 x 2B, 2 x 4B, ..., the rest at maxSize */
+    for (s = 0, n = headSize, pos = 0, ext = 0; pos < irLen; s++) {
+      int32_t parts = (n >= maxSize || s == PARTCONV_MAXSTAGES - 1 ?
+                       INT_MAX : (s == 0 ? 4 : 2));
+      if (parts >= (irLen - pos + n - 1) / n)
+        parts = (irLen - pos + n - 1) / n;
+      N[s] = n; P[s] = parts; O[s] = pos;
+      pos += parts * n;
+      if (O[s] + headSize + 2 * n > ext) ext = O[s] + headSize + 2 * n;
+      if (n < maxSize) n <<= 1;
+    }
+    for (size = headSize; size < ext + headSize; size <<= 1) ;
+
+    p = (PARTCONV*) csound->Calloc(csound, sizeof(PARTCONV));
+    p->csound = csound;
+    p->headSize = headSize;
+    p->nChannels = nChannels;
+    p->nStages = s;
+    p->ringMask = size - 1;
+    p->in = (MYFLT*) csound->Calloc(csound, sizeof(MYFLT) * headSize);
+    p->out = (MYFLT*) csound->Calloc(csound,
+                                     sizeof(MYFLT) * headSize * nChannels);
+    p->ring = (MYFLT*) csound->Calloc(csound, sizeof(MYFLT) * size * nChannels);
+    p->stage = (PCSTAGE*) csound->Calloc(csound, sizeof(PCSTAGE) * s);
+    for (s = 0; s < p->nStages; s++) {
+      PCSTAGE *st = &(p->stage[s]);
+      int32_t len = N[s] << 1, slack = O[s] + headSize - N[s];
+      st->N = N[s];
+      st->nParts = P[s];
+      st->offset = O[s];
+      st->spread = (slack < N[s] ? slack : N[s]) / headSize;
+      st->slot = 0;
+      st->nTasks = 1 + nChannels * (P[s] + 1);
+      st->done = -1;
+      st->inBuf = (MYFLT*) csound->Calloc(csound, sizeof(MYFLT) * N[s]);
+      st->fdl = (MYFLT*) csound->Calloc(csound, sizeof(MYFLT) * len * P[s]);
+      st->ir = (MYFLT*) csound->Calloc(csound,
+                                       sizeof(MYFLT) * len * P[s] * nChannels);
+      st->acc = (MYFLT*) csound->Calloc(csound,
+                                        sizeof(MYFLT) * len * nChannels);
+      st->fwdsetup = csoundRealFFT2Setup(csound, len, FFT_FWD);
+      st->invsetup = csoundRealFFT2Setup(csound, len, FFT_INV);
+      if (st->spread > 0) tail = 1;
+    }
+
+    if (threaded && tail) {
+      p->workLock = csoundCreateThreadLock();
+      p->queueLock = csoundCreateMutex(0);
+      p->queue = (PCSTAGE**) csound->Calloc(csound, sizeof(PCSTAGE*) *
+                                            (p->nStages + 1));
+      csoundWaitThreadLock(p->workLock, 0);   /* created signalled */
+      for (s = 0; s < p->nStages; s++) {
+        PCSTAGE *st = &(p->stage[s]);
+        if (st->spread == 0) continue;
+        st->doneLock = csoundCreateThreadLock();
+        csoundWaitThreadLock(st->doneLock, 0);
+        /* the FFTLIB tables are built on first use; not on the worker */
+        csoundRealFFT2(csound, st->fwdsetup, st->acc);
+        csoundRealFFT2(csound, st->invsetup, st->acc);
+      }
+      p->thread = csoundCreateThread(partconv_worker, (void*) p);
+    }
+    return (void*) p;
+}
+
+void csoundPartConvLoad(CSOUND *csound, void *pc, int chn,
+                        const MYFLT *ir, int stride, int len,
+                        int start, int end)
+{
+    PARTCONV *p = (PARTCONV*) pc;
+    int32_t  s, k, i;
+
+    if (UNLIKELY(chn < 0 || chn >= p->nChannels))
+      return;
+    for (s = 0; s < p->nStages; s++) {
+      PCSTAGE *st = &(p->stage[s]);
+      int32_t len2 = st->N << 1;
+      for (k = 0; k < st->nParts; k++) {
+        int32_t o = st->offset + k * st->N;
+        MYFLT   *h = st->ir + (chn * st->nParts + k) * len2;
+        if (o + st->N <= start || o + st->N > end)
+          continue;
+        stage_join(p, st);              /* the worker may be reading it */
+        if (ir == NULL) {
+          memset(h, 0, sizeof(MYFLT) * len2);
+          continue;
+        }
+        for (i = 0; i < st->N; i++)
+          h[i] = (o + i < len ? ir[(size_t) (o + i) * stride] : FL(0.0));
+        memset(h + st->N, 0, sizeof(MYFLT) * st->N);
+        csoundRealFFT2(csound, st->fwdsetup, h);
+      }
+    }
+}
+
+void csoundPartConvProcess(CSOUND *csound, void *pc, const MYFLT *in,
+                           MYFLT **out, int nsmps)
+{
+    PARTCONV *p = (PARTCONV*) pc;
+    int32_t  B = p->headSize, i = 0, c;
+
+    while (i < nsmps) {
+      int32_t n = B - p->cnt;
+      if (n > nsmps - i) n = nsmps - i;
+      /* input first: in and out may be the same signal */
+      memcpy(p->in + p->cnt, in + i, sizeof(MYFLT) * n);
+      for (c = 0; c < p->nChannels; c++)
+        memcpy(out[c] + i, p->out + c * B + p->cnt, sizeof(MYFLT) * n);
+      i += n;
+      if ((p->cnt += n) == B) {
+        p->cnt = 0;
+        partconv_tick(csound, p);
+      }
+    }
+}
+
+void csoundPartConvClear(CSOUND *csound, void *pc)
+{
+    PARTCONV *p = (PARTCONV*) pc;
+    int32_t  s;
+    IGN(csound);
+
+    for (s = 0; s < p->nStages; s++) {
+      PCSTAGE *st = &(p->stage[s]);
+      stage_join(p, st);
+      st->done = -1;
+      st->fill = 0;
+      memset(st->fdl, 0, sizeof(MYFLT) * (st->N << 1) * st->nParts);
+    }
+    memset(p->out, 0, sizeof(MYFLT) * p->headSize * p->nChannels);
+    memset(p->ring, 0, sizeof(MYFLT) * (p->ringMask + 1) * p->nChannels);
+    p->cnt = 0;
+}
+
+void csoundPartConvDestroy(CSOUND *csound, void *pc)
+{
+    PARTCONV *p = (PARTCONV*) pc;
+    int32_t  s;
+
+    if (p == NULL) return;
+    if (p->thread != NULL) {
+      for (s = 0; s < p->nStages; s++)
+        stage_join(p, &(p->stage[s]));
+      csoundLockMutex(p->queueLock);
+      p->quit = 1;
+      csoundUnlockMutex(p->queueLock);
+      csoundNotifyThreadLock(p->workLock);
+      csoundJoinThread(p->thread);
+      csoundDestroyThreadLock(p->workLock);
+      csoundDestroyMutex(p->queueLock);
+      csound->Free(csound, p->queue);
+    }
+    /* the FFT setups are released with the instance, as for ftconv */
+    for (s = 0; s < p->nStages; s++) {
+      PCSTAGE *st = &(p->stage[s]);
+      if (st->doneLock != NULL) csoundDestroyThreadLock(st->doneLock);
+      csound->Free(csound, st->inBuf);
+      csound->Free(csound, st->fdl);
+      csound->Free(csound, st->ir);
+      csound->Free(csound, st->acc);
+    }
+    csound->Free(csound, p->stage);
+    csound->Free(csound, p->in);
+    csound->Free(csound, p->out);
+    csound->Free(csound, p->ring);
+    csound->Free(csound, p);
+}
@@ -23,6 +23,7 @@
 
 #include "stdopcod.h"
 #include <math.h>
+#include <limits.h>
 
 #define FTCONV_MAXCHN   8
 
@@ -307,6 +308,117 @@ static int32_t ftconv_perf(CSOUND *csound, FTCONV *p)
                              Str("ftconv: not initialised"));
 }
 
+/* ftconvnu: as ftconv, with partitions growing from iplen to imaxpart
+   (non-uniform partitioned convolution, see OOps/partconv.c) */
+
+#define FTCONVNU_MAXPART    8192
+
+typedef struct {
+    OPDS    h;
+    MYFLT   *aOut[FTCONV_MAXCHN];
+    MYFLT   *aIn;
+    MYFLT   *iFTNum;
+    MYFLT   *iPartLen;
+    MYFLT   *iSkipSamples;
+    MYFLT   *iTotLen;
+    MYFLT   *iMaxPartLen;
+    MYFLT   *iThread;
+ /* ------------------------- */
+    int32_t     nChannels;
+    void    *conv;
+} FTCONVNU;
+
+static int32_t ftconvnu_deinit(CSOUND *csound, void *pp)
+{
+    FTCONVNU *p = (FTCONVNU*) pp;
+    if (p->conv != NULL) {
+      csound->PartConvDestroy(csound, p->conv);
+      p->conv = NULL;
+    }
+    return OK;
+}
+
+static int32_t ftconvnu_init(CSOUND *csound, FTCONVNU *p)
+{
+    FUNC    *ftp;
+    int32_t     j, n, partSize, maxSize, skipSamples;
+
+    p->nChannels = (int32_t) p->OUTOCOUNT;
+    if (UNLIKELY(p->nChannels < 1 || p->nChannels > FTCONV_MAXCHN)) {
+      return csound->InitError(csound,
+                               Str("ftconvnu: invalid number of channels"));
+    }
+    partSize = MYFLT2LRND(*(p->iPartLen));
+    if (UNLIKELY(partSize < 4 || (partSize & (partSize - 1)) != 0)) {
+      return csound->InitError(csound, Str("ftconvnu: invalid impulse response "
+                                           "partition length"));
+    }
+    maxSize = MYFLT2LRND(*(p->iMaxPartLen));
+    if (maxSize <= 0)
+      maxSize = FTCONVNU_MAXPART;
+    if (maxSize < partSize)
+      maxSize = partSize;
+    if (UNLIKELY((maxSize & (maxSize - 1)) != 0)) {
+      return csound->InitError(csound, Str("ftconvnu: invalid maximum "
+                                           "partition length"));
+    }
+    ftp = csound->FTnp2Find(csound, p->iFTNum);
+    if (UNLIKELY(ftp == NULL))
+      return NOTOK; /* ftfind should already have printed the error message */
+    n = (int32_t) ftp->flen / p->nChannels;
+    skipSamples = MYFLT2LRND(*(p->iSkipSamples));
+    n -= skipSamples;
+    if (MYFLT2LRND(*(p->iTotLen)) > 0 && n > MYFLT2LRND(*(p->iTotLen)))
+      n = MYFLT2LRND(*(p->iTotLen));
+    if (UNLIKELY(n <= 0 || skipSamples < 0)) {
+      return csound->InitError(csound,
+                               Str("ftconvnu: invalid length, or insufficient"
+                                   " IR data for convolution"));
+    }
+    if (p->conv != NULL)                /* reinit */
+      csound->PartConvDestroy(csound, p->conv);
+    else
+      csound->RegisterDeinitCallback(csound, p, ftconvnu_deinit);
+    p->conv = csound->PartConvCreate(csound, partSize, maxSize, n,
+                                     p->nChannels, *(p->iThread) != FL(0.0));
+    if (UNLIKELY(p->conv == NULL)) {
+      return csound->InitError(csound, Str("ftconvnu: invalid impulse response "
+                                           "partition length"));
+    }
+    for (j = 0; j < p->nChannels; j++)
+      csound->PartConvLoad(csound, p->conv, j,
+                           &(ftp->ftable[skipSamples * p->nChannels + j]),
+                           p->nChannels, n, -1, INT_MAX);
+    return OK;
+}
+
+static int32_t ftconvnu_perf(CSOUND *csound, FTCONVNU *p)
+{
+    MYFLT         *out[FTCONV_MAXCHN];
+    int32_t           n;
+    uint32_t offset = p->h.insdshead->ksmps_offset;
+    uint32_t early  = p->h.insdshead->ksmps_no_end;
+    uint32_t nsmps = CS_KSMPS;
+
+    if (UNLIKELY(p->conv == NULL)) goto err1;
+    if (UNLIKELY(offset))
+      for (n = 0; n < p->nChannels; n++)
+        memset(p->aOut[n], '\0', offset*sizeof(MYFLT));
+    if (UNLIKELY(early)) {
+      nsmps -= early;
+      for (n = 0; n < p->nChannels; n++)
+        memset(&p->aOut[n][nsmps], '\0', early*sizeof(MYFLT));
+    }
+    for (n = 0; n < p->nChannels; n++)
+      out[n] = p->aOut[n] + offset;
+    csound->PartConvProcess(csound, p->conv, p->aIn + offset, out,
+                            (int32_t) (nsmps - offset));
+    return OK;
+ err1:
+    return csound->PerfError(csound, &(p->h),
+                             Str("ftconvnu: not initialised"));
+}
+
 /* module interface functions */
 
 int32_t ftconv_init_(CSOUND *csound)
@@ -316,6 +428,12 @@ int32_t ftconv_init_(CSOUND *csound)
                                 "mmmmmmmm", "aiiooo",
                                 (int32_t (*)(CSOUND *, void *)) ftconv_init,
                                 (int32_t (*)(CSOUND *, void *)) ftconv_perf,
-                                NULL);
+                                NULL)
+      | csound->AppendOpcode(csound, "ftconvnu",
+                             (int32_t) sizeof(FTCONVNU), TR, 3,
+                             "mmmmmmmm", "aiioooo",
+                             (int32_t (*)(CSOUND *, void *)) ftconvnu_init,
+                             (int32_t (*)(CSOUND *, void *)) ftconvnu_perf,
+                             NULL);
 }
 
@@ -51,6 +51,11 @@ typedef struct {
     MYFLT   *iftno, *ifreeTime;
 } FTFREE;
 
+typedef struct {
+    OPDS    h;
+    MYFLT   *kr, *ifn;
+} FTREADY;
+
 typedef struct {
     OPDS    h;
     int32_t fno;
@@ -82,8 +87,9 @@ static int32_t register_ftable_delete(CSOUND *csound, void *p, int32_t tableNum)
     return csound->RegisterDeinitCallback(csound, op, ftable_delete);
 }
 
-/* set up and call any GEN routine */
-static int32_t ftgen_(CSOUND *csound, FTGEN *p, int32_t istring1, int32_t istring2)
+/* set up and call any GEN routine; if async, in the background */
+static int32_t ftgen_(CSOUND *csound, FTGEN *p, int32_t istring1,
+                      int32_t istring2, int32_t async)
 {
     MYFLT   *fp;
     FUNC    *ftp;
@@ -152,6 +158,15 @@ static int32_t ftgen_(CSOUND *csound, FTGEN *p, int32_t istring1, int32_t istrin
         *fp++ = **argp++;                               /* copy rem arglist */
       } while (--n);
     }
+    if (async) {
+      int fno;
+      n = csound->FTGenAsync(csound, &fno, ftevt, 1);   /* queue the fgen */
+      csound->Free(csound, ftevt);
+      if (UNLIKELY(n != 0))
+        return csound->InitError(csound, Str("ftgenasync error"));
+      *p->ifno = (MYFLT) fno;
+      return OK;
+    }
     n = csound->hfgens(csound, &ftp, ftevt, 1);         /* call the fgen */
     csound->Free(csound, ftevt);
     if (UNLIKELY(n != 0))
@@ -162,19 +177,42 @@ static int32_t ftgen_(CSOUND *csound, FTGEN *p, int32_t istring1, int32_t istrin
 }
 
 static int32_t ftgen(CSOUND *csound, FTGEN *p) {
-    return ftgen_(csound,p,0,0);
+    return ftgen_(csound,p,0,0,0);
 }
 
 static int32_t ftgen_S(CSOUND *csound, FTGEN *p) {
-    return ftgen_(csound,p,1,0);
+    return ftgen_(csound,p,1,0,0);
 }
 
 static int32_t ftgen_iS(CSOUND *csound, FTGEN *p) {
-    return ftgen_(csound,p,0,1);
+    return ftgen_(csound,p,0,1,0);
 }
 
 static int32_t ftgen_SS(CSOUND *csound, FTGEN *p) {
-    return ftgen_(csound,p,1,1);
+    return ftgen_(csound,p,1,1,0);
+}
+
+static int32_t ftgenasync(CSOUND *csound, FTGEN *p) {
+    return ftgen_(csound,p,0,0,1);
+}
+
+static int32_t ftgenasync_S(CSOUND *csound, FTGEN *p) {
+    return ftgen_(csound,p,1,0,1);
+}
+
+static int32_t ftgenasync_iS(CSOUND *csound, FTGEN *p) {
+    return ftgen_(csound,p,0,1,1);
+}
+
+static int32_t ftgenasync_SS(CSOUND *csound, FTGEN *p) {
+    return ftgen_(csound,p,1,1,1);
+}
+
+/* 1 once a table from ftgenasync is installed, 0 before, -1 if none */
+static int32_t ftready(CSOUND *csound, FTREADY *p)
+{
+    *p->kr = (MYFLT) csound->FTReady(csound, (int) MYFLT2LRND(*p->ifn));
+    return OK;
 }
 
 static int32_t ftgentmp(CSOUND *csound, FTGEN *p)
@@ -195,7 +233,7 @@ static int32_t ftgentmp_S(CSOUND *csound, FTGEN *p)
 {
     int32_t   p1, fno;
 
-    if (UNLIKELY(ftgen_(csound, p,0,1) != OK))
+    if (UNLIKELY(ftgen_(csound, p,0,1,0) != OK))
       return NOTOK;
     p1 = (int32_t) MYFLT2LRND(*p->p1);
     if (p1)
@@ -208,7 +246,7 @@ static int32_t ftgentmp_Si(CSOUND *csound, FTGEN *p)
 {
     int32_t   p1, fno;
 
-    if (UNLIKELY(ftgen_(csound, p,1,0) != OK))
+    if (UNLIKELY(ftgen_(csound, p,1,0,0) != OK))
       return NOTOK;
     p1 = (int32_t) MYFLT2LRND(*p->p1);
     if (p1)
@@ -221,7 +259,7 @@ static int32_t ftgentmp_SS(CSOUND *csound, FTGEN *p)
 {
     int32_t   p1, fno;
 
-    if (UNLIKELY(ftgen_(csound, p,1,1) != OK))
+    if (UNLIKELY(ftgen_(csound, p,1,1,0) != OK))
       return NOTOK;
     p1 = (int32_t) MYFLT2LRND(*p->p1);
     if (p1)
@@ -716,6 +754,13 @@ static OENTRY localops[] = {
   { "ftgentmp.iS", S(FTGEN),  TW, 1,  "i",  "iiiiSm", (SUBR) ftgentmp_S, NULL,NULL},
   { "ftgentmp.Si", S(FTGEN),  TW, 1,  "i",  "iiiSim", (SUBR) ftgentmp_Si,NULL,NULL},
   { "ftgentmp.SS", S(FTGEN),  TW, 1,  "i",  "iiiSSm", (SUBR) ftgentmp_SS,NULL,NULL},
+  { "ftgenasync", S(FTGEN),   TW, 1,  "i",  "iiiiim", (SUBR) ftgenasync, NULL, NULL },
+  { "ftgenasync.S", S(FTGEN), TW, 1,  "i",  "iiiSim", (SUBR) ftgenasync_S, NULL, NULL },
+  { "ftgenasync.iS", S(FTGEN), TW, 1, "i",  "iiiiSm", (SUBR) ftgenasync_iS, NULL, NULL },
+  { "ftgenasync.SS", S(FTGEN), TW, 1, "i",  "iiiSSm", (SUBR) ftgenasync_SS, NULL, NULL },
+  { "ftready.i", S(FTREADY),  TR, 1,  "i",  "i",      (SUBR) ftready, NULL, NULL  },
+  { "ftready.k", S(FTREADY),  TR, 3,  "k",  "k",      (SUBR) ftready, (SUBR) ftready,
+                                                                        NULL  },
   { "ftfree",   S(FTFREE),    TW, 1,  "",   "ii",     (SUBR) ftfree, NULL, NULL   },
   { "ftsave",   S(FTLOAD),    TR, 1,  "",   "iim",    (SUBR) ftsave, NULL, NULL   },
   { "ftsave.S",   S(FTLOAD),  TR, 1,  "",   "Sim",    (SUBR) ftsave_S, NULL, NULL },
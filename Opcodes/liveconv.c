@@ -25,6 +25,7 @@
 
 #include "csdl.h"
 #include <math.h>
+#include <limits.h>
 
 /*
 ** Data structures holding the load/unload information
@@ -93,6 +94,7 @@ typedef struct {
   MYFLT     *kUpdate;     // Control variable for updating the IR buffer
                           // (+1 is start load, -1 is start unload)
   MYFLT     *kClear;      // Clear output buffers
+  MYFLT     *iFade;       // Crossfade time of a background swap (seconds)
 
   /*
   ** Internal state of opcode maintained outside
@@ -115,6 +117,25 @@ typedef struct {
 
   void    *fwdsetup, *invsetup;
   AUXCH   auxData;        /* Aux data buffer allocated in init pass */
+
+  /*
+  ** Background swap (kUpdate = 2): a worker thread computes every IR
+  ** partition into IR_Stage; the next k-cycle after it is done swaps
+  ** IR_Stage and IR_Data and, if iFade > 0, keeps convolving with the
+  ** old IR while crossfading.  Allocated on the first swap.
+  */
+  MYFLT   *IR_Stage;      /* IR spectra being prepared by the worker */
+  MYFLT   *IR_Old;        /* IR being faded out */
+  MYFLT   *outOld;        /* output buffer of the IR being faded out */
+  void    *stagesetup;    /* forward FFT setup of the worker */
+  void    *worker;        /* preparing thread, or NULL */
+  FUNC    *stageFtp;      /* table being prepared */
+  int32_t stageReady;     /* set by the worker when IR_Stage is complete */
+  int32_t stageQueued;    /* a swap was asked for while preparing */
+  int32_t fadeLen;        /* crossfade length in samples */
+  int32_t fadePos;        /* fadeLen when not fading */
+  int32_t hasDeinit;      /* deinit callback registered for this note */
+  AUXCH   stageData;
 } liveconv_t;
 
 /*
@@ -239,6 +260,87 @@ static void set_buf_pointers(liveconv_t *p, int32_t partSize, int32_t nPartition
     p->loader.begin = (load_t*) ptr;
 }
 
+/* worker: FFT the whole table into IR_Stage, in liveconv's layout */
+static uintptr_t liveconv_prepare(void *data)
+{
+    liveconv_t  *p = (liveconv_t*) data;
+    CSOUND      *csound = p->h.insdshead->csound;
+    FUNC        *ftp = p->stageFtp;
+    int32_t     nSamples = p->partSize, nPart, k, n, cnt = 0;
+
+    for (nPart = 1; nPart <= p->nPartitions; nPart++) {
+      n = (nSamples << 1) * (p->nPartitions - nPart);
+      for (k = 0; k < nSamples; k++, cnt++)
+        p->IR_Stage[n + k] = (ftp != NULL && cnt < (int32_t) ftp->flen) ?
+          ftp->ftable[cnt] : FL(0.0);
+      memset(p->IR_Stage + n + nSamples, 0, nSamples*sizeof(MYFLT));
+      csound->RealFFT2(csound, p->stagesetup, &(p->IR_Stage[n]));
+    }
+    ATOMIC_SET(p->stageReady, 1);
+    return 0;
+}
+
+static void liveconv_start_prepare(CSOUND *csound, liveconv_t *p)
+{
+    int32_t n = (p->partSize << 1) * p->nPartitions;
+
+    if (p->IR_Stage == NULL) {
+      csound->AuxAlloc(csound,
+                       (2 * n + (p->partSize << 1)) * sizeof(MYFLT),
+                       &p->stageData);
+      p->IR_Stage = (MYFLT*) p->stageData.auxp;
+      p->IR_Old = p->IR_Stage + n;
+      p->outOld = p->IR_Old + n;
+      p->stagesetup = csound->RealFFT2Setup(csound, (p->partSize << 1),
+                                            FFT_FWD);
+      /* FFTLIB builds its tables on first use: not on the worker */
+      csound->RealFFT2(csound, p->stagesetup, p->outOld);
+      memset(p->outOld, 0, (p->partSize << 1)*sizeof(MYFLT));
+    }
+    p->stageFtp = csound->FTnp2Find(csound, p->iFTNum);
+    p->stageReady = 0;
+    p->worker = csound->CreateThread(liveconv_prepare, (void*) p);
+}
+
+/* make the prepared IR current; progressive loads are cancelled */
+static void liveconv_swap(liveconv_t *p)
+{
+    MYFLT   *prev = p->IR_Data;
+    load_t  *iter;
+
+    if (p->fadeLen > 0) {
+      p->IR_Data = p->IR_Stage;
+      p->IR_Stage = p->IR_Old;
+      p->IR_Old = prev;
+      /* both paths go on from the current tail */
+      memcpy(p->outOld, p->outBuf, (p->partSize << 1)*sizeof(MYFLT));
+      p->fadePos = 0;
+    }
+    else {
+      p->IR_Data = p->IR_Stage;
+      p->IR_Stage = prev;
+    }
+    for (iter = p->loader.begin; iter != p->loader.end; iter++)
+      iter->status = NO_LOAD;
+    p->loader.available = 1;
+}
+
+static void liveconv_join(CSOUND *csound, liveconv_t *p)
+{
+    if (p->worker != NULL) {
+      csound->JoinThread(p->worker);
+      p->worker = NULL;
+    }
+}
+
+static int32_t liveconv_deinit(CSOUND *csound, void *pp)
+{
+    liveconv_t *p = (liveconv_t*) pp;
+    liveconv_join(csound, p);
+    p->hasDeinit = 0;           /* a new note registers again */
+    return OK;
+}
+
 static int32_t liveconv_init(CSOUND *csound, liveconv_t *p)
 {
     FUNC    *ftp;       // function table
@@ -275,6 +377,12 @@ static int32_t liveconv_init(CSOUND *csound, liveconv_t *p)
     ** Function of partition size and number of partitions
     */
 
+    liveconv_join(csound, p);           /* reinit while preparing */
+    if (!p->hasDeinit) {
+      csound->RegisterDeinitCallback(csound, p, liveconv_deinit);
+      p->hasDeinit = 1;
+    }
+
     nBytes = buf_bytes_alloc(p->partSize, p->nPartitions);
     if (nBytes != (int32_t) p->auxData.size)
       csound->AuxAlloc(csound, (int32) nBytes, &(p->auxData));
@@ -306,6 +414,13 @@ static int32_t liveconv_init(CSOUND *csound, liveconv_t *p)
     /* clear output buffers to zero */
     memset(p->outBuf, 0, (p->partSize << 1)*sizeof(MYFLT));
 
+    /* background swaps: staging is allocated on the first */
+    p->IR_Stage = p->IR_Old = p->outOld = NULL;
+    p->stageQueued = 0;
+    p->fadeLen = p->fadePos =
+      (int32_t) (*(p->iFade) * csound->GetSr(csound) + FL(0.5));
+    if (p->fadeLen < 0) p->fadeLen = p->fadePos = 0;
+
     /*
     ** After initialization:
     **    Buffer indexes are zero
@@ -320,7 +435,7 @@ static int32_t liveconv_init(CSOUND *csound, liveconv_t *p)
 
 static int32_t liveconv_perf(CSOUND *csound, liveconv_t *p)
 {
-    MYFLT       *x, *rBuf;
+    MYFLT       *x, *rBuf, g;
     FUNC        *ftp;       // function table
     int32_t         i, k, n, nSamples, rBufPos, updateIR, clearBuf, nPart, cnt;
 
@@ -360,6 +475,8 @@ static int32_t liveconv_perf(CSOUND *csound, liveconv_t *p)
 
       /* clear output buffers to zero */
       memset(p->outBuf, 0, (nSamples << 1)*sizeof(MYFLT));
+      if (p->outOld != NULL)
+        memset(p->outOld, 0, (nSamples << 1)*sizeof(MYFLT));
     }
 
     /*
@@ -367,13 +484,26 @@ static int32_t liveconv_perf(CSOUND *csound, liveconv_t *p)
     ** -1: Gradually clear the IR buffer
     **      0: Do nothing
     **  1: Gradually load the IR buffer
+    **  2: Prepare the whole IR in the background, then swap it in
     */
 
+    updateIR = MYFLT2LRND(*(p->kUpdate));
+    if (p->worker != NULL && ATOMIC_GET(p->stageReady)) {
+      csound->JoinThread(p->worker);
+      p->worker = NULL;
+      liveconv_swap(p);
+    }
+    if (updateIR == 2)
+      p->stageQueued = 1;
+    if (p->stageQueued && p->worker == NULL) {
+      p->stageQueued = 0;
+      liveconv_start_prepare(csound, p);
+    }
+
     if (p->loader.available) {
 
       // The buffer before the head position is the temporary buffer
       load_ptr = previous_load(&p->loader, p->loader.head);
-      updateIR = MYFLT2LRND(*(p->kUpdate));
       if (updateIR == 1) {
         load_ptr->status = LOADING;
         load_ptr->pos = 0;
@@ -400,7 +530,13 @@ static int32_t liveconv_perf(CSOUND *csound, liveconv_t *p)
 
       /* copy output signals from buffer (contains data from previous
          convolution pass) */
-      p->aOut[nn] = p->outBuf[p->cnt];
+      if (p->fadePos < p->fadeLen) {
+        g = (MYFLT) ++p->fadePos / (MYFLT) p->fadeLen;
+        p->aOut[nn] =
+          g * p->outBuf[p->cnt] + (FL(1.0) - g) * p->outOld[p->cnt];
+      }
+      else
+        p->aOut[nn] = p->outBuf[p->cnt];
 
       /* is input buffer full ? */
       if (++p->cnt < nSamples)
@@ -496,6 +632,18 @@ static int32_t liveconv_perf(CSOUND *csound, liveconv_t *p)
         x[i + nSamples] = p->tmpBuf[i + nSamples];
       }
 
+      /* while crossfading, the old IR runs alongside */
+      if (p->fadePos < p->fadeLen) {
+        multiply_fft_buffers(p->tmpBuf, p->ringBuf, p->IR_Old,
+                             nSamples, p->nPartitions, rBufPos);
+        csound->RealFFT2(csound, p->invsetup, p->tmpBuf);
+        x = &(p->outOld[0]);
+        for (i = 0; i < nSamples; i++) {
+          x[i] = p->tmpBuf[i] + x[i + nSamples];
+          x[i + nSamples] = p->tmpBuf[i + nSamples];
+        }
+      }
+
     }
     return OK;
 
@@ -504,6 +652,142 @@ static int32_t liveconv_perf(CSOUND *csound, liveconv_t *p)
                              "%s", Str("liveconv: not initialised"));
 }
 
+/*
+** liveconvnu - liveconv on the non-uniform partitioned convolver
+** (OOps/partconv.c): partitions grow from iPartLen to iMaxPartLen.
+** A load or unload walks the IR at the audio rate, as in liveconv: a
+** partition is (re)loaded once the whole of its segment has been passed.
+*/
+
+#define LIVECONVNU_MAXPART  8192
+
+typedef struct {
+  OPDS    h;
+  MYFLT   *aOut;
+  MYFLT   *aIn;
+  MYFLT   *iFTNum;
+  MYFLT   *iPartLen;
+  MYFLT   *kUpdate;
+  MYFLT   *kClear;
+  MYFLT   *iMaxPartLen;   // largest partition (0: 8192)
+  MYFLT   *iThread;       // compute the tail on a background thread
+
+  void    *conv;          /* csound->PartConvCreate() */
+  int32_t irLen;          /* table length at init */
+  int32_t loadPos;        /* IR samples passed by the current load, or -1 */
+  int32_t unload;         /* the current operation clears the IR */
+} liveconvnu_t;
+
+static int32_t liveconvnu_deinit(CSOUND *csound, void *pp)
+{
+    liveconvnu_t *p = (liveconvnu_t*) pp;
+    if (p->conv != NULL) {
+      csound->PartConvDestroy(csound, p->conv);
+      p->conv = NULL;
+    }
+    return OK;
+}
+
+static int32_t liveconvnu_init(CSOUND *csound, liveconvnu_t *p)
+{
+    FUNC    *ftp;
+    int32_t partSize, maxSize;
+
+    partSize = MYFLT2LRND(*(p->iPartLen));
+    if (UNLIKELY(partSize < 4 || (partSize & (partSize - 1)) != 0)) {
+      return csound->InitError(csound, "%s",
+                               Str("liveconvnu: invalid impulse response "
+                                   "partition length"));
+    }
+    maxSize = MYFLT2LRND(*(p->iMaxPartLen));
+    if (maxSize <= 0)
+      maxSize = LIVECONVNU_MAXPART;
+    if (maxSize < partSize)
+      maxSize = partSize;
+    if (UNLIKELY((maxSize & (maxSize - 1)) != 0)) {
+      return csound->InitError(csound, "%s",
+                               Str("liveconvnu: invalid maximum "
+                                   "partition length"));
+    }
+    ftp = csound->FTnp2Find(csound, p->iFTNum);
+    if (UNLIKELY(ftp == NULL))
+      return NOTOK;
+    p->irLen = (int32_t) ftp->flen;
+    if (UNLIKELY(p->irLen <= 0)) {
+      return csound->InitError(csound, "%s",
+                               Str("liveconvnu: invalid length, or insufficient"
+                                   " IR data for convolution"));
+    }
+    if (p->conv != NULL)                /* reinit */
+      csound->PartConvDestroy(csound, p->conv);
+    else
+      csound->RegisterDeinitCallback(csound, p, liveconvnu_deinit);
+    /* as liveconv, the IR starts empty */
+    p->conv = csound->PartConvCreate(csound, partSize, maxSize, p->irLen, 1,
+                                     *(p->iThread) != FL(0.0));
+    if (UNLIKELY(p->conv == NULL))
+      return csound->InitError(csound, "%s",
+                               Str("liveconvnu: could not create the "
+                                   "convolution"));
+    p->loadPos = -1;
+    p->unload = 0;
+    return OK;
+}
+
+static int32_t liveconvnu_perf(CSOUND *csound, liveconvnu_t *p)
+{
+    FUNC      *ftp;
+    int32_t   update, from;
+    uint32_t  offset = p->h.insdshead->ksmps_offset;
+    uint32_t  early  = p->h.insdshead->ksmps_no_end;
+    uint32_t  nsmps = CS_KSMPS;
+    MYFLT     *out;
+
+    if (UNLIKELY(p->conv == NULL)) goto err1;
+
+    if (UNLIKELY(offset))
+      memset(p->aOut, '\0', offset*sizeof(MYFLT));
+    if (UNLIKELY(early)) {
+      nsmps -= early;
+      memset(&p->aOut[nsmps], '\0', early*sizeof(MYFLT));
+    }
+
+    if (MYFLT2LRND(*(p->kClear)))
+      csound->PartConvClear(csound, p->conv);
+
+    /* +1 starts a load, -1 an unload; either restarts from the IR start */
+    update = MYFLT2LRND(*(p->kUpdate));
+    if (update == 1 || update == -1) {
+      p->loadPos = 0;
+      p->unload = (update == -1);
+    }
+
+    out = p->aOut + offset;
+    csound->PartConvProcess(csound, p->conv, p->aIn + offset, &out,
+                            (int32_t) (nsmps - offset));
+
+    if (p->loadPos >= 0 &&
+        (ftp = csound->FTnp2Find(csound, p->iFTNum)) != NULL) {
+      from = p->loadPos;
+      p->loadPos += (int32_t) (nsmps - offset);
+      if (p->loadPos >= p->irLen) {     /* the rest, then done */
+        csound->PartConvLoad(csound, p->conv, 0,
+                             p->unload ? NULL : ftp->ftable, 1,
+                             (int32_t) ftp->flen, from, INT_MAX);
+        p->loadPos = -1;
+      }
+      else
+        csound->PartConvLoad(csound, p->conv, 0,
+                             p->unload ? NULL : ftp->ftable, 1,
+                             (int32_t) ftp->flen, from, p->loadPos);
+    }
+    return OK;
+
+ err1:
+    return csound->PerfError(csound, &(p->h),
+                             "%s", Str("liveconvnu: not initialised"));
+}
+
 /* module interface functions */
 
 static OENTRY localops[] = {
@@ -512,9 +796,18 @@ static OENTRY localops[] = {
     sizeof(liveconv_t),     // data size of state block
     TR, 3,                  // thread
     "a",                    // output arguments
-    "aiikk",                // input arguments
+    "aiikko",               // input arguments
     (SUBR) liveconv_init,   // init function
     (SUBR) liveconv_perf    // a-rate function
+  },
+  {
+    "liveconvnu",
+    sizeof(liveconvnu_t),
+    TR, 3,
+    "a",
+    "aiikkoo",
+    (SUBR) liveconvnu_init,
+    (SUBR) liveconvnu_perf
   }
 };
 
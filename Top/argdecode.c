@@ -289,6 +289,15 @@ static const char *longUsageList[] = {
   Str_noop("--no-default-paths      turn off relative paths from CSD/ORC/SCO"),
   Str_noop("--sample-accurate       use sample-accurate timing of score events"),
   Str_noop("--realtime              realtime priority mode"),
+  Str_noop("--profile               time each instrument and opcode"),
+  Str_noop("--profile-output=FNAME  write the profile to FNAME at the end "
+                                   "(.json or CSV)"),
+  Str_noop("--orc-cache=DIR         keep compiled orchestras in DIR and "
+                                   "reuse them"),
+  Str_noop("--score-window=BEATS    sort the score in windows of BEATS, for "
+                                   "scores nearly in time order"),
+  Str_noop("--par-scheduler=NAME    task dispatcher for -j N: dag (default) "
+                                   "or steal"),
   Str_noop("--nchnls=N              override number of audio channels"),
   Str_noop("--nchnls_i=N            override number of input audio channels"),
   Str_noop("--0dbfs=N               override 0dbfs (max positive signal amplitude)"),
@@ -962,31 +971,37 @@ static int decode_long(CSOUND *csound, char *s, int argc, char **argv)
     else if (!(strncmp (s, "midi-key=", 9))) {
       s += 9;
       O->midiKey = atoi(s);
+      csound->init_image_version++;
       return 1;
     }
     else if (!(strncmp (s, "midi-key-cps=", 13))) {
       s += 13 ;
       O->midiKeyCps = atoi(s);
+      csound->init_image_version++;
       return 1;
     }
     else if (!(strncmp (s, "midi-key-oct=", 13))) {
       s += 13 ;
       O->midiKeyOct = atoi(s);
+      csound->init_image_version++;
       return 1;
     }
     else if (!(strncmp (s, "midi-key-pch=", 13))) {
       s += 13 ;
       O->midiKeyPch = atoi(s);
+      csound->init_image_version++;
       return 1;
     }
     else if (!(strncmp (s, "midi-velocity=", 14))) {
       s += 14;
       O->midiVelocity = atoi(s);
+      csound->init_image_version++;
       return 1;
     }
     else if (!(strncmp (s, "midi-velocity-amp=", 18))) {
       s += 18;
       O->midiVelocityAmp = atoi(s);
+      csound->init_image_version++;
       return 1;
     }
     else if (!(strncmp (s, "opcode-lib=", 11))) {
@@ -1023,6 +1038,17 @@ static int decode_long(CSOUND *csound, char *s, int argc, char **argv)
       O->numThreads = atoi(s);
       return 1;
     }
+    else if (!(strncmp (s, "par-scheduler=", 14))) {
+      s += 14;
+      if (!strcmp(s, "dag")) O->parScheduler = PAR_SCHED_DAG;
+      else if (!strcmp(s, "steal")) O->parScheduler = PAR_SCHED_STEAL;
+      else {
+        csound->Warning(csound, Str("unknown parallel scheduler %s, using dag"),
+                        s);
+        O->parScheduler = PAR_SCHED_DAG;
+      }
+      return 1;
+    }
     else if (!(strcmp (s, "syntax-check-only"))) {
       O->syntaxCheckOnly = 1;
       return 1;
@@ -1046,6 +1072,32 @@ static int decode_long(CSOUND *csound, char *s, int argc, char **argv)
       O->realtime = 1;
       return 1;
     }
+    else if (!(strcmp(s, "profile"))) {
+      csoundSetProfiling(csound, 1);
+      return 1;
+    }
+    else if (!(strncmp(s, "profile-output=", 15))) {
+      s += 15;
+      if (UNLIKELY(*s == '\0'))
+        dieu(csound, Str("no profile output file name"));
+      csound->profile_file = cs_strdup(csound, s);
+      csoundSetProfiling(csound, 1);
+      return 1;
+    }
+    else if (!(strncmp(s, "orc-cache=", 10))) {
+      s += 10;
+      if (UNLIKELY(*s == '\0'))
+        dieu(csound, Str("no orchestra cache directory"));
+      csound->orc_cache_dir = cs_strdup(csound, s);
+      return 1;
+    }
+    else if (!(strncmp(s, "score-window=", 13))) {
+      s += 13;
+      csound->score_window = (MYFLT) atof(s);
+      if (UNLIKELY(csound->score_window <= FL(0.0)))
+        dieu(csound, Str("score window must be positive"));
+      return 1;
+    }
     else if (!(strncmp(s, "nchnls=", 7))) {
       s += 7;
       O->nchnls_override = atoi(s);
@@ -1586,6 +1638,7 @@ PUBLIC void csoundSetParams(CSOUND *csound, CSOUND_PARAMS *p){
     if (p->midi_velocity > 0) oparms->midiVelocity = p->midi_velocity;
     else if (p->midi_velocity_amp > 0)
       oparms->midiVelocityAmp = p->midi_velocity_amp;
+    csound->init_image_version++;
 
     /* CSD line counts */
     if (p->csd_line_counts > 0) oparms->useCsdLineCounts = p->csd_line_counts;
@@ -85,7 +85,7 @@ PUBLIC void csoundDebuggerClean(CSOUND *csound)
     }
     csound->Free(csound, data);
     csound->csdebug_data = NULL;
-    csound->kperf = kperf_nodebug;
+    csound->kperf = csound->profiling ? kperf_profile : kperf_nodebug;
 }
 
 PUBLIC void csoundDebugStart(CSOUND *csound)
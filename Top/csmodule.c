@@ -75,8 +75,14 @@
 #include <errno.h>
 #include <setjmp.h>
 
+#include <sys/stat.h>
+#if defined(HAVE_UNISTD_H)
+#include <unistd.h>
+#endif
+
 #include "csoundCore.h"
 #include "csmodule.h"
+#include "find_opcode.h"
 
 #if defined(__MACH__)
 #include <TargetConditionals.h>
@@ -179,6 +185,7 @@ typedef struct csoundModule_s {
       pluginLibFunc_t   p;                  /* generic plugin interface      */
       opcodeLibFunc_t   o;                  /* opcode library interface      */
     } fn;
+    struct pluginLib_s *lib;                /* its plugin index entry        */
     char        name[1];                    /* name of the module            */
 } csoundModule_t;
 
@@ -388,6 +395,350 @@ static int csoundCheckOpcodeDeny(CSOUND * csound, const char *fname)
     return 0;
 }
 
+/* ---- plugin index ----
+
+   With CS_PLUGIN_INDEX set to a file name, csoundLoadModules() keeps in
+   that file, for every library in the plugin directories, its size and
+   modification time, whether it must be loaded at startup, and the names
+   of the opcodes it adds.  While the file matches the directories only
+   the libraries marked for startup are opened; the others are loaded by
+   csoundLoadModuleForOpcode() when an orchestra first names one of their
+   opcodes.  A missing or stale index is rebuilt from a full scan, by
+   watching what each library registers as it is created and initialised.
+
+   A library must be loaded at startup if it registers anything other
+   than opcodes (audio or MIDI modules, utilities, configuration
+   variables, named GENs), if it fails to load, or if it adds to an opcode
+   name that core Csound or another library also defines, since the
+   parser would then never ask for it. */
+
+typedef struct pluginLib_s {
+    struct pluginLib_s *nxt;
+    int64_t     size, mtime;
+    int         eager;          /* loaded by csoundLoadModules() */
+    int         loaded;
+    CONS_CELL   *opnames;       /* short names of the opcodes it adds */
+    char        path[1];
+} pluginLib_t;
+
+typedef struct pluginIndex_s {
+    char        *file;
+    pluginLib_t *libs, **tail;  /* the plugin directories, in scan order */
+    CS_HASH_TABLE *ops;         /* opcode name -> pluginLib_t */
+    int         rebuild;        /* write the index after initialisation */
+    pluginLib_t *rec;           /* library whose opcodes are being noted */
+    int (*AppendOpcode)(CSOUND *, const char *, int, int, int,
+                        const char *, const char *,
+                        int (*)(CSOUND *, void *), int (*)(CSOUND *, void *),
+                        int (*)(CSOUND *, void *));
+    int (*AppendOpcodes)(CSOUND *, const OENTRY *, int);
+} pluginIndex_t;
+
+/* what a library may register besides opcodes */
+typedef struct {
+    int     modules, utilities, cfgvars;
+    void    *namedgen;
+} pluginTrace_t;
+
+static  const   char    *plugin_index_envvar = "CS_PLUGIN_INDEX";
+static  const   char    *plugin_index_magic = "csound-plugin-index 1";
+
+static void plugin_trace(CSOUND *csound, pluginTrace_t *t)
+{
+    MODULE_INFO **modules =
+      (MODULE_INFO **) csoundQueryGlobalVariable(csound, "_MODULES");
+    char    **utils = csoundListUtilities(csound);
+
+    memset(t, 0, sizeof(pluginTrace_t));
+    if (modules != NULL)
+      while (t->modules < 64 && modules[t->modules] != NULL) /* MAX_MODULES */
+        t->modules++;
+    if (utils != NULL) {
+      while (utils[t->utilities] != NULL) t->utilities++;
+      csoundDeleteUtilityList(csound, utils);
+    }
+    if (csound->cfgVariableDB != NULL)
+      t->cfgvars = (int) csound->cfgVariableDB->count;
+    t->namedgen = csound->namedgen;
+}
+
+static int plugin_trace_differs(CSOUND *csound, const pluginTrace_t *t)
+{
+    pluginTrace_t now;
+    plugin_trace(csound, &now);
+    return memcmp(t, &now, sizeof(pluginTrace_t)) != 0;
+}
+
+static void plugin_note_opcode(CSOUND *csound, const char *opname)
+{
+    pluginIndex_t *idx = (pluginIndex_t*) csound->csmodule_index;
+    pluginLib_t   *owner;
+    char          *s = get_opcode_short_name(csound, (char*) opname);
+
+    owner = (pluginLib_t*) cs_hash_table_get(csound, idx->ops, s);
+    if (owner == NULL) {
+      /* a name core Csound already defines */
+      if (cs_hash_table_get(csound, csound->opcodes, s) != NULL)
+        idx->rec->eager = 1;
+      else
+        cs_hash_table_put(csound, idx->ops, s, idx->rec);
+      idx->rec->opnames = cs_cons(csound, cs_strdup(csound, s),
+                                  idx->rec->opnames);
+    }
+    else if (owner != idx->rec)         /* shared with another library */
+      owner->eager = idx->rec->eager = 1;
+    if (s != opname) csound->Free(csound, s);
+}
+
+static int plugin_append_opcode(CSOUND *csound, const char *opname,
+                                int dsblksiz, int flags, int thread,
+                                const char *outypes, const char *intypes,
+                                int (*iopadr)(CSOUND *, void *),
+                                int (*kopadr)(CSOUND *, void *),
+                                int (*aopadr)(CSOUND *, void *))
+{
+    pluginIndex_t *idx = (pluginIndex_t*) csound->csmodule_index;
+    if (opname != NULL)
+      plugin_note_opcode(csound, opname);
+    return idx->AppendOpcode(csound, opname, dsblksiz, flags, thread,
+                             outypes, intypes, iopadr, kopadr, aopadr);
+}
+
+static int plugin_append_opcodes(CSOUND *csound, const OENTRY *opcodeList,
+                                 int n)
+{
+    pluginIndex_t *idx = (pluginIndex_t*) csound->csmodule_index;
+    const OENTRY  *ep = opcodeList;
+    int           i = (n <= 0 ? 0x7FFFFFFF : n);
+
+    for ( ; ep != NULL && i && ep->opname != NULL; i--, ep++)
+      plugin_note_opcode(csound, ep->opname);
+    return idx->AppendOpcodes(csound, opcodeList, n);
+}
+
+/* run f (load or initialise a library) noting what it registers */
+static void plugin_watch(CSOUND *csound, pluginLib_t *lib, int on)
+{
+    pluginIndex_t *idx = (pluginIndex_t*) csound->csmodule_index;
+    if (on) {
+      idx->rec = lib;
+      idx->AppendOpcode = csound->AppendOpcode;
+      idx->AppendOpcodes = csound->AppendOpcodes;
+      csound->AppendOpcode = plugin_append_opcode;
+      csound->AppendOpcodes = plugin_append_opcodes;
+    }
+    else {
+      csound->AppendOpcode = idx->AppendOpcode;
+      csound->AppendOpcodes = idx->AppendOpcodes;
+      idx->rec = NULL;
+    }
+}
+
+static pluginLib_t *plugin_lib_new(CSOUND *csound, const char *path)
+{
+    pluginLib_t *lib = (pluginLib_t*)
+      csound->Calloc(csound, sizeof(pluginLib_t) + strlen(path));
+    strcpy(&(lib->path[0]), path);
+    return lib;
+}
+
+/* note a library found by the directory scan */
+static void plugin_index_add(CSOUND *csound, pluginIndex_t *idx,
+                             const char *path)
+{
+    pluginLib_t *lib = plugin_lib_new(csound, path);
+    struct stat st;
+
+    if (stat(path, &st) == 0) {
+      lib->size = (int64_t) st.st_size;
+      lib->mtime = (int64_t) st.st_mtime;
+    }
+    *(idx->tail) = lib;
+    idx->tail = &(lib->nxt);
+}
+
+/* the libraries listed in the index file, or NULL; a file that does not
+   end with the "end" line written last was cut short, and is stale */
+static pluginLib_t *plugin_index_read(CSOUND *csound, const char *file)
+{
+    FILE        *f = fopen(file, "r");
+    pluginLib_t *libs = NULL, **tail = &libs, *lib = NULL;
+    char        line[1024];
+    int         ok, complete = 0;
+
+    if (f == NULL)
+      return NULL;
+    ok = (fgets(line, sizeof(line), f) != NULL &&
+          strncmp(line, plugin_index_magic, strlen(plugin_index_magic)) == 0 &&
+          atoi(line + strlen(plugin_index_magic)) == (int) sizeof(MYFLT));
+    while (ok && !complete && fgets(line, sizeof(line), f) != NULL) {
+      size_t      len = strlen(line);
+      long long   size, mtime;
+      int         eager, pos;
+
+      if (len > 0 && line[len - 1] == '\n')
+        line[--len] = '\0';
+      if (strncmp(line, "lib ", 4) == 0 &&
+          sscanf(line + 4, "%d %lld %lld %n", &eager, &size, &mtime, &pos) == 3) {
+        lib = plugin_lib_new(csound, line + 4 + pos);
+        lib->eager = eager;
+        lib->size = (int64_t) size;
+        lib->mtime = (int64_t) mtime;
+        *tail = lib;
+        tail = &(lib->nxt);
+      }
+      else if (strncmp(line, "op ", 3) == 0 && lib != NULL)
+        lib->opnames = cs_cons(csound, cs_strdup(csound, line + 3),
+                               lib->opnames);
+      else if (strcmp(line, "end") == 0)
+        complete = 1;
+      else
+        ok = 0;
+    }
+    fclose(f);
+    if (!ok || !complete)
+      libs = plugin_lib_new(csound, "");   /* damaged: compares as stale */
+    return libs;
+}
+
+static void plugin_index_write(CSOUND *csound, pluginIndex_t *idx)
+{
+    FILE        *f;
+    pluginLib_t *lib;
+    CONS_CELL   *c;
+    char        *tmp;
+    int         ok;
+
+    tmp = (char*) csound->Malloc(csound, strlen(idx->file) + 24);
+#if defined(HAVE_UNISTD_H)
+    sprintf(tmp, "%s.%d", idx->file, (int) getpid());
+#else
+    sprintf(tmp, "%s.%p", idx->file, (void*) csound);
+#endif
+    if ((f = fopen(tmp, "w")) != NULL) {
+      fprintf(f, "%s %d\n", plugin_index_magic, (int) sizeof(MYFLT));
+      for (lib = idx->libs; lib != NULL; lib = lib->nxt) {
+        fprintf(f, "lib %d %lld %lld %s\n", lib->eager,
+                (long long) lib->size, (long long) lib->mtime, lib->path);
+        for (c = lib->opnames; c != NULL; c = c->next)
+          fprintf(f, "op %s\n", (char*) c->value);
+      }
+      fprintf(f, "end\n");
+      ok = !ferror(f);
+      ok = (fclose(f) == 0) && ok;
+      /* readers, also in other processes, see the old index or the new */
+#if defined(WIN32)
+      if (ok)
+        remove(idx->file);              /* rename() does not replace */
+#endif
+      if (!ok || rename(tmp, idx->file) != 0) {
+        remove(tmp);
+        ok = 0;
+      }
+    }
+    else ok = 0;
+    if (UNLIKELY(!ok))
+      csound->Warning(csound, Str("cannot write plugin index %s"), idx->file);
+    else if (UNLIKELY(csound->oparms->odebug))
+      csound->Message(csound, Str("plugin index written to %s\n"), idx->file);
+    csound->Free(csound, tmp);
+}
+
+int csoundLoadAndInitModule(CSOUND *csound, const char *fname);
+
+/* load the scanned libraries, or only those the index says must be */
+static int plugin_index_load(CSOUND *csound, pluginIndex_t *idx)
+{
+    pluginLib_t *lib, *p, *old = plugin_index_read(csound, idx->file);
+    int         n, err = CSOUND_SUCCESS, deferred = 0;
+
+    idx->rebuild = (old == NULL);
+    for (lib = idx->libs, p = old; lib != NULL && !idx->rebuild;
+         lib = lib->nxt, p = p->nxt) {
+      /* same libraries, in the same order, unchanged */
+      if (p == NULL || strcmp(p->path, lib->path) != 0 ||
+          p->size != lib->size || p->mtime != lib->mtime)
+        idx->rebuild = 1;
+      else {
+        lib->eager = p->eager;
+        lib->opnames = p->opnames;
+      }
+    }
+    if (p != NULL)
+      idx->rebuild = 1;
+    for (lib = idx->libs; lib != NULL; lib = lib->nxt) {
+      CONS_CELL   *c;
+      void        *prev = csound->csmodule_db;
+      pluginTrace_t t;
+
+      if (!idx->rebuild && !lib->eager) {
+        for (c = lib->opnames; c != NULL; c = c->next)
+          cs_hash_table_put(csound, idx->ops, (char*) c->value, lib);
+        deferred++;
+        continue;
+      }
+      if (idx->rebuild) {
+        lib->eager = 0;
+        lib->opnames = NULL;
+        plugin_trace(csound, &t);
+        plugin_watch(csound, lib, 1);
+      }
+      if (UNLIKELY(csound->oparms->odebug))
+        csoundMessage(csound, Str("Loading '%s'\n"), lib->path);
+      n = csoundLoadExternal(csound, lib->path);
+      if (idx->rebuild) {
+        plugin_watch(csound, lib, 0);
+        if (n != CSOUND_SUCCESS || plugin_trace_differs(csound, &t))
+          lib->eager = 1;
+      }
+      lib->loaded = 1;
+      if (csound->csmodule_db != prev)
+        ((csoundModule_t*) csound->csmodule_db)->lib = lib;
+      if (UNLIKELY(n == CSOUND_ERROR))
+        continue;               /* ignore non-plugin files */
+      if (UNLIKELY(n < err))
+        err = n;                /* record serious errors */
+    }
+    if (UNLIKELY(csound->oparms->odebug) && deferred)
+      csound->Message(csound, Str("%d plugin libraries deferred (%s)\n"),
+                      deferred, idx->file);
+    return err;
+}
+
+int csoundLoadModuleForOpcode(CSOUND *csound, const char *opname)
+{
+    pluginIndex_t *idx = (pluginIndex_t*) csound->csmodule_index;
+    pluginLib_t   *lib;
+    char          *s;
+    int           err;
+
+    if (LIKELY(idx == NULL || idx->rebuild))
+      return 0;
+    if (opname == NULL) {               /* everything */
+      for (lib = idx->libs; lib != NULL; lib = lib->nxt)
+        if (!lib->loaded && lib->opnames != NULL)
+          csoundLoadModuleForOpcode(csound, (char*) lib->opnames->value);
+      return 1;
+    }
+    s = get_opcode_short_name(csound, (char*) opname);
+    lib = (pluginLib_t*) cs_hash_table_get(csound, idx->ops, s);
+    if (s != opname) csound->Free(csound, s);
+    if (lib == NULL)
+      return 0;
+    if (!lib->loaded) {
+      lib->loaded = 1;
+      if (UNLIKELY(csound->oparms->odebug))
+        csoundMessage(csound, Str("Loading '%s' for %s\n"), lib->path, opname);
+      err = csoundLoadAndInitModule(csound, lib->path);
+      if (UNLIKELY(err != CSOUND_SUCCESS)) {
+        csound->Warning(csound, Str("could not load plugin '%s' for %s"),
+                        lib->path, opname);
+        return 0;
+      }
+    }
+    return 1;
+}
+
 /**
  * Load plugin libraries for Csound instance 'csound', and call
  * pre-initialisation functions.
@@ -405,6 +756,7 @@ int csoundLoadModules(CSOUND *csound)
     int             i, n, len, err = CSOUND_SUCCESS;
     char   *dname1, *end;
     int     read_directory = 1;
+    pluginIndex_t *idx = NULL;
     char sep =
 #ifdef WIN32
     ';';
@@ -415,6 +767,15 @@ int csoundLoadModules(CSOUND *csound)
     if (UNLIKELY(csound->csmodule_db != NULL))
       return CSOUND_ERROR;
 
+    dname = csoundGetEnv(csound, plugin_index_envvar);
+    if (dname != NULL && dname[0] != '\0') {
+      idx = (pluginIndex_t*) csound->Calloc(csound, sizeof(pluginIndex_t));
+      idx->file = cs_strdup(csound, (char*) dname);
+      idx->tail = &(idx->libs);
+      idx->ops = cs_hash_table_create(csound);
+      csound->csmodule_index = (void*) idx;
+    }
+
     /* open plugin directory */
     dname = csoundGetEnv(csound, (sizeof(MYFLT) == sizeof(float) ?
                                   plugindir_envvar : plugindir64_envvar));
@@ -506,6 +867,10 @@ int csoundLoadModules(CSOUND *csound)
         continue;
       }
       snprintf(buf, 1024, "%s%c%s", dname1, DIRSEP, fname);
+      if (idx != NULL) {        /* loaded, or deferred, below */
+        plugin_index_add(csound, idx, buf);
+        continue;
+      }
       if (UNLIKELY(csound->oparms->odebug)) {
         csoundMessage(csound, Str("Loading '%s'\n"), buf);
        }
@@ -518,6 +883,8 @@ int csoundLoadModules(CSOUND *csound)
     closedir(dir);
     csound->Free(csound, dname1);
     }
+    if (idx != NULL && (n = plugin_index_load(csound, idx)) < err)
+      err = n;
     return (err == CSOUND_INITIALIZATION ? CSOUND_ERROR : err);
 #else
     return CSOUND_SUCCESS;
@@ -607,8 +974,8 @@ static CS_NOINLINE int csoundInitModule(CSOUND *csound, csoundModule_t *m)
         else {
           length /= (long) sizeof(OENTRY);
           if (length) {
-            if (UNLIKELY(csoundAppendOpcodes(csound, opcodlst_n,
-                                               (int) length) != 0))
+            if (UNLIKELY(csound->AppendOpcodes(csound, opcodlst_n,
+                                                 (int) length) != 0))
               return CSOUND_ERROR;
           }
         }
@@ -627,6 +994,7 @@ static CS_NOINLINE int csoundInitModule(CSOUND *csound, csoundModule_t *m)
 int csoundInitModules(CSOUND *csound)
 {
     csoundModule_t  *m;
+    pluginIndex_t   *idx = (pluginIndex_t*) csound->csmodule_index;
     int             i, retval = CSOUND_SUCCESS;
     /* For regular Csound, init_static_modules is not compiled or called.
      * For some builds of Csound, e.g. for PNaCl, init_static_modules is
@@ -638,10 +1006,26 @@ int csoundInitModules(CSOUND *csound)
 #endif
     /* call init functions */
     for (m = (csoundModule_t*) csound->csmodule_db; m != NULL; m = m->nxt) {
+      pluginTrace_t t;
+      int watch = (idx != NULL && idx->rebuild && m->lib != NULL);
+      if (watch) {
+        plugin_trace(csound, &t);
+        plugin_watch(csound, m->lib, 1);
+      }
       i = csoundInitModule(csound, m);
+      if (watch) {
+        plugin_watch(csound, m->lib, 0);
+        if (i != CSOUND_SUCCESS || plugin_trace_differs(csound, &t) ||
+            (m->PreInitFunc == NULL && m->fn.o.fgen_init != NULL))
+          m->lib->eager = 1;
+      }
       if (UNLIKELY(i != CSOUND_SUCCESS && i < retval))
         retval = i;
     }
+    if (idx != NULL && idx->rebuild) {
+      plugin_index_write(csound, idx);
+      idx->rebuild = 0;
+    }
     /* return with error code */
     return retval;
 }
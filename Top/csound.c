@@ -55,6 +55,7 @@
 #include "namedins.h"
 #include "pvfileio.h"
 #include "fftlib.h"
+#include "partconv.h"
 #include "cs_par_base.h"
 #include "cs_par_orc_semantics.h"
 //#include "cs_par_dispatch.h"
@@ -67,6 +68,7 @@
 #include "csound_standard_types.h"
 
 #include "csdebug.h"
+#include "cs_profile.h"
 #include <time.h>
 
 extern void allocate_message_queue(CSOUND *csound);
@@ -140,11 +142,11 @@ void print_csound_version(CSOUND* csound)
 }
 
 static void free_opcode_table(CSOUND* csound) {
-    int i;
+    uint32_t i;
     CS_HASH_TABLE_ITEM* bucket;
     CONS_CELL* head;
 
-    for (i = 0; i < HASH_SIZE; i++) {
+    for (i = 0; i < csound->opcodes->table_size; i++) {
       bucket = csound->opcodes->buckets[i];
 
       while (bucket != NULL) {
@@ -155,6 +157,7 @@ static void free_opcode_table(CSOUND* csound) {
     }
 
     cs_hash_table_free(csound, csound->opcodes);
+    csoundClearOpcodeResolution(csound);
 }
 static void create_opcode_table(CSOUND *csound)
 {
@@ -500,11 +503,17 @@ static const CSOUND cenviron_ = {
     csoundGetHostData,
     strNcpy,
     csoundGetZaBounds,
+    csoundPartConvCreate,
+    csoundPartConvLoad,
+    csoundPartConvProcess,
+    csoundPartConvClear,
+    csoundPartConvDestroy,
+    csoundFTGenAsync,
+    csoundFTReady,
     {
       NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL,
       NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL,
-      NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL,
-      NULL, NULL, NULL, NULL
+      NULL, NULL, NULL, NULL, NULL, NULL, NULL
     },
     /* ------- private data (not to be used by hosts or externals) ------- */
     /* callback function pointers */
@@ -712,6 +721,9 @@ static const CSOUND cenviron_ = {
     NULL,           /*  evtFuncChain        */
     NULL,           /*  OrcTrigEvts         */
     NULL,           /*  freeEvtNodes        */
+    NULL,           /*  OrcTrigHeap         */
+    0, 0,           /*  OrcTrigCnt, OrcTrigSize */
+    0,              /*  OrcTrigSeqno        */
     1,              /*  csoundIsScorePending_ */
     0,              /*  advanceCnt          */
     0,              /*  initonly            */
@@ -907,7 +919,8 @@ static const CSOUND cenviron_ = {
       0.4,          /*    vbr quality  */
       0,            /*    ksmps_override */
       0,             /*    fft_lib */
-      0
+      0,             /*    echo */
+      PAR_SCHED_DAG  /*    parScheduler */
     },
 
     {0, 0, {0}}, /* REMOT_BUF */
@@ -963,10 +976,10 @@ static const CSOUND cenviron_ = {
     0,              /* unusedint */
     1,              /* inZero */
     NULL,           /* msg_queue */
-    0,              /* msg_queue_wget */
     0,              /* msg_queue_wput */
     0,              /* msg_queue_rstart */
-    0,              /* msg_queue_items */
+    0,              /* msg_queue_size */
+    0,              /* msg_queue_argsiz */
     127,            /* aftouch */
     NULL,           /* directory for corfiles */
     NULL,           /* alloc_queue */
@@ -978,7 +991,26 @@ static const CSOUND cenviron_ = {
     NULL,           /* message_string */
     0,              /* message_string_queue_items */
     0,              /* message_string_queue_wp */
-    NULL            /* message_string_queue */
+    NULL,           /* message_string_queue */
+    NULL,           /* dag_ws */
+    NULL,           /* dag_topo */
+    0,              /* dag_orc_version */
+    0,              /* spout_dirty */
+    NULL,           /* planar_out */
+    0,              /* planar_in */
+    0,              /* profiling */
+    NULL,           /* profile_file */
+    0,              /* prof_tick0 */
+    {0, 0},         /* prof_clock0 */
+    NULL,           /* orc_cache_dir */
+    NULL,           /* csmodule_index */
+    NULL,           /* opcode_resolved */
+    NULL,           /* ftgen_async */
+    FL(0.0),        /* score_window */
+    NULL,           /* score_stream */
+    NULL,           /* score_binary */
+    0,              /* init_image_version */
+    SPINLOCK_INIT   /* chn_db_lock */
     /*, NULL */           /* self-reference */
 };
 
@@ -1482,11 +1514,42 @@ inline void advanceINSDSPointer(INSDS ***start, int num)
 }
 
 int dag_get_task(CSOUND *csound, int index, int numThreads, int next_task);
-int dag_end_task(CSOUND *csound, int task);
+int dag_end_task(CSOUND *csound, int index, int task);
 void dag_build(CSOUND *csound, INSDS *chain);
 void dag_reinit(CSOUND *csound);
 
-inline static int nodePerf(CSOUND *csound, int index, int numThreads)
+/* kperf and nodePerf are expanded separately with profile = 0 and 1, so
+   the normal perf loop carries no trace of the profiling one */
+#if defined(__GNUC__)
+#define PERF_INLINE inline static __attribute__((always_inline))
+#elif defined(_MSC_VER)
+#define PERF_INLINE static __forceinline
+#else
+#define PERF_INLINE inline static
+#endif
+
+/* Run one opcode, charging its time to the OPTXT it was built from */
+inline static int run_op_profiled(CSOUND *csound, OPDS *op)
+{
+    TEXT    *t = &op->optext->t;
+    int64_t t0 = cs_prof_clock();
+    int     error = (*op->opadr)(csound, op);
+    cs_prof_add(&t->prof_ticks, cs_prof_clock() - t0);
+    cs_prof_add(&t->prof_calls, 1);
+    return error;
+}
+
+#define RUN_OP(profile, op)                                     \
+    ((profile) ? run_op_profiled(csound, op) : (*(op)->opadr)(csound, op))
+
+inline static void instr_profiled(INSDS *ip, int64_t t0)
+{
+    cs_prof_add(&ip->instr->t.prof_ticks, cs_prof_clock() - t0);
+    cs_prof_add(&ip->instr->t.prof_calls, 1);
+}
+
+PERF_INLINE int nodePerf(CSOUND *csound, int index, int numThreads,
+                         const int profile)
 {
     INSDS *insds = NULL;
     OPDS  *opstart = NULL;
@@ -1520,6 +1583,7 @@ inline static int nodePerf(CSOUND *csound, int index, int numThreads)
         done = insds->init_done;
 #endif
         if (done) {
+          int64_t t0 = profile ? cs_prof_clock() : 0;
           opstart = (OPDS*)task_map[which_task];
           if (insds->ksmps == csound->ksmps) {
             insds->spin = csound->spin;
@@ -1528,7 +1592,7 @@ inline static int nodePerf(CSOUND *csound, int index, int numThreads)
             while ((opstart = opstart->nxtp) != NULL) {
               /* In case of jumping need this repeat of opstart */
               opstart->insdshead->pds = opstart;
-              (*opstart->opadr)(csound, opstart); /* run each opcode */
+              RUN_OP(profile, opstart); /* run each opcode */
               opstart = opstart->insdshead->pds;
             }
           } else {
@@ -1560,7 +1624,7 @@ inline static int nodePerf(CSOUND *csound, int index, int numThreads)
               opstart = (OPDS*) insds;
               while ((opstart = opstart->nxtp) != NULL) {
                 opstart->insdshead->pds = opstart;
-                (*opstart->opadr)(csound, opstart); /* run each opcode */
+                RUN_OP(profile, opstart); /* run each opcode */
                 opstart = opstart->insdshead->pds;
               }
               insds->kcounter++;
@@ -1568,33 +1632,71 @@ inline static int nodePerf(CSOUND *csound, int index, int numThreads)
           }
           insds->ksmps_offset = 0; /* reset sample-accuracy offset */
           insds->ksmps_no_end = 0;  /* reset end of loop samples */
+          if (profile) instr_profiled(insds, t0);
           played_count++;
         }
         //printf("******** finished task %d\n", which_task);
-        next_task = dag_end_task(csound, which_task);
+        next_task = dag_end_task(csound, index, which_task);
     }
     return played_count;
 }
 
+/* Send the planar spraw out as interleaved spout.  When no output opcode
+   ran this cycle both buffers only need clearing if the previous cycle
+   left something in them. */
 inline static void make_interleave(CSOUND *csound)
 {
-    uint32_t nsmps = csound->ksmps, i, j, k=0;
-    MYFLT *spout = csound->spout;
-
     if (!csound->spoutactive) {
-      memset(spout, '\0', csound->nspout*sizeof(MYFLT));
+      if (csound->spout_dirty) {
+        memset(csound->spout, '\0', csound->nspout*sizeof(MYFLT));
+        csound->spout_dirty = 0;
+      }
     }
     else {
-      for (j=0; j<nsmps; j++) {
-        for (i=0; i<csound->nchnls; i++) {
-          // Will be copy t ad when complette
-          spout[k + i] = csound->spraw[i*nsmps+j];
-        }
-        k += csound->nchnls;
+      cs_interleave_planar(csound->spout, csound->spraw,
+                           csound->nchnls, csound->ksmps);
+      csound->spout_dirty = 1;
+    }
+}
+
+/* Hand the cycle's output on: interleaved to spoutran, and planar to the
+   host buffers of csoundPerformKsmpsPlanar().  If the host takes planar
+   output and there is no file or device to write, spout is left alone. */
+static void send_output(CSOUND *csound)
+{
+    MYFLT *const *out = csound->planar_out;
+    uint32_t c, nsmps = csound->ksmps;
+
+    if (out == NULL || csound->libsndStatics.osfopen) {
+      make_interleave(csound);
+      csound->spoutran(csound);         /*      send to audio_out  */
+    }
+    else {
+      spoutsf_planar(csound);
+      if (csound->spoutactive)          /* spout is now out of date */
+        csound->spout_dirty = 1;
+    }
+    if (out != NULL) {
+      for (c = 0; c < (uint32_t) csound->nchnls; c++) {
+        if (out[c] == NULL) continue;
+        if (csound->spoutactive)
+          memcpy(out[c], csound->spraw + c*nsmps, nsmps*sizeof(MYFLT));
+        else
+          memset(out[c], 0, nsmps*sizeof(MYFLT));
       }
     }
 }
 
+/* Output opcodes only accumulate into spraw once spoutactive is set,
+   so it has to start the cycle zeroed; it already is unless the last
+   cycle wrote to it.  spout is rewritten in full by make_interleave(). */
+inline static void clear_spraw(CSOUND *csound)
+{
+    csound->spoutactive = 0;
+    if (csound->spout_dirty)
+      memset(csound->spraw, 0, csound->nspout*sizeof(MYFLT));
+}
+
 
 unsigned long kperfThread(void * cs)
 {
@@ -1638,13 +1740,14 @@ unsigned long kperfThread(void * cs)
       }
       /*csound_global_mutex_unlock();*/
 
-      nodePerf(csound, index, numThreads);
+      if (csound->profiling) nodePerf(csound, index, numThreads, 1);
+      else nodePerf(csound, index, numThreads, 0);
 
       csound->WaitBarrier(csound->barrier2);
     }
 }
 
-int kperf_nodebug(CSOUND *csound)
+PERF_INLINE int kperf_perform(CSOUND *csound, const int profile)
 {
     INSDS *ip;
     /* update orchestra time */
@@ -1654,6 +1757,9 @@ int kperf_nodebug(CSOUND *csound)
 
    /* call message_dequeue to run API calls */
     message_dequeue(csound);
+    /* install the tables finished by asynchronous ftgen */
+    if (UNLIKELY(csound->ftgen_async != NULL))
+      csoundFTAsyncPublish(csound);
 
 
     /* if skipping time on request by 'a' score statement: */
@@ -1672,12 +1778,10 @@ int kperf_nodebug(CSOUND *csound)
     }
 
     /* for one kcnt: */
-    if (csound->oparms_.sfread)         /*   if audio_infile open  */
+    if (csound->oparms_.sfread &&       /*   if audio_infile open  */
+        !csound->planar_in)             /*   and no host input     */
       csound->spinrecv(csound);         /*      fill the spin buf  */
-    csound->spoutactive = 0;            /*   make spout inactive   */
-    /* clear spout */
-    memset(csound->spout, 0, csound->nspout*sizeof(MYFLT));
-    memset(csound->spraw, 0, csound->nspout*sizeof(MYFLT));
+    clear_spraw(csound);                /*   make spout inactive   */
     ip = csound->actanchor.nxtact;
 
     if (ip != NULL) {
@@ -1690,7 +1794,7 @@ int kperf_nodebug(CSOUND *csound)
         /* process this partition */
         csound->WaitBarrier(csound->barrier1);
 
-        (void) nodePerf(csound, 0, 1);
+        (void) nodePerf(csound, 0, 1, profile);
 
         /* wait until partition is complete */
         csound->WaitBarrier(csound->barrier2);
@@ -1714,6 +1818,7 @@ int kperf_nodebug(CSOUND *csound)
           done = ATOMIC_GET(ip->init_done);
           if (done == 1) {/* if init-pass has been done */
             int error = 0;
+            int64_t t0 = profile ? cs_prof_clock() : 0;
             OPDS  *opstart = (OPDS*) ip;
             ip->spin = csound->spin;
             ip->spout = csound->spraw;
@@ -1723,7 +1828,7 @@ int kperf_nodebug(CSOUND *csound)
                      (opstart = opstart->nxtp) != NULL &&
                      ip->actflg) {
                 opstart->insdshead->pds = opstart;
-                error = (*opstart->opadr)(csound, opstart); /* run each opcode */
+                error = RUN_OP(profile, opstart); /* run each opcode */
                 opstart = opstart->insdshead->pds;
               }
             } else {
@@ -1757,12 +1862,13 @@ int kperf_nodebug(CSOUND *csound)
                   while (error ==  0 && (opstart = opstart->nxtp) != NULL
                          && ip->actflg) {
                     opstart->insdshead->pds = opstart;
-                    error = (*opstart->opadr)(csound, opstart); /* run each opcode */
+                    error = RUN_OP(profile, opstart); /* run each opcode */
                     opstart = opstart->insdshead->pds;
                   }
                   ip->kcounter++;
                 }
             }
+            if (profile) instr_profiled(ip, t0);
           }
           /*else csound->Message(csound, "time %f\n",
                                  csound->kcounter/csound->ekr);*/
@@ -1773,12 +1879,7 @@ int kperf_nodebug(CSOUND *csound)
       }
     }
 
-    if (!csound->spoutactive) { /* results now in spout? */
-      memset(csound->spout, 0, csound->nspout * sizeof(MYFLT));
-      memset(csound->spraw, 0, csound->nspout * sizeof(MYFLT));
-    }
-    make_interleave(csound);
-    csound->spoutran(csound); /* send to audio_out */
+    send_output(csound);                /* results now in spout */
     //#ifdef ANDROID
     //struct timespec ts;
     //clock_gettime(CLOCK_MONOTONIC, &ts);
@@ -1788,6 +1889,17 @@ int kperf_nodebug(CSOUND *csound)
     return 0;
 }
 
+int kperf_nodebug(CSOUND *csound)
+{
+    return kperf_perform(csound, 0);
+}
+
+/* kperf with per-opcode and per-instrument timing, see csoundSetProfiling */
+int kperf_profile(CSOUND *csound)
+{
+    return kperf_perform(csound, 1);
+}
+
 static inline void opcode_perf_debug(CSOUND *csound,
                                      csdebug_data_t *data, INSDS *ip)
 {
@@ -1873,6 +1985,8 @@ int kperf_debug(CSOUND *csound)
 
     /* call message_dequeue to run API calls */
     message_dequeue(csound);
+    if (UNLIKELY(csound->ftgen_async != NULL))
+      csoundFTAsyncPublish(csound);
 
     if (!data || data->status != CSDEBUG_STATUS_STOPPED) {
       /* update orchestra time */
@@ -1903,12 +2017,10 @@ int kperf_debug(CSOUND *csound)
     if (!data || data->status == CSDEBUG_STATUS_RUNNING)
     {
       /* for one kcnt: */
-      if (csound->oparms_.sfread)         /*   if audio_infile open  */
+      if (csound->oparms_.sfread &&       /*   if audio_infile open  */
+          !csound->planar_in)             /*   and no host input     */
         csound->spinrecv(csound);         /*      fill the spin buf  */
-      csound->spoutactive = 0;            /*   make spout inactive   */
-      /* clear spout */
-      memset(csound->spout, 0, csound->nspout*sizeof(MYFLT));
-      memset(csound->spraw, 0, csound->nspout*sizeof(MYFLT));
+      clear_spraw(csound);                /*   make spout inactive   */
     }
 
     ip = csound->actanchor.nxtact;
@@ -1945,7 +2057,7 @@ int kperf_debug(CSOUND *csound)
         /* process this partition */
         csound->WaitBarrier(csound->barrier1);
 
-        (void) nodePerf(csound, 0, 1);
+        (void) nodePerf(csound, 0, 1, 0);
 
         /* wait until partition is complete */
         csound->WaitBarrier(csound->barrier2);
@@ -2055,13 +2167,7 @@ int kperf_debug(CSOUND *csound)
 
     if (!data || data->status != CSDEBUG_STATUS_STOPPED)
     {
-    if (!csound->spoutactive) {             /*   results now in spout? */
-      memset(csound->spout, 0, csound->nspout * sizeof(MYFLT));
-      memset(csound->spraw, 0, csound->nspout * sizeof(MYFLT));
-    }
-    else
-      make_interleave(csound);
-    csound->spoutran(csound);               /*      send to audio_out  */
+    send_output(csound);                    /*   results now in spout  */
     }
     return 0;
 }
@@ -2136,6 +2242,22 @@ PUBLIC int csoundPerformKsmps(CSOUND *csound)
     return 0;
 }
 
+PUBLIC int csoundPerformKsmpsPlanar(CSOUND *csound, MYFLT *const *out,
+                                    const MYFLT *const *in)
+{
+    int retval;
+    if (in != NULL && csound->spin != NULL) {
+      cs_interleave(csound->spin, csound->inchnls, in,
+                    csound->inchnls, csound->ksmps);
+      csound->planar_in = 1;            /* not overwritten from -i */
+    }
+    csound->planar_out = out;
+    retval = csoundPerformKsmps(csound);
+    csound->planar_out = NULL;
+    csound->planar_in = 0;
+    return retval;
+}
+
 static int csoundPerformKsmpsInternal(CSOUND *csound)
 {
     int done;
@@ -2342,6 +2464,14 @@ PUBLIC MYFLT *csoundGetSpout(CSOUND *csound)
     return csound->spout;
 }
 
+PUBLIC MYFLT *csoundGetSpoutChannel(CSOUND *csound, int channel)
+{
+    if (UNLIKELY(csound->spraw == NULL ||
+                 channel < 0 || channel >= csound->nchnls))
+      return NULL;
+    return csound->spraw + channel*csound->ksmps;
+}
+
 PUBLIC MYFLT csoundGetSpoutSample(CSOUND *csound, int frame, int channel)
 {
     int index = (frame * csound->nchnls) + channel;
@@ -3084,6 +3214,7 @@ static CS_NOINLINE int opcode_list_new_oentry(CSOUND *csound,
       return CSOUND_ERROR;
 
     shortName = get_opcode_short_name(csound, ep->opname);
+    csoundClearOpcodeResolution(csound);  /* a new overload may match */
 
     head = cs_hash_table_get(csound, csound->opcodes, shortName);
     entryCopy = csound->Malloc(csound, sizeof(OENTRY));
@@ -3239,6 +3370,7 @@ static void reset(CSOUND *csound)
     /* delete temporary files created by this Csound instance */
     remove_tmpfiles(csound);
     rlsmemfiles(csound);
+    rlssndmemfiles(csound);
 
      while (csound->filedir[n])        /* Clear source directory */
        csound->Free(csound,csound->filedir[n++]);
@@ -3355,6 +3487,7 @@ PUBLIC void csoundReset(CSOUND *csound)
      csoundSpinLockInit(&csound->spinlock);
      csoundSpinLockInit(&csound->memlock);
      csoundSpinLockInit(&csound->spinlock1);
+     csoundSpinLockInit(&csound->chn_db_lock);
      if (UNLIKELY(O->odebug))
         csound->Message(csound,"init spinlocks\n");
     }
@@ -292,6 +292,15 @@ PUBLIC int csoundCompileArgs(CSOUND *csound, int argc, const char **argv)
       csound->scorestr = NULL;
       csound->scorestr = copy_to_corefile(csound, csound->scorename, NULL, 1);
     }
+    else if (csound->scorestr == NULL && csound->scorename != NULL &&
+             (n = scbin_open(csound, csound->scorename)) != 0) {
+      /* binary score: already sorted and warped, read by rdscor() */
+      if (UNLIKELY(n < 0))
+        csoundDie(csound, Str("cannot read binary score %s"),
+                  csound->scorename);
+      if (csound->xfilename != NULL)
+        csound->Warning(csound, Str("cannot extract from a binary score"));
+    }
     else {
       //sortedscore = NULL;
       if (csound->scorestr==NULL) {
@@ -308,7 +317,8 @@ PUBLIC int csoundCompileArgs(CSOUND *csound, int argc, const char **argv)
         fclose(ff);
       }
     }
-    if (csound->xfilename != NULL) {            /* optionally extract */
+    if (csound->xfilename != NULL &&            /* optionally extract */
+        csound->score_binary == NULL) {
       if (UNLIKELY(!(xfile = fopen(csound->xfilename, "r"))))
         csoundDie(csound, Str("cannot open extract file %s"),csound->xfilename);
       csoundNotifyFileOpened(csound, csound->xfilename,
@@ -0,0 +1,255 @@
+/*
+    profile.c:
+
+    Copyright (C) 2018 The Csound Developers
+
+    This file is part of Csound.
+
+    The Csound Library is free software; you can redistribute it
+    and/or modify it under the terms of the GNU Lesser General Public
+    License as published by the Free Software Foundation; either
+    version 2.1 of the License, or (at your option) any later version.
+
+    Csound is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public
+    License along with Csound; if not, write to the Free Software
+    Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA
+    02110-1301 USA
+*/
+
+/* Per-opcode and per-instrument profile.  kperf_profile() charges every
+   opcode call to the TEXT of the OPTXT it was built from, and every
+   k-cycle of an instance to the TEXT of its INSTRTXT; this file turns
+   the mode on and off and collects the counters. */
+
+#include "csoundCore.h"
+#include "cs_profile.h"
+#include <string.h>
+
+static void profile_reset_instr(INSTRTXT *ip)
+{
+    OPTXT *bp;
+    ip->t.prof_ticks = ip->t.prof_calls = 0;
+    for (bp = ip->nxtop; bp != NULL; bp = bp->nxtop)
+      bp->t.prof_ticks = bp->t.prof_calls = 0;
+}
+
+PUBLIC void csoundSetProfiling(CSOUND *csound, int on)
+{
+    INSTRTXT **instrs = csound->engineState.instrtxtp;
+    int i, n = csound->engineState.maxinsno;
+
+    if (csound->engineState.maxopcno > n) n = csound->engineState.maxopcno;
+    if (instrs != NULL)
+      for (i = 0; i <= n; i++)
+        if (instrs[i] != NULL) profile_reset_instr(instrs[i]);
+    csound->prof_tick0 = cs_prof_clock();
+    csoundInitTimerStruct(&csound->prof_clock0);
+    csound->profiling = (on != 0);
+    if (csound->csdebug_data == NULL)   /* the debugger restores it */
+      csound->kperf = csound->profiling ? kperf_profile : kperf_nodebug;
+}
+
+/* profile clock ticks per second, measured since profiling was reset */
+static double profile_rate(CSOUND *csound)
+{
+    double t = csoundGetRealTime(&csound->prof_clock0);
+    if (t <= 0.0) return 0.0;
+    return (double) (cs_prof_clock() - csound->prof_tick0) / t;
+}
+
+typedef struct {
+    const void  *key;           /* OENTRY of an opcode, INSTRTXT of an instr */
+    CSOUND_PROFILE_ENTRY e;
+} PROF_ITEM;
+
+static int by_key(const void *a, const void *b)
+{
+    uintptr_t x = (uintptr_t) ((const PROF_ITEM *) a)->key;
+    uintptr_t y = (uintptr_t) ((const PROF_ITEM *) b)->key;
+    return x < y ? -1 : (x > y ? 1 : 0);
+}
+
+static int by_ticks(const void *a, const void *b)
+{
+    uint64_t x = ((const PROF_ITEM *) a)->e.ticks;
+    uint64_t y = ((const PROF_ITEM *) b)->e.ticks;
+    return x > y ? -1 : (x < y ? 1 : 0);
+}
+
+static void profile_item(PROF_ITEM *p, const void *key, const char *name,
+                         int insno, TEXT *t)
+{
+    p->key = key;
+    p->e.name = name;
+    p->e.insno = insno;
+    p->e.calls = (uint64_t) t->prof_calls;
+    p->e.ticks = (uint64_t) t->prof_ticks;
+}
+
+PUBLIC int csoundGetProfile(CSOUND *csound, int instruments,
+                            CSOUND_PROFILE_ENTRY *entries, int max)
+{
+    INSTRTXT  **instrs = csound->engineState.instrtxtp;
+    PROF_ITEM *p;
+    int       i, j, cnt = 0;
+    double    rate;
+
+    if (instrs == NULL) return 0;
+    /* UDO bodies are not timed: their cost is that of the calling opcode */
+    for (i = 1; i <= csound->engineState.maxinsno; i++) {
+      OPTXT *bp;
+      if (instrs[i] == NULL) continue;
+      if (instruments) cnt += (instrs[i]->t.prof_calls != 0);
+      else
+        for (bp = instrs[i]->nxtop; bp != NULL; bp = bp->nxtop)
+          cnt += (bp->t.prof_calls != 0);
+    }
+    if (cnt == 0) return 0;
+    p = (PROF_ITEM *) csound->Malloc(csound, sizeof(PROF_ITEM) * cnt);
+
+    /* counters that start during the walk are left for the next snapshot */
+    for (i = 1, j = 0; i <= csound->engineState.maxinsno && j < cnt; i++) {
+      INSTRTXT *ip = instrs[i];
+      OPTXT    *bp;
+      if (ip == NULL) continue;
+      if (instruments) {
+        if (ip->t.prof_calls != 0)
+          profile_item(&p[j++], ip, ip->insname, i, &ip->t);
+        continue;
+      }
+      for (bp = ip->nxtop; bp != NULL && j < cnt; bp = bp->nxtop)
+        if (bp->t.prof_calls != 0)
+          profile_item(&p[j++], bp->t.oentry, bp->t.oentry->opname, 0,
+                       &bp->t);
+    }
+    cnt = j;
+
+    if (!instruments) {           /* one entry per OENTRY */
+      qsort(p, cnt, sizeof(PROF_ITEM), by_key);
+      for (i = 1, j = 0; i < cnt; i++) {
+        if (p[i].key == p[j].key) {
+          p[j].e.calls += p[i].e.calls;
+          p[j].e.ticks += p[i].e.ticks;
+        }
+        else p[++j] = p[i];
+      }
+      cnt = j + 1;
+    }
+    qsort(p, cnt, sizeof(PROF_ITEM), by_ticks);
+
+    if (entries != NULL) {
+      rate = profile_rate(csound);
+      for (i = 0; i < cnt && i < max; i++) {
+        entries[i] = p[i].e;
+        entries[i].seconds = rate > 0.0 ? (double) p[i].e.ticks / rate : 0.0;
+      }
+    }
+    csound->Free(csound, p);
+    return cnt;
+}
+
+static CSOUND_PROFILE_ENTRY *profile_get(CSOUND *csound, int instruments,
+                                         int *cnt)
+{
+    CSOUND_PROFILE_ENTRY *e = NULL;
+    *cnt = csoundGetProfile(csound, instruments, NULL, 0);
+    if (*cnt > 0) {
+      e = (CSOUND_PROFILE_ENTRY *)
+        csound->Malloc(csound, sizeof(CSOUND_PROFILE_ENTRY) * *cnt);
+      *cnt = csoundGetProfile(csound, instruments, e, *cnt);
+    }
+    return e;
+}
+
+/* write a name as a JSON string, or as a CSV field quoted if it needs it */
+static void profile_name(FILE *f, const char *s, int json)
+{
+    if (!json && strpbrk(s, ",\"\r\n") == NULL) {
+      fputs(s, f);
+      return;
+    }
+    putc('"', f);
+    for ( ; *s != '\0'; s++) {
+      unsigned char c = (unsigned char) *s;
+      if (!json) {
+        if (c == '"') putc('"', f);     /* CSV doubles its quotes */
+        putc(c, f);
+      }
+      else if (c == '"' || c == '\\')
+        fprintf(f, "\\%c", c);
+      else if (c < 0x20)
+        fprintf(f, "\\u%04x", c);
+      else
+        putc(c, f);
+    }
+    putc('"', f);
+}
+
+static void profile_write(FILE *f, CSOUND_PROFILE_ENTRY *e, int cnt,
+                          int instruments, int json)
+{
+    int i;
+    for (i = 0; i < cnt; i++) {
+      char num[16];
+      const char *name = e[i].name;
+      if (name == NULL) {
+        snprintf(num, sizeof(num), "%d", e[i].insno);
+        name = num;
+      }
+      if (json) {
+        fputs("    {\"name\": ", f);
+        profile_name(f, name, 1);
+        fprintf(f, ", \"insno\": %d, \"calls\": %llu, "
+                "\"ticks\": %llu, \"seconds\": %.9f}%s\n",
+                e[i].insno, (unsigned long long) e[i].calls,
+                (unsigned long long) e[i].ticks, e[i].seconds,
+                i < cnt - 1 ? "," : "");
+      }
+      else {
+        fprintf(f, "%s,", instruments ? "instr" : "opcode");
+        profile_name(f, name, 0);
+        fprintf(f, ",%d,%llu,%llu,%.9f\n", e[i].insno,
+                (unsigned long long) e[i].calls,
+                (unsigned long long) e[i].ticks, e[i].seconds);
+      }
+    }
+}
+
+PUBLIC int csoundDumpProfile(CSOUND *csound, const char *filename)
+{
+    CSOUND_PROFILE_ENTRY *ins, *ops;
+    size_t  len = strlen(filename);
+    int     json = (len > 5 && strcmp(filename + len - 5, ".json") == 0);
+    int     nins, nops;
+    FILE    *f;
+
+    if (UNLIKELY((f = fopen(filename, "w")) == NULL)) {
+      csound->Warning(csound, Str("cannot open profile output file %s"),
+                      filename);
+      return CSOUND_ERROR;
+    }
+    ins = profile_get(csound, 1, &nins);
+    ops = profile_get(csound, 0, &nops);
+    if (json) {
+      fprintf(f, "{\n  \"instruments\": [\n");
+      profile_write(f, ins, nins, 1, 1);
+      fprintf(f, "  ],\n  \"opcodes\": [\n");
+      profile_write(f, ops, nops, 0, 1);
+      fprintf(f, "  ]\n}\n");
+    }
+    else {
+      fprintf(f, "kind,name,insno,calls,ticks,seconds\n");
+      profile_write(f, ins, nins, 1, 0);
+      profile_write(f, ops, nops, 0, 0);
+    }
+    fclose(f);
+    if (ins != NULL) csound->Free(csound, ins);
+    if (ops != NULL) csound->Free(csound, ops);
+    csound->Message(csound, Str("profile written to %s\n"), filename);
+    return CSOUND_SUCCESS;
+}
@@ -21,6 +21,7 @@
 
 #include "csoundCore.h"
 #include "csound_orc.h"
+#include "bus.h"
 #include <stdlib.h>
 
 #ifdef USE_DOUBLE
@@ -31,6 +32,8 @@
 
 int csoundKillInstanceInternal(CSOUND *csound, MYFLT instr, char *instrName,
                                int mode, int allow_release, int async);
+int csoundPreallocInstrInternal(CSOUND *csound, MYFLT instr,
+                                const char *instrName, int count);
 int csoundCompileTreeInternal(CSOUND *csound, TREE *root, int async);
 int csoundCompileOrcInternal(CSOUND *csound, const char *str, int async);
 void merge_state(CSOUND *csound, ENGINE_STATE *engineState,
@@ -53,27 +56,50 @@ void set_channel_data_ptr(CSOUND *csound, const char *name,
 enum {INPUT_MESSAGE=1, READ_SCORE, SCORE_EVENT, SCORE_EVENT_ABS,
       TABLE_COPY_OUT, TABLE_COPY_IN, TABLE_SET, MERGE_STATE, KILL_INSTANCE};
 
-/* MAX QUEUE SIZE */
+/* default number of queue slots (rounded up to a power of two) */
 #define API_MAX_QUEUE 1024
+/* default bytes of argument space preallocated per slot */
+#define API_ARG_SIZE 256
 /* ARG LIST ALIGNMENT */
 #define ARG_ALIGN 8
-
-/* Message queue structure */
+/* enqueue attempts on a full queue before the blocking call sleeps */
+#define API_SPIN_ROUNDS 64
+
+/* Message queue slot.
+
+   The queue is a bounded ring of slots that any number of API threads
+   write and only the performance thread (message_dequeue()) reads.
+   Each slot carries a sequence number: a writer may claim position p
+   when seq == p, publishes it by setting seq = p+1, and the reader
+   hands it back for the next lap with seq = p+size.  Claiming is a
+   single compare-and-swap on the write position, so neither side takes
+   a lock, and the reader never has to wait for a slow writer other
+   than the one it is about to read from.
+
+   Arguments are copied into space preallocated for each slot; only a
+   message that does not fit (a long score string, an event with many
+   pfields) makes its writer grow a heap block kept with the slot, so
+   the performance thread never allocates or frees.
+*/
 typedef struct _message_queue {
-  int64_t message;  /* message id */
-  char *args;   /* args, arg pointers */
-  int64_t rtn;  /* return value */
+  volatile long seq;  /* sequence number, see above */
+  int32_t message;    /* message id */
+  int32_t bigsiz;     /* size of big */
+  char *args;         /* args, arg pointers: slab or big */
+  char *slab;         /* this slot's preallocated args */
+  char *big;          /* heap block for args that do not fit the slab */
 } message_queue_t;
 
-
-/* atomicGetAndIncrementWithModulus */
-static long atomicGet_Incr_Mod(volatile long* val, long mod) {
-  volatile long oldVal, newVal;
-  do {
-    oldVal = *val;
-    newVal = (oldVal + 1) % mod;
-  } while (ATOMIC_CMP_XCH(val, newVal, oldVal));
-  return oldVal;
+static void free_message_queue(CSOUND *csound)
+{
+  message_queue_t *q = csound->msg_queue;
+  long i;
+  if (q == NULL) return;
+  for (i = 0; i < csound->msg_queue_size; i++)
+    if (q[i].big != NULL) csound->Free(csound, q[i].big);
+  csound->Free(csound, q[0].slab);
+  csound->Free(csound, q);
+  csound->msg_queue = NULL;
 }
 
 /* called by csoundCreate() at the start
@@ -82,45 +108,93 @@ static long atomicGet_Incr_Mod(volatile long* val, long mod) {
 */
 void allocate_message_queue(CSOUND *csound) {
   if (csound->msg_queue == NULL) {
-    int i;
-    csound->msg_queue = (message_queue_t **)
-      csound->Calloc(csound, sizeof(message_queue_t*)*API_MAX_QUEUE);
-    for (i = 0; i < API_MAX_QUEUE; i++) {
-      csound->msg_queue[i] =
-        (message_queue_t*)
-        csound->Calloc(csound, sizeof(message_queue_t));
+    long i, size = 1;
+    char *slab;
+    message_queue_t *q;
+    if (csound->msg_queue_size <= 0)
+      csound->msg_queue_size = API_MAX_QUEUE;
+    if (csound->msg_queue_argsiz <= 0)
+      csound->msg_queue_argsiz = API_ARG_SIZE;
+    while (size < csound->msg_queue_size) size <<= 1;
+    csound->msg_queue_size = size;
+    q = (message_queue_t *)
+      csound->Calloc(csound, sizeof(message_queue_t)*size);
+    slab = (char *) csound->Calloc(csound, csound->msg_queue_argsiz*size);
+    for (i = 0; i < size; i++) {
+      q[i].seq = i;
+      q[i].slab = slab + i*csound->msg_queue_argsiz;
     }
+    csound->msg_queue_wput = 0;
+    csound->msg_queue_rstart = 0;
+    csound->msg_queue = q;
   }
 }
 
+/* claim the next free slot, or return NULL if the queue is full */
+static message_queue_t *message_claim(CSOUND *csound, long *ppos) {
+  message_queue_t *q = csound->msg_queue;
+  long mask = csound->msg_queue_size - 1;
+  long pos = ATOMIC_GET(csound->msg_queue_wput);
+  while (1) {
+    message_queue_t *msg = &q[pos & mask];
+    long dif = (long) ((unsigned long) ATOMIC_GET(msg->seq)
+                       - (unsigned long) pos);
+    if (dif == 0) {
+      long next = pos + 1;
+      if (!ATOMIC_CMP_XCH(&csound->msg_queue_wput, next, pos)) {
+        *ppos = pos;
+        return msg;
+      }
+    }
+    else if (dif < 0)
+      return NULL;          /* not yet read on the previous lap */
+    pos = ATOMIC_GET(csound->msg_queue_wput);
+  }
+}
 
-/* enqueue should be called by the relevant API function */
-void *message_enqueue(CSOUND *csound, int32_t message, char *args,
-                      int argsiz) {
-  if(csound->msg_queue != NULL) {
-    int64_t *rtn;
-    volatile long items;
-
-    /* block if queue is full */
-    do {
-      items = ATOMIC_GET(csound->msg_queue_items);
-    } while(items >= API_MAX_QUEUE);
-
-    message_queue_t* msg =
-      csound->msg_queue[atomicGet_Incr_Mod(&csound->msg_queue_wget,
-                                           API_MAX_QUEUE)];
-    msg->message = message;
-    if(msg->args != NULL)
-      csound->Free(csound, msg->args);
-    msg->args = (char *)csound->Calloc(csound, argsiz);
-    memcpy(msg->args, args, argsiz);
-    rtn = &msg->rtn;
-    csound->msg_queue[atomicGet_Incr_Mod(&csound->msg_queue_wput,
-                                         API_MAX_QUEUE)] = msg;
-    ATOMIC_INCR(csound->msg_queue_items);
-    return (void *) rtn;
+/* space for argsiz bytes of args in a claimed slot */
+static char *message_args(CSOUND *csound, message_queue_t *msg, int argsiz) {
+  if (argsiz <= csound->msg_queue_argsiz)
+    return (msg->args = msg->slab);
+  if (argsiz > msg->bigsiz) {
+    msg->big = (char *) csound->ReAlloc(csound, msg->big, argsiz);
+    msg->bigsiz = argsiz;
   }
-  else return NULL;
+  return (msg->args = msg->big);
+}
+
+static inline void message_publish(message_queue_t *msg, int32_t message,
+                                   long pos) {
+  msg->message = message;
+  ATOMIC_SET(msg->seq, pos + 1);
+}
+
+/* Claim a slot, blocking if 'block' is set and the queue is full;
+   the caller fills the args returned and then calls message_publish().
+*/
+static char *message_reserve(CSOUND *csound, int argsiz, int block,
+                             message_queue_t **pmsg, long *ppos) {
+  message_queue_t *msg;
+  int spins = 0;
+  if (UNLIKELY(csound->msg_queue == NULL)) return NULL;
+  while ((msg = message_claim(csound, ppos)) == NULL) {
+    if (!block) return NULL;
+    if (++spins >= API_SPIN_ROUNDS) csoundSleep(1);
+  }
+  *pmsg = msg;
+  return message_args(csound, msg, argsiz);
+}
+
+/* enqueue should be called by the relevant API function */
+static int message_enqueue(CSOUND *csound, int32_t message, char *args,
+                           int argsiz, int block) {
+  message_queue_t *msg;
+  long pos;
+  char *dst = message_reserve(csound, argsiz, block, &msg, &pos);
+  if (dst == NULL) return CSOUND_ERROR;
+  memcpy(dst, args, argsiz);
+  message_publish(msg, message, pos);
+  return CSOUND_SUCCESS;
 }
 
 /* dequeue should be called by kperf_*()
@@ -128,12 +202,16 @@ void *message_enqueue(CSOUND *csound, int32_t message, char *args,
 */
 void message_dequeue(CSOUND *csound) {
   if(csound->msg_queue != NULL) {
+    long mask = csound->msg_queue_size - 1;
     long rp = csound->msg_queue_rstart;
-    long items = csound->msg_queue_items;
-    long rend = rp + items;
-
-    while(rp < rend) {
-      message_queue_t* msg = csound->msg_queue[rp % API_MAX_QUEUE];
+    /* only what was queued before we started, so that messages
+       enqueued by the handlers below wait for the next k-cycle */
+    long rend = ATOMIC_GET(csound->msg_queue_wput);
+
+    while(rp != rend) {
+      message_queue_t* msg = &csound->msg_queue[rp & mask];
+      /* claimed but still being written: keep order, try next time */
+      if (ATOMIC_GET(msg->seq) != rp + 1) break;
       switch(msg->message) {
       case INPUT_MESSAGE:
         {
@@ -151,33 +229,28 @@ void message_dequeue(CSOUND *csound) {
       case SCORE_EVENT:
         {
           char type;
-          const MYFLT *pfields;
           long numFields;
           type = msg->args[0];
-          memcpy(&pfields, msg->args + ARG_ALIGN,
-                 sizeof(MYFLT *));
-          memcpy(&numFields, msg->args + ARG_ALIGN*2,
+          memcpy(&numFields, msg->args + ARG_ALIGN,
                  sizeof(long));
-
-          csoundScoreEventInternal(csound, type, pfields, numFields);
+          csoundScoreEventInternal(csound, type,
+                                   (MYFLT *) (msg->args + ARG_ALIGN*2),
+                                   numFields);
         }
         break;
       case SCORE_EVENT_ABS:
         {
           char type;
-          const MYFLT *pfields;
           long numFields;
           double ofs;
           type = msg->args[0];
-          memcpy(&pfields, msg->args + ARG_ALIGN,
-                 sizeof(MYFLT *));
-          memcpy(&numFields, msg->args + ARG_ALIGN*2,
+          memcpy(&numFields, msg->args + ARG_ALIGN,
                  sizeof(long));
-          memcpy(&ofs, msg->args + ARG_ALIGN*3,
+          memcpy(&ofs, msg->args + ARG_ALIGN*2,
                  sizeof(double));
-
-          csoundScoreEventAbsoluteInternal(csound, type, pfields, numFields,
-                                             ofs);
+          csoundScoreEventAbsoluteInternal(csound, type,
+                                           (MYFLT *) (msg->args + ARG_ALIGN*3),
+                                           numFields, ofs);
         }
         break;
       case TABLE_COPY_OUT:
@@ -244,21 +317,42 @@ void message_dequeue(CSOUND *csound) {
         break;
       }
       msg->message = 0;
+      ATOMIC_SET(msg->seq, rp + mask + 1);
       rp += 1;
     }
-    ATOMIC_SUB(csound->msg_queue_items, items);
-    csound->msg_queue_rstart = rp % API_MAX_QUEUE;
+    csound->msg_queue_rstart = rp;
   }
 }
 
+/* Resize the queue; only before csoundStart() and while it is empty */
+int csoundSetAsyncQueueSize(CSOUND *csound, int items, int argBytes)
+{
+  if (UNLIKELY(items <= 0 || argBytes < 0))
+    return CSOUND_ERROR;
+  if (UNLIKELY(csound->engineStatus & CS_STATE_COMP))
+    return CSOUND_ERROR;
+  if (UNLIKELY(csound->msg_queue != NULL &&
+               csound->msg_queue_wput != csound->msg_queue_rstart))
+    return CSOUND_ERROR;
+  /* keep the fixed-size messages out of the heap */
+  if (argBytes < ARG_ALIGN*5) argBytes = ARG_ALIGN*5;
+  argBytes = (argBytes + ARG_ALIGN - 1) & ~(ARG_ALIGN - 1);
+  free_message_queue(csound);
+  csound->msg_queue_size = items;
+  csound->msg_queue_argsiz = argBytes;
+  allocate_message_queue(csound);
+  return CSOUND_SUCCESS;
+}
+
 /* these are the message enqueueing functions for each relevant API function */
-static inline void csoundInputMessage_enqueue(CSOUND *csound,
-                                              const char *str){
-  message_enqueue(csound,INPUT_MESSAGE, (char *) str, strlen(str)+1);
+static inline int csoundInputMessage_enqueue(CSOUND *csound,
+                                             const char *str, int block){
+  return message_enqueue(csound,INPUT_MESSAGE, (char *) str, strlen(str)+1,
+                         block);
 }
 
-static inline int64_t *csoundReadScore_enqueue(CSOUND *csound, const char *str){
-  return message_enqueue(csound, READ_SCORE, (char *) str, strlen(str)+1);
+static inline int csoundReadScore_enqueue(CSOUND *csound, const char *str){
+  return message_enqueue(csound, READ_SCORE, (char *) str, strlen(str)+1, 1);
 }
 
 static inline void csoundTableCopyOut_enqueue(CSOUND *csound, int table,
@@ -267,7 +361,7 @@ static inline void csoundTableCopyOut_enqueue(CSOUND *csound, int table,
   char args[ARG_ALIGN*2];
   memcpy(args, &table, sizeof(int));
   memcpy(args+ARG_ALIGN, &ptable, sizeof(MYFLT *));
-  message_enqueue(csound,TABLE_COPY_OUT, args, argsize);
+  message_enqueue(csound,TABLE_COPY_OUT, args, argsize, 1);
 }
 
 static inline void csoundTableCopyIn_enqueue(CSOUND *csound, int table,
@@ -276,46 +370,62 @@ static inline void csoundTableCopyIn_enqueue(CSOUND *csound, int table,
   char args[ARG_ALIGN*2];
   memcpy(args, &table, sizeof(int));
   memcpy(args+ARG_ALIGN, &ptable, sizeof(MYFLT *));
-  message_enqueue(csound,TABLE_COPY_IN, args, argsize);
+  message_enqueue(csound,TABLE_COPY_IN, args, argsize, 1);
 }
 
-static inline void csoundTableSet_enqueue(CSOUND *csound, int table, int index,
-                                          MYFLT value)
+static inline int csoundTableSet_enqueue(CSOUND *csound, int table, int index,
+                                         MYFLT value, int block)
 {
   const int argsize = ARG_ALIGN*3;
   char args[ARG_ALIGN*3];
   memcpy(args, &table, sizeof(int));
   memcpy(args+ARG_ALIGN, &index, sizeof(int));
   memcpy(args+2*ARG_ALIGN, &value, sizeof(MYFLT));
-  message_enqueue(csound,TABLE_SET, args, argsize);
+  return message_enqueue(csound,TABLE_SET, args, argsize, block);
 }
 
-
-static inline int64_t *csoundScoreEvent_enqueue(CSOUND *csound, char type,
-                                                const MYFLT *pfields,
-                                                long numFields)
+/* score events carry a copy of their pfields, written straight into
+   the slot, so the caller's array may be reused as soon as we return */
+static inline int csoundScoreEvent_enqueue(CSOUND *csound, char type,
+                                           const MYFLT *pfields,
+                                           long numFields, int block)
 {
-  const int argsize = ARG_ALIGN*3;
-  char args[ARG_ALIGN*3];
+  message_queue_t *msg;
+  long pos;
+  char *args;
+  if (UNLIKELY(numFields < 0)) numFields = 0;
+  args = message_reserve(csound, ARG_ALIGN*2 + sizeof(MYFLT)*numFields,
+                         block, &msg, &pos);
+  if (args == NULL) return CSOUND_ERROR;
   args[0] = type;
-  memcpy(args+ARG_ALIGN, &pfields, sizeof(MYFLT *));
-  memcpy(args+2*ARG_ALIGN, &numFields, sizeof(long));
-  return message_enqueue(csound,SCORE_EVENT, args, argsize);
+  memcpy(args+ARG_ALIGN, &numFields, sizeof(long));
+  if (numFields > 0)
+    memcpy(args+2*ARG_ALIGN, pfields, sizeof(MYFLT)*numFields);
+  message_publish(msg, SCORE_EVENT, pos);
+  return CSOUND_SUCCESS;
 }
 
 
-static inline int64_t *csoundScoreEventAbsolute_enqueue(CSOUND *csound, char type,
-                                                        const MYFLT *pfields,
-                                                        long numFields,
-                                                        double time_ofs)
+static inline int csoundScoreEventAbsolute_enqueue(CSOUND *csound, char type,
+                                                   const MYFLT *pfields,
+                                                   long numFields,
+                                                   double time_ofs,
+                                                   int block)
 {
-  const int argsize = ARG_ALIGN*4;
-  char args[ARG_ALIGN*4];
+  message_queue_t *msg;
+  long pos;
+  char *args;
+  if (UNLIKELY(numFields < 0)) numFields = 0;
+  args = message_reserve(csound, ARG_ALIGN*3 + sizeof(MYFLT)*numFields,
+                         block, &msg, &pos);
+  if (args == NULL) return CSOUND_ERROR;
   args[0] = type;
-  memcpy(args+ARG_ALIGN, &pfields, sizeof(MYFLT *));
-  memcpy(args+2*ARG_ALIGN, &numFields, sizeof(long));
-  memcpy(args+3*ARG_ALIGN, &time_ofs, sizeof(double));
-  return message_enqueue(csound,SCORE_EVENT_ABS, args, argsize);
+  memcpy(args+ARG_ALIGN, &numFields, sizeof(long));
+  memcpy(args+2*ARG_ALIGN, &time_ofs, sizeof(double));
+  if (numFields > 0)
+    memcpy(args+3*ARG_ALIGN, pfields, sizeof(MYFLT)*numFields);
+  message_publish(msg, SCORE_EVENT_ABS, pos);
+  return CSOUND_SUCCESS;
 }
 
 /* this is to be called from
@@ -326,12 +436,12 @@ void killInstance_enqueue(CSOUND *csound, MYFLT instr, int insno,
                           int allow_release) {
   const int argsize = ARG_ALIGN*5;
   char args[ARG_ALIGN*5];
-  memcpy(args, &instr, sizeof(int));
+  memcpy(args, &instr, sizeof(MYFLT));
   memcpy(args+ARG_ALIGN, &insno, sizeof(int));
   memcpy(args+ARG_ALIGN*2, &ip, sizeof(INSDS *));
   memcpy(args+ARG_ALIGN*3, &mode, sizeof(int));
   memcpy(args+ARG_ALIGN*4, &allow_release, sizeof(int));
-  message_enqueue(csound,KILL_INSTANCE,args,argsize);
+  message_enqueue(csound,KILL_INSTANCE,args,argsize,1);
 }
 
 /* this is to be called from
@@ -343,7 +453,7 @@ void mergeState_enqueue(CSOUND *csound, ENGINE_STATE *e, TYPE_TABLE* t, OPDS *id
   memcpy(args, &e, sizeof(ENGINE_STATE *));
   memcpy(args+ARG_ALIGN, &t, sizeof(TYPE_TABLE *));
   memcpy(args+2*ARG_ALIGN, &ids, sizeof(OPDS *));
-  message_enqueue(csound,MERGE_STATE, args, argsize);
+  message_enqueue(csound,MERGE_STATE, args, argsize, 1);
 }
 
 /*  VL: These functions are slated to
@@ -364,6 +474,14 @@ int csoundReadScore(CSOUND *csound, const char *message){
   return res;
 }
 
+int csoundReadScoreBinary(CSOUND *csound, const char *fileName){
+  int res;
+  csoundLockMutex(csound->API_lock);
+  res = scbin_open(csound, fileName) > 0 ? CSOUND_SUCCESS : CSOUND_ERROR;
+  csoundUnlockMutex(csound->API_lock);
+  return res;
+}
+
 void csoundTableCopyOut(CSOUND *csound, int table, MYFLT *ptable){
 
   csoundLockMutex(csound->API_lock);
@@ -412,6 +530,11 @@ int csoundKillInstance(CSOUND *csound, MYFLT instr, char *instrName,
                                     allow_release, async);
 }
 
+int csoundPreallocInstr(CSOUND *csound, MYFLT instr, const char *instrName,
+                        int count){
+  return csoundPreallocInstrInternal(csound, instr, instrName, count);
+}
+
 int csoundCompileTree(CSOUND *csound, TREE *root) {
   int async = 0;
   return csoundCompileTreeInternal(csound, root, async);
@@ -422,6 +545,16 @@ int csoundCompileOrc(CSOUND *csound, const char *str) {
   return csoundCompileOrcInternal(csound, str, async);
 }
 
+int csoundCompileOrcCached(CSOUND *csound, const char *str,
+                           const char *cachedir) {
+  int async = 0, retVal;
+  char *dir = csound->orc_cache_dir;
+  csound->orc_cache_dir = (char *) cachedir;
+  retVal = csoundCompileOrcInternal(csound, str, async);
+  csound->orc_cache_dir = dir;
+  return retVal;
+}
+
 int init0(CSOUND *csound);
 
 MYFLT csoundEvalCode(CSOUND *csound, const char *str)
@@ -445,7 +578,7 @@ MYFLT csoundEvalCode(CSOUND *csound, const char *str)
     To be removed once everything is made async
 */
 void csoundInputMessageAsync(CSOUND *csound, const char *message){
-  csoundInputMessage_enqueue(csound, message);
+  csoundInputMessage_enqueue(csound, message, 1);
 }
 
 void csoundReadScoreAsync(CSOUND *csound, const char *message){
@@ -462,13 +595,13 @@ void csoundTableCopyInAsync(CSOUND *csound, int table, MYFLT *ptable){
 
 void csoundTableSetAsync(CSOUND *csound, int table, int index, MYFLT value)
 {
-  csoundTableSet_enqueue(csound, table, index, value);
+  csoundTableSet_enqueue(csound, table, index, value, 1);
 }
 
 void csoundScoreEventAsync(CSOUND *csound, char type,
                            const MYFLT *pfields, long numFields)
 {
-  csoundScoreEvent_enqueue(csound, type, pfields, numFields);
+  csoundScoreEvent_enqueue(csound, type, pfields, numFields, 1);
 }
 
 void csoundScoreEventAbsoluteAsync(CSOUND *csound, char type,
@@ -476,7 +609,32 @@ void csoundScoreEventAbsoluteAsync(CSOUND *csound, char type,
                                    double time_ofs)
 {
 
-  csoundScoreEventAbsolute_enqueue(csound, type, pfields, numFields, time_ofs);
+  csoundScoreEventAbsolute_enqueue(csound, type, pfields, numFields,
+                                   time_ofs, 1);
+}
+
+/* non-blocking versions: CSOUND_ERROR if the queue is full */
+int csoundTryInputMessageAsync(CSOUND *csound, const char *message){
+  return csoundInputMessage_enqueue(csound, message, 0);
+}
+
+int csoundTryTableSetAsync(CSOUND *csound, int table, int index, MYFLT value)
+{
+  return csoundTableSet_enqueue(csound, table, index, value, 0);
+}
+
+int csoundTryScoreEventAsync(CSOUND *csound, char type,
+                             const MYFLT *pfields, long numFields)
+{
+  return csoundScoreEvent_enqueue(csound, type, pfields, numFields, 0);
+}
+
+int csoundTryScoreEventAbsoluteAsync(CSOUND *csound, char type,
+                                     const MYFLT *pfields, long numFields,
+                                     double time_ofs)
+{
+  return csoundScoreEventAbsolute_enqueue(csound, type, pfields, numFields,
+                                          time_ofs, 0);
 }
 
 int csoundCompileTreeAsync(CSOUND *csound, TREE *root) {
@@ -583,17 +741,10 @@ void csoundSetAudioChannel(CSOUND *csound, const char *name, MYFLT *samples)
   }
 }
 
-void csoundSetStringChannel(CSOUND *csound, const char *name, char *string)
+static void set_string_channel(CSOUND *csound, STRINGDAT *stringdat,
+                               spin_lock_t *lock, const char *string)
 {
-  MYFLT  *pstring;
-
-  if (csoundGetChannelPtr(csound, &pstring, name,
-                          CSOUND_STRING_CHANNEL | CSOUND_INPUT_CHANNEL)
-      == CSOUND_SUCCESS){
-
-    STRINGDAT* stringdat = (STRINGDAT*) pstring;
     int    size = stringdat->size; //csoundGetChannelDatasize(csound, name);
-    spin_lock_t *lock = (spin_lock_t *) csoundGetChannelLock(csound, (char*) name);
 
     if (lock != NULL) {
       csoundSpinLock(lock);
@@ -601,7 +752,7 @@ void csoundSetStringChannel(CSOUND *csound, const char *name, char *string)
 
     if (strlen(string) + 1 > (unsigned int) size) {
       if (stringdat->data!=NULL) csound->Free(csound,stringdat->data);
-      stringdat->data = cs_strdup(csound, string);
+      stringdat->data = cs_strdup(csound, (char *) string);
       stringdat->size = strlen(string) + 1;
       //set_channel_data_ptr(csound,name,(void*)pstring, strlen(string)+1);
     } else {
@@ -611,20 +762,13 @@ void csoundSetStringChannel(CSOUND *csound, const char *name, char *string)
     if (lock != NULL) {
       csoundSpinUnLock(lock);
     }
-  }
 }
 
-void csoundGetStringChannel(CSOUND *csound, const char *name, char *string)
+static void get_string_channel(STRINGDAT *stringdat, spin_lock_t *lock,
+                               char *string)
 {
-  MYFLT  *pstring;
-  char *chstring;
-  int n2;
-  if (strlen(name) == 0) return;
-  if (csoundGetChannelPtr(csound, &pstring, name,
-                          CSOUND_STRING_CHANNEL | CSOUND_OUTPUT_CHANNEL)
-      == CSOUND_SUCCESS){
-    spin_lock_t *lock = (spin_lock_t *) csoundGetChannelLock(csound, (char*) name);
-    chstring = ((STRINGDAT *) pstring)->data;
+    char *chstring = stringdat->data;
+    int n2;
     if (lock != NULL)
       csoundSpinLock(lock);
     if (string != NULL && chstring != NULL) {
@@ -634,9 +778,180 @@ void csoundGetStringChannel(CSOUND *csound, const char *name, char *string)
     }
     if (lock != NULL)
       csoundSpinUnLock(lock);
+}
+
+void csoundSetStringChannel(CSOUND *csound, const char *name, char *string)
+{
+  MYFLT  *pstring;
+
+  if (csoundGetChannelPtr(csound, &pstring, name,
+                          CSOUND_STRING_CHANNEL | CSOUND_INPUT_CHANNEL)
+      == CSOUND_SUCCESS){
+    spin_lock_t *lock = (spin_lock_t *) csoundGetChannelLock(csound, (char*) name);
+    set_string_channel(csound, (STRINGDAT*) pstring, lock, string);
+  }
+}
+
+void csoundGetStringChannel(CSOUND *csound, const char *name, char *string)
+{
+  MYFLT  *pstring;
+  if (strlen(name) == 0) return;
+  if (csoundGetChannelPtr(csound, &pstring, name,
+                          CSOUND_STRING_CHANNEL | CSOUND_OUTPUT_CHANNEL)
+      == CSOUND_SUCCESS){
+    spin_lock_t *lock = (spin_lock_t *) csoundGetChannelLock(csound, (char*) name);
+    get_string_channel((STRINGDAT *) pstring, lock, string);
   }
 }
 
+/* Channel handles: a handle is the channel's CHNENTRY, found once by
+   csoundGetChannelHandle() in bus.c, so these skip the name lookup.
+   The data pointer is still read through the entry on every call, as
+   chnexport and string resizing may replace it.
+*/
+#define IS_CHANNEL(h, t) \
+  ((h) != NULL && ((h)->type & CSOUND_CHANNEL_TYPE_MASK) == (t))
+
+static inline MYFLT get_control_channel(CSOUND_CHANNEL h)
+{
+  union {
+    MYFLT d;
+    MYFLT_INT_TYPE i;
+  } x;
+#if defined(MSVC)
+  x.i = InterlockedExchangeAdd64((MYFLT_INT_TYPE *) h->data, 0);
+#elif defined(HAVE_ATOMIC_BUILTIN)
+  x.i = __atomic_load_n((MYFLT_INT_TYPE *) h->data, __ATOMIC_SEQ_CST);
+#else
+  x.d = *h->data;
+#endif
+  return x.d;
+}
+
+static inline void set_control_channel(CSOUND_CHANNEL h, MYFLT val)
+{
+  union {
+    MYFLT d;
+    MYFLT_INT_TYPE i;
+  } x;
+  x.d = val;
+#if defined(MSVC)
+  InterlockedExchange64((MYFLT_INT_TYPE *) h->data, x.i);
+#elif defined(HAVE_ATOMIC_BUILTIN)
+  __atomic_store_n((MYFLT_INT_TYPE *) h->data, x.i, __ATOMIC_SEQ_CST);
+#else
+  csoundSpinLock(&h->lock);
+  *h->data = x.d;
+  csoundSpinUnLock(&h->lock);
+#endif
+}
+
+MYFLT csoundGetControlChannelByHandle(CSOUND *csound, CSOUND_CHANNEL h)
+{
+  IGN(csound);
+  if (UNLIKELY(!IS_CHANNEL(h, CSOUND_CONTROL_CHANNEL))) return FL(0.0);
+  return get_control_channel(h);
+}
+
+void csoundSetControlChannelByHandle(CSOUND *csound, CSOUND_CHANNEL h,
+                                     MYFLT val)
+{
+  IGN(csound);
+  if (LIKELY(IS_CHANNEL(h, CSOUND_CONTROL_CHANNEL)))
+    set_control_channel(h, val);
+}
+
+void csoundGetControlChannelsByHandle(CSOUND *csound,
+                                      const CSOUND_CHANNEL *handles,
+                                      MYFLT *values, int n)
+{
+  int i;
+  IGN(csound);
+  for (i = 0; i < n; i++)
+    values[i] = LIKELY(IS_CHANNEL(handles[i], CSOUND_CONTROL_CHANNEL)) ?
+      get_control_channel(handles[i]) : FL(0.0);
+}
+
+void csoundSetControlChannelsByHandle(CSOUND *csound,
+                                      const CSOUND_CHANNEL *handles,
+                                      const MYFLT *values, int n)
+{
+  int i;
+  IGN(csound);
+  for (i = 0; i < n; i++)
+    if (LIKELY(IS_CHANNEL(handles[i], CSOUND_CONTROL_CHANNEL)))
+      set_control_channel(handles[i], values[i]);
+}
+
+void csoundGetAudioChannelByHandle(CSOUND *csound, CSOUND_CHANNEL h,
+                                   MYFLT *samples)
+{
+  if (UNLIKELY(!IS_CHANNEL(h, CSOUND_AUDIO_CHANNEL))) return;
+  csoundSpinLock(&h->lock);
+  memcpy(samples, h->data, csound->ksmps*sizeof(MYFLT));
+  csoundSpinUnLock(&h->lock);
+}
+
+void csoundSetAudioChannelByHandle(CSOUND *csound, CSOUND_CHANNEL h,
+                                   const MYFLT *samples)
+{
+  if (UNLIKELY(!IS_CHANNEL(h, CSOUND_AUDIO_CHANNEL))) return;
+  csoundSpinLock(&h->lock);
+  memcpy(h->data, samples, csound->ksmps*sizeof(MYFLT));
+  csoundSpinUnLock(&h->lock);
+}
+
+void csoundGetAudioChannelsByHandle(CSOUND *csound,
+                                    const CSOUND_CHANNEL *handles,
+                                    MYFLT **samples, int n)
+{
+  int i;
+  for (i = 0; i < n; i++)
+    csoundGetAudioChannelByHandle(csound, handles[i], samples[i]);
+}
+
+void csoundSetAudioChannelsByHandle(CSOUND *csound,
+                                    const CSOUND_CHANNEL *handles,
+                                    MYFLT **samples, int n)
+{
+  int i;
+  for (i = 0; i < n; i++)
+    csoundSetAudioChannelByHandle(csound, handles[i], samples[i]);
+}
+
+void csoundGetStringChannelByHandle(CSOUND *csound, CSOUND_CHANNEL h,
+                                    char *string)
+{
+  IGN(csound);
+  if (LIKELY(IS_CHANNEL(h, CSOUND_STRING_CHANNEL)))
+    get_string_channel((STRINGDAT *) h->data, &h->lock, string);
+}
+
+void csoundSetStringChannelByHandle(CSOUND *csound, CSOUND_CHANNEL h,
+                                    const char *string)
+{
+  if (LIKELY(IS_CHANNEL(h, CSOUND_STRING_CHANNEL)))
+    set_string_channel(csound, (STRINGDAT *) h->data, &h->lock, string);
+}
+
+void csoundGetStringChannelsByHandle(CSOUND *csound,
+                                     const CSOUND_CHANNEL *handles,
+                                     char **strings, int n)
+{
+  int i;
+  for (i = 0; i < n; i++)
+    csoundGetStringChannelByHandle(csound, handles[i], strings[i]);
+}
+
+void csoundSetStringChannelsByHandle(CSOUND *csound,
+                                     const CSOUND_CHANNEL *handles,
+                                     char **strings, int n)
+{
+  int i;
+  for (i = 0; i < n; i++)
+    csoundSetStringChannelByHandle(csound, handles[i], strings[i]);
+}
+
 PUBLIC int csoundSetPvsChannel(CSOUND *csound, const PVSDATEXT *fin,
                                const char *name)
 {
@@ -248,7 +248,9 @@ PUBLIC int csoundScoreSort(CSOUND *csound, FILE *inFile, FILE *outFile)
     int   err;
     CORFIL *inf = corfile_create_w(csound);
     int c;
+    volatile MYFLT window = csound->score_window;
     if ((err = setjmp(csound->exitjmp)) != 0) {
+      csound->score_window = window;
       return ((err - CSOUND_EXITJMP_SUCCESS) | CSOUND_EXITJMP_SUCCESS);
     }
     while ((c=getc(inFile))!=EOF) corfile_putc(csound, c, inf);
@@ -256,13 +258,45 @@ PUBLIC int csoundScoreSort(CSOUND *csound, FILE *inFile, FILE *outFile)
     corfile_rewind(inf);
     /* scsortstr() ignores the second arg - Jan 5 2012 */
     csound->scorestr = inf;
+    /* the whole score, not just its first --score-window */
+    csound->score_window = FL(0.0);
     scsortstr(csound, inf);
+    csound->score_window = window;
     while ((c=corfile_getc(csound->scstr))!=EOF)
       putc(c, outFile);
     corfile_rm(csound, &csound->scstr);
     return 0;
 }
 
+/**
+ * Sorts score file 'inFile' and writes the result to 'outFile' as a
+ * binary score. The Csound instance should be initialised before
+ * calling this function, and csoundReset() should be called after
+ * to clean up. The return value is zero on success.
+ */
+PUBLIC int csoundScoreToBinary(CSOUND *csound, FILE *inFile, FILE *outFile)
+{
+    int   err;
+    CORFIL *inf = corfile_create_w(csound);
+    int c;
+    volatile MYFLT window = csound->score_window;
+    if ((err = setjmp(csound->exitjmp)) != 0) {
+      csound->score_window = window;
+      return ((err - CSOUND_EXITJMP_SUCCESS) | CSOUND_EXITJMP_SUCCESS);
+    }
+    while ((c=getc(inFile))!=EOF) corfile_putc(csound, c, inf);
+    corfile_puts(csound, "\ne\n#exit\n", inf);
+    corfile_rewind(inf);
+    csound->scorestr = inf;
+    /* the whole score, not just its first --score-window */
+    csound->score_window = FL(0.0);
+    scsortstr(csound, inf);
+    csound->score_window = window;
+    err = scbin_write(csound, outFile);
+    corfile_rm(csound, &csound->scstr);
+    return err;
+}
+
 /**
  * Extracts from 'inFile', controlled by 'extractFile', and writes
  * the result to 'outFile'. The Csound instance should be initialised
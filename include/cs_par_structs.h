@@ -47,6 +47,10 @@ struct instr_semantics_t;
 
 typedef int taskID;
 
+/* Which dispatcher hands out tasks with -j N (--par-scheduler=) */
+#define PAR_SCHED_DAG   (0)        /* shared status array and watch lists */
+#define PAR_SCHED_STEAL (1)        /* per-thread deques with work stealing */
+
 /* Each task has a status */
 enum state { WAITING = 3,          /* Dependencies have not been finished */
              AVAILABLE = 2,        /* Dependencies met, ready to be run */
@@ -67,4 +71,25 @@ typedef struct _watchList {
                      sizeof(struct _watchList *))) / sizeof(uint8_t)];
 } watchList;
 
+/* Instances in the active chain are grouped into runs of the same
+ * instrument.  Whether two groups must be ordered only depends on the two
+ * instruments, so it is looked up in a cache of instrument pairs that lives
+ * as long as the compiled orchestra; the per-cycle task list is then just
+ * the chain walk plus a small group x group matrix.
+ */
+typedef struct _dagTopology {
+  char    **instr_dep;    /* lazy rows, instr_dep[b][a] for a <= b */
+  int     instr_size;     /* rows in instr_dep */
+  int     orc_version;    /* csound->dag_orc_version the cache is for */
+  int     num_groups;
+  int     max_groups;
+  int     *group_start;   /* first task of each group, num_groups+1 entries */
+  int     *group_ins;     /* instrument number of each group */
+  int     *group_wait;    /* earliest group each group waits for, or -1 */
+  char    *group_dep;     /* [earlier*num_groups+later], diagonal: self */
+  int     group_dep_size;
+  int     *task_group;    /* group of each task */
+  taskID  *first_dep;     /* earliest task each task waits for, or -1 */
+} dagTopology;
+
 #endif
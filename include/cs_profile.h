@@ -0,0 +1,63 @@
+/*
+    cs_profile.h:
+
+    Copyright (C) 2018 The Csound Developers
+
+    This file is part of Csound.
+
+    The Csound Library is free software; you can redistribute it
+    and/or modify it under the terms of the GNU Lesser General Public
+    License as published by the Free Software Foundation; either
+    version 2.1 of the License, or (at your option) any later version.
+
+    Csound is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public
+    License along with Csound; if not, write to the Free Software
+    Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA
+    02110-1301 USA
+*/
+
+#ifndef CS_PROFILE_H
+#define CS_PROFILE_H
+
+/* Clock and counters of the profiling perf loop (csoundSetProfiling).
+   The clock is the cheapest monotonic counter the CPU offers; its rate
+   is measured against real time when a profile is read. */
+
+#if defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+#include <intrin.h>
+#endif
+
+static inline int64_t cs_prof_clock(void)
+{
+#if defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+    return (int64_t) __rdtsc();
+#elif defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+    return (int64_t) __builtin_ia32_rdtsc();
+#elif defined(__GNUC__) && defined(__aarch64__)
+    int64_t v;
+    __asm__ __volatile__ ("mrs %0, cntvct_el0" : "=r" (v));
+    return v;
+#else
+    RTCLOCK zero = { 0, 0 };    /* real time since the clock's epoch */
+    return (int64_t) (csoundGetRealTime(&zero) * 1.0e9);
+#endif
+}
+
+/* Performance threads may run instances of one instrument at once */
+static inline void cs_prof_add(volatile int64_t *p, int64_t v)
+{
+#if defined(MSVC)
+    InterlockedExchangeAdd64((volatile LONGLONG *) p, v);
+#elif defined(HAVE_ATOMIC_BUILTIN)
+    __atomic_fetch_add(p, v, __ATOMIC_RELAXED);
+#else
+    *p += v;
+#endif
+}
+
+#endif  /* CS_PROFILE_H */
@@ -569,6 +569,34 @@ extern "C" {
     uint32_t    mt[624];
   } CsoundRandMTState;
 
+  /**
+   * Allocation counters, see csoundGetMemoryStats().
+   */
+  typedef struct {
+    uint64_t    allocs;         /* blocks allocated since create/reset   */
+    uint64_t    frees;          /* blocks freed                          */
+    uint64_t    reallocs;       /* resizes; a moved block also counts as
+                                   an alloc and a free                   */
+    uint64_t    contended;      /* allocations that found their arena
+                                   locked by another thread              */
+    uint64_t    bytesInUse;     /* live bytes, rounded to size class     */
+    uint64_t    bytesReserved;  /* bytes obtained from the system        */
+    uint64_t    smallBlocks;    /* live blocks cut from arena chunks     */
+    uint64_t    largeBlocks;    /* live blocks allocated individually    */
+  } CSOUND_MEMORY_STATS;
+
+  /**
+   * One line of a profile, see csoundGetProfile().
+   */
+  typedef struct {
+    const char  *name;          /* opcode name, or instrument name (NULL
+                                   for unnamed instruments)              */
+    int         insno;          /* instrument number; 0 for opcodes      */
+    uint64_t    calls;          /* perf calls; k-cycles for instruments  */
+    uint64_t    ticks;          /* profile clock ticks spent             */
+    double      seconds;        /* the same, converted to seconds        */
+  } CSOUND_PROFILE_ENTRY;
+
   /* PVSDATEXT is a variation on PVSDAT used in
      the pvs bus interface */
   typedef struct pvsdat_ext {
@@ -656,6 +684,11 @@ extern "C" {
     controlChannelHints_t    hints;
   } controlChannelInfo_t;
 
+  /**
+   * Opaque handle to a channel, see csoundGetChannelHandle()
+   */
+  typedef struct channelEntry_s *CSOUND_CHANNEL;
+
   typedef void (*channelCallback_t)(CSOUND *csound,
                                     const char *channelName,
                                     void *channelValuePtr,
@@ -748,6 +781,17 @@ extern "C" {
    */
   PUBLIC int csoundCompileOrcAsync(CSOUND *csound, const char *str);
 
+  /**
+   *  As csoundCompileOrc(), keeping the checked and optimised parse tree
+   *  in the directory cachedir, which must exist. The tree is stored
+   *  under a hash of the preprocessed orchestra and of the opcode set, so
+   *  compiling the same orchestra again, in this or another process,
+   *  loads it instead of parsing. Cached trees are not used when
+   *  running with more than one thread (-j).
+   */
+  PUBLIC int csoundCompileOrcCached(CSOUND *csound, const char *str,
+                                    const char *cachedir);
+
   /**
    *   Parse and compile an orchestra given on an string,
    *   evaluating any global space code (i-time only).
@@ -896,6 +940,19 @@ extern "C" {
    */
   PUBLIC int csoundPerformKsmps(CSOUND *);
 
+  /**
+   * As csoundPerformKsmps(), exchanging audio with the host one buffer
+   * per channel instead of interleaved.  If 'in' is not NULL it holds
+   * nchnls_i pointers to ksmps input samples each, which replace the
+   * contents of spin before the k-cycle; an input file or device (-i)
+   * is not read for that k-cycle.  If 'out' is not NULL it holds
+   * nchnls pointers to buffers of ksmps samples that receive the output
+   * of the k-cycle; NULL entries are skipped.  When no output file or
+   * device is open, spout is not updated by this call.
+   */
+  PUBLIC int csoundPerformKsmpsPlanar(CSOUND *csound, MYFLT *const *out,
+                                      const MYFLT *const *in);
+
   /**
    * Performs Csound, sensing real-time and score events
    * and processing one buffer's worth (-b frames) of interleaved audio.
@@ -1236,6 +1293,14 @@ extern "C" {
    */
   PUBLIC MYFLT *csoundGetSpout(CSOUND *csound);
 
+  /**
+   * Returns the address of the ksmps output samples of one channel
+   * (counting from 0) of the last k-cycle, before interleaving, or NULL
+   * if the channel does not exist.  Only valid after csoundStart();
+   * the address changes when Csound is restarted.
+   */
+  PUBLIC MYFLT *csoundGetSpoutChannel(CSOUND *csound, int channel);
+
   /**
    * Returns the indicated sample from the Csound audio output
    * working buffer (spout); only ever makes sense after calling
@@ -1459,6 +1524,16 @@ extern "C" {
    */
   PUBLIC void csoundReadScoreAsync(CSOUND *csound, const char *str);
 
+  /**
+   *  Plays the binary score fileName, written by csoundScoreToBinary(),
+   *  in place of any text score. The file is mapped and its events are
+   *  read as they fall due, without being sorted. Call it before
+   *  csoundStart(). A binary score given as the score file on the
+   *  command line is recognised in the same way.
+   *  Returns CSOUND_ERROR if fileName is not a binary score.
+   */
+  PUBLIC int csoundReadScoreBinary(CSOUND *csound, const char *fileName);
+
   /**
    * Returns the current score time in seconds
    * since the beginning of performance.
@@ -1531,6 +1606,15 @@ extern "C" {
   PUBLIC int csoundScoreExtract(CSOUND *,
                                 FILE *inFile, FILE *outFile, FILE *extractFile);
 
+  /**
+   * Sorts score file 'inFile' as csoundScoreSort() does, and writes the
+   * sorted and warped events to 'outFile' as a binary score, for
+   * csoundReadScoreBinary(). The binary format is that of the machine
+   * it is written on. csoundReset() should be called afterwards to
+   * clean up. On success, zero is returned.
+   */
+  PUBLIC int csoundScoreToBinary(CSOUND *, FILE *inFile, FILE *outFile);
+
   /** @}*/
   /** @defgroup MESSAGES Messages and Text
    *
@@ -1786,6 +1870,104 @@ extern "C" {
    */
   PUBLIC int csoundGetChannelDatasize(CSOUND *csound, const char *name);
 
+  /**
+   * Looks up the channel 'name', creating it if it does not exist, as
+   * csoundGetChannelPtr() does, and stores a handle to it in *handle.
+   * The ...ByHandle() functions below then access the channel without
+   * looking its name up again, which matters to hosts that move many
+   * channels per block. Handles stay valid until csoundReset().
+   * Returns CSOUND_SUCCESS, or as csoundGetChannelPtr() on failure,
+   * in which case *handle is set to NULL.
+   */
+  PUBLIC int csoundGetChannelHandle(CSOUND *csound, CSOUND_CHANNEL *handle,
+                                    const char *name, int type);
+
+  /**
+   * atomically reads the control channel 'handle'; returns 0 if the
+   * handle is NULL or not a control channel
+   */
+  PUBLIC MYFLT csoundGetControlChannelByHandle(CSOUND *csound,
+                                               CSOUND_CHANNEL handle);
+
+  /**
+   * atomically sets the control channel 'handle' to val
+   */
+  PUBLIC void csoundSetControlChannelByHandle(CSOUND *csound,
+                                              CSOUND_CHANNEL handle,
+                                              MYFLT val);
+
+  /**
+   * reads n control channels into values[0..n-1]; each value is read
+   * atomically, but not the set as a whole
+   */
+  PUBLIC void csoundGetControlChannelsByHandle(CSOUND *csound,
+                                               const CSOUND_CHANNEL *handles,
+                                               MYFLT *values, int n);
+
+  /**
+   * sets n control channels from values[0..n-1]
+   */
+  PUBLIC void csoundSetControlChannelsByHandle(CSOUND *csound,
+                                               const CSOUND_CHANNEL *handles,
+                                               const MYFLT *values, int n);
+
+  /**
+   * as csoundGetAudioChannel(), for a channel handle
+   */
+  PUBLIC void csoundGetAudioChannelByHandle(CSOUND *csound,
+                                            CSOUND_CHANNEL handle,
+                                            MYFLT *samples);
+
+  /**
+   * as csoundSetAudioChannel(), for a channel handle
+   */
+  PUBLIC void csoundSetAudioChannelByHandle(CSOUND *csound,
+                                            CSOUND_CHANNEL handle,
+                                            const MYFLT *samples);
+
+  /**
+   * copies n audio channels into the ksmps-long arrays samples[0..n-1]
+   */
+  PUBLIC void csoundGetAudioChannelsByHandle(CSOUND *csound,
+                                             const CSOUND_CHANNEL *handles,
+                                             MYFLT **samples, int n);
+
+  /**
+   * sets n audio channels from the ksmps-long arrays samples[0..n-1]
+   */
+  PUBLIC void csoundSetAudioChannelsByHandle(CSOUND *csound,
+                                             const CSOUND_CHANNEL *handles,
+                                             MYFLT **samples, int n);
+
+  /**
+   * as csoundGetStringChannel(), for a channel handle
+   */
+  PUBLIC void csoundGetStringChannelByHandle(CSOUND *csound,
+                                             CSOUND_CHANNEL handle,
+                                             char *string);
+
+  /**
+   * as csoundSetStringChannel(), for a channel handle
+   */
+  PUBLIC void csoundSetStringChannelByHandle(CSOUND *csound,
+                                             CSOUND_CHANNEL handle,
+                                             const char *string);
+
+  /**
+   * copies n string channels into strings[0..n-1], each of which
+   * should have room for the channel's string
+   */
+  PUBLIC void csoundGetStringChannelsByHandle(CSOUND *csound,
+                                              const CSOUND_CHANNEL *handles,
+                                              char **strings, int n);
+
+  /**
+   * sets n string channels from strings[0..n-1]
+   */
+  PUBLIC void csoundSetStringChannelsByHandle(CSOUND *csound,
+                                              const CSOUND_CHANNEL *handles,
+                                              char **strings, int n);
+
   /** Sets the function which will be called whenever the invalue opcode
    * is used. */
   PUBLIC void
@@ -1832,6 +2014,15 @@ extern "C" {
   PUBLIC void csoundScoreEventAsync(CSOUND *,
                               char type, const MYFLT *pFields, long numFields);
 
+  /**
+   *  Like csoundScoreEventAsync(), but never blocks: returns CSOUND_ERROR
+   *  if the message queue is full (see csoundSetAsyncQueueSize()),
+   *  CSOUND_SUCCESS otherwise. The pfields are copied, so the array
+   *  may be reused as soon as the call returns.
+   */
+  PUBLIC int csoundTryScoreEventAsync(CSOUND *,
+                              char type, const MYFLT *pFields, long numFields);
+
   /**
    * Like csoundScoreEvent(), this function inserts a score event, but
    * at absolute time with respect to the start of performance, or from an
@@ -1845,6 +2036,13 @@ extern "C" {
    */
   PUBLIC void csoundScoreEventAbsoluteAsync(CSOUND *,
                  char type, const MYFLT *pfields, long numFields, double time_ofs);
+
+  /**
+   *  Non-blocking version of csoundScoreEventAbsoluteAsync(); returns
+   *  CSOUND_ERROR if the message queue is full.
+   */
+  PUBLIC int csoundTryScoreEventAbsoluteAsync(CSOUND *,
+                 char type, const MYFLT *pfields, long numFields, double time_ofs);
   /**
    * Input a NULL-terminated string (as if from a console),
    * used for line events.
@@ -1856,6 +2054,25 @@ extern "C" {
    */
   PUBLIC void csoundInputMessageAsync(CSOUND *, const char *message);
 
+  /**
+   * Non-blocking version of csoundInputMessageAsync(); returns
+   * CSOUND_ERROR if the message queue is full.
+   */
+  PUBLIC int csoundTryInputMessageAsync(CSOUND *, const char *message);
+
+  /**
+   * Sets the capacity of the queue used by the Async functions:
+   * 'items' messages (rounded up to a power of two, default 1024), each
+   * with 'argBytes' bytes of preallocated argument space (default 256).
+   * Messages with larger arguments, such as long strings or events
+   * with many pfields, are still queued, but cost their sender an
+   * allocation. The Async functions block while the queue is full;
+   * the csoundTry...Async() variants return CSOUND_ERROR instead.
+   * Must be called before csoundStart(), with no messages pending, and
+   * again after csoundReset(). Returns CSOUND_SUCCESS or CSOUND_ERROR.
+   */
+  PUBLIC int csoundSetAsyncQueueSize(CSOUND *, int items, int argBytes);
+
   /**
    * Kills off one or more running instances of an instrument identified
    * by instr (number) or instrName (name). If instrName is NULL, the
@@ -1869,6 +2086,18 @@ extern "C" {
   PUBLIC int csoundKillInstance(CSOUND *csound, MYFLT instr,
                                 char *instrName, int mode, int allow_release);
 
+  /**
+   * Makes sure that 'count' instances of the instrument identified by
+   * instr (number) or instrName (name) are allocated, as the prealloc
+   * opcode does, and raises the instrument's prealloc mark to 'count'.
+   * Up to that many free instances are then kept across score sections
+   * instead of being released, so that notes within the mark start
+   * without allocating memory. Returns CSOUND_SUCCESS, or CSOUND_ERROR
+   * if the instrument does not exist.
+   */
+  PUBLIC int csoundPreallocInstr(CSOUND *csound, MYFLT instr,
+                                 const char *instrName, int count);
+
 
   /**
    * Register a function to be called once in every control period
@@ -1965,6 +2194,18 @@ extern "C" {
    */
   PUBLIC void csoundTableSet(CSOUND *, int table, int index, MYFLT value);
 
+  /**
+   * Asynchronous version of csoundTableSet()
+   */
+  PUBLIC void csoundTableSetAsync(CSOUND *, int table, int index, MYFLT value);
+
+  /**
+   * Non-blocking version of csoundTableSetAsync(); returns
+   * CSOUND_ERROR if the message queue is full.
+   */
+  PUBLIC int csoundTryTableSetAsync(CSOUND *, int table, int index,
+                                    MYFLT value);
+
 
   /**
    * Copy the contents of a function table into a supplied array *dest
@@ -2326,6 +2567,43 @@ extern "C" {
    */
   PUBLIC double csoundGetCPUTime(RTCLOCK *);
 
+  /**
+   * Fill 'stats' with the allocation counters of the memory database of
+   * this Csound instance.  The counters start from zero when the instance
+   * is created or reset.  This may be called from any thread.
+   */
+  PUBLIC void csoundGetMemoryStats(CSOUND *csound,
+                                   CSOUND_MEMORY_STATS *stats);
+
+  /**
+   * Turn profiling on (non-zero 'on') or off.  While it is on, the time
+   * spent in the perf routine of every opcode is accumulated per opcode
+   * and per instrument.  The counters are reset each time this is called.
+   * Time in a user-defined opcode or subinstr includes the opcodes they
+   * run.  When profiling is off the performance loop is not instrumented
+   * at all.
+   */
+  PUBLIC void csoundSetProfiling(CSOUND *csound, int on);
+
+  /**
+   * Take a snapshot of the profile, per instrument if 'instruments' is
+   * non-zero and otherwise per opcode.  Up to 'max' entries are stored in
+   * 'entries', most expensive first; entries for instruments or opcodes
+   * that never ran are left out.  Returns the number of entries available,
+   * which may be more than 'max'.  'entries' may be NULL to just count.
+   * Call it between k-cycles, or from the performance thread.
+   */
+  PUBLIC int csoundGetProfile(CSOUND *csound, int instruments,
+                              CSOUND_PROFILE_ENTRY *entries, int max);
+
+  /**
+   * Write the instrument and opcode profiles to 'filename', as JSON if
+   * the name ends in ".json" and as CSV otherwise.  This is done
+   * automatically at the end of performance when the --profile-output
+   * option is given.  Returns CSOUND_SUCCESS or CSOUND_ERROR.
+   */
+  PUBLIC int csoundDumpProfile(CSOUND *csound, const char *filename);
+
   /**
    * Return a 32-bit unsigned integer to be used as seed from current time.
    */
@@ -193,6 +193,10 @@ public:
   {
     return csoundReadScore(csound, str);
   }
+  virtual int ReadScoreBinary(const char *fileName)
+  {
+    return csoundReadScoreBinary(csound, fileName);
+  }
   virtual int CompileArgs(int argc,const char **argv)
   {
     return csoundCompileArgs(csound, argc, argv);
@@ -477,6 +481,10 @@ public:
   {
     return csoundScoreExtract(csound, inFile, outFile, extractFile);
   }
+  virtual int ScoreToBinary(FILE *inFile, FILE *outFile)
+  {
+    return csoundScoreToBinary(csound, inFile, outFile);
+  }
   virtual void Message(const char *format, ...)
   {
     va_list args;
@@ -262,6 +262,7 @@ typedef struct CORFIL {
     int     ksmps_override;
     int     fft_lib;
     int     echo;
+    int     parScheduler;   /* PAR_SCHED_DAG or PAR_SCHED_STEAL (-j N) */
   } OPARMS;
 
   typedef struct arglst {
@@ -309,6 +310,8 @@ typedef struct CORFIL {
     unsigned        int outArgCount;
     char            intype;         /* Type of first input argument (g,k,a,w etc) */
     char            pftype;         /* Type of output argument (k,a etc) */
+    volatile int64_t prof_ticks;    /* profiling: clock ticks spent, and */
+    volatile int64_t prof_calls;    /* perf calls (instruments: k-cycles) */
   } TEXT;
 
 
@@ -345,6 +348,12 @@ typedef struct CORFIL {
     int     instcnt;                /* Count number of instances ever */
     int     isNew;                  /* is this a new definition */
     int     nocheckpcnt;            /* Control checks on pcnt */
+    int     prealloc;               /* free instances orcompact() keeps */
+    char    *init_image;            /* instance block as built by instance() */
+    int32   *init_reloc;            /* offsets of its pointers into itself */
+    int     init_nreloc;
+    size_t  init_size;              /* size of an instance block */
+    int     init_version;           /* csound->init_image_version of it */
   } INSTRTXT;
 
   typedef struct namedInstr {
@@ -689,6 +698,8 @@ typedef struct CORFIL {
     int32   flen;
     int     fno, guardreq;
     EVTBLK  e;
+    int     async;      /* made off the perf thread: not in flist yet */
+    FUNC    *newftp;    /* where ftalloc() puts the table when async */
   } FGDATA;
 
   typedef struct {
@@ -825,6 +836,7 @@ typedef struct CORFIL {
   typedef struct eventnode {
     struct eventnode  *nxt;
     uint32     start_kcnt;
+    uint64_t          seqno;    /* order of insertion, for equal start_kcnt */
     EVTBLK            evt;
   } EVTNODE;
 
@@ -875,6 +887,7 @@ typedef struct CORFIL {
  * and nodebug kperf functions */
   int kperf_nodebug(CSOUND *csound);
   int kperf_debug(CSOUND *csound);
+  int kperf_profile(CSOUND *csound);
 
 #endif  /* __BUILDING_LIBCSOUND */
 
@@ -1373,12 +1386,22 @@ typedef struct _message_queue_t_ {
     void *(*GetHostData)(CSOUND *);
     char *(*strNcpy)(char *dst, const char *src, size_t siz);
     int (*GetZaBounds)(CSOUND *, MYFLT **);
+    void *(*PartConvCreate)(CSOUND *, int headSize, int maxSize,
+                            int irLen, int nChannels, int threaded);
+    void (*PartConvLoad)(CSOUND *, void *pc, int chn, const MYFLT *ir,
+                         int stride, int len, int start, int end);
+    void (*PartConvProcess)(CSOUND *, void *pc, const MYFLT *in,
+                            MYFLT **out, int nsmps);
+    void (*PartConvClear)(CSOUND *, void *pc);
+    void (*PartConvDestroy)(CSOUND *, void *pc);
+    int (*FTGenAsync)(CSOUND *, int *fno, const EVTBLK *, int mode);
+    int (*FTReady)(CSOUND *, int fno);
 
        /**@}*/
     /** @name Placeholders
         To allow the API to grow while maintining backward binary compatibility. */
     /**@{ */
-    SUBR dummyfn_2[36];
+    SUBR dummyfn_2[29];
     /**@}*/
 #ifdef __BUILDING_LIBCSOUND
     /* ------- private data (not to be used by hosts or externals) ------- */
@@ -1526,8 +1549,11 @@ typedef struct _message_queue_t_ {
     int32         rngcnt[MAXCHNLS];
     int16         rngflg, multichan;
     void          *evtFuncChain;
-    EVTNODE       *OrcTrigEvts;             /* List of events to be started */
+    EVTNODE       *OrcTrigEvts;             /* Next event to be started */
     EVTNODE       *freeEvtNodes;
+    EVTNODE       **OrcTrigHeap;            /* Min-heap of pending events */
+    int           OrcTrigCnt, OrcTrigSize;
+    uint64_t      OrcTrigSeqno;
     int           csoundIsScorePending_;
     int64_t       advanceCnt;
     int           initonly;
@@ -1745,7 +1771,7 @@ typedef struct _message_queue_t_ {
     volatile stateWithPadding    *dag_task_status;
     watchList     * volatile *dag_task_watch;
     watchList     *dag_wlmm;
-    char          **dag_task_dep;
+    char          **dag_task_dep; /* no longer used, see dag_topo */
     int           dag_task_max_size;
     uint32_t      tempStatus;    /* keeps track of which files are temps */
     int           orcLineOffset; /* 1 less than 1st orch line in the CSD */
@@ -1776,11 +1802,11 @@ typedef struct _message_queue_t_ {
     CS_HASH_TABLE* symbtab;
     int           unused_int1;
     int           inZero;       /* flag compilation of instr0 */
-    struct _message_queue **msg_queue;
-    volatile long msg_queue_wget; /* Writer - Get index */
-    volatile long msg_queue_wput; /* Writer - Put Index */
-    volatile long msg_queue_rstart; /* Reader - start index */
-    volatile long msg_queue_items;
+    struct _message_queue *msg_queue; /* API message ring, threadsafe.c */
+    volatile long msg_queue_wput; /* Writers - next position to claim */
+    long msg_queue_rstart;        /* Reader - next position to read */
+    long msg_queue_size;          /* slots, a power of two */
+    long msg_queue_argsiz;        /* preallocated arg bytes per slot */
     int      aftouch;
     void     *directory;
     ALLOC_DATA *alloc_queue;
@@ -1795,6 +1821,32 @@ typedef struct _message_queue_t_ {
     volatile unsigned long message_string_queue_items;
     unsigned long message_string_queue_wp;
     message_string_queue_t *message_string_queue;
+    struct dag_ws_t *dag_ws;    /* work-stealing scheduler state */
+    dagTopology   *dag_topo;    /* task groups and instr dependency cache */
+    int           dag_orc_version; /* bumped when instruments are merged */
+    int           spout_dirty;  /* spraw/spout not known to be zero */
+    MYFLT *const  *planar_out;  /* host channel buffers of
+                                   csoundPerformKsmpsPlanar() */
+    int           planar_in;    /* spin filled by the host this cycle */
+    int           profiling;    /* kperf is kperf_profile */
+    char          *profile_file; /* where to dump the profile at cleanup */
+    int64_t       prof_tick0;   /* profile clock and real time when */
+    RTCLOCK       prof_clock0;  /* profiling was last reset */
+    char          *orc_cache_dir; /* where csoundParseOrc() keeps trees */
+    void          *csmodule_index; /* CS_PLUGIN_INDEX state (csmodule.c) */
+    CS_HASH_TABLE *opcode_resolved; /* call signature -> OENTRY, dropped
+                                       when an opcode is added */
+    void          *ftgen_async; /* FTASYNC workers and unpublished tables
+                                   of csoundFTGenAsync() (fgens.c) */
+    MYFLT         score_window; /* --score-window: beats a score event may
+                                   start before the latest one read */
+    void          *score_stream; /* SCSTREAM of a score sorted in windows
+                                    (scsort.c) */
+    void          *score_binary; /* SCBIN of a mapped binary score, read
+                                    in place of scstr (scbin.c) */
+    int           init_image_version; /* bumped when the MIDI p-field
+                                         options change instance layouts */
+    spin_lock_t   chn_db_lock;  /* chn_db lookups and inserts (bus.c) */
     /*struct CSOUND_ **self;*/
     /**@}*/
 #endif  /* __BUILDING_LIBCSOUND */
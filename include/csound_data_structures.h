@@ -28,7 +28,11 @@
 extern "C" {
 #endif
 
-#define HASH_SIZE 4099
+/* initial number of buckets in a CS_HASH_TABLE; grows by doubling.
+   Growing relinks every item and frees the old bucket array, so a table
+   that one thread writes while others read must be locked by its owner
+   (as chn_db is, in bus.c). */
+#define CS_HASH_INIT_SIZE 16
 
 typedef struct _cons {
     void* value; // should be car, but using value
@@ -40,10 +44,13 @@ typedef struct _cs_hash_bucket_item {
     char* key;
     void* value;
     struct _cs_hash_bucket_item* next;
+    uint32_t hash;       /* cached hash of key */
 } CS_HASH_TABLE_ITEM;
 
 typedef struct _cs_hash_table {
-    CS_HASH_TABLE_ITEM* buckets[HASH_SIZE];
+    uint32_t table_size; /* number of buckets, a power of two */
+    uint32_t count;      /* number of items */
+    CS_HASH_TABLE_ITEM** buckets;
 } CS_HASH_TABLE;
 
 /* FUNCTIONS FOR CONS CELL */
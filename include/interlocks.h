@@ -50,6 +50,9 @@
 #define IW (0x0400)
 #define IB (0x0600)
 
+// No side effects: writes only its outputs, from its inputs alone
+#define PU (0x0800)
+
 //Deprecated
 #define _QQ (0x8000)
 
@@ -0,0 +1,70 @@
+/*
+ * aops_bench.c: cost per sample of the a-rate arithmetic opcodes
+ *
+ * Compiles one instrument holding a block of each a-rate arithmetic
+ * form (a+a, a*k, k/a, divz, int, frac, ...), performs it with
+ * profiling on and reports the time each opcode spends per sample,
+ * as read back through csoundGetProfile().
+ *
+ *   aops_bench [ksmps] [cycles]
+ *
+ * Not run by ctest; build target benchAops.
+ */
+
+#include "csound.h"
+#include <stdio.h>
+#include <stdlib.h>
+
+#define REPEAT 16
+
+static const char *ops[] = {
+    "a3 = a1 + a2", "a3 = a1 + k1", "a3 = k1 + a2",
+    "a3 = a1 - a2", "a3 = a1 - k1", "a3 = k1 - a2",
+    "a3 = a1 * a2", "a3 = a1 * k1", "a3 = k1 * a2",
+    "a3 = a1 / a2", "a3 = a1 / k1", "a3 = k1 / a2",
+    "a3 divz a1, a2, 0", "a3 divz k1, a2, 0", "a3 divz a1, k1, 0",
+    "a3 = int(a1)", "a3 = frac(a1)", NULL
+};
+
+int main(int argc, char **argv)
+{
+    CSOUND  *csound;
+    CSOUND_PROFILE_ENTRY e[64];
+    char    *orc, *p;
+    int     ksmps = 64, cycles = 20000, i, j, n;
+
+    if (argc > 1) ksmps = atoi(argv[1]);
+    if (argc > 2) cycles = atoi(argv[2]);
+
+    p = orc = (char *) malloc(64 * REPEAT * 20 + 256);
+    p += sprintf(p, "sr = 48000\nksmps = %d\nnchnls = 1\n0dbfs = 1\n"
+                 "instr 1\nk1 init 0.25\na1 init 1.75\na2 init -0.5\n",
+                 ksmps);
+    for (i = 0; ops[i] != NULL; i++)
+      for (j = 0; j < REPEAT; j++)
+        p += sprintf(p, "%s\n", ops[i]);
+    sprintf(p, "endin\n");
+
+    csound = csoundCreate(NULL);
+    csoundSetOption(csound, "-n");
+    csoundSetOption(csound, "-m0");
+    csoundSetOption(csound, "-d");
+    if (csoundCompileOrc(csound, orc) != 0 || csoundStart(csound) != 0) {
+      fprintf(stderr, "orchestra did not compile\n");
+      return 1;
+    }
+    csoundReadScore(csound, "i1 0 -1\n");
+    csoundPerformKsmps(csound);         /* run the init pass unprofiled */
+    csoundSetProfiling(csound, 1);
+    for (i = 0; i < cycles; i++)
+      if (csoundPerformKsmps(csound) != 0) break;
+
+    n = csoundGetProfile(csound, 0, e, 64);
+    printf("ksmps %d, %d cycles\n", ksmps, cycles);
+    for (i = 0; i < n && i < 64; i++)
+      printf("%-12s %8.3f ns/sample\n", e[i].name,
+             1e9 * e[i].seconds / ((double) e[i].calls * ksmps));
+    csoundDestroy(csound);
+    free(orc);
+    return 0;
+}
@@ -0,0 +1,105 @@
+/*
+ * File:   aops_simd_test.c
+ *
+ * Checks each vector kernel table this CPU can run against the plain C
+ * loops, bit for bit, on the inputs where modf() is easy to get wrong.
+ */
+
+#define __BUILDING_LIBCSOUND
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include "csoundCore.h"
+#include "prototyp.h"
+#include "CUnit/Basic.h"
+
+#define NIN 19
+
+static const MYFLT in[NIN] = {
+    NAN, -NAN, INFINITY, -INFINITY, FL(-3.0), FL(-0.0), FL(0.0), FL(2.0),
+    FL(3.25), FL(-3.25), FL(0.5), FL(-0.5), FL(1.0e-30), FL(-1.0e-30),
+    FL(1.0e30), FL(-1.0e30), FL(8388607.5), FL(-8388607.5), FL(7.75)
+};
+
+int init_suite1(void) {
+    return 0;
+}
+
+int clean_suite1(void) {
+    return 0;
+}
+
+/* equal bits, or both NaN */
+static int same(MYFLT a, MYFLT b) {
+    if (isnan(a))
+      return isnan(b);
+    return memcmp(&a, &b, sizeof(MYFLT)) == 0;
+}
+
+static void check(const char *name, vop_v_fn c, vop_v_fn v) {
+    MYFLT r0[NIN], r[NIN];
+    int i;
+
+    c(r0, in, NIN);
+    v(r, in, NIN);
+    for (i = 0; i < NIN; i++) {
+      if (!same(r0[i], r[i]))
+        printf("%s(%g): %g, C loop gives %g\n", name, (double) in[i],
+               (double) r[i], (double) r0[i]);
+      CU_ASSERT(same(r0[i], r[i]));
+    }
+}
+
+void test_vop_int(void) {
+    const VOP_KERNELS *k[4];
+    int n = cs_vop_kernel_sets(k), i;
+
+    for (i = 1; i < n; i++)
+      check("int", k[0]->vint, k[i]->vint);
+}
+
+void test_vop_frac(void) {
+    const VOP_KERNELS *k[4];
+    int n = cs_vop_kernel_sets(k), i;
+    MYFLT r[NIN];
+
+    /* the C loop itself keeps the sign and the NaN */
+    k[0]->vfrac(r, in, NIN);
+    CU_ASSERT(isnan(r[0]));
+    CU_ASSERT(r[3] == FL(0.0) && signbit(r[3]));
+    CU_ASSERT(r[4] == FL(0.0) && signbit(r[4]));
+    CU_ASSERT(r[5] == FL(0.0) && signbit(r[5]));
+    CU_ASSERT_EQUAL(r[9], FL(-0.25));
+    for (i = 1; i < n; i++)
+      check("frac", k[0]->vfrac, k[i]->vfrac);
+}
+
+int main() {
+    CU_pSuite pSuite = NULL;
+
+    /* initialize the CUnit test registry */
+    if (CUE_SUCCESS != CU_initialize_registry())
+        return CU_get_error();
+
+    /* add a suite to the registry */
+    pSuite = CU_add_suite("a-rate vector kernel tests", init_suite1, clean_suite1);
+    if (NULL == pSuite) {
+        CU_cleanup_registry();
+        return CU_get_error();
+    }
+
+    /* add the tests to the suite */
+    if ((NULL == CU_add_test(pSuite, "Test int kernels", test_vop_int)) ||
+        (NULL == CU_add_test(pSuite, "Test frac kernels", test_vop_frac))) {
+        CU_cleanup_registry();
+        return CU_get_error();
+    }
+
+    /* Run all tests using the CUnit Basic interface */
+    CU_basic_set_mode(CU_BRM_VERBOSE);
+    CU_basic_run_tests();
+    CU_cleanup_registry();
+    return CU_get_error();
+}
@@ -1,5 +1,7 @@
 #include <stdio.h>
 #include <string.h>
+#include <stdlib.h>
+#include <stdint.h>
 #include <CUnit/Basic.h>
 #include "csound.h"
 
@@ -358,6 +360,125 @@ void test_string_channel(void)
     csoundDestroy(csound);
 }
 
+void test_channel_handles(void)
+{
+    CSOUND_CHANNEL kh[2], ah, sh;
+    MYFLT kvals[2] = {1.0, 2.0}, kout[2];
+    MYFLT *ain, *aout;
+    char string[32];
+    int i, ksmps;
+
+    csoundSetGlobalEnv("OPCODE6DIR64", "../../");
+    CSOUND *csound = csoundCreate(0);
+    csoundCreateMessageBuffer(csound, 0);
+    csoundSetOption(csound, "--logfile=NULL");
+    csoundCompileOrc(csound, orc1);
+    CU_ASSERT(csoundStart(csound) == CSOUND_SUCCESS);
+
+    CU_ASSERT(csoundGetChannelHandle(csound, &kh[0], "k1",
+                                     CSOUND_CONTROL_CHANNEL |
+                                     CSOUND_INPUT_CHANNEL) == CSOUND_SUCCESS);
+    CU_ASSERT(csoundGetChannelHandle(csound, &kh[1], "k2",
+                                     CSOUND_CONTROL_CHANNEL |
+                                     CSOUND_INPUT_CHANNEL) == CSOUND_SUCCESS);
+    CU_ASSERT_PTR_NOT_NULL(kh[0]);
+    csoundSetControlChannelByHandle(csound, kh[0], 5.0);
+    CU_ASSERT_EQUAL(5.0, csoundGetControlChannel(csound, "k1", NULL));
+    csoundSetControlChannel(csound, "k1", 6.0);
+    CU_ASSERT_EQUAL(6.0, csoundGetControlChannelByHandle(csound, kh[0]));
+    csoundSetControlChannelsByHandle(csound, kh, kvals, 2);
+    csoundGetControlChannelsByHandle(csound, kh, kout, 2);
+    CU_ASSERT_EQUAL(1.0, kout[0]);
+    CU_ASSERT_EQUAL(2.0, kout[1]);
+
+    /* a handle of the wrong type is ignored */
+    CU_ASSERT(csoundGetChannelHandle(csound, &ah, "k1",
+                                     CSOUND_AUDIO_CHANNEL) != CSOUND_SUCCESS);
+    CU_ASSERT_PTR_NULL(ah);
+    csoundSetControlChannelByHandle(csound, NULL, 1.0);
+
+    ksmps = csoundGetKsmps(csound);
+    ain = (MYFLT *) malloc(2*ksmps*sizeof(MYFLT));
+    aout = ain + ksmps;
+    for (i = 0; i < ksmps; i++) ain[i] = i;
+    CU_ASSERT(csoundGetChannelHandle(csound, &ah, "a1",
+                                     CSOUND_AUDIO_CHANNEL) == CSOUND_SUCCESS);
+    csoundSetAudioChannelByHandle(csound, ah, ain);
+    csoundGetAudioChannel(csound, "a1", aout);
+    CU_ASSERT_EQUAL(aout[ksmps-1], ksmps-1);
+    free(ain);
+
+    CU_ASSERT(csoundGetChannelHandle(csound, &sh, "s1",
+                                     CSOUND_STRING_CHANNEL) == CSOUND_SUCCESS);
+    csoundSetStringChannelByHandle(csound, sh, "handle_val");
+    csoundGetStringChannel(csound, "s1", string);
+    CU_ASSERT_STRING_EQUAL(string, "handle_val");
+    csoundSetStringChannel(csound, "s1", "name_val");
+    csoundGetStringChannelByHandle(csound, sh, string);
+    CU_ASSERT_STRING_EQUAL(string, "name_val");
+
+    csoundCleanup(csound);
+    csoundDestroyMessageBuffer(csound);
+    csoundDestroy(csound);
+}
+
+static volatile int reader_stop;
+
+static uintptr_t channel_reader(void *data)
+{
+    CSOUND *csound = (CSOUND *) data;
+    char name[16];
+    int i = 0, err;
+    while (!reader_stop) {
+      snprintf(name, sizeof(name), "c%d", i);
+      csoundGetControlChannel(csound, name, &err);
+      i = (i + 1) % 500;
+    }
+    return 0;
+}
+
+/* the host reads (and so creates) channels by name while i-time code
+   creates them, which grows the channel table several times */
+void test_channel_threads(void)
+{
+    char name[16];
+    void *thread;
+    int i, err, bad = 0;
+
+    csoundSetGlobalEnv("OPCODE6DIR64", "../../");
+    CSOUND *csound = csoundCreate(0);
+    csoundCreateMessageBuffer(csound, 0);
+    csoundSetOption(csound, "--logfile=NULL");
+    csoundCompileOrc(csound, "instr 1\n"
+                             "i1 = 0\n"
+                             "while i1 < 500 do\n"
+                             "  chnset i1, sprintf(\"c%d\", i1)\n"
+                             "  i1 += 1\n"
+                             "od\n"
+                             "endin\n"
+                             "schedule 1, 0, 0\n");
+    CU_ASSERT(csoundStart(csound) == CSOUND_SUCCESS);
+    reader_stop = 0;
+    thread = csoundCreateThread(channel_reader, (void *) csound);
+    CU_ASSERT_PTR_NOT_NULL(thread);
+    for (i = 0; i < 10; i++)
+      csoundPerformKsmps(csound);
+    reader_stop = 1;
+    if (thread != NULL)
+      csoundJoinThread(thread);
+    for (i = 0; i < 500; i++) {
+      snprintf(name, sizeof(name), "c%d", i);
+      if (csoundGetControlChannel(csound, name, &err) != i ||
+          err != CSOUND_SUCCESS)
+        bad++;
+    }
+    CU_ASSERT_EQUAL(bad, 0);
+
+    csoundCleanup(csound);
+    csoundDestroyMessageBuffer(csound);
+    csoundDestroy(csound);
+}
+
 int main(void)
 {
    CU_pSuite pSuite = NULL;
@@ -383,6 +504,9 @@ int main(void)
            || (NULL == CU_add_test(pSuite, "Invalid channels", test_invalid_channel))
            || (NULL == CU_add_test(pSuite, "Channel hints", test_chn_hints))
            || (NULL == CU_add_test(pSuite, "String channel", test_string_channel))
+           || (NULL == CU_add_test(pSuite, "Channel handles", test_channel_handles))
+           || (NULL == CU_add_test(pSuite, "Channels across threads",
+                                   test_channel_threads))
        )
    {
       CU_cleanup_registry();
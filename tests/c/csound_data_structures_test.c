@@ -147,6 +147,35 @@ void test_cs_hash_table_get_put_key(void) {
     csoundDestroy(csound);
 }
 
+void test_cs_hash_table_grow(void) {
+    CSOUND* csound = csoundCreate(NULL);
+    char key[32];
+    int i, n = 0;
+
+    CS_HASH_TABLE* hashTable = cs_hash_table_create(csound);
+    for (i = 0; i < 10000; i++) {
+        sprintf(key, "gkchan%04d", i);
+        cs_hash_table_put(csound, hashTable, key, (void*) (intptr_t) (i + 1));
+    }
+    CU_ASSERT(hashTable->table_size >= 10000);
+    CU_ASSERT_EQUAL(hashTable->count, 10000);
+    for (i = 0; i < 10000; i++) {
+        sprintf(key, "gkchan%04d", i);
+        n += (cs_hash_table_get(csound, hashTable, key) ==
+              (void*) (intptr_t) (i + 1));
+    }
+    CU_ASSERT_EQUAL(n, 10000);
+    for (i = 0; i < 10000; i += 2) {
+        sprintf(key, "gkchan%04d", i);
+        cs_hash_table_remove(csound, hashTable, key);
+    }
+    CU_ASSERT_EQUAL(hashTable->count, 5000);
+    CU_ASSERT_PTR_NULL(cs_hash_table_get(csound, hashTable, "gkchan0000"));
+    CU_ASSERT_PTR_NOT_NULL(cs_hash_table_get(csound, hashTable, "gkchan0001"));
+    CU_ASSERT_EQUAL(cs_cons_length(cs_hash_table_keys(csound, hashTable)), 5000);
+
+    csoundDestroy(csound);
+}
 
 int main() {
     CU_pSuite pSuite = NULL;
@@ -167,7 +196,8 @@ int main() {
         (NULL == CU_add_test(pSuite, "Test cs_cons_append()", test_cs_cons_append)) ||
         (NULL == CU_add_test(pSuite, "Test cs_hash_table()", test_cs_hash_table)) ||
         (NULL == CU_add_test(pSuite, "Test cs_hash_table_merge()", test_cs_hash_table_merge)) ||
-        (NULL == CU_add_test(pSuite, "Test cs_hash_table_get_put_key()", test_cs_hash_table_get_put_key))) {
+        (NULL == CU_add_test(pSuite, "Test cs_hash_table_get_put_key()", test_cs_hash_table_get_put_key)) ||
+        (NULL == CU_add_test(pSuite, "Test cs_hash_table grows", test_cs_hash_table_grow))) {
         
         CU_cleanup_registry();
         return CU_get_error();
@@ -1,6 +1,11 @@
 #include "csound.h"
 #include <stdio.h>
+#include <string.h>
+#include <math.h>
 #include <CUnit/Basic.h>
+#include <dirent.h>
+#include <sys/stat.h>
+#include <unistd.h>
 
 #include "time.h"
 
@@ -54,6 +59,1453 @@ void test_compile_async(void)
     csoundDestroy(csound);
 }
 
+/* counts instances of instr 1 built rather than cloned (-v reports them) */
+static int instances_built;
+
+static void count_builds(CSOUND *csound, int attr,
+                         const char *format, va_list args)
+{
+    (void) csound; (void) attr;
+    if (strncmp(format, "instr %d allocated at", 21) == 0) {
+      va_list ap;
+      va_copy(ap, args);
+      if (va_arg(ap, int) == 1)
+        instances_built++;
+      va_end(ap);
+    }
+}
+
+void test_prealloc_instances(void)
+{
+    CSOUND  *csound;
+    MYFLT   *sum;
+    int     i;
+    csound = csoundCreate(NULL);
+    csoundSetOption(csound, "-n");
+    csoundSetOption(csound, "-m0");
+    csoundSetOption(csound, "-v");
+    csoundSetMessageCallback(csound, count_builds);
+    instances_built = 0;
+    csoundCompileOrc(csound, "ksmps = 10\n"
+                             "instr 1\n"
+                             "ival = p4\n"
+                             "icnt = 0\n"
+                             "loop:\n"
+                             "icnt += 1\n"
+                             "if icnt < 3 igoto loop\n"
+                             "chnset chnget:i(\"sum\") + ival*icnt, \"sum\"\n"
+                             "endin\n");
+    CU_ASSERT_EQUAL(csoundPreallocInstr(csound, 1, NULL, 4), CSOUND_SUCCESS);
+    csoundStart(csound);
+    /* the first four events take the preallocated instances (one built,
+       three cloned from its image); those are still playing when the
+       next four arrive, which are cloned too, after an unrelated
+       instrument is compiled, which leaves the image in use */
+    for (i = 0; i < 8; i++) {
+      MYFLT pf[4] = { 1, 0, 0.01, (MYFLT) (i + 1) };
+      csoundScoreEvent(csound, 'i', pf, 4);
+      if (i == 3) {
+        csoundPerformKsmps(csound);
+        csoundCompileOrc(csound, "instr 2\n"
+                                 "endin\n");
+      }
+    }
+    csoundPerformKsmps(csound);
+    csoundGetChannelPtr(csound, &sum, "sum",
+                        CSOUND_CONTROL_CHANNEL | CSOUND_OUTPUT_CHANNEL);
+    CU_ASSERT_DOUBLE_EQUAL(*sum, 108.0, 0.0001);
+    CU_ASSERT_EQUAL(instances_built, 1);
+    csoundDestroy(csound);
+}
+
+void test_memory_stats(void)
+{
+    CSOUND  *csound;
+    CSOUND_MEMORY_STATS stats;
+    csound = csoundCreate(NULL);
+    csoundSetOption(csound, "-n");
+    csoundCompileOrc(csound, "instr 1\n"
+                             "a1 oscili 0.5, 440\n"
+                             "endin\n");
+    csoundGetMemoryStats(csound, &stats);
+    CU_ASSERT(stats.allocs > 0);
+    CU_ASSERT(stats.frees <= stats.allocs);
+    CU_ASSERT_EQUAL(stats.smallBlocks + stats.largeBlocks,
+                    stats.allocs - stats.frees);
+    CU_ASSERT(stats.bytesInUse > 0);
+    CU_ASSERT(stats.bytesReserved >= stats.bytesInUse);
+    csoundReset(csound);
+    csoundGetMemoryStats(csound, &stats);
+    CU_ASSERT_EQUAL(stats.smallBlocks + stats.largeBlocks,
+                    stats.allocs - stats.frees);
+    csoundDestroy(csound);
+}
+
+void test_planar_perform(void)
+{
+    CSOUND  *csound;
+    MYFLT   left[16], right[16], inl[16], inr[16];
+    MYFLT   *out[2] = { left, right };
+    const MYFLT *in[2] = { inl, inr };
+    MYFLT   *chn;
+    int     i;
+    csound = csoundCreate(NULL);
+    csoundSetOption(csound, "-n");
+    csoundSetOption(csound, "-m0");
+    csoundCompileOrc(csound, "ksmps = 16\n"
+                             "nchnls = 2\n"
+                             "nchnls_i = 2\n"
+                             "0dbfs = 1\n"
+                             "instr 1\n"
+                             "a1, a2 ins\n"
+                             "outs a1*0.5, a2 + 0.25\n"
+                             "endin\n"
+                             "schedule 1, 0, 1\n");
+    csoundStart(csound);
+    for (i = 0; i < 16; i++) {
+      inl[i] = (MYFLT) i;
+      inr[i] = (MYFLT) -i;
+    }
+    CU_ASSERT_EQUAL(csoundPerformKsmpsPlanar(csound, out, in), 0);
+    for (i = 0; i < 16; i++) {
+      CU_ASSERT_DOUBLE_EQUAL(left[i], 0.5 * i, 0.0001);
+      CU_ASSERT_DOUBLE_EQUAL(right[i], 0.25 - i, 0.0001);
+    }
+    chn = csoundGetSpoutChannel(csound, 1);
+    CU_ASSERT_PTR_NOT_NULL(chn);
+    CU_ASSERT_DOUBLE_EQUAL(chn[3], 0.25 - 3, 0.0001);
+    CU_ASSERT_PTR_NULL(csoundGetSpoutChannel(csound, 2));
+    csoundDestroy(csound);
+
+    /* host input takes the place of an input file for its k-cycle */
+    csound = csoundCreate(NULL);
+    csoundSetOption(csound, "-oplanar_in_test.wav");
+    csoundSetOption(csound, "-f");
+    csoundSetOption(csound, "-m0");
+    csoundCompileOrc(csound, "ksmps = 16\n"
+                             "nchnls = 2\n"
+                             "0dbfs = 1\n"
+                             "instr 1\n"
+                             "outs a(0.75), a(-0.75)\n"
+                             "endin\n"
+                             "schedule 1, 0, 0.01\n");
+    csoundStart(csound);
+    while (csoundPerformKsmps(csound) == 0)
+      ;
+    csoundDestroy(csound);
+    csound = csoundCreate(NULL);
+    csoundSetOption(csound, "-n");
+    csoundSetOption(csound, "-iplanar_in_test.wav");
+    csoundSetOption(csound, "-m0");
+    csoundCompileOrc(csound, "ksmps = 16\n"
+                             "nchnls = 2\n"
+                             "nchnls_i = 2\n"
+                             "0dbfs = 1\n"
+                             "instr 1\n"
+                             "a1, a2 ins\n"
+                             "outs a1*0.5, a2 + 0.25\n"
+                             "endin\n"
+                             "schedule 1, 0, 1\n");
+    csoundStart(csound);
+    CU_ASSERT_EQUAL(csoundPerformKsmpsPlanar(csound, out, in), 0);
+    for (i = 0; i < 16; i++)
+      CU_ASSERT_DOUBLE_EQUAL(left[i], 0.5 * i, 0.0001);
+    CU_ASSERT_EQUAL(csoundPerformKsmpsPlanar(csound, out, NULL), 0);
+    for (i = 0; i < 16; i++)
+      CU_ASSERT_DOUBLE_EQUAL(left[i], 0.375, 0.0001);
+    csoundDestroy(csound);
+    remove("planar_in_test.wav");
+}
+
+void test_profile(void)
+{
+    CSOUND  *csound;
+    CSOUND_PROFILE_ENTRY e[8];
+    uint64_t calls;
+    int     i, n;
+    csound = csoundCreate(NULL);
+    csoundSetOption(csound, "-n");
+    csoundSetOption(csound, "-m0");
+    csoundCompileOrc(csound, "ksmps = 16\n"
+                             "instr 1\n"
+                             "a1 oscili 0.5, 440\n"
+                             "a2 oscili 0.5, 660\n"
+                             "out a1 + a2\n"
+                             "endin\n"
+                             "instr 2\n"
+                             "k1 = 1\n"
+                             "endin\n"
+                             "schedule 1, 0, 1\n"
+                             "schedule 2, 0, 1\n");
+    csoundStart(csound);
+    csoundPerformKsmps(csound);
+    CU_ASSERT_EQUAL(csoundGetProfile(csound, 0, NULL, 0), 0);
+    csoundSetProfiling(csound, 1);
+    for (i = 0; i < 10; i++) csoundPerformKsmps(csound);
+    n = csoundGetProfile(csound, 1, e, 8);
+    CU_ASSERT_EQUAL(n, 2);
+    for (i = 0; i < n && i < 8; i++)
+      CU_ASSERT_EQUAL(e[i].calls, 10);
+    n = csoundGetProfile(csound, 0, e, 8);
+    CU_ASSERT(n > 0 && n <= 8);
+    for (i = 0, calls = 0; i < n && i < 8; i++) {
+      CU_ASSERT(e[i].calls > 0);
+      if (i > 0) CU_ASSERT(e[i].ticks <= e[i-1].ticks);
+      if (strncmp(e[i].name, "oscili", 6) == 0) calls += e[i].calls;
+    }
+    CU_ASSERT_EQUAL(calls, 20);
+    csoundSetProfiling(csound, 0);
+    csoundPerformKsmps(csound);
+    CU_ASSERT_EQUAL(csoundGetProfile(csound, 1, NULL, 0), 0);
+    csoundDestroy(csound);
+}
+
+void test_udo_args(void)
+{
+    CSOUND  *csound;
+    int     err;
+    csound = csoundCreate(NULL);
+    csoundSetOption(csound, "-n");
+    csoundSetOption(csound, "-m0");
+    csoundCompileOrc(csound, "ksmps = 16\n"
+                             "opcode Gain, ak, ak\n"
+                             "ain, kg xin\n"
+                             "xout ain*kg, kg+1\n"
+                             "endop\n"
+                             "opcode Twice, a, a\n"
+                             "setksmps 4\n"
+                             "ain xin\n"
+                             "xout ain*2\n"
+                             "endop\n"
+                             "instr 1\n"
+                             "a1 = 1\n"
+                             "a2, k2 Gain a1, 3\n"
+                             "a3 Twice a2\n"
+                             "k3 downsamp a3\n"
+                             "chnset k2, \"k\"\n"
+                             "chnset k3, \"a\"\n"
+                             "endin\n"
+                             "schedule 1, 0, 1\n");
+    csoundStart(csound);
+    csoundPerformKsmps(csound);
+    csoundPerformKsmps(csound);
+    CU_ASSERT_DOUBLE_EQUAL(csoundGetControlChannel(csound, "k", &err), 4.0,
+                           0.0001);
+    CU_ASSERT_DOUBLE_EQUAL(csoundGetControlChannel(csound, "a", &err), 6.0,
+                           0.0001);
+    csoundDestroy(csound);
+}
+
+void test_expression_fusion(void)
+{
+    CSOUND  *csound;
+    CSOUND_PROFILE_ENTRY e[16];
+    MYFLT   fused[16], plain[16];
+    int     i, n, found = 0;
+    csound = csoundCreate(NULL);
+    csoundSetOption(csound, "-n");
+    csoundSetOption(csound, "-m0");
+    csoundCompileOrc(csound, "ksmps = 16\n"
+                             "instr 1\n"
+                             "a2 oscili 0.5, 440\n"
+                             "a3 oscili 0.3, 220\n"
+                             "k1 line 0, 1, 1\n"
+                             "a1 = sin((a2*k1 + a3)*0.5) / (abs(a3) + 1)\n"
+                             "at1 = a2*k1\n"
+                             "at2 = at1 + a3\n"
+                             "at3 = at2*0.5\n"
+                             "at4 = sin(at3)\n"
+                             "at5 = abs(a3)\n"
+                             "at6 = at5 + 1\n"
+                             "a4 = at4 / at6\n"
+                             "chnset a1, \"fused\"\n"
+                             "chnset a4, \"plain\"\n"
+                             "endin\n"
+                             "schedule 1, 0, 1\n");
+    csoundStart(csound);
+    csoundSetProfiling(csound, 1);
+    for (i = 0; i < 10; i++) {
+      csoundPerformKsmps(csound);
+      csoundGetAudioChannel(csound, "fused", fused);
+      csoundGetAudioChannel(csound, "plain", plain);
+      CU_ASSERT_EQUAL(memcmp(fused, plain, sizeof(fused)), 0);
+    }
+    n = csoundGetProfile(csound, 0, e, 16);
+    for (i = 0; i < n && i < 16; i++)
+      if (strcmp(e[i].name, "##fuse") == 0) found = 1;
+    CU_ASSERT(found);
+    csoundSetProfiling(csound, 0);
+    csoundDestroy(csound);
+}
+
+void test_orc_optimize(void)
+{
+    CSOUND  *csound;
+    CSOUND_PROFILE_ENTRY e[16];
+    int     i, n, err, sin_calls = 0, others = 0;
+    csound = csoundCreate(NULL);
+    csoundSetOption(csound, "-n");
+    csoundSetOption(csound, "-m0");
+    csoundCompileOrc(csound, "ksmps = 16\n"
+                             "instr 1\n"
+                             "k1 line 0.25, 1, 0.25\n"
+                             "k2 = sin(k1*2) + 1\n"
+                             "k3 = sin(k1*2) + 2\n"
+                             "kdead = cos(k1)\n"
+                             "kf = p4*2\n"
+                             "chnset k2 + k3 + kf, \"out\"\n"
+                             "endin\n"
+                             "schedule 1, 0, 1, 3\n");
+    csoundStart(csound);
+    csoundSetProfiling(csound, 1);
+    for (i = 0; i < 10; i++) csoundPerformKsmps(csound);
+    CU_ASSERT_DOUBLE_EQUAL(csoundGetControlChannel(csound, "out", &err),
+                           2*sin(0.5) + 3 + 6, 0.0001);
+    n = csoundGetProfile(csound, 0, e, 16);
+    for (i = 0; i < n && i < 16; i++) {
+      if (strcmp(e[i].name, "sin.k") == 0) sin_calls += e[i].calls;
+      if (strcmp(e[i].name, "cos.k") == 0 || strcmp(e[i].name, "=.k") == 0)
+        others++;
+    }
+    CU_ASSERT_EQUAL(sin_calls, 10);     /* sin(k1*2) computed once */
+    CU_ASSERT_EQUAL(others, 0);         /* kdead gone, kf set at i-time */
+    csoundSetProfiling(csound, 0);
+    csoundDestroy(csound);
+}
+
+static const char *cached_orc =
+    "ksmps = 16\n"
+    "giTab[] fillarray 1, 2, 3\n"
+    "opcode Scale, k, kk\n"
+    "kin, kf xin\n"
+    "xout kin*kf\n"
+    "endop\n"
+    "instr 1\n"
+    "k1 line 1, 1, 2\n"
+    "k2 Scale k1 + giTab[2], p4\n"
+    "chnset k2, \"out\"\n"
+    "endin\n"
+    "schedule 1, 0, 1, 2\n";
+
+/* orchestras loaded from the cache, and UDOs defined twice (-v) */
+static int cache_hits, udos_redefined;
+
+static void count_cache_hits(CSOUND *csound, int attr,
+                             const char *format, va_list args)
+{
+    (void) csound; (void) attr; (void) args;
+    if (strncmp(format, "orchestra loaded from cache", 27) == 0)
+      cache_hits++;
+    if (strncmp(format, "WARNING: redefined opcode", 25) == 0)
+      udos_redefined++;
+}
+
+static CSOUND *create_cached(void)
+{
+    CSOUND  *csound = csoundCreate(NULL);
+    csoundSetOption(csound, "-n");
+    csoundSetOption(csound, "-m0");
+    csoundSetOption(csound, "-v");
+    csoundSetMessageCallback(csound, count_cache_hits);
+    return csound;
+}
+
+static MYFLT run_cached_orc(const char *dir)
+{
+    CSOUND  *csound = create_cached();
+    MYFLT   val;
+    int     i, err;
+    CU_ASSERT_EQUAL(csoundCompileOrcCached(csound, cached_orc, dir), 0);
+    csoundStart(csound);
+    for (i = 0; i < 10; i++) csoundPerformKsmps(csound);
+    val = csoundGetControlChannel(csound, "out", &err);
+    csoundDestroy(csound);
+    return val;
+}
+
+/* files in dir, removed if clear is set */
+static int cache_files(const char *dir, int clear)
+{
+    DIR     *d = opendir(dir);
+    struct dirent *f;
+    char    path[512];
+    int     n = 0;
+    if (d == NULL) return -1;
+    while ((f = readdir(d)) != NULL) {
+      if (f->d_name[0] == '.') continue;
+      n++;
+      snprintf(path, sizeof(path), "%s/%s", dir, f->d_name);
+      if (clear) remove(path);
+    }
+    closedir(d);
+    return n;
+}
+
+void test_orc_cache(void)
+{
+    const char *dir = "orc_cache_test";
+    MYFLT   cold, warm, plain;
+    CSOUND  *csound;
+    DIR     *d;
+    struct dirent *f;
+    char    path[512];
+    struct stat st;
+    int     i, err;
+
+    mkdir(dir, 0755);
+    cache_files(dir, 1);
+    cache_hits = 0;
+    cold = run_cached_orc(dir);         /* parses and writes the cache */
+    CU_ASSERT_EQUAL(cache_hits, 0);
+    CU_ASSERT_EQUAL(cache_files(dir, 0), 1);
+    warm = run_cached_orc(dir);         /* loads it */
+    CU_ASSERT_EQUAL(cache_hits, 1);
+    CU_ASSERT_EQUAL(cache_files(dir, 0), 1);
+
+    /* a damaged file is ignored before any of its UDOs is defined */
+    d = opendir(dir);
+    while ((f = readdir(d)) != NULL && f->d_name[0] == '.') ;
+    snprintf(path, sizeof(path), "%s/%s", dir, f->d_name);
+    closedir(d);
+    CU_ASSERT_EQUAL(stat(path, &st), 0);
+    CU_ASSERT_EQUAL(truncate(path, st.st_size - 8), 0);
+    cache_hits = udos_redefined = 0;
+    CU_ASSERT_EQUAL(run_cached_orc(dir), cold);
+    CU_ASSERT_EQUAL(cache_hits, 0);
+    CU_ASSERT_EQUAL(udos_redefined, 0);
+
+    csound = csoundCreate(NULL);
+    csoundSetOption(csound, "-n");
+    csoundSetOption(csound, "-m0");
+    csoundCompileOrc(csound, cached_orc);
+    csoundStart(csound);
+    for (i = 0; i < 10; i++) csoundPerformKsmps(csound);
+    plain = csoundGetControlChannel(csound, "out", &err);
+    csoundDestroy(csound);
+
+    CU_ASSERT(plain > 7.0);
+    CU_ASSERT_EQUAL(cold, plain);
+    CU_ASSERT_EQUAL(warm, plain);
+
+    /* a tree checked where a global exists is not loaded where it
+       does not */
+    cache_files(dir, 1);
+    csound = create_cached();
+    csoundCompileOrc(csound, "gkglobal init 3\n");
+    CU_ASSERT_EQUAL(csoundCompileOrcCached(csound, "instr 1\n"
+                                           "chnset gkglobal, \"g\"\n"
+                                           "endin\n", dir), 0);
+    csoundDestroy(csound);
+    csound = create_cached();
+    cache_hits = 0;
+    CU_ASSERT(csoundCompileOrcCached(csound, "instr 1\n"
+                                     "chnset gkglobal, \"g\"\n"
+                                     "endin\n", dir) != 0);
+    CU_ASSERT_EQUAL(cache_hits, 0);
+    csoundDestroy(csound);
+    cache_files(dir, 1);
+    rmdir(dir);
+}
+
+/* deferred plugin libraries loaded, by csoundLoadModuleForOpcode() (-v) */
+static int lazy_loads;
+static char lazy_path[1024];
+
+static void count_lazy_loads(CSOUND *csound, int attr,
+                             const char *format, va_list args)
+{
+    (void) csound; (void) attr;
+    if (strncmp(format, "Loading '%s' for %s", 19) == 0) {
+      va_list ap;
+      va_copy(ap, args);
+      snprintf(lazy_path, sizeof(lazy_path), "%s", va_arg(ap, char *));
+      va_end(ap);
+      lazy_loads++;
+    }
+}
+
+void test_plugin_index(void)
+{
+    const char *index = "plugin_index_test.idx";
+    CSOUND  *csound;
+    FILE    *f;
+    char    line[1024], lib[1024] = "", orc[256], *head;
+    int     eager = 1, found = 0, n = 0;
+    long    pos = 0, cut = 0;
+
+    remove(index);
+    csoundSetGlobalEnv("CS_PLUGIN_INDEX", index);
+    csoundDestroy(csoundCreate(NULL));  /* scans and writes the index */
+
+    /* an opcode of the first library that is not loaded at startup */
+    f = fopen(index, "r");
+    CU_ASSERT_PTR_NOT_NULL(f);
+    while (f != NULL && !found && fgets(line, sizeof(line), f) != NULL) {
+      line[strcspn(line, "\n")] = '\0';
+      if (sscanf(line, "lib %d %*s %*s %n", &eager, &n) == 1 && n > 0)
+        strcpy(lib, line + n);
+      else if (strncmp(line, "op ", 3) == 0 && !eager) {
+        snprintf(orc, sizeof(orc), "instr 2\n%s\nendin\n", line + 3);
+        found = 1;
+        cut = pos;
+      }
+      pos = ftell(f);
+    }
+    if (f != NULL) fclose(f);
+    CU_ASSERT(found);
+
+    csound = csoundCreate(NULL);
+    csoundSetOption(csound, "-n");
+    csoundSetOption(csound, "-m0");
+    csoundSetOption(csound, "-v");
+    csoundSetMessageCallback(csound, count_lazy_loads);
+    lazy_loads = 0;
+    csoundCompileOrc(csound, "instr 1\n"
+                             "a1 oscili 0.5, 440\n"
+                             "out a1\n"
+                             "endin\n");
+    CU_ASSERT_EQUAL(lazy_loads, 0);     /* nothing deferred was needed */
+    if (found) {
+      csoundCompileOrc(csound, orc);    /* may not check; it is looked up */
+      CU_ASSERT_EQUAL(lazy_loads, 1);
+      CU_ASSERT_STRING_EQUAL(lazy_path, lib);
+    }
+    csoundDestroy(csound);
+
+    /* cut between lines, before that opcode: the index is stale, not
+       read as a library without it */
+    if (found) {
+      head = (char *) malloc(cut);
+      f = fopen(index, "r");
+      CU_ASSERT(f != NULL && fread(head, 1, cut, f) == (size_t) cut);
+      if (f != NULL) fclose(f);
+      f = fopen(index, "w");
+      fwrite(head, 1, cut, f);
+      fclose(f);
+      free(head);
+      csound = csoundCreate(NULL);
+      csoundSetOption(csound, "-n");
+      csoundSetOption(csound, "-m0");
+      CU_ASSERT_EQUAL(csoundCompileOrc(csound, orc), 0);
+      csoundDestroy(csound);
+      /* and written again, whole */
+      line[0] = '\0';
+      f = fopen(index, "r");
+      while (f != NULL && fgets(line, sizeof(line), f) != NULL)
+        ;
+      if (f != NULL) fclose(f);
+      CU_ASSERT_STRING_EQUAL(line, "end\n");
+    }
+
+    csoundSetGlobalEnv("CS_PLUGIN_INDEX", NULL);
+    remove(index);
+}
+
+void test_opcode_resolution(void)
+{
+    CSOUND  *csound;
+    int     err;
+    csound = csoundCreate(NULL);
+    csoundSetOption(csound, "-n");
+    csoundSetOption(csound, "-m0");
+    csoundCompileOrc(csound, "opcode Scale, k, k\n"
+                             "kx xin\n"
+                             "xout kx*2\n"
+                             "endop\n"
+                             "instr 1\n"
+                             "k1 Scale 1\n"
+                             "k2 Scale k1\n"      /* same signature */
+                             "chnset k2, \"one\"\n"
+                             "endin\n"
+                             "schedule 1, 0, 1\n");
+    csoundStart(csound);
+    csoundPerformKsmps(csound);
+    /* a new overload registered after the first calls were resolved */
+    csoundCompileOrc(csound, "opcode Scale, k, kk\n"
+                             "kx, ky xin\n"
+                             "xout kx*ky\n"
+                             "endop\n"
+                             "instr 2\n"
+                             "k1 Scale 3, 5\n"
+                             "k2 Scale k1\n"
+                             "chnset k2, \"two\"\n"
+                             "endin\n"
+                             "schedule 2, 0, 1\n");
+    csoundPerformKsmps(csound);
+    csoundPerformKsmps(csound);
+    CU_ASSERT_DOUBLE_EQUAL(csoundGetControlChannel(csound, "one", &err), 4.0,
+                           0.0001);
+    CU_ASSERT_DOUBLE_EQUAL(csoundGetControlChannel(csound, "two", &err), 30.0,
+                           0.0001);
+    csoundDestroy(csound);
+}
+
+void test_partconv(void)
+{
+    CSOUND  *csound;
+    int     i, err;
+    csound = csoundCreate(NULL);
+    csoundSetOption(csound, "-n");
+    csoundSetOption(csound, "-m0");
+    /* 5000 samples at 64: partitions of 64, 128, 256 and 512 */
+    csoundCompileOrc(csound, "ksmps = 32\n"
+                             "gir ftgen 1, 0, -5000, 21, 1, 0.1\n"
+                             "instr 1\n"
+                             "asig rand 0.5\n"
+                             "a1 ftconv asig, 1, 64\n"
+                             "a2 ftconvnu asig, 1, 64, 0, 0, 512\n"
+                             "a3 ftconvnu asig, 1, 64, 0, 0, 512, 1\n"
+                             "kd2 max_k a1 - a2, 1, 1\n"
+                             "kd3 max_k a1 - a3, 1, 1\n"
+                             "ka max_k a1, 1, 1\n"
+                             "chnset max(chnget:k(\"d\"), kd2, kd3), \"d\"\n"
+                             "chnset max(chnget:k(\"a\"), ka), \"a\"\n"
+                             "endin\n"
+                             "schedule 1, 0, 1\n");
+    csoundStart(csound);
+    for (i = 0; i < 1000; i++) csoundPerformKsmps(csound);
+    CU_ASSERT(csoundGetControlChannel(csound, "a", &err) > 0.1);
+    CU_ASSERT(csoundGetControlChannel(csound, "d", &err) < 1.0e-4);
+    csoundDestroy(csound);
+}
+
+void test_liveconv_swap(void)
+{
+    CSOUND  *csound;
+    int     i, err;
+    csound = csoundCreate(NULL);
+    csoundSetOption(csound, "-n");
+    csoundSetOption(csound, "-m0");
+    /* kupdate = 2 on the first cycle; once swapped in, with or without a
+       crossfade, the whole IR is there as in ftconv.  The IR starts out
+       empty, so "swapped" is set once both instances give output. */
+    csoundCompileOrc(csound, "ksmps = 32\n"
+                             "sr = 44100\n"
+                             "gir ftgen 1, 0, -5000, 21, 1, 0.1\n"
+                             "instr 1\n"
+                             "asig rand 0.5\n"
+                             "kc init 0\n"
+                             "kc += 1\n"
+                             "kup = kc == 1 ? 2 : 0\n"
+                             "a1 ftconv asig, 1, 64\n"
+                             "a2 liveconv asig, 1, 64, kup, 0\n"
+                             "a3 liveconv asig, 1, 64, kup, 0, 0.01\n"
+                             "ks2 max_k a2, 1, 1\n"
+                             "ks3 max_k a3, 1, 1\n"
+                             "chnset min(ks2, ks3), \"swapped\"\n"
+                             "kn init 0\n"
+                             "kn = chnget:k(\"go\") > 0 ? kn + 1 : 0\n"
+                             "if kn > 40 then\n"
+                             "kd2 max_k a1 - a2, 1, 1\n"
+                             "kd3 max_k a1 - a3, 1, 1\n"
+                             "ka max_k a1, 1, 1\n"
+                             "chnset max(chnget:k(\"d\"), kd2, kd3), \"d\"\n"
+                             "chnset max(chnget:k(\"a\"), ka), \"a\"\n"
+                             "endif\n"
+                             "endin\n"
+                             "schedule 1, 0, -1\n");
+    csoundStart(csound);
+    /* the worker prepares the IR in the background: wait, a cycle at a
+       time, for both instances to swap it in */
+    for (i = 0; i < 5000; i++) {
+      csoundPerformKsmps(csound);
+      if (csoundGetControlChannel(csound, "swapped", &err) > 0) break;
+      csoundSleep(1);
+    }
+    CU_ASSERT(i < 5000);
+    csoundSetControlChannel(csound, "go", 1);
+    for (i = 0; i < 1000; i++) csoundPerformKsmps(csound);
+    CU_ASSERT(csoundGetControlChannel(csound, "a", &err) > 0.1);
+    CU_ASSERT(csoundGetControlChannel(csound, "d", &err) < 1.0e-4);
+    csoundDestroy(csound);
+}
+
+static int sample_loads;
+
+static void count_sample_loads(CSOUND *csound, int attr,
+                               const char *format, va_list args)
+{
+    (void) csound; (void) attr; (void) args;
+    if (strstr(format, "(sr = %d Hz") != NULL)
+      sample_loads++;
+}
+
+static int sample_cache_ftgen(CSOUND *csound, int fno, const char *name)
+{
+    char    orc[256];
+    snprintf(orc, sizeof(orc), "gi%d ftgen %d, 0, 0, 1, \"%s\", 0, 0, 0\n",
+             fno, fno, name);
+    csoundCompileOrc(csound, orc);
+    return sample_loads;
+}
+
+void test_sample_cache(void)
+{
+    CSOUND  *csound;
+    MYFLT   *t1, *t4;
+    FILE    *in, *out;
+    char    buf[4096];
+    size_t  n;
+    int     i, err, len;
+    /* a float WAV file of 185220 frames, 740880 bytes of samples */
+    csound = csoundCreate(NULL);
+    csoundSetOption(csound, "-osample_cache_test.wav");
+    csoundSetOption(csound, "-W");
+    csoundSetOption(csound, "-f");
+    csoundSetOption(csound, "-m0");
+    csoundCompileOrc(csound, "ksmps = 32\n"
+                             "0dbfs = 1\n"
+                             "instr 1\n"
+                             "out oscili(0.5, 441)\n"
+                             "endin\n"
+                             "schedule 1, 0, 4.2\n");
+    csoundStart(csound);
+    for (i = 0; i < 6000; i++) csoundPerformKsmps(csound);
+    csoundCleanup(csound);
+    csoundDestroy(csound);
+    /* and a copy, which is another entry */
+    in = fopen("sample_cache_test.wav", "rb");
+    out = fopen("sample_cache_test2.wav", "wb");
+    CU_ASSERT(in != NULL && out != NULL);
+    if (in == NULL || out == NULL)
+      return;
+    while ((n = fread(buf, 1, sizeof(buf), in)) > 0)
+      fwrite(buf, 1, n, out);
+    fclose(in);
+    fclose(out);
+    /* two tables and two diskin2 instances of the same file, one load */
+    csound = csoundCreate(NULL);
+    csoundSetOption(csound, "-n");
+    csoundSetOption(csound, "-m0");
+    csoundSetMessageCallback(csound, count_sample_loads);
+    sample_loads = 0;
+    csoundCompileOrc(csound, "ksmps = 32\n"
+                             "0dbfs = 1\n"
+                             "gi1 ftgen 1, 0, 0, 1, \"sample_cache_test.wav\","
+                             " 0, 0, 0\n"
+                             "gi2 ftgen 2, 0, 0, 1, \"sample_cache_test.wav\","
+                             " 0, 0, 0\n"
+                             "instr 1\n"
+                             "a1 diskin2 \"sample_cache_test.wav\", 1, 0, 0, 0, 1\n"
+                             "a2 diskin2 \"sample_cache_test.wav\", 1, 0, 0, 0, 1\n"
+                             "andx line 0, 1, sr\n"
+                             "a3 table andx, 1\n"
+                             "a4 table andx, 2\n"
+                             "kd max_k abs(a1 - a3) + abs(a2 - a3) + abs(a4 - a3),"
+                             " 1, 1\n"
+                             "ka max_k a3, 1, 1\n"
+                             "chnset max(chnget:k(\"d\"), kd), \"d\"\n"
+                             "chnset max(chnget:k(\"a\"), ka), \"a\"\n"
+                             "endin\n"
+                             "schedule 1, 0, 0.5\n");
+    csoundStart(csound);
+    for (i = 0; i < 500; i++) csoundPerformKsmps(csound);
+    CU_ASSERT(csoundGetControlChannel(csound, "a", &err) > 0.4);
+    CU_ASSERT(csoundGetControlChannel(csound, "d", &err) < 1.0e-6);
+    CU_ASSERT_EQUAL(sample_loads, 1);
+    csoundDestroy(csound);
+    /* with -realtime, diskin2 never decodes a file at i-time: it streams
+       one that is not in memory yet, and shares one that is */
+    csound = csoundCreate(NULL);
+    csoundSetOption(csound, "-n");
+    csoundSetOption(csound, "-m0");
+    csoundSetOption(csound, "--realtime");
+    csoundSetMessageCallback(csound, count_sample_loads);
+    sample_loads = 0;
+    csoundCompileOrc(csound, "ksmps = 32\n"
+                             "instr 1\n"
+                             "a1 diskin2 \"sample_cache_test.wav\", 1\n"
+                             "a2 diskin2 \"sample_cache_test.wav\", 1\n"
+                             "endin\n"
+                             "schedule 1, 0, 0.1\n");
+    csoundStart(csound);
+    for (i = 0; i < 200; i++) csoundPerformKsmps(csound);
+    CU_ASSERT_EQUAL(sample_loads, 0);
+    sample_cache_ftgen(csound, 1, "sample_cache_test.wav");
+    csoundCompileOrc(csound, "schedule 1, 0, 0.1\n");
+    for (i = 0; i < 200; i++) csoundPerformKsmps(csound);
+    CU_ASSERT_EQUAL(sample_loads, 1);   /* by GEN01 only */
+    csoundDestroy(csound);
+    /* with room for one file: shared while in use, kept when unused, and
+       the least recently used file dropped for another */
+    csoundSetGlobalEnv("CS_SAMPLE_CACHE", "1");
+    csound = csoundCreate(NULL);
+    csoundSetOption(csound, "-n");
+    csoundSetOption(csound, "-m0");
+    csoundSetMessageCallback(csound, count_sample_loads);
+    sample_loads = 0;
+    csoundCompileOrc(csound, "ksmps = 32\n"
+                             "instr 1\n"
+                             "a1 diskin2 \"sample_cache_test.wav\", 1\n"
+                             "a2 diskin2 \"sample_cache_test.wav\", 1\n"
+                             "endin\n"
+                             "schedule 1, 0, 0.2\n");
+    csoundStart(csound);
+    csoundPerformKsmps(csound);
+    CU_ASSERT_EQUAL(sample_loads, 1);   /* two users, one entry */
+    CU_ASSERT_EQUAL(sample_cache_ftgen(csound, 1, "sample_cache_test.wav"), 1);
+    for (i = 0; i < 400; i++) csoundPerformKsmps(csound);
+    /* no users left; it still fits */
+    CU_ASSERT_EQUAL(sample_cache_ftgen(csound, 2, "sample_cache_test.wav"), 1);
+    /* two unused files do not fit, so the older one goes */
+    CU_ASSERT_EQUAL(sample_cache_ftgen(csound, 3, "sample_cache_test2.wav"), 2);
+    CU_ASSERT_EQUAL(sample_cache_ftgen(csound, 4, "sample_cache_test.wav"), 3);
+    CU_ASSERT_EQUAL(sample_cache_ftgen(csound, 5, "sample_cache_test.wav"), 3);
+    len = csoundGetTable(csound, &t1, 1);
+    CU_ASSERT_EQUAL(len, 185220);
+    CU_ASSERT_EQUAL(csoundGetTable(csound, &t4, 4), len);
+    if (len > 0 && csoundGetTable(csound, &t4, 4) == len)
+      CU_ASSERT(memcmp(t1, t4, len * sizeof(MYFLT)) == 0);
+    csoundDestroy(csound);
+    csoundSetGlobalEnv("CS_SAMPLE_CACHE", NULL);
+    remove("sample_cache_test.wav");
+    remove("sample_cache_test2.wav");
+}
+
+void test_additive_gens(void)
+{
+    CSOUND  *csound;
+    MYFLT   *tab;
+    double  d = 0.0, x, v;
+    int     i, n, len;
+    csound = csoundCreate(NULL);
+    csoundSetOption(csound, "-n");
+    csoundSetOption(csound, "-m0");
+    csoundSetOption(csound, "-j4");
+    /* harmonic tables of 2^n points take the inverse FFT; the inharmonic
+       GEN09 is summed on two threads */
+    csoundCompileOrc(csound, "gi1 ftgen 1, 0, 65536, -10, 1, 0.5, 0, 0.25\n"
+                             "gi2 ftgen 2, 0, 65536, -9, 1, 1, 0, 7, 0.5, 90,"
+                             " 300, 0.1, 45\n"
+                             "gi3 ftgen 3, 0, 8192, -19, 2, 1, 30, 0.2,"
+                             " 5, 0.5, 0, 0.1\n"
+                             "gi4 ftgen 4, 0, 8192, -11, 20, 3, 0.9\n"
+                             "gi5 ftgen 5, 0, 1200000, -9, 1.5, 1, 0, 2.25,"
+                             " 0.5, 10\n");
+    csoundStart(csound);
+    for (i = 1; i <= 4; i++) {
+      len = csoundGetTable(csound, &tab, i);
+      CU_ASSERT_EQUAL(len, i < 3 ? 65536 : 8192);
+      for (n = 0; n <= len; n++) {
+        x = 2.0 * M_PI * n / len;
+        if (i == 1)
+          v = sin(x) + 0.5 * sin(2.0 * x) + 0.25 * sin(4.0 * x);
+        else if (i == 2)
+          v = sin(x) + 0.5 * cos(7.0 * x) + 0.1 * sin(300.0 * x + M_PI / 4);
+        else if (i == 3)
+          v = sin(2.0 * x + M_PI / 6) + 0.5 * sin(5.0 * x) + 0.3;
+        else {
+          int h;
+          double a = 0.1 / (1.0 - pow(0.9, 20));
+          for (v = 0.0, h = 0; h < 20; h++, a *= 0.9)
+            v += a * cos((3 + h) * x);
+        }
+        if (fabs(tab[n] - v) > d) d = fabs(tab[n] - v);
+      }
+    }
+    CU_ASSERT(d < 1.0e-6);
+    len = csoundGetTable(csound, &tab, 5);
+    CU_ASSERT_EQUAL(len, 1200000);
+    for (d = 0.0, n = 0; n <= len; n++) {
+      x = 2.0 * M_PI * n / len;
+      v = sin(1.5 * x) + 0.5 * sin(2.25 * x + M_PI / 18);
+      if (fabs(tab[n] - v) > d) d = fabs(tab[n] - v);
+    }
+    CU_ASSERT(d < 1.0e-6);
+    csoundDestroy(csound);
+}
+
+void test_ftgen_async(void)
+{
+    CSOUND  *csound;
+    MYFLT   *tab1, *tab2;
+    int     i, err, len1, len2, fn;
+    csound = csoundCreate(NULL);
+    csoundSetOption(csound, "-n");
+    csoundSetOption(csound, "-m0");
+    /* instr 2 reads its table at i-time, so waits for it */
+    csoundCompileOrc(csound, "ksmps = 32\n"
+                             "gi1 ftgen 0, 0, 262144, 10, 1, 0.5\n"
+                             "instr 1\n"
+                             "ifn ftgenasync 0, 0, 262144, 10, 1, 0.5\n"
+                             "chnset ifn, \"fn\"\n"
+                             "chnset ftready:k(ifn), \"ready\"\n"
+                             "endin\n"
+                             "instr 2\n"
+                             "ifn ftgenasync 0, 0, 4096, 10, 1\n"
+                             "chnset table:i(1024, ifn), \"peak\"\n"
+                             "endin\n"
+                             "schedule 1, 0, 1\n"
+                             "schedule 2, 0, 0.1\n");
+    csoundStart(csound);
+    for (i = 0; i < 1000; i++) csoundPerformKsmps(csound);
+    fn = (int) csoundGetControlChannel(csound, "fn", &err);
+    CU_ASSERT(fn > 0);
+    CU_ASSERT_EQUAL(csoundGetControlChannel(csound, "ready", &err), 1.0);
+    CU_ASSERT_DOUBLE_EQUAL(csoundGetControlChannel(csound, "peak", &err),
+                           1.0, 1.0e-9);
+    len1 = csoundGetTable(csound, &tab1, 101);
+    len2 = csoundGetTable(csound, &tab2, fn);
+    CU_ASSERT_EQUAL(len1, 262144);
+    CU_ASSERT_EQUAL(len2, 262144);
+    if (len1 == len2 && len1 > 0)
+      CU_ASSERT(memcmp(tab1, tab2, sizeof(MYFLT) * (len1 + 1)) == 0);
+    csoundDestroy(csound);
+}
+
+void test_score_window(void)
+{
+    CSOUND  *csound;
+    char    *sco, *p;
+    int     i, err, n = 100000;
+    csound = csoundCreate(NULL);
+    csoundSetOption(csound, "-n");
+    csoundSetOption(csound, "-m0");
+    csoundSetOption(csound, "--score-window=0.5");
+    csoundCompileOrc(csound, "ksmps = 32\n"
+                             "giprev init 0\n"
+                             "gicnt init 0\n"
+                             "gibad init 0\n"
+                             "instr 1\n"
+                             "if p2 < giprev then\n"
+                             "gibad = gibad + 1\n"
+                             "endif\n"
+                             "giprev = p2\n"
+                             "gicnt = gicnt + 1\n"
+                             "chnset gicnt, \"count\"\n"
+                             "chnset gibad, \"bad\"\n"
+                             "endin\n"
+                             "instr 2\n"
+                             "chnset 1, \"extra\"\n"
+                             "endin\n");
+    /* each event within 0.4 beats of its place, several sort windows */
+    sco = (char *) malloc(n * 32 + 64);
+    p = sco + sprintf(sco, "t 0 120\n");
+    srand(1);
+    for (i = 0; i < n; i++)
+      p += sprintf(p, "i 1 %.4f 0.01\n",
+                   i * 0.0002 + 0.4 * rand() / (double) RAND_MAX);
+    csoundReadScore(csound, sco);
+    free(sco);
+    csoundStart(csound);
+    for (i = 0; i < 100; i++) csoundPerformKsmps(csound);
+    /* a score read during performance leaves the windowed one intact */
+    csoundReadScore(csound, "i 2 0 0.01\n");
+    while (csoundPerformKsmps(csound) == 0)
+      ;
+    CU_ASSERT_EQUAL(csoundGetControlChannel(csound, "count", &err), n);
+    CU_ASSERT_EQUAL(csoundGetControlChannel(csound, "bad", &err), 0.0);
+    CU_ASSERT_EQUAL(csoundGetControlChannel(csound, "extra", &err), 1.0);
+    csoundDestroy(csound);
+}
+
+void test_score_binary(void)
+{
+    CSOUND  *csound;
+    FILE    *in, *out;
+    int     i, err, n = 1000;
+    csound = csoundCreate(NULL);
+    csoundSetOption(csound, "-n");
+    csoundSetOption(csound, "-m0");
+    csoundSetOption(csound, "--score-window=0.5");  /* ignored here */
+    /* events in reverse, every tenth one with a string */
+    in = fopen("score_binary_test.sco", "w");
+    fprintf(in, "t 0 6000\n");
+    for (i = n - 1; i >= 0; i--)
+      if (i % 10 == 0)
+        fprintf(in, "i 2 %d 0.01 \"s%d\" %d\n", i, i % 3, i % 3);
+      else
+        fprintf(in, "i 1 %d 0.01\n", i);
+    fclose(in);
+    in = fopen("score_binary_test.sco", "r");
+    out = fopen("score_binary_test.scb", "wb");
+    CU_ASSERT_EQUAL(csoundScoreToBinary(csound, in, out), 0);
+    fclose(in);
+    fclose(out);
+    csoundDestroy(csound);
+
+    csound = csoundCreate(NULL);
+    csoundSetOption(csound, "-n");
+    csoundSetOption(csound, "-m0");
+    csoundCompileOrc(csound, "ksmps = 32\n"
+                             "giprev init -1\n"
+                             "gicnt init 0\n"
+                             "gibad init 0\n"
+                             "instr 1, 2\n"
+                             "if p2 <= giprev then\n"
+                             "gibad = gibad + 1\n"
+                             "endif\n"
+                             "if p1 == 2 then\n"
+                             "S1 strget p4\n"
+                             "S2 sprintf \"s%d\", p5\n"
+                             "if strcmp(S1, S2) != 0 then\n"
+                             "gibad = gibad + 1\n"
+                             "endif\n"
+                             "endif\n"
+                             "giprev = p2\n"
+                             "gicnt = gicnt + 1\n"
+                             "chnset gicnt, \"count\"\n"
+                             "chnset gibad, \"bad\"\n"
+                             "endin\n");
+    CU_ASSERT_EQUAL(csoundReadScoreBinary(csound, "score_binary_test.sco"),
+                    CSOUND_ERROR);
+    CU_ASSERT_EQUAL(csoundReadScoreBinary(csound, "score_binary_test.scb"),
+                    CSOUND_SUCCESS);
+    csoundStart(csound);
+    while (csoundPerformKsmps(csound) == 0)
+      ;
+    CU_ASSERT_EQUAL(csoundGetControlChannel(csound, "count", &err), n);
+    CU_ASSERT_EQUAL(csoundGetControlChannel(csound, "bad", &err), 0.0);
+    /* warped at 100 beats a second: the last note ends at 9.9901 s */
+    CU_ASSERT(csoundGetScoreTime(csound) > 9.98);
+    CU_ASSERT(csoundGetScoreTime(csound) < 10.05);
+    csoundDestroy(csound);
+    remove("score_binary_test.sco");
+    remove("score_binary_test.scb");
+}
+
+void test_steal_order(void)
+{
+    CSOUND  *csound;
+    char    sco[1024], *p = sco;
+    int     i, err;
+    csound = csoundCreate(NULL);
+    csoundSetOption(csound, "-n");
+    csoundSetOption(csound, "-m0");
+    csoundSetOption(csound, "-j4");
+    csoundSetOption(csound, "--par-scheduler=steal");
+    /* 1 -> 2 -> 3 through globals, with independent work alongside */
+    csoundCompileOrc(csound, "ksmps = 16\n"
+                             "gkstep init 0\n"
+                             "gk1 init 0\n"
+                             "gk2 init 0\n"
+                             "gkbad init 0\n"
+                             "instr 1\n"
+                             "gkstep = gkstep + 1\n"
+                             "gk1 = gkstep\n"
+                             "endin\n"
+                             "instr 2\n"
+                             "a1 oscili 0.1, 440 + gk1\n"
+                             "a2 moogladder a1, 1000, 0.5\n"
+                             "gk2 = gk1 * 2\n"
+                             "endin\n"
+                             "instr 3\n"
+                             "if gk2 != gkstep * 2 then\n"
+                             "gkbad = gkbad + 1\n"
+                             "endif\n"
+                             "chnset gkbad, \"bad\"\n"
+                             "chnset gkstep, \"steps\"\n"
+                             "endin\n"
+                             "instr 10\n"
+                             "a1 oscili 0.1, 440\n"
+                             "a2 moogladder a1, 1000, 0.5\n"
+                             "endin\n");
+    p += sprintf(p, "i 1 0 1\ni 3 0 1\n");
+    /* instance counts change while it runs */
+    for (i = 0; i < 4; i++)
+      p += sprintf(p, "i 2 %.2f 1\n", i * 0.05);
+    for (i = 0; i < 16; i++)
+      p += sprintf(p, "i 10 %.2f 1\n", i * 0.02);
+    csoundReadScore(csound, sco);
+    csoundStart(csound);
+    for (i = 0; i < 1000; i++)
+      csoundPerformKsmps(csound);
+    CU_ASSERT_EQUAL(csoundGetControlChannel(csound, "steps", &err), 1000.0);
+    CU_ASSERT_EQUAL(csoundGetControlChannel(csound, "bad", &err), 0.0);
+    csoundDestroy(csound);
+}
+
+void test_rt_event_order(void)
+{
+    CSOUND  *csound;
+    int     i, err;
+    csound = csoundCreate(NULL);
+    csoundSetOption(csound, "-n");
+    csoundSetOption(csound, "-m0");
+    /* 500 events on 50 k-cycles: each must start on its own k-cycle,
+       and those on the same k-cycle in the order they were scheduled */
+    csoundCompileOrc(csound, "sr = 1000\n"
+                             "ksmps = 10\n"
+                             "giprevt init -1\n"
+                             "giprevn init -1\n"
+                             "gicnt init 0\n"
+                             "gibad init 0\n"
+                             "instr 1\n"
+                             "seed 1\n"
+                             "icnt = 0\n"
+                             "while icnt < 500 do\n"
+                             "ir random 0, 50\n"
+                             "idel = int(ir) * 0.01\n"
+                             "schedule 2, idel, 0.005, icnt, idel\n"
+                             "icnt = icnt + 1\n"
+                             "od\n"
+                             "endin\n"
+                             "instr 2\n"
+                             "it times\n"
+                             "if abs(it - p5) > 0.015 || it < giprevt || "
+                             "(it == giprevt && p4 < giprevn) then\n"
+                             "gibad = gibad + 1\n"
+                             "endif\n"
+                             "giprevt = it\n"
+                             "giprevn = p4\n"
+                             "gicnt = gicnt + 1\n"
+                             "chnset gicnt, \"count\"\n"
+                             "chnset gibad, \"bad\"\n"
+                             "endin\n");
+    csoundReadScore(csound, "i 1 0 0.01\n");
+    csoundStart(csound);
+    for (i = 0; i < 70; i++)
+      csoundPerformKsmps(csound);
+    CU_ASSERT_EQUAL(csoundGetControlChannel(csound, "count", &err), 500.0);
+    CU_ASSERT_EQUAL(csoundGetControlChannel(csound, "bad", &err), 0.0);
+    csoundDestroy(csound);
+}
+
+static int div_warnings;
+
+static void count_div_warnings(CSOUND *csound, int attr,
+                               const char *format, va_list args)
+{
+    (void) csound; (void) args;
+    if ((attr & CSOUNDMSG_TYPE_MASK) == CSOUNDMSG_WARNING &&
+        strstr(format, "Division by zero") != NULL)
+      div_warnings++;
+}
+
+/* a division that can warn is not merged, dropped or hoisted */
+void test_orc_optimize_div(void)
+{
+    CSOUND  *csound;
+    int     i;
+    csound = csoundCreate(NULL);
+    csoundSetOption(csound, "-n");
+    csoundSetMessageCallback(csound, count_div_warnings);
+    div_warnings = 0;
+    csoundCompileOrc(csound, "ksmps = 16\n"
+                             "instr 1\n"
+                             "kz init 0\n"
+                             "k1 = 1/kz\n"
+                             "k2 = 1/kz\n"
+                             "kdead = 1/kz\n"
+                             "chnset k1 + k2, \"out\"\n"
+                             "endin\n"
+                             "schedule 1, 0, 1\n");
+    csoundStart(csound);
+    for (i = 0; i < 5; i++) csoundPerformKsmps(csound);
+    CU_ASSERT_EQUAL(div_warnings, 3*5);
+    csoundDestroy(csound);
+}
+
+void test_ftgen_async_pending(void)
+{
+    CSOUND  *csound;
+    MYFLT   *tab;
+    int     i, err;
+    csound = csoundCreate(NULL);
+    csoundSetOption(csound, "-n");
+    csoundSetOption(csound, "-m0");
+    /* tables are installed between k-cycles, so none is ready at i-time */
+    csoundCompileOrc(csound, "ksmps = 32\n"
+                             "instr 1\n"
+                             "i1 ftgenasync 50, 0, 1048576, 10, 1\n"
+                             "chnset ftready:i(50), \"ready50\"\n"
+                             "i2 ftgenasync 50, 0, 4096, 10, 0, 1\n"
+                             "i3 ftgenasync 51, 0, 4096, 10, 1\n"
+                             "ftfree 51, 0\n"
+                             "i4 ftgenasync 52, 0, 4096, 10, 1\n"
+                             "i5 ftgen 52, 0, 4096, 10, 0, 1\n"
+                             "i6 ftgenasync 53, 0, 4096, 21, 1\n"
+                             "chnset ftready:i(53), \"ready53\"\n"
+                             "endin\n"
+                             "instr 2\n"
+                             "chnset ftready:i(51), \"ready51\"\n"
+                             "endin\n"
+                             "schedule 1, 0, 0\n"
+                             "schedule 2, 0.5, 0\n");
+    csoundStart(csound);
+    for (i = 0; i < 1000; i++) csoundPerformKsmps(csound);
+    CU_ASSERT_EQUAL(csoundGetControlChannel(csound, "ready50", &err), 0.0);
+    /* GEN21 draws random numbers, so it was made at once */
+    CU_ASSERT_EQUAL(csoundGetControlChannel(csound, "ready53", &err), 1.0);
+    /* deleted before it was made */
+    CU_ASSERT_EQUAL(csoundGetControlChannel(csound, "ready51", &err), -1.0);
+    CU_ASSERT_EQUAL(csoundGetTable(csound, &tab, 51), -1);
+    /* the second harmonic replaced the pending first one in both */
+    CU_ASSERT_EQUAL(csoundGetTable(csound, &tab, 50), 4096);
+    if (tab != NULL)
+      CU_ASSERT_DOUBLE_EQUAL(tab[512], 1.0, 1.0e-9);
+    CU_ASSERT_EQUAL(csoundGetTable(csound, &tab, 52), 4096);
+    if (tab != NULL)
+      CU_ASSERT_DOUBLE_EQUAL(tab[512], 1.0, 1.0e-9);
+    csoundDestroy(csound);
+}
+
+void test_score_sort_window(void)
+{
+    CSOUND  *csound;
+    FILE    *in, *out;
+    char    line[256];
+    double  p2, prev = -1.0;
+    int     i, cnt = 0, bad = 0, n = 2000;
+    csound = csoundCreate(NULL);
+    csoundSetOption(csound, "-n");
+    csoundSetOption(csound, "-m0");
+    csoundSetOption(csound, "--score-window=0.5");
+    /* in reverse, over many windows: all of it is sorted */
+    in = tmpfile();
+    out = tmpfile();
+    for (i = n - 1; i >= 0; i--)
+      fprintf(in, "i 1 %d 0.01\n", i);
+    rewind(in);
+    CU_ASSERT_EQUAL(csoundScoreSort(csound, in, out), 0);
+    rewind(out);
+    while (fgets(line, sizeof(line), out) != NULL) {
+      if (sscanf(line, "i %*s %lf", &p2) != 1)
+        continue;
+      if (p2 <= prev)
+        bad++;
+      prev = p2;
+      cnt++;
+    }
+    CU_ASSERT_EQUAL(cnt, n);
+    CU_ASSERT_EQUAL(bad, 0);
+    fclose(in);
+    fclose(out);
+    csoundDestroy(csound);
+}
+
+/* run the orchestra for 400 cycles of 16 samples on the given number of
+   threads, keeping the output and the shared accumulator of each cycle */
+static void dag_regroup_run(const char *orc, const char *sco, int threads,
+                            MYFLT *out, MYFLT *acc)
+{
+    CSOUND  *csound;
+    MYFLT   *spout;
+    char    opt[16];
+    int     i, n, err;
+    csound = csoundCreate(NULL);
+    csoundSetOption(csound, "-n");
+    csoundSetOption(csound, "-m0");
+    sprintf(opt, "-j%d", threads);
+    csoundSetOption(csound, opt);
+    csoundCompileOrc(csound, orc);
+    csoundReadScore(csound, sco);
+    csoundStart(csound);
+    spout = csoundGetSpout(csound);
+    for (i = 0; i < 400; i++) {
+      csoundPerformKsmps(csound);
+      for (n = 0; n < 16; n++) out[i*16+n] = spout[n];
+      acc[i] = csoundGetControlChannel(csound, "acc", &err);
+    }
+    csoundDestroy(csound);
+}
+
+void test_dag_regroup(void)
+{
+    /* instr 1 instances chain through gkacc, so their order shows in the
+       result, and instr 2 reads it; instr 3 shares nothing */
+    static const char *shared =
+      "ksmps = 16\n0dbfs = 1\n"
+      "gkacc init 0\n"
+      "instr 1\ngkacc = gkacc * 0.5 + p4\nendin\n"
+      "instr 2\nout oscili(0.1, 200 + gkacc * 100)\nendin\n"
+      "instr 3\nout oscili(0.05, p4)\nendin\n"
+      "instr 9\nchnset gkacc, \"acc\"\nendin\n";
+    static const char *apart =
+      "ksmps = 16\n0dbfs = 1\n"
+      "instr 1\nout oscili(0.02, p4 * 100)\nendin\n"
+      "instr 2\nout oscili(0.1, 200)\nendin\n"
+      "instr 3\nout oscili(0.05, p4)\nendin\n"
+      "instr 9\nchnset 0, \"acc\"\nendin\n";
+    const char *orcs[2] = { shared, apart };
+    MYFLT   *out1, *out2, acc1[400], acc2[400];
+    char    sco[4096], *p = sco;
+    double  d;
+    int     i, k;
+
+    /* notes come and go so the run of instruments in the chain changes,
+       and at times stays the same while the instance counts change */
+    p += sprintf(p, "i 9 0 2\n");
+    for (i = 0; i < 24; i++) {
+      p += sprintf(p, "i 1 %.3f %.3f %d\n", i * 0.003, 0.004 + (i % 3) * 0.002,
+                   i + 1);
+      p += sprintf(p, "i 2 %.3f 0.005\n", i * 0.004);
+      p += sprintf(p, "i 3 %.3f %.3f %d\n", i * 0.005, 0.003 + (i % 4) * 0.001,
+                   300 + i * 10);
+    }
+    out1 = (MYFLT *) malloc(sizeof(MYFLT) * 400 * 16);
+    out2 = (MYFLT *) malloc(sizeof(MYFLT) * 400 * 16);
+    for (k = 0; k < 2; k++) {
+      dag_regroup_run(orcs[k], sco, 1, out1, acc1);
+      dag_regroup_run(orcs[k], sco, 2, out2, acc2);
+      /* the sum into spout may be taken in another order */
+      for (d = 0.0, i = 0; i < 400 * 16; i++)
+        if (fabs(out1[i] - out2[i]) > d) d = fabs(out1[i] - out2[i]);
+      CU_ASSERT(d < 1.0e-6);
+      CU_ASSERT(memcmp(acc1, acc2, sizeof(acc1)) == 0);
+      if (k == 0) CU_ASSERT(acc1[399] > 0.0);
+    }
+    free(out1);
+    free(out2);
+}
+
+/* instr 2 counts the events of each producer (p4) and checks that their
+   numbers (p5) come one after the other, and repeated in p10 by the long
+   ones; instr 9 checks that the value
+   table 1 gets from csoundTableSetAsync() never goes back */
+static const char *async_queue_orc =
+    "ksmps = 32\n"
+    "giLast[] init 8\n"
+    "gicnt init 0\n"
+    "gibad init 0\n"
+    "gitab ftgen 1, 0, 8, -2, 0\n"
+    "instr 2\n"
+    "ip = p4\n"
+    "if p5 != giLast[ip] + 1 || (p10 != 0 && p10 != p5) then\n"
+    "gibad = gibad + 1\n"
+    "endif\n"
+    "giLast[ip] = p5\n"
+    "gicnt = gicnt + 1\n"
+    "chnset gicnt, \"count\"\n"
+    "chnset gibad, \"bad\"\n"
+    "turnoff\n"
+    "endin\n"
+    "instr 9\n"
+    "kprev init 0\n"
+    "kbad init 0\n"
+    "kv tab 0, 1\n"
+    "if kv < kprev then\n"
+    "kbad = kbad + 1\n"
+    "endif\n"
+    "kprev = kv\n"
+    "chnset kv, \"tab\"\n"
+    "chnset kbad, \"tabbad\"\n"
+    "endin\n"
+    "schedule 9, 0, -1\n";
+
+#define ASYNC_QUEUE_N 1000
+
+typedef struct {
+    CSOUND  *csound;
+    int     id;
+} async_producer_t;
+
+/* every other message is too big for the slot, so takes the heap block;
+   the pfields and the string are overwritten as soon as the call returns */
+static uintptr_t async_producer(void *data)
+{
+    async_producer_t *pr = (async_producer_t *) data;
+    MYFLT   pf[10] = { 2, 0, 0.001, 0, 0, 0, 0, 0, 0, 0 };
+    char    msg[128];
+    int     i;
+    for (i = 1; i <= ASYNC_QUEUE_N; i++) {
+      switch (pr->id) {
+      case 0: case 1:
+        pf[3] = pr->id; pf[4] = pf[9] = i;
+        csoundScoreEventAsync(pr->csound, 'i', pf, (i & 1) ? 10 : 5);
+        pf[3] = pf[4] = pf[9] = -1;
+        break;
+      case 2: case 3:
+        if (i & 1)
+          snprintf(msg, sizeof(msg), "i 2 0 0.001 %d %d 0 0 0 0 %d"
+                   " 0 0 0 0 0 0 0 0 0 0 0 0 0 0 0 0 0 0 0 0\n",
+                   pr->id, i, i);
+        else
+          snprintf(msg, sizeof(msg), "i 2 0 0.001 %d %d\n", pr->id, i);
+        csoundInputMessageAsync(pr->csound, msg);
+        memset(msg, 'x', sizeof(msg) - 1);
+        break;
+      default:
+        csoundTableSetAsync(pr->csound, 1, 0, i);
+        break;
+      }
+    }
+    return 0;
+}
+
+void test_async_queue_producers(void)
+{
+    CSOUND  *csound;
+    async_producer_t pr[5];
+    void    *thread[5];
+    int     i, err;
+    csound = csoundCreate(NULL);
+    csoundSetOption(csound, "-n");
+    csoundSetOption(csound, "-m0");
+    /* 16 slots for 5000 messages, so the ring wraps many times over */
+    CU_ASSERT_EQUAL(csoundSetAsyncQueueSize(csound, 16, 64), CSOUND_SUCCESS);
+    csoundCompileOrc(csound, async_queue_orc);
+    csoundStart(csound);
+    for (i = 0; i < 5; i++) {
+      pr[i].csound = csound;
+      pr[i].id = i;
+      thread[i] = csoundCreateThread(async_producer, (void *) &pr[i]);
+      CU_ASSERT_PTR_NOT_NULL(thread[i]);
+    }
+    for (i = 0; i < 200000; i++) {
+      csoundPerformKsmps(csound);
+      if (csoundGetControlChannel(csound, "count", &err) ==
+          4 * ASYNC_QUEUE_N &&
+          csoundGetControlChannel(csound, "tab", &err) == ASYNC_QUEUE_N)
+        break;
+    }
+    for (i = 0; i < 5; i++)
+      if (thread[i] != NULL) csoundJoinThread(thread[i]);
+    /* nothing left over, nothing twice */
+    for (i = 0; i < 10; i++) csoundPerformKsmps(csound);
+    CU_ASSERT_EQUAL(csoundGetControlChannel(csound, "count", &err),
+                    4 * ASYNC_QUEUE_N);
+    CU_ASSERT_EQUAL(csoundGetControlChannel(csound, "bad", &err), 0.0);
+    CU_ASSERT_EQUAL(csoundGetControlChannel(csound, "tab", &err),
+                    ASYNC_QUEUE_N);
+    CU_ASSERT_EQUAL(csoundGetControlChannel(csound, "tabbad", &err), 0.0);
+    csoundDestroy(csound);
+}
+
+void test_async_queue_full(void)
+{
+    CSOUND  *csound;
+    MYFLT   pf[5] = { 2, 0, 0.001, 0, 0 };
+    char    msg[512];
+    int     i, n, err;
+    csound = csoundCreate(NULL);
+    csoundSetOption(csound, "-n");
+    csoundSetOption(csound, "-m0");
+    CU_ASSERT_EQUAL(csoundSetAsyncQueueSize(csound, 4, 0), CSOUND_SUCCESS);
+    csoundCompileOrc(csound, async_queue_orc);
+    csoundStart(csound);
+    CU_ASSERT_EQUAL(csoundSetAsyncQueueSize(csound, 8, 0), CSOUND_ERROR);
+    /* the Try variants fail instead of waiting once the 4 slots are taken,
+       and succeed again when a k-cycle has emptied them */
+    for (n = 1; n <= 3; n++) {
+      for (i = 1; i <= 4; i++) {
+        pf[4] = (n - 1) * 4 + i;
+        CU_ASSERT_EQUAL(csoundTryScoreEventAsync(csound, 'i', pf, 5),
+                        CSOUND_SUCCESS);
+      }
+      pf[4] = 0;
+      CU_ASSERT_EQUAL(csoundTryScoreEventAsync(csound, 'i', pf, 5),
+                      CSOUND_ERROR);
+      CU_ASSERT_EQUAL(csoundTryInputMessageAsync(csound, "i 2 0 0.001 0 0\n"),
+                      CSOUND_ERROR);
+      CU_ASSERT_EQUAL(csoundTryTableSetAsync(csound, 1, 0, 1), CSOUND_ERROR);
+      /* read on one k-cycle, the events start on the next */
+      csoundPerformKsmps(csound);
+      csoundPerformKsmps(csound);
+      CU_ASSERT_EQUAL(csoundGetControlChannel(csound, "count", &err), n * 4);
+    }
+    /* a message much larger than the slot's argument space */
+    n = snprintf(msg, sizeof(msg), "i 2 0 0.001 1 1");
+    while (n < (int) sizeof(msg) - 4) n += sprintf(msg + n, " 0");
+    sprintf(msg + n, "\n");
+    CU_ASSERT_EQUAL(csoundTryInputMessageAsync(csound, msg), CSOUND_SUCCESS);
+    csoundPerformKsmps(csound);
+    csoundPerformKsmps(csound);
+    CU_ASSERT_EQUAL(csoundGetControlChannel(csound, "count", &err), 13.0);
+    CU_ASSERT_EQUAL(csoundGetControlChannel(csound, "bad", &err), 0.0);
+    csoundDestroy(csound);
+}
+
 int main()
 {
     CU_pSuite pSuite = NULL;
@@ -73,6 +1525,49 @@ int main()
     if ((NULL == CU_add_test(pSuite, "Test daemon mode", test_daemon))
         || (NULL == CU_add_test(pSuite, "Test evalcode", test_eval_code))
 	|| (NULL == CU_add_test(pSuite, "Test compileAsync", test_compile_async)) 
+        || (NULL == CU_add_test(pSuite, "Test preallocated instances",
+                                test_prealloc_instances))
+        || (NULL == CU_add_test(pSuite, "Test memory stats", test_memory_stats))
+        || (NULL == CU_add_test(pSuite, "Test planar perform",
+                                test_planar_perform))
+        || (NULL == CU_add_test(pSuite, "Test profile", test_profile))
+        || (NULL == CU_add_test(pSuite, "Test UDO arguments", test_udo_args))
+        || (NULL == CU_add_test(pSuite, "Test expression fusion",
+                                test_expression_fusion))
+        || (NULL == CU_add_test(pSuite, "Test orchestra optimiser",
+                                test_orc_optimize))
+        || (NULL == CU_add_test(pSuite, "Test orchestra cache",
+                                test_orc_cache))
+        || (NULL == CU_add_test(pSuite, "Test plugin index", test_plugin_index))
+        || (NULL == CU_add_test(pSuite, "Test opcode resolution",
+                                test_opcode_resolution))
+        || (NULL == CU_add_test(pSuite, "Test partitioned convolution",
+                                test_partconv))
+        || (NULL == CU_add_test(pSuite, "Test liveconv swap",
+                                test_liveconv_swap))
+        || (NULL == CU_add_test(pSuite, "Test sample cache", test_sample_cache))
+        || (NULL == CU_add_test(pSuite, "Test additive GENs",
+                                test_additive_gens))
+        || (NULL == CU_add_test(pSuite, "Test asynchronous ftgen",
+                                test_ftgen_async))
+        || (NULL == CU_add_test(pSuite, "Test score window", test_score_window))
+        || (NULL == CU_add_test(pSuite, "Test binary score", test_score_binary))
+        || (NULL == CU_add_test(pSuite, "Test work-stealing order",
+                                test_steal_order))
+        || (NULL == CU_add_test(pSuite, "Test real-time event order",
+                                test_rt_event_order))
+        || (NULL == CU_add_test(pSuite, "Test optimiser keeps division warnings",
+                                test_orc_optimize_div))
+        || (NULL == CU_add_test(pSuite, "Test pending asynchronous ftables",
+                                test_ftgen_async_pending))
+        || (NULL == CU_add_test(pSuite, "Test score sort ignores the score window",
+                                test_score_sort_window))
+        || (NULL == CU_add_test(pSuite, "DAG regrouping against -j 1",
+                                test_dag_regroup))
+        || (NULL == CU_add_test(pSuite, "Async queue from several threads",
+                                test_async_queue_producers))
+        || (NULL == CU_add_test(pSuite, "Async queue when full",
+                                test_async_queue_full))
 	)
     {
         CU_cleanup_registry();
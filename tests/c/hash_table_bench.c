@@ -0,0 +1,182 @@
+/*
+ * hash_table_bench.c: CS_HASH_TABLE against the old fixed-size table
+ *
+ * 1. Puts and looks up N generated names (gkchan0001...) in a
+ *    CS_HASH_TABLE and in a copy of the previous implementation
+ *    (4099 fixed buckets, shift-xor hash), reporting ns per lookup
+ *    and the longest chain of the old table.
+ * 2. Compiles an orchestra of N instruments, each with its own
+ *    global channel variable, and looks every channel up by name
+ *    through csoundGetChannelPtr().
+ *
+ *   hash_table_bench [count] [lookup rounds]
+ *
+ * Not run by ctest; build target benchHashTable.
+ */
+
+#include "csound.h"
+#include "csound_data_structures.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/* ---- previous implementation, for reference ---- */
+
+#define OLD_HASH_SIZE 4099
+
+typedef struct old_item {
+    char *key;
+    void *value;
+    struct old_item *next;
+} OLD_ITEM;
+
+static unsigned int old_name_hash(const char *s)
+{
+    unsigned int h = 0;
+    while (*s != '\0') {
+      h = (h<<4) ^ *s++;
+    }
+    return (h%OLD_HASH_SIZE);
+}
+
+static void old_put(OLD_ITEM **buckets, char *key, void *value)
+{
+    unsigned int index = old_name_hash(key);
+    OLD_ITEM *item = buckets[index], *newItem;
+    while (item != NULL) {
+      if (strcmp(key, item->key) == 0) {
+        item->value = value;
+        return;
+      }
+      if (item->next == NULL) break;
+      item = item->next;
+    }
+    newItem = (OLD_ITEM *) malloc(sizeof(OLD_ITEM));
+    newItem->key = key;
+    newItem->value = value;
+    newItem->next = NULL;
+    if (item == NULL) buckets[index] = newItem;
+    else item->next = newItem;
+}
+
+static void *old_get(OLD_ITEM **buckets, const char *key)
+{
+    OLD_ITEM *item = buckets[old_name_hash(key)];
+    while (item != NULL) {
+      if (strcmp(key, item->key) == 0) return item->value;
+      item = item->next;
+    }
+    return NULL;
+}
+
+/* ---- */
+
+static char **make_names(int count)
+{
+    char **names = (char **) malloc(sizeof(char *) * count);
+    int i;
+    for (i = 0; i < count; i++) {
+      names[i] = (char *) malloc(16);
+      snprintf(names[i], 16, "gkchan%04d", i);
+    }
+    return names;
+}
+
+static void bench_tables(CSOUND *csound, char **names, int count, int rounds)
+{
+    OLD_ITEM **old = (OLD_ITEM **) calloc(OLD_HASH_SIZE, sizeof(OLD_ITEM *));
+    CS_HASH_TABLE *table = cs_hash_table_create(csound);
+    RTCLOCK clk;
+    double t;
+    int i, r, longest = 0;
+    long found = 0;
+
+    for (i = 0; i < count; i++) {
+      old_put(old, names[i], names[i]);
+      cs_hash_table_put(csound, table, names[i], names[i]);
+    }
+    for (i = 0; i < OLD_HASH_SIZE; i++) {
+      int n = 0;
+      OLD_ITEM *item;
+      for (item = old[i]; item != NULL; item = item->next) n++;
+      if (n > longest) longest = n;
+    }
+
+    csoundInitTimerStruct(&clk);
+    for (r = 0; r < rounds; r++)
+      for (i = 0; i < count; i++)
+        found += old_get(old, names[i]) != NULL;
+    t = csoundGetRealTime(&clk);
+    printf("old table:  %.1f ns/lookup (longest chain %d)\n",
+           1e9 * t / ((double) rounds * count), longest);
+
+    csoundInitTimerStruct(&clk);
+    for (r = 0; r < rounds; r++)
+      for (i = 0; i < count; i++)
+        found += cs_hash_table_get(csound, table, names[i]) != NULL;
+    t = csoundGetRealTime(&clk);
+    printf("new table:  %.1f ns/lookup (%u buckets)\n",
+           1e9 * t / ((double) rounds * count), table->table_size);
+
+    if (found != 2L * rounds * count)
+      printf("lookup error: %ld of %ld found\n", found, 2L * rounds * count);
+    cs_hash_table_free(csound, table);
+}
+
+static void bench_orchestra(char **names, int count, int rounds)
+{
+    CSOUND  *csound = csoundCreate(NULL);
+    size_t  size = (size_t) count * 64 + 256;
+    char    *orc = (char *) malloc(size), *p = orc;
+    RTCLOCK clk;
+    MYFLT   *val;
+    double  t;
+    int     i, r, err = 0;
+
+    csoundSetOption(csound, "-n");
+    csoundSetOption(csound, "-m0");
+    csoundSetOption(csound, "-d");
+    p += sprintf(p, "sr = 44100\nksmps = 64\nnchnls = 1\n");
+    for (i = 0; i < count; i++)
+      p += sprintf(p, "instr %d\n%s chnget \"%s\"\nendin\n",
+                   i + 1, names[i], names[i]);
+
+    csoundInitTimerStruct(&clk);
+    if (csoundCompileOrc(csound, orc) != 0) {
+      fprintf(stderr, "orchestra did not compile\n");
+      exit(1);
+    }
+    t = csoundGetRealTime(&clk);
+    printf("compile:    %d instruments in %.3f s\n", count, t);
+
+    csoundStart(csound);
+    csoundInitTimerStruct(&clk);
+    for (r = 0; r < rounds; r++)
+      for (i = 0; i < count; i++)
+        err |= csoundGetChannelPtr(csound, &val, names[i],
+                                   CSOUND_CONTROL_CHANNEL |
+                                   CSOUND_INPUT_CHANNEL);
+    t = csoundGetRealTime(&clk);
+    printf("channels:   %.1f ns/lookup%s\n",
+           1e9 * t / ((double) rounds * count), err ? " (errors)" : "");
+
+    csoundDestroy(csound);
+    free(orc);
+}
+
+int main(int argc, char **argv)
+{
+    int    count = 5000, rounds = 200;
+    char   **names;
+    CSOUND *csound;
+
+    if (argc > 1) count = atoi(argv[1]);
+    if (argc > 2) rounds = atoi(argv[2]);
+    names = make_names(count);
+
+    csound = csoundCreate(NULL);
+    bench_tables(csound, names, count, rounds);
+    csoundDestroy(csound);
+    bench_orchestra(names, count, rounds);
+    return 0;
+}
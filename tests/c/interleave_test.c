@@ -0,0 +1,136 @@
+/*
+ * File:   interleave_test.c
+ *
+ * Checks each interleave kernel set this CPU can run against the plain
+ * loops, for every channel count up to two groups of four and one over,
+ * on odd block lengths and on buffers that are not vector aligned.
+ */
+
+#define __BUILDING_LIBCSOUND
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "csoundCore.h"
+#include "prototyp.h"
+#include "CUnit/Basic.h"
+
+#define MAXCH   9
+#define MAXSMPS 67
+
+static const uint32_t lengths[] = { 1, 2, 3, 5, 7, 8, 15, 16, 33, 64, MAXSMPS };
+#define NLEN (sizeof(lengths) / sizeof(lengths[0]))
+
+int init_suite1(void) {
+    return 0;
+}
+
+int clean_suite1(void) {
+    return 0;
+}
+
+/* distinct values, so that a sample in the wrong place shows */
+static MYFLT sample(uint32_t c, uint32_t n) {
+    return (MYFLT) (c * 1000 + n) + FL(0.25);
+}
+
+/* one element past a fresh allocation is never 16 or 32 byte aligned */
+static MYFLT *unaligned(MYFLT **base, size_t n) {
+    *base = (MYFLT *) calloc(n + 1, sizeof(MYFLT));
+    return *base + 1;
+}
+
+static void check_set(int set) {
+    MYFLT    *pbase, *obase, *rbase, *planar, *out, *ref;
+    MYFLT    *chbase[MAXCH], *ch[MAXCH];
+    uint32_t nchnls, stride, i, c, n;
+    size_t   size = (MAXCH + 1) * MAXSMPS;
+
+    planar = unaligned(&pbase, MAXCH * MAXSMPS);
+    out = unaligned(&obase, size);
+    ref = unaligned(&rbase, size);
+    for (c = 0; c < MAXCH; c++)
+      ch[c] = unaligned(&chbase[c], MAXSMPS + 1);
+    for (nchnls = 1; nchnls <= MAXCH; nchnls++)
+      for (i = 0; i < NLEN; i++) {
+        uint32_t nsmps = lengths[i];
+        /* a frame wider than the channels written, as for a device buffer */
+        stride = nchnls + 1;
+        for (c = 0; c < nchnls; c++)
+          for (n = 0; n < nsmps; n++)
+            ch[c][n] = planar[c*nsmps + n] = sample(c, n);
+        memset(ref, 0, size * sizeof(MYFLT));
+        for (c = 0; c < nchnls; c++)
+          for (n = 0; n < nsmps; n++)
+            ref[n*stride + c] = sample(c, n);
+        memset(out, 0, size * sizeof(MYFLT));
+        cs_interleave(out, stride, (const MYFLT *const *) ch, nchnls, nsmps);
+        CU_ASSERT(memcmp(out, ref, size * sizeof(MYFLT)) == 0);
+
+        memset(ref, 0, size * sizeof(MYFLT));
+        for (c = 0; c < nchnls; c++)
+          for (n = 0; n < nsmps; n++)
+            ref[n*nchnls + c] = sample(c, n);
+        memset(out, 0, size * sizeof(MYFLT));
+        cs_interleave_planar(out, planar, nchnls, nsmps);
+        CU_ASSERT(memcmp(out, ref, size * sizeof(MYFLT)) == 0);
+
+        /* back again, one sample into each channel buffer */
+        for (c = 0; c < MAXCH; c++)
+          memset(ch[c], 0, (MAXSMPS + 1) * sizeof(MYFLT));
+        for (c = 0; c < nchnls; c++)
+          for (n = 0; n < nsmps; n++)
+            out[n*stride + c] = sample(c, n);
+        cs_deinterleave(ch, 1, out, stride, nchnls, nsmps);
+        for (c = 0; c < MAXCH; c++) {
+          CU_ASSERT(ch[c][0] == FL(0.0));
+          for (n = 0; n < nsmps; n++)
+            CU_ASSERT(ch[c][n+1] == (c < nchnls ? sample(c, n) : FL(0.0)));
+          if (nsmps < MAXSMPS)
+            CU_ASSERT(ch[c][nsmps+1] == FL(0.0));
+        }
+      }
+    free(pbase);
+    free(obase);
+    free(rbase);
+    for (c = 0; c < MAXCH; c++)
+      free(chbase[c]);
+}
+
+void test_interleave_kernels(void) {
+    int n = cs_interleave_kernels(0), i;
+
+    for (i = 0; i < n; i++) {
+      cs_interleave_kernels(i);
+      check_set(i);
+    }
+    cs_interleave_kernels(-1);
+}
+
+int main() {
+    CU_pSuite pSuite = NULL;
+
+    /* initialize the CUnit test registry */
+    if (CUE_SUCCESS != CU_initialize_registry())
+        return CU_get_error();
+
+    /* add a suite to the registry */
+    pSuite = CU_add_suite("interleave kernel tests", init_suite1, clean_suite1);
+    if (NULL == pSuite) {
+        CU_cleanup_registry();
+        return CU_get_error();
+    }
+
+    /* add the tests to the suite */
+    if (NULL == CU_add_test(pSuite, "Test interleave kernels",
+                            test_interleave_kernels)) {
+        CU_cleanup_registry();
+        return CU_get_error();
+    }
+
+    /* Run all tests using the CUnit Basic interface */
+    CU_basic_set_mode(CU_BRM_VERBOSE);
+    CU_basic_run_tests();
+    CU_cleanup_registry();
+    return CU_get_error();
+}
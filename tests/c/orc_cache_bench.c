@@ -0,0 +1,104 @@
+/*
+ * orc_cache_bench.c: cold against warm orchestra compilation
+ *
+ * Generates an orchestra of N instruments, each a dozen lines of
+ * expressions, conditionals and a UDO call, and compiles it in fresh
+ * Csound instances:
+ *   plain   csoundCompileOrc()
+ *   cold    csoundCompileOrcCached() on an empty cache (parse and store)
+ *   warm    csoundCompileOrcCached() again (load)
+ * reporting the best of R runs of each.  DIR must exist; the cache
+ * files written there are left in place.
+ *
+ *   orc_cache_bench [instruments] [runs] [dir]
+ *
+ * Not run by ctest; build target benchOrcCache.
+ */
+
+#include "csound.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+static char *make_orc(int count, int run)
+{
+    size_t  size = (size_t) count * 640 + 512;
+    char    *orc = (char *) malloc(size), *p = orc;
+    int     i;
+
+    /* a distinct line per run makes a fresh key, so the cache is cold */
+    p += sprintf(p, "sr = 44100\nksmps = 32\nnchnls = 2\n0dbfs = 1\n"
+                 "girun = %d\n"
+                 "opcode Pan, aa, ak\n"
+                 "ain, kpos xin\n"
+                 "xout ain*sqrt(1-kpos), ain*sqrt(kpos)\n"
+                 "endop\n", run);
+    for (i = 0; i < count; i++)
+      p += sprintf(p,
+                   "instr %d\n"
+                   "iamp = ampdbfs(p4 - %d*0.01)\n"
+                   "icps = cpspch(p5) * (1 + %d*0.0001)\n"
+                   "kenv linseg 0, 0.01, 1, p3 - 0.02, 0.5, 0.01, 0\n"
+                   "kvib = 1 + 0.003*sin(6.28*5*times:k())\n"
+                   "a1 vco2 iamp*kenv, icps*kvib\n"
+                   "a2 oscili iamp*kenv*0.5, icps*2.01\n"
+                   "if kenv > 0.5 then\n"
+                   "  kcut = 2000 + kenv*3000\n"
+                   "else\n"
+                   "  kcut = 800 + kenv*1000\n"
+                   "endif\n"
+                   "af moogladder a1 + a2, kcut, 0.3\n"
+                   "aL, aR Pan af*0.5 + (a1 - a2)*0.1, %d/%d\n"
+                   "outs aL, aR\n"
+                   "endin\n", i + 1, i % 60, i, i % 16, 15);
+    return orc;
+}
+
+static double compile_once(const char *orc, const char *dir)
+{
+    CSOUND  *csound = csoundCreate(NULL);
+    RTCLOCK clk;
+    double  t;
+    int     err;
+
+    csoundSetOption(csound, "-n");
+    csoundSetOption(csound, "-m0");
+    csoundSetOption(csound, "-d");
+    csoundInitTimerStruct(&clk);
+    err = dir ? csoundCompileOrcCached(csound, orc, dir)
+              : csoundCompileOrc(csound, orc);
+    t = csoundGetRealTime(&clk);
+    csoundDestroy(csound);
+    if (err != 0) {
+      fprintf(stderr, "orchestra did not compile\n");
+      exit(1);
+    }
+    return t;
+}
+
+int main(int argc, char **argv)
+{
+    int     count = 2000, runs = 5, i;
+    const char *dir = ".";
+    double  plain = 1e9, cold = 1e9, warm = 1e9, t;
+
+    if (argc > 1) count = atoi(argv[1]);
+    if (argc > 2) runs = atoi(argv[2]);
+    if (argc > 3) dir = argv[3];
+    srand((unsigned) time(NULL));
+
+    for (i = 0; i < runs; i++) {
+      char *orc = make_orc(count, rand());
+      if ((t = compile_once(orc, NULL)) < plain) plain = t;
+      if ((t = compile_once(orc, dir)) < cold) cold = t;
+      if ((t = compile_once(orc, dir)) < warm) warm = t;
+      free(orc);
+    }
+    printf("%d instruments, %d lines\n", count, count * 16 + 9);
+    printf("plain: %.3f s\n", plain);
+    printf("cold:  %.3f s (parse and store)\n", cold);
+    printf("warm:  %.3f s (load), %.1fx faster than plain\n",
+           warm, warm > 0.0 ? plain / warm : 0.0);
+    return 0;
+}
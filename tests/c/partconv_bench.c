@@ -0,0 +1,74 @@
+/*
+ * partconv_bench.c: ftconvnu against ftconv at equal latency
+ *
+ * Convolves noise with an impulse response of S seconds of noise at
+ * 48 kHz, with a latency (first partition) of L samples, for D seconds:
+ *   ftconv            uniform partitions of L
+ *   ftconvnu          partitions from L up to 8192, tail over k-cycles
+ *   ftconvnu thread   the same, tail on a background thread
+ * reporting the wall-clock time of each as a fraction of real time.
+ *
+ *   partconv_bench [seconds of IR] [latency] [seconds]
+ *
+ * Not run by ctest; build target benchPartConv.
+ */
+
+#include "csound.h"
+#include <stdio.h>
+#include <stdlib.h>
+
+static double run(const char *opcode, const char *extra, double irsecs,
+                  int latency, double secs)
+{
+    CSOUND  *csound = csoundCreate(NULL);
+    RTCLOCK clk;
+    char    orc[1024];
+    int     i, n;
+    double  t;
+
+    snprintf(orc, sizeof(orc),
+             "sr = 48000\nksmps = 64\nnchnls = 1\n0dbfs = 1\n"
+             "gir ftgen 1, 0, -%d, 21, 1, 0.01\n"
+             "instr 1\n"
+             "asig rand 0.5\n"
+             "a1 %s asig, 1, %d%s\n"
+             "out a1\n"
+             "endin\n"
+             "schedule 1, 0, -1\n",
+             (int) (irsecs * 48000), opcode, latency, extra);
+    csoundSetOption(csound, "-n");
+    csoundSetOption(csound, "-m0");
+    csoundSetOption(csound, "-d");
+    if (csoundCompileOrc(csound, orc) != 0 || csoundStart(csound) != 0) {
+      fprintf(stderr, "%s: orchestra did not start\n", opcode);
+      exit(1);
+    }
+    csoundPerformKsmps(csound);         /* instr 1 init: IR spectra */
+    n = (int) (secs * 48000 / 64);
+    csoundInitTimerStruct(&clk);
+    for (i = 0; i < n; i++)
+      csoundPerformKsmps(csound);
+    t = csoundGetRealTime(&clk);
+    csoundDestroy(csound);
+    return t;
+}
+
+int main(int argc, char **argv)
+{
+    double  irsecs = 6.0, secs = 10.0, t;
+    int     latency = 64;
+
+    if (argc > 1) irsecs = atof(argv[1]);
+    if (argc > 2) latency = atoi(argv[2]);
+    if (argc > 3) secs = atof(argv[3]);
+
+    printf("%.1f s IR at 48 kHz, latency %d, %.1f s of audio\n",
+           irsecs, latency, secs);
+    t = run("ftconv", "", irsecs, latency, secs);
+    printf("ftconv:           %.3f s (%.3f of real time)\n", t, t / secs);
+    t = run("ftconvnu", ", 0, 0, 8192", irsecs, latency, secs);
+    printf("ftconvnu:         %.3f s (%.3f of real time)\n", t, t / secs);
+    t = run("ftconvnu", ", 0, 0, 8192, 1", irsecs, latency, secs);
+    printf("ftconvnu thread:  %.3f s (%.3f of real time)\n", t, t / secs);
+    return 0;
+}
@@ -0,0 +1,69 @@
+/*
+ * plugin_index_bench.c: startup with and without CS_PLUGIN_INDEX
+ *
+ * Times csoundCreate(), csoundCompileOrc() of a one-line orchestra and
+ * csoundStart() of fresh instances, reporting the best of R runs, and
+ * the peak resident set size of the process.  With a file name, the
+ * index is used (and written first if it does not exist); without
+ * one, every plugin library is loaded as before.  Run once per mode, as
+ * the peak RSS is that of the whole process:
+ *
+ *   plugin_index_bench [runs]
+ *   plugin_index_bench [runs] [index file]
+ *
+ * Not run by ctest; build target benchPluginIndex.
+ */
+
+#include "csound.h"
+#include <stdio.h>
+#include <stdlib.h>
+#if !defined(WIN32)
+#include <sys/resource.h>
+#endif
+
+static double start_once(void)
+{
+    RTCLOCK clk;
+    CSOUND  *csound;
+    double  t;
+
+    csoundInitTimerStruct(&clk);
+    csound = csoundCreate(NULL);
+    csoundSetOption(csound, "-n");
+    csoundSetOption(csound, "-m0");
+    csoundSetOption(csound, "-d");
+    if (csoundCompileOrc(csound, "instr 1\nout oscili(0.5, 440)\nendin\n")
+        != 0 || csoundStart(csound) != 0) {
+      fprintf(stderr, "could not start Csound\n");
+      exit(1);
+    }
+    t = csoundGetRealTime(&clk);
+    csoundDestroy(csound);
+    return t;
+}
+
+int main(int argc, char **argv)
+{
+    int     runs = 10, i;
+    double  best = 1e9, t;
+
+    if (argc > 1) runs = atoi(argv[1]);
+    if (argc > 2) {
+      csoundSetGlobalEnv("CS_PLUGIN_INDEX", argv[2]);
+      csoundDestroy(csoundCreate(NULL));    /* writes a missing index */
+    }
+    for (i = 0; i < runs; i++)
+      if ((t = start_once()) < best)
+        best = t;
+    printf("%s: startup %.2f ms (best of %d)\n",
+           argc > 2 ? "index" : "plain", best * 1000.0, runs);
+#if !defined(WIN32)
+    {
+      struct rusage ru;
+      getrusage(RUSAGE_SELF, &ru);
+      /* kilobytes on Linux, bytes on macOS */
+      printf("peak RSS: %ld\n", (long) ru.ru_maxrss);
+    }
+#endif
+    return 0;
+}
@@ -0,0 +1,66 @@
+/*
+ * rt_event_bench.c: cost of queueing and dispatching real-time events
+ *
+ * Schedules N future 'i' events through csoundScoreEvent() in random time
+ * order, then performs until they have all started, reporting the average
+ * cost of each insert and of each k-cycle dispatch.
+ *
+ *   rt_event_bench [count] [seconds]
+ *
+ * Not run by ctest; build target benchRtEvents.
+ */
+
+#include "csound.h"
+#include <stdio.h>
+#include <stdlib.h>
+
+static const char *orc =
+  "sr = 44100\n"
+  "ksmps = 441\n"
+  "nchnls = 1\n"
+  "0dbfs = 1\n"
+  "instr 1\n"
+  "endin\n";
+
+int main(int argc, char **argv)
+{
+    CSOUND  *csound;
+    RTCLOCK clk;
+    MYFLT   pf[3];
+    long    i, count = 1000000;
+    double  span = 600.0, t, kcycles = 0;
+
+    if (argc > 1) count = atol(argv[1]);
+    if (argc > 2) span = atof(argv[2]);
+
+    csound = csoundCreate(NULL);
+    csoundSetOption(csound, "-n");
+    csoundSetOption(csound, "-m0");
+    csoundSetOption(csound, "-d");
+    if (csoundCompileOrc(csound, orc) != 0 || csoundStart(csound) != 0) {
+      fprintf(stderr, "could not start Csound\n");
+      return 1;
+    }
+    srand(1);
+    pf[0] = 1; pf[2] = 0.001;
+    csoundInitTimerStruct(&clk);
+    for (i = 0; i < count; i++) {
+      pf[1] = (MYFLT) (span * rand() / (double) RAND_MAX);
+      csoundScoreEvent(csound, 'i', pf, 3);
+    }
+    t = csoundGetRealTime(&clk);
+    printf("insert:   %ld events in %.3f s, %.1f ns/event\n",
+           count, t, 1e9 * t / count);
+
+    csoundInitTimerStruct(&clk);
+    while (csoundGetScoreTime(csound) <= span + 1.0) {
+      if (csoundPerformKsmps(csound) != 0) break;
+      kcycles++;
+    }
+    t = csoundGetRealTime(&clk);
+    printf("dispatch: %ld events over %.0f k-cycles in %.3f s, "
+           "%.1f ns/event\n", count, kcycles, t, 1e9 * t / count);
+
+    csoundDestroy(csound);
+    return 0;
+}
@@ -0,0 +1,69 @@
+/*
+    bmain.c:
+
+    Copyright (C) 2018 The Csound Developers
+
+    This file is part of Csound.
+
+    The Csound Library is free software; you can redistribute it
+    and/or modify it under the terms of the GNU Lesser General Public
+    License as published by the Free Software Foundation; either
+    version 2.1 of the License, or (at your option) any later version.
+
+    Csound is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public
+    License along with Csound; if not, write to the Free Software
+    Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA
+    02110-1301 USA
+*/
+
+#include "csound.h"                                    /*   BMAIN.C  */
+#include <stdio.h>
+
+static void msg_callback(CSOUND *csound,
+                         int attr, const char *fmt, va_list args)
+{
+  (void) csound;
+    if (attr & CSOUNDMSG_TYPE_MASK) {
+      vfprintf(stderr, fmt, args);
+    }
+}
+
+/* scbin: sorts a text score and writes it as a binary score, which
+   csound plays without sorting:  scbin score.sco score.scb            */
+
+int main(int argc, char **argv)
+{
+    CSOUND *csound;
+    FILE   *inf, *outf;
+    int    err;
+
+    if (argc != 3) {
+      fprintf(stderr, "usage: scbin infile outfile\n");
+      return 1;
+    }
+    if ((inf = fopen(argv[1], "r")) == NULL) {
+      fprintf(stderr, "scbin: cannot open %s\n", argv[1]);
+      return 1;
+    }
+    if ((outf = fopen(argv[2], "wb")) == NULL) {
+      fprintf(stderr, "scbin: cannot create %s\n", argv[2]);
+      fclose(inf);
+      return 1;
+    }
+    csound = csoundCreate(NULL);
+    csoundSetMessageCallback(csound, msg_callback);
+    err = csoundScoreToBinary(csound, inf, outf);
+    csoundDestroy(csound);
+    fclose(inf);
+    if (fclose(outf) != 0)
+      err = 1;
+    if (err)
+      fprintf(stderr, "scbin: failed to write %s\n", argv[2]);
+
+    return err;
+}